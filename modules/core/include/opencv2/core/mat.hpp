@@ -469,6 +469,35 @@ public:
     virtual BufferPoolController* getBufferPoolController(const char* id = NULL) const;
 };
 
+/** @brief Replaces the default allocator of the calling thread while the object is alive.
+
+Matrices created by the calling thread without an explicit allocator use the given allocator
+instead of the one set with Mat::setDefaultAllocator(). Other threads, including the worker threads
+of parallel_for_, are not affected. Scopes can be nested.
+@code
+    {
+        MatAllocatorScope scope(Mat::getPoolAllocator());
+        for (;;)
+        {
+            cap >> frame;
+            process(frame); // temporary matrices are reused from frame to frame
+        }
+    }
+@endcode
+*/
+class CV_EXPORTS MatAllocatorScope
+{
+public:
+    explicit MatAllocatorScope(MatAllocator* allocator);
+    ~MatAllocatorScope();
+
+private:
+    MatAllocator* prevAllocator;
+
+    MatAllocatorScope(const MatAllocatorScope&); // disabled
+    MatAllocatorScope& operator=(const MatAllocatorScope&); // disabled
+};
+
 
 //////////////////////////////// MatCommaInitializer //////////////////////////////////
 
@@ -2089,6 +2118,18 @@ public:
     static MatAllocator* getStdAllocator();
     static MatAllocator* getDefaultAllocator();
     static void setDefaultAllocator(MatAllocator* allocator);
+    /** @brief Returns the allocator that reuses released buffers.
+
+    The allocator keeps released buffers in per-thread pools, grouped by size classes, and
+    hands them out again instead of calling the system allocator. A buffer always returns to the
+    pool of the thread that allocated it, and the pool of a thread is freed when the thread exits.
+    It is useful for code that creates and releases many temporary matrices of the same sizes,
+    e.g. per-frame processing. The pools are controlled through getBufferPoolController(); the
+    limit for all pools together can also be set with the OPENCV_BUFFERPOOL_LIMIT environment
+    variable (128 MB by default). Use it either globally with setDefaultAllocator() or within a
+    block of code with MatAllocatorScope.
+    */
+    static MatAllocator* getPoolAllocator();
 
     //! interaction with UMat
     UMatData* u;
@@ -323,6 +323,8 @@ public:
 
         BASE64      = 64,     //!< flag, write rawdata in Base64 by default. (consider using WRITE_BASE64)
         WRITE_BASE64 = BASE64 | WRITE, //!< flag, enable both WRITE and BASE64
+        LAZY        = 128,    //!< flag, map the file into memory and parse top-level nodes on the first access
+                              //!< (ignored for MEMORY and compressed storages)
     };
     enum
     {
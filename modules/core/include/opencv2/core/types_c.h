@@ -1672,6 +1672,7 @@ typedef struct CvFileStorage CvFileStorage;
 #define CV_STORAGE_FORMAT_JSON  24
 #define CV_STORAGE_BASE64       64
 #define CV_STORAGE_WRITE_BASE64  (CV_STORAGE_BASE64 | CV_STORAGE_WRITE)
+#define CV_STORAGE_LAZY        128
 
 /** @brief List of attributes. :
 
@@ -162,6 +162,26 @@ static bool ocl_binary_op(InputArray _src1, InputArray _src2, OutputArray _dst,
 
 #endif
 
+// applies the element-wise function to the stripes of the same-size arrays
+struct BinaryFuncStripes
+{
+    BinaryFuncStripes( BinaryFuncC _func, const Mat& _src1, const Mat& _src2, const Mat& _dst,
+                       int _widthScale, void* _usrdata )
+        : func(_func), src1(_src1), src2(_src2), dst(_dst), widthScale(_widthScale), usrdata(_usrdata) {}
+
+    void operator()( int, const Range& rows ) const
+    {
+        Mat s1 = src1.rowRange(rows), s2 = src2.rowRange(rows), d = dst.rowRange(rows);
+        Size sz = getContinuousSize(s1, s2, d, widthScale);
+        func(s1.ptr(), s1.step, s2.ptr(), s2.step, d.ptr(), d.step, sz.width, sz.height, usrdata);
+    }
+
+    BinaryFuncC func;
+    const Mat &src1, &src2, &dst;
+    int widthScale;
+    void* usrdata;
+};
+
 static void binary_op( InputArray _src1, InputArray _src2, OutputArray _dst,
                        InputArray _mask, const BinaryFuncC* tab,
                        bool bitwise, int oclop )
@@ -195,6 +215,13 @@ static void binary_op( InputArray _src1, InputArray _src2, OutputArray _dst,
             func = tab[depth1];
 
         Mat src1 = psrc1->getMat(), src2 = psrc2->getMat(), dst = _dst.getMat();
+        int nstripes = getParallelStripes(dst);
+        if( nstripes > 1 )
+        {
+            parallel_for_stripes(dst.rows, nstripes, BinaryFuncStripes(func, src1, src2, dst, cn, 0));
+            return;
+        }
+
         Size sz = getContinuousSize(src1, src2, dst);
         size_t len = sz.width*(size_t)cn;
         if( len == (size_t)(int)len )
@@ -595,144 +622,33 @@ static bool ocl_arithm_op(InputArray _src1, InputArray _src2, OutputArray _dst,
 
 #endif
 
-static void arithm_op(InputArray _src1, InputArray _src2, OutputArray _dst,
-                      InputArray _mask, int dtype, BinaryFuncC* tab, bool muldiv=false,
-                      void* usrdata=0, int oclop=-1 )
+// the generic part of arithm_op(): type conversions, masks and scalars
+struct ArithmOpBody
 {
-    const _InputArray *psrc1 = &_src1, *psrc2 = &_src2;
-    int kind1 = psrc1->kind(), kind2 = psrc2->kind();
-    bool haveMask = !_mask.empty();
-    bool reallocate = false;
-    int type1 = psrc1->type(), depth1 = CV_MAT_DEPTH(type1), cn = CV_MAT_CN(type1);
-    int type2 = psrc2->type(), depth2 = CV_MAT_DEPTH(type2), cn2 = CV_MAT_CN(type2);
-    int wtype, dims1 = psrc1->dims(), dims2 = psrc2->dims();
-    Size sz1 = dims1 <= 2 ? psrc1->size() : Size();
-    Size sz2 = dims2 <= 2 ? psrc2->size() : Size();
-#ifdef HAVE_OPENCL
-    bool use_opencl = OCL_PERFORMANCE_CHECK(_dst.isUMat()) && dims1 <= 2 && dims2 <= 2;
-#endif
-    bool src1Scalar = checkScalar(*psrc1, type2, kind1, kind2);
-    bool src2Scalar = checkScalar(*psrc2, type1, kind2, kind1);
-
-    if( (kind1 == kind2 || cn == 1) && sz1 == sz2 && dims1 <= 2 && dims2 <= 2 && type1 == type2 &&
-        !haveMask && ((!_dst.fixedType() && (dtype < 0 || CV_MAT_DEPTH(dtype) == depth1)) ||
-                       (_dst.fixedType() && _dst.type() == type1)) &&
-        ((src1Scalar && src2Scalar) || (!src1Scalar && !src2Scalar)) )
-    {
-        _dst.createSameSize(*psrc1, type1);
-        CV_OCL_RUN(use_opencl,
-            ocl_arithm_op(*psrc1, *psrc2, _dst, _mask,
-                          (!usrdata ? type1 : std::max(depth1, CV_32F)),
-                          usrdata, oclop, false))
-
-        Mat src1 = psrc1->getMat(), src2 = psrc2->getMat(), dst = _dst.getMat();
-        Size sz = getContinuousSize(src1, src2, dst, src1.channels());
-        tab[depth1](src1.ptr(), src1.step, src2.ptr(), src2.step, dst.ptr(), dst.step, sz.width, sz.height, usrdata);
-        return;
-    }
-
-    bool haveScalar = false, swapped12 = false;
-
-    if( dims1 != dims2 || sz1 != sz2 || cn != cn2 ||
-        (kind1 == _InputArray::MATX && (sz1 == Size(1,4) || sz1 == Size(1,1))) ||
-        (kind2 == _InputArray::MATX && (sz2 == Size(1,4) || sz2 == Size(1,1))) )
-    {
-        if( checkScalar(*psrc1, type2, kind1, kind2) )
-        {
-            // src1 is a scalar; swap it with src2
-            swap(psrc1, psrc2);
-            swap(sz1, sz2);
-            swap(type1, type2);
-            swap(depth1, depth2);
-            swap(cn, cn2);
-            swap(dims1, dims2);
-            swapped12 = true;
-            if( oclop == OCL_OP_SUB )
-                oclop = OCL_OP_RSUB;
-            if ( oclop == OCL_OP_DIV_SCALE )
-                oclop = OCL_OP_RDIV_SCALE;
-        }
-        else if( !checkScalar(*psrc2, type1, kind2, kind1) )
-            CV_Error( CV_StsUnmatchedSizes,
-                     "The operation is neither 'array op array' "
-                     "(where arrays have the same size and the same number of channels), "
-                     "nor 'array op scalar', nor 'scalar op array'" );
-        haveScalar = true;
-        CV_Assert(type2 == CV_64F && (sz2.height == 1 || sz2.height == 4));
-
-        if (!muldiv)
-        {
-            Mat sc = psrc2->getMat();
-            depth2 = actualScalarDepth(sc.ptr<double>(), sz2 == Size(1, 1) ? cn2 : cn);
-            if( depth2 == CV_64F && (depth1 < CV_32S || depth1 == CV_32F) )
-                depth2 = CV_32F;
-        }
-        else
-            depth2 = CV_64F;
-    }
-
-    if( dtype < 0 )
-    {
-        if( _dst.fixedType() )
-            dtype = _dst.type();
-        else
-        {
-            if( !haveScalar && type1 != type2 )
-                CV_Error(CV_StsBadArg,
-                     "When the input arrays in add/subtract/multiply/divide functions have different types, "
-                     "the output array type must be explicitly specified");
-            dtype = type1;
-        }
-    }
-    dtype = CV_MAT_DEPTH(dtype);
-
-    if( depth1 == depth2 && dtype == depth1 )
-        wtype = dtype;
-    else if( !muldiv )
+    void operator()( int, const Range& rows ) const
     {
-        wtype = depth1 <= CV_8S && depth2 <= CV_8S ? CV_16S :
-                depth1 <= CV_32S && depth2 <= CV_32S ? CV_32S : std::max(depth1, depth2);
-        wtype = std::max(wtype, dtype);
-
-        // when the result of addition should be converted to an integer type,
-        // and just one of the input arrays is floating-point, it makes sense to convert that input to integer type before the operation,
-        // instead of converting the other input to floating-point and then converting the operation result back to integers.
-        if( dtype < CV_32F && (depth1 < CV_32F || depth2 < CV_32F) )
-            wtype = CV_32S;
-    }
-    else
-    {
-        wtype = std::max(depth1, std::max(depth2, CV_32F));
-        wtype = std::max(wtype, dtype);
+        run(psrc1->rowRange(rows), haveScalar ? *psrc2 : psrc2->rowRange(rows),
+            pdst->rowRange(rows), pmask->empty() ? *pmask : pmask->rowRange(rows));
     }
 
-    dtype = CV_MAKETYPE(dtype, cn);
-    wtype = CV_MAKETYPE(wtype, cn);
+    void run( const Mat& src1, const Mat& src2, const Mat& dst, const Mat& mask ) const;
 
-    if( haveMask )
-    {
-        int mtype = _mask.type();
-        CV_Assert( (mtype == CV_8UC1 || mtype == CV_8SC1) && _mask.sameSize(*psrc1) );
-        reallocate = !_dst.sameSize(*psrc1) || _dst.type() != dtype;
-    }
-
-    _dst.createSameSize(*psrc1, dtype);
-    if( reallocate )
-        _dst.setTo(0.);
-
-    CV_OCL_RUN(use_opencl,
-               ocl_arithm_op(*psrc1, *psrc2, _dst, _mask, wtype,
-               usrdata, oclop, haveScalar))
-
-    BinaryFunc cvtsrc1 = type1 == wtype ? 0 : getConvertFunc(type1, wtype);
-    BinaryFunc cvtsrc2 = type2 == type1 ? cvtsrc1 : type2 == wtype ? 0 : getConvertFunc(type2, wtype);
-    BinaryFunc cvtdst = dtype == wtype ? 0 : getConvertFunc(wtype, dtype);
+    BinaryFuncC func;
+    BinaryFunc cvtsrc1, cvtsrc2, cvtdst;
+    int wtype;
+    size_t esz1, esz2, dsz;
+    bool haveScalar, swapped12;
+    void* usrdata;
+    const Mat *psrc1, *psrc2, *pdst, *pmask;
+};
 
-    size_t esz1 = CV_ELEM_SIZE(type1), esz2 = CV_ELEM_SIZE(type2);
-    size_t dsz = CV_ELEM_SIZE(dtype), wsz = CV_ELEM_SIZE(wtype);
+void ArithmOpBody::run( const Mat& src1, const Mat& src2, const Mat& dst, const Mat& mask ) const
+{
+    bool haveMask = !mask.empty();
+    int cn = CV_MAT_CN(wtype);
+    size_t wsz = CV_ELEM_SIZE(wtype);
     size_t blocksize0 = (size_t)(BLOCK_SIZE + wsz-1)/wsz;
     BinaryFunc copymask = getCopyMaskFunc(dsz);
-    Mat src1 = psrc1->getMat(), src2 = psrc2->getMat(), dst = _dst.getMat(), mask = _mask.getMat();
 
     AutoBuffer<uchar> _buf;
     uchar *buf, *maskbuf = 0, *buf1 = 0, *buf2 = 0, *wbuf = 0;
@@ -740,7 +656,6 @@ static void arithm_op(InputArray _src1, InputArray _src2, OutputArray _dst,
                     (cvtsrc2 || haveScalar ? wsz : 0) +
                     (cvtdst ? wsz : 0) +
                     (haveMask ? dsz : 0);
-    BinaryFuncC func = tab[CV_MAT_DEPTH(wtype)];
 
     if( !haveScalar )
     {
@@ -795,13 +710,13 @@ static void arithm_op(InputArray _src1, InputArray _src2, OutputArray _dst,
                         cvtdst( wbuf, 1, 0, 1, dptr, 1, bszn, 0 );
                     else if( !cvtdst )
                     {
-                        copymask( wbuf, 1, ptrs[3], 1, dptr, 1, Size(bsz, 1), &dsz );
+                        copymask( wbuf, 1, ptrs[3], 1, dptr, 1, Size(bsz, 1), (void*)&dsz );
                         ptrs[3] += bsz;
                     }
                     else
                     {
                         cvtdst( wbuf, 1, 0, 1, maskbuf, 1, bszn, 0 );
-                        copymask( maskbuf, 1, ptrs[3], 1, dptr, 1, Size(bsz, 1), &dsz );
+                        copymask( maskbuf, 1, ptrs[3], 1, dptr, 1, Size(bsz, 1), (void*)&dsz );
                         ptrs[3] += bsz;
                     }
                 }
@@ -858,13 +773,13 @@ static void arithm_op(InputArray _src1, InputArray _src2, OutputArray _dst,
                         cvtdst( wbuf, 1, 0, 1, dptr, 1, bszn, 0 );
                     else if( !cvtdst )
                     {
-                        copymask( wbuf, 1, ptrs[2], 1, dptr, 1, Size(bsz, 1), &dsz );
+                        copymask( wbuf, 1, ptrs[2], 1, dptr, 1, Size(bsz, 1), (void*)&dsz );
                         ptrs[2] += bsz;
                     }
                     else
                     {
                         cvtdst( wbuf, 1, 0, 1, maskbuf, 1, bszn, 0 );
-                        copymask( maskbuf, 1, ptrs[2], 1, dptr, 1, Size(bsz, 1), &dsz );
+                        copymask( maskbuf, 1, ptrs[2], 1, dptr, 1, Size(bsz, 1), (void*)&dsz );
                         ptrs[2] += bsz;
                     }
                 }
@@ -874,6 +789,167 @@ static void arithm_op(InputArray _src1, InputArray _src2, OutputArray _dst,
     }
 }
 
+static void arithm_op(InputArray _src1, InputArray _src2, OutputArray _dst,
+                      InputArray _mask, int dtype, BinaryFuncC* tab, bool muldiv=false,
+                      void* usrdata=0, int oclop=-1 )
+{
+    const _InputArray *psrc1 = &_src1, *psrc2 = &_src2;
+    int kind1 = psrc1->kind(), kind2 = psrc2->kind();
+    bool haveMask = !_mask.empty();
+    bool reallocate = false;
+    int type1 = psrc1->type(), depth1 = CV_MAT_DEPTH(type1), cn = CV_MAT_CN(type1);
+    int type2 = psrc2->type(), depth2 = CV_MAT_DEPTH(type2), cn2 = CV_MAT_CN(type2);
+    int wtype, dims1 = psrc1->dims(), dims2 = psrc2->dims();
+    Size sz1 = dims1 <= 2 ? psrc1->size() : Size();
+    Size sz2 = dims2 <= 2 ? psrc2->size() : Size();
+#ifdef HAVE_OPENCL
+    bool use_opencl = OCL_PERFORMANCE_CHECK(_dst.isUMat()) && dims1 <= 2 && dims2 <= 2;
+#endif
+    bool src1Scalar = checkScalar(*psrc1, type2, kind1, kind2);
+    bool src2Scalar = checkScalar(*psrc2, type1, kind2, kind1);
+
+    if( (kind1 == kind2 || cn == 1) && sz1 == sz2 && dims1 <= 2 && dims2 <= 2 && type1 == type2 &&
+        !haveMask && ((!_dst.fixedType() && (dtype < 0 || CV_MAT_DEPTH(dtype) == depth1)) ||
+                       (_dst.fixedType() && _dst.type() == type1)) &&
+        ((src1Scalar && src2Scalar) || (!src1Scalar && !src2Scalar)) )
+    {
+        _dst.createSameSize(*psrc1, type1);
+        CV_OCL_RUN(use_opencl,
+            ocl_arithm_op(*psrc1, *psrc2, _dst, _mask,
+                          (!usrdata ? type1 : std::max(depth1, CV_32F)),
+                          usrdata, oclop, false))
+
+        Mat src1 = psrc1->getMat(), src2 = psrc2->getMat(), dst = _dst.getMat();
+        int nstripes = getParallelStripes(dst);
+        if( nstripes > 1 )
+        {
+            parallel_for_stripes(dst.rows, nstripes,
+                                 BinaryFuncStripes(tab[depth1], src1, src2, dst, src1.channels(), usrdata));
+            return;
+        }
+
+        Size sz = getContinuousSize(src1, src2, dst, src1.channels());
+        tab[depth1](src1.ptr(), src1.step, src2.ptr(), src2.step, dst.ptr(), dst.step, sz.width, sz.height, usrdata);
+        return;
+    }
+
+    bool haveScalar = false, swapped12 = false;
+
+    if( dims1 != dims2 || sz1 != sz2 || cn != cn2 ||
+        (kind1 == _InputArray::MATX && (sz1 == Size(1,4) || sz1 == Size(1,1))) ||
+        (kind2 == _InputArray::MATX && (sz2 == Size(1,4) || sz2 == Size(1,1))) )
+    {
+        if( checkScalar(*psrc1, type2, kind1, kind2) )
+        {
+            // src1 is a scalar; swap it with src2
+            swap(psrc1, psrc2);
+            swap(sz1, sz2);
+            swap(type1, type2);
+            swap(depth1, depth2);
+            swap(cn, cn2);
+            swap(dims1, dims2);
+            swapped12 = true;
+            if( oclop == OCL_OP_SUB )
+                oclop = OCL_OP_RSUB;
+            if ( oclop == OCL_OP_DIV_SCALE )
+                oclop = OCL_OP_RDIV_SCALE;
+        }
+        else if( !checkScalar(*psrc2, type1, kind2, kind1) )
+            CV_Error( CV_StsUnmatchedSizes,
+                     "The operation is neither 'array op array' "
+                     "(where arrays have the same size and the same number of channels), "
+                     "nor 'array op scalar', nor 'scalar op array'" );
+        haveScalar = true;
+        CV_Assert(type2 == CV_64F && (sz2.height == 1 || sz2.height == 4));
+
+        if (!muldiv)
+        {
+            Mat sc = psrc2->getMat();
+            depth2 = actualScalarDepth(sc.ptr<double>(), sz2 == Size(1, 1) ? cn2 : cn);
+            if( depth2 == CV_64F && (depth1 < CV_32S || depth1 == CV_32F) )
+                depth2 = CV_32F;
+        }
+        else
+            depth2 = CV_64F;
+    }
+
+    if( dtype < 0 )
+    {
+        if( _dst.fixedType() )
+            dtype = _dst.type();
+        else
+        {
+            if( !haveScalar && type1 != type2 )
+                CV_Error(CV_StsBadArg,
+                     "When the input arrays in add/subtract/multiply/divide functions have different types, "
+                     "the output array type must be explicitly specified");
+            dtype = type1;
+        }
+    }
+    dtype = CV_MAT_DEPTH(dtype);
+
+    if( depth1 == depth2 && dtype == depth1 )
+        wtype = dtype;
+    else if( !muldiv )
+    {
+        wtype = depth1 <= CV_8S && depth2 <= CV_8S ? CV_16S :
+                depth1 <= CV_32S && depth2 <= CV_32S ? CV_32S : std::max(depth1, depth2);
+        wtype = std::max(wtype, dtype);
+
+        // when the result of addition should be converted to an integer type,
+        // and just one of the input arrays is floating-point, it makes sense to convert that input to integer type before the operation,
+        // instead of converting the other input to floating-point and then converting the operation result back to integers.
+        if( dtype < CV_32F && (depth1 < CV_32F || depth2 < CV_32F) )
+            wtype = CV_32S;
+    }
+    else
+    {
+        wtype = std::max(depth1, std::max(depth2, CV_32F));
+        wtype = std::max(wtype, dtype);
+    }
+
+    dtype = CV_MAKETYPE(dtype, cn);
+    wtype = CV_MAKETYPE(wtype, cn);
+
+    if( haveMask )
+    {
+        int mtype = _mask.type();
+        CV_Assert( (mtype == CV_8UC1 || mtype == CV_8SC1) && _mask.sameSize(*psrc1) );
+        reallocate = !_dst.sameSize(*psrc1) || _dst.type() != dtype;
+    }
+
+    _dst.createSameSize(*psrc1, dtype);
+    if( reallocate )
+        _dst.setTo(0.);
+
+    CV_OCL_RUN(use_opencl,
+               ocl_arithm_op(*psrc1, *psrc2, _dst, _mask, wtype,
+               usrdata, oclop, haveScalar))
+
+    ArithmOpBody body;
+    body.func = tab[CV_MAT_DEPTH(wtype)];
+    body.cvtsrc1 = type1 == wtype ? 0 : getConvertFunc(type1, wtype);
+    body.cvtsrc2 = type2 == type1 ? body.cvtsrc1 : type2 == wtype ? 0 : getConvertFunc(type2, wtype);
+    body.cvtdst = dtype == wtype ? 0 : getConvertFunc(wtype, dtype);
+    body.wtype = wtype;
+    body.esz1 = CV_ELEM_SIZE(type1);
+    body.esz2 = CV_ELEM_SIZE(type2);
+    body.dsz = CV_ELEM_SIZE(dtype);
+    body.haveScalar = haveScalar;
+    body.swapped12 = swapped12;
+    body.usrdata = usrdata;
+
+    Mat src1 = psrc1->getMat(), src2 = psrc2->getMat(), dst = _dst.getMat(), mask = _mask.getMat();
+    int nstripes = getParallelStripes(dst);
+    if( nstripes > 1 )
+    {
+        body.psrc1 = &src1; body.psrc2 = &src2; body.pdst = &dst; body.pmask = &mask;
+        parallel_for_stripes(dst.rows, nstripes, body);
+    }
+    else
+        body.run(src1, src2, dst, mask);
+}
+
 static BinaryFuncC* getAddTab()
 {
     static BinaryFuncC addTab[] =
@@ -1300,6 +1300,28 @@ static bool ipp_convertTo(Mat &src, Mat &dst, double alpha, double beta)
 #endif
 
 
+namespace cv
+{
+
+struct ConvertStripes
+{
+    ConvertStripes( BinaryFunc _func, const Mat& _src, const Mat& _dst, double* _scale )
+        : func(_func), src(_src), dst(_dst), scale(_scale) {}
+
+    void operator()( int, const Range& rows ) const
+    {
+        Mat s = src.rowRange(rows), d = dst.rowRange(rows);
+        Size sz = getContinuousSize(s, d, s.channels());
+        func(s.ptr(), s.step, 0, 0, d.ptr(), d.step, sz, scale);
+    }
+
+    BinaryFunc func;
+    const Mat &src, &dst;
+    double* scale;
+};
+
+}
+
 void cv::Mat::convertTo(OutputArray _dst, int _type, double alpha, double beta) const
 {
     CV_INSTRUMENT_REGION()
@@ -1332,7 +1354,12 @@ void cv::Mat::convertTo(OutputArray _dst, int _type, double alpha, double beta)
     int cn = channels();
     CV_Assert( func != 0 );
 
-    if( dims <= 2 )
+    int nstripes = std::max(getParallelStripes(src), getParallelStripes(dst));
+    if( nstripes > 1 )
+    {
+        parallel_for_stripes(src.rows, nstripes, ConvertStripes(func, src, dst, scale));
+    }
+    else if( dims <= 2 )
     {
         Size sz = getContinuousSize(src, dst, cn);
 
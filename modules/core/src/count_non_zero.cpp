@@ -354,6 +354,24 @@ static bool ipp_countNonZero( Mat &src, int &res )
 
 } // cv::
 
+namespace cv
+{
+
+struct CountNonZeroStripes
+{
+    CountNonZeroStripes( const Mat& _src, int* _partial ) : src(_src), partial(_partial) {}
+
+    void operator()( int i, const Range& rows ) const
+    {
+        partial[i] = countNonZero(src.rowRange(rows));
+    }
+
+    const Mat& src;
+    int* partial;
+};
+
+}
+
 int cv::countNonZero( InputArray _src )
 {
     CV_INSTRUMENT_REGION()
@@ -377,6 +395,18 @@ int cv::countNonZero( InputArray _src )
     CountNonZeroFunc func = getCountNonZeroTab(src.depth());
     CV_Assert( func != 0 );
 
+    int nstripes = getParallelStripes(src);
+    if( nstripes > 1 )
+    {
+        std::vector<int> partial(nstripes);
+        parallel_for_stripes(src.rows, nstripes, CountNonZeroStripes(src, &partial[0]));
+
+        int nz = 0;
+        for( int i = 0; i < nstripes; i++ )
+            nz += partial[i];
+        return nz;
+    }
+
     const Mat* arrays[] = {&src, 0};
     uchar* ptrs[1];
     NAryMatIterator it(arrays, ptrs);
@@ -45,6 +45,9 @@
 #include "opencl_kernels_core.hpp"
 #include <map>
 
+#include "dxt.simd.hpp"
+#include "dxt.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX2,...,BASELINE based on CMakeLists.txt content
+
 namespace cv
 {
 
@@ -465,6 +468,18 @@ template<> struct DFT_VecR4<float>
 
 #endif
 
+// dispatched radix-4/radix-2 passes; return the size of the transforms done so far
+static int DFT_R24(Complexf* dst, int N, int n0, int& dw0, const Complexf* wave)
+{
+    CV_CPU_DISPATCH(dftRadix24_32f, (dst, N, n0, dw0, wave),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+static int DFT_R24(Complexd*, int, int, int&, const Complexd*)
+{
+    return 1;
+}
+
 #ifdef USE_IPP_DFT
 static IppStatus ippsDFTFwd_CToC( const Complex<float>* src, Complex<float>* dst,
                              const void* spec, uchar* buf)
@@ -707,7 +722,10 @@ DFT(const OcvDftOptions & c, const Complex<T>* src, Complex<T>* dst)
     // 1. power-2 transforms
     if( (c.factors[0] & 1) == 0 )
     {
-        if( c.factors[0] >= 4 && c.haveSSE3)
+        if( c.factors[0] >= 4 )
+            n = DFT_R24(dst, c.factors[0], c.n, dw0, wave);
+
+        if( n == 1 && c.factors[0] >= 4 && c.haveSSE3)
         {
             DFT_VecR4<T> vr4;
             n = vr4(dst, c.factors[0], c.n, dw0, wave);
@@ -1090,11 +1108,15 @@ RealDFT(const OcvDftOptions & c, const T* src, T* dst)
         T scale2 = scale*(T)0.5;
         int n2 = n >> 1;
 
-        c.factors[0] >>= 1;
+        // the factors may be shared with other transforms (and threads),
+        // so the half-length transform gets its own copy
+        int sub_factors[34];
+        memcpy( sub_factors, c.factors, c.nf*sizeof(sub_factors[0]) );
+        sub_factors[0] >>= 1;
 
         OcvDftOptions sub_c = c;
-        sub_c.factors += (c.factors[0] == 1);
-        sub_c.nf -= (c.factors[0] == 1);
+        sub_c.factors = sub_factors + (sub_factors[0] == 1);
+        sub_c.nf -= (sub_factors[0] == 1);
         sub_c.isComplex = false;
         sub_c.isInverse = false;
         sub_c.noPermute = false;
@@ -1103,8 +1125,6 @@ RealDFT(const OcvDftOptions & c, const T* src, T* dst)
 
         DFT(sub_c, (Complex<T>*)src, (Complex<T>*)dst);
 
-        c.factors[0] <<= 1;
-
         t = dst[0] - dst[1];
         dst[0] = (dst[0] + dst[1])*scale;
         dst[1] = t*scale;
@@ -1305,11 +1325,15 @@ CCSIDFT(const OcvDftOptions & c, const T* src, T* dst)
             }
         }
 
-        c.factors[0] >>= 1;
+        // the factors may be shared with other transforms (and threads),
+        // so the half-length transform gets its own copy
+        int sub_factors[34];
+        memcpy( sub_factors, c.factors, c.nf*sizeof(sub_factors[0]) );
+        sub_factors[0] >>= 1;
 
         OcvDftOptions sub_c = c;
-        sub_c.factors += (c.factors[0] == 1);
-        sub_c.nf -= (c.factors[0] == 1);
+        sub_c.factors = sub_factors + (sub_factors[0] == 1);
+        sub_c.nf -= (sub_factors[0] == 1);
         sub_c.isComplex = false;
         sub_c.isInverse = false;
         sub_c.noPermute = !inplace;
@@ -1318,8 +1342,6 @@ CCSIDFT(const OcvDftOptions & c, const T* src, T* dst)
 
         DFT(sub_c, (Complex<T>*)dst, (Complex<T>*)dst);
 
-        c.factors[0] <<= 1;
-
         for( j = 0; j < n; j += 2 )
         {
             t0 = dst[j]*scale;
@@ -1369,98 +1391,6 @@ CopyColumn( const uchar* _src, size_t src_step,
 }
 
 
-static void
-CopyFrom2Columns( const uchar* _src, size_t src_step,
-                  uchar* _dst0, uchar* _dst1,
-                  int len, size_t elem_size )
-{
-    int i, t0, t1;
-    const int* src = (const int*)_src;
-    int* dst0 = (int*)_dst0;
-    int* dst1 = (int*)_dst1;
-    src_step /= sizeof(src[0]);
-
-    if( elem_size == sizeof(int) )
-    {
-        for( i = 0; i < len; i++, src += src_step )
-        {
-            t0 = src[0]; t1 = src[1];
-            dst0[i] = t0; dst1[i] = t1;
-        }
-    }
-    else if( elem_size == sizeof(int)*2 )
-    {
-        for( i = 0; i < len*2; i += 2, src += src_step )
-        {
-            t0 = src[0]; t1 = src[1];
-            dst0[i] = t0; dst0[i+1] = t1;
-            t0 = src[2]; t1 = src[3];
-            dst1[i] = t0; dst1[i+1] = t1;
-        }
-    }
-    else if( elem_size == sizeof(int)*4 )
-    {
-        for( i = 0; i < len*4; i += 4, src += src_step )
-        {
-            t0 = src[0]; t1 = src[1];
-            dst0[i] = t0; dst0[i+1] = t1;
-            t0 = src[2]; t1 = src[3];
-            dst0[i+2] = t0; dst0[i+3] = t1;
-            t0 = src[4]; t1 = src[5];
-            dst1[i] = t0; dst1[i+1] = t1;
-            t0 = src[6]; t1 = src[7];
-            dst1[i+2] = t0; dst1[i+3] = t1;
-        }
-    }
-}
-
-
-static void
-CopyTo2Columns( const uchar* _src0, const uchar* _src1,
-                uchar* _dst, size_t dst_step,
-                int len, size_t elem_size )
-{
-    int i, t0, t1;
-    const int* src0 = (const int*)_src0;
-    const int* src1 = (const int*)_src1;
-    int* dst = (int*)_dst;
-    dst_step /= sizeof(dst[0]);
-
-    if( elem_size == sizeof(int) )
-    {
-        for( i = 0; i < len; i++, dst += dst_step )
-        {
-            t0 = src0[i]; t1 = src1[i];
-            dst[0] = t0; dst[1] = t1;
-        }
-    }
-    else if( elem_size == sizeof(int)*2 )
-    {
-        for( i = 0; i < len*2; i += 2, dst += dst_step )
-        {
-            t0 = src0[i]; t1 = src0[i+1];
-            dst[0] = t0; dst[1] = t1;
-            t0 = src1[i]; t1 = src1[i+1];
-            dst[2] = t0; dst[3] = t1;
-        }
-    }
-    else if( elem_size == sizeof(int)*4 )
-    {
-        for( i = 0; i < len*4; i += 4, dst += dst_step )
-        {
-            t0 = src0[i]; t1 = src0[i+1];
-            dst[0] = t0; dst[1] = t1;
-            t0 = src0[i+2]; t1 = src0[i+3];
-            dst[2] = t0; dst[3] = t1;
-            t0 = src1[i]; t1 = src1[i+1];
-            dst[4] = t0; dst[5] = t1;
-            t0 = src1[i+2]; t1 = src1[i+3];
-            dst[6] = t0; dst[7] = t1;
-        }
-    }
-}
-
-
 static void
 ExpandCCS( uchar* _ptr, int n, int elem_size )
 {
@@ -1503,6 +1433,57 @@ ExpandCCS( uchar* _ptr, int n, int elem_size )
     }
 }
 
+// gathers ncols adjacent columns into ncols contiguous vectors of len elements;
+// the source is read row by row, which is much friendlier to the cache
+// than copying the columns one by one
+template<typename T> static void
+CopyFromNColumns_( const uchar* _src, size_t src_step, T* dst, int len, int ncols )
+{
+    for( int i = 0; i < len; i++, _src += src_step )
+    {
+        const T* src = (const T*)_src;
+        for( int k = 0; k < ncols; k++ )
+            dst[k*len + i] = src[k];
+    }
+}
+
+template<typename T> static void
+CopyToNColumns_( const T* src, uchar* _dst, size_t dst_step, int len, int ncols )
+{
+    for( int i = 0; i < len; i++, _dst += dst_step )
+    {
+        T* dst = (T*)_dst;
+        for( int k = 0; k < ncols; k++ )
+            dst[k] = src[k*len + i];
+    }
+}
+
+static void
+CopyFromNColumns( const uchar* src, size_t src_step, uchar* dst,
+                  int len, int ncols, size_t elem_size )
+{
+    if( elem_size == sizeof(Complexf) )
+        CopyFromNColumns_( src, src_step, (Complexf*)dst, len, ncols );
+    else
+    {
+        assert( elem_size == sizeof(Complexd) );
+        CopyFromNColumns_( src, src_step, (Complexd*)dst, len, ncols );
+    }
+}
+
+static void
+CopyToNColumns( const uchar* src, uchar* dst, size_t dst_step,
+                int len, int ncols, size_t elem_size )
+{
+    if( elem_size == sizeof(Complexf) )
+        CopyToNColumns_( (const Complexf*)src, dst, dst_step, len, ncols );
+    else
+    {
+        assert( elem_size == sizeof(Complexd) );
+        CopyToNColumns_( (const Complexd*)src, dst, dst_step, len, ncols );
+    }
+}
+
 static void DFT_32f(const OcvDftOptions & c, const Complexf* src, Complexf* dst)
 {
     DFT(c, src, dst);
@@ -2607,6 +2588,99 @@ inline DftDims determineDims(int rows, int cols, bool isRowWise, bool isContinuo
     return InvalidDim;
 }
 
+static void DCTInit( int n, int elem_size, void* _wave, int inv );
+
+// factorization, twiddle factors and permutation table for a single transform length.
+// A plan is never modified after it has been built, so the same plan may be used
+// by several transforms (and threads) at once.
+struct OcvDftPlan
+{
+    int n;
+    int nf;
+    int factors[34];
+    AutoBuffer<uchar> wave;
+    AutoBuffer<int> itab;
+    AutoBuffer<uchar> dct_wave;
+
+    OcvDftPlan(int _n, int depth, bool inv_itab, bool dct)
+    {
+        int complex_elem_size = depth == CV_32F ? sizeof(Complexf) : sizeof(Complexd);
+        n = _n;
+        nf = DFTFactorize( n, factors );
+        wave.allocate(n*complex_elem_size);
+        itab.allocate(n);
+        DFTInit( n, nf, factors, itab, complex_elem_size, wave, inv_itab );
+        if( dct )
+        {
+            dct_wave.allocate((n/2 + 1)*complex_elem_size);
+            DCTInit( n, complex_elem_size, dct_wave, inv_itab );
+        }
+    }
+
+    size_t footprint() const
+    {
+        return wave.size() + itab.size()*sizeof(int) + dct_wave.size();
+    }
+};
+
+// Repeated transforms of the same size (frame-by-frame processing, tiled correlation)
+// would otherwise recompute the tables on every call.
+class OcvDftPlanCache
+{
+public:
+    enum { MAX_CACHE_SIZE = 1 << 24 };
+
+    static OcvDftPlanCache & getInstance()
+    {
+        CV_SINGLETON_LAZY_INIT_REF(OcvDftPlanCache, new OcvDftPlanCache())
+    }
+
+    Ptr<OcvDftPlan> getPlan(int n, int depth, bool inv_itab, bool dct)
+    {
+        int64 key = ((int64)n << 3) | (depth == CV_64F ? 4 : 0) | (inv_itab ? 2 : 0) | (dct ? 1 : 0);
+        {
+            AutoLock lock(mutex);
+            std::map<int64, Ptr<OcvDftPlan> >::iterator f = planStorage.find(key);
+            if (f != planStorage.end())
+                return f->second;
+        }
+
+        // build the plan without holding the lock, it may take a while for large n
+        Ptr<OcvDftPlan> newPlan = makePtr<OcvDftPlan>(n, depth, inv_itab, dct);
+        size_t planSize = newPlan->footprint();
+        if (planSize <= (size_t)MAX_CACHE_SIZE)
+        {
+            AutoLock lock(mutex);
+            if (totalSize + planSize > (size_t)MAX_CACHE_SIZE)
+            {
+                planStorage.clear();
+                totalSize = 0;
+            }
+            if (planStorage.insert(std::make_pair(key, newPlan)).second)
+                totalSize += planSize;
+        }
+        return newPlan;
+    }
+
+    ~OcvDftPlanCache()
+    {
+        planStorage.clear();
+    }
+
+protected:
+    OcvDftPlanCache() :
+        planStorage(), totalSize(0)
+    {
+    }
+    Mutex mutex;
+    std::map<int64, Ptr<OcvDftPlan> > planStorage;
+    size_t totalSize;
+};
+
+// the HAL replacements and IPP-based 1D transforms may keep per-call state,
+// so only our own implementation is applied to several rows/columns in parallel
+static bool isReentrantDft(const Ptr<hal::DFT1D>& c);
+
 class OcvDftImpl : public hal::DFT2D
 {
 protected:
@@ -2629,8 +2703,9 @@ protected:
     bool useIpp;
     int src_channels;
     int dst_channels;
+    bool parallelA;
+    bool parallelB;
 
-    AutoBuffer<uchar> tmp_bufA;
     AutoBuffer<uchar> tmp_bufB;
     AutoBuffer<uchar> buf0;
     AutoBuffer<uchar> buf1;
@@ -2654,6 +2729,8 @@ public:
         useIpp = false;
         src_channels = 0;
         dst_channels = 0;
+        parallelA = false;
+        parallelB = false;
     }
 
     void init(int _width, int _height, int _depth, int _src_channels, int _dst_channels, int flags, int _nonzero_rows)
@@ -2760,8 +2837,7 @@ public:
                 }
                 needBufferA = isInplace;
                 contextA = hal::DFT1D::create(len, count, depth, f, &needBufferA);
-                if (needBufferA)
-                    tmp_bufA.allocate(len * complex_elem_size);
+                parallelA = isReentrantDft(contextA);
             }
             else
             {
@@ -2770,6 +2846,7 @@ public:
                 f |= CV_HAL_DFT_STAGE_COLS;
                 needBufferB = isInplace;
                 contextB = hal::DFT1D::create(len, count, depth, f, &needBufferB);
+                parallelB = isReentrantDft(contextB);
                 if (needBufferB)
                     tmp_bufB.allocate(len * complex_elem_size);
 
@@ -2858,6 +2935,88 @@ public:
 
 protected:
 
+    enum { DFT_PARALLEL_MIN_SIZE = 1 << 15, DFT_PARALLEL_STRIPE_SIZE = 1 << 14, DFT_COL_BLOCK_SIZE = 128 };
+
+    class RowsInvoker : public ParallelLoopBody
+    {
+    public:
+        RowsInvoker(const OcvDftImpl* _impl, const uchar* _src, size_t _src_step,
+                    uchar* _dst, size_t _dst_step, int _len, int _dptr_offset, int _dst_full_len) :
+            impl(_impl), src(_src), src_step(_src_step), dst(_dst), dst_step(_dst_step),
+            len(_len), dptr_offset(_dptr_offset), dst_full_len(_dst_full_len)
+        {
+        }
+
+        void operator()(const Range& range) const
+        {
+            AutoBuffer<uchar> buf;
+            if( impl->needBufferA )
+                buf.allocate(len * impl->complex_elem_size);
+
+            for( int i = range.start; i < range.end; i++ )
+            {
+                const uchar* sptr = src + src_step * i;
+                uchar* dptr0 = dst + dst_step * i;
+                uchar* dptr = impl->needBufferA ? (uchar*)buf : dptr0;
+
+                impl->contextA->apply(sptr, dptr);
+
+                if( impl->needBufferA )
+                    memcpy( dptr0, dptr + dptr_offset, dst_full_len );
+            }
+        }
+
+    private:
+        const OcvDftImpl* impl;
+        const uchar* src;
+        size_t src_step;
+        uchar* dst;
+        size_t dst_step;
+        int len;
+        int dptr_offset;
+        int dst_full_len;
+    };
+
+    class ColsInvoker : public ParallelLoopBody
+    {
+    public:
+        ColsInvoker(const OcvDftImpl* _impl, const uchar* _src, size_t _src_step,
+                    uchar* _dst, size_t _dst_step, int _ncols, int _blockCols) :
+            impl(_impl), src(_src), src_step(_src_step), dst(_dst), dst_step(_dst_step),
+            ncols(_ncols), blockCols(_blockCols)
+        {
+        }
+
+        void operator()(const Range& range) const
+        {
+            int len = impl->height;
+            size_t esz = impl->complex_elem_size;
+            size_t bufsize = len*esz*blockCols;
+            AutoBuffer<uchar> buf(impl->needBufferB ? bufsize*2 : bufsize);
+            uchar* ibuf = buf;
+            uchar* obuf = impl->needBufferB ? ibuf + bufsize : ibuf;
+
+            for( int blk = range.start; blk < range.end; blk++ )
+            {
+                int c0 = blk*blockCols, nc = std::min(blockCols, ncols - c0);
+
+                CopyFromNColumns( src + c0*esz, src_step, ibuf, len, nc, esz );
+                for( int k = 0; k < nc; k++ )
+                    impl->contextB->apply(ibuf + k*len*esz, obuf + k*len*esz);
+                CopyToNColumns( obuf, dst + c0*esz, dst_step, len, nc, esz );
+            }
+        }
+
+    private:
+        const OcvDftImpl* impl;
+        const uchar* src;
+        size_t src_step;
+        uchar* dst;
+        size_t dst_step;
+        int ncols;
+        int blockCols;
+    };
+
     void rowDft(const uchar* src_data, size_t src_step, uchar* dst_data, size_t dst_step, bool isComplex, bool isLastStage)
     {
         int len, count;
@@ -2887,23 +3046,13 @@ protected:
         if( nz <= 0 || nz > count )
             nz = count;
 
-        int i;
-        for( i = 0; i < nz; i++ )
-        {
-            const uchar* sptr = src_data + src_step * i;
-            uchar* dptr0 = dst_data + dst_step * i;
-            uchar* dptr = dptr0;
-
-            if( needBufferA )
-                dptr = tmp_bufA;
-
-            contextA->apply(sptr, dptr);
-
-            if( needBufferA )
-                memcpy( dptr0, dptr + dptr_offset, dst_full_len );
-        }
+        RowsInvoker body(this, src_data, src_step, dst_data, dst_step, len, dptr_offset, dst_full_len);
+        if( parallelA && nz > 1 && (double)nz*len >= DFT_PARALLEL_MIN_SIZE )
+            parallel_for_(Range(0, nz), body, (double)nz*len/DFT_PARALLEL_STRIPE_SIZE);
+        else
+            body(Range(0, nz));
 
-        for( ; i < count; i++ )
+        for( int i = nz; i < count; i++ )
         {
             uchar* dptr0 = dst_data + dst_step * i;
             memset( dptr0, 0, dst_full_len );
@@ -3015,25 +3164,18 @@ protected:
             }
         }
 
-        for(int i = a; i < b; i += 2 )
-        {
-            if( i+1 < b )
-            {
-                CopyFrom2Columns( sptr0, src_step, buf0, buf1, len, complex_elem_size );
-                contextB->apply(buf1, dbuf1);
-            }
-            else
-                CopyColumn( sptr0, src_step, buf0, complex_elem_size, len, complex_elem_size );
-
-            contextB->apply(buf0, dbuf0);
+        // the remaining columns are complex; they are transformed in blocks
+        // of adjacent columns, each block being gathered into and scattered
+        // from contiguous buffers row by row
+        int ncols = b - a;
+        int blockCols = std::max(DFT_COL_BLOCK_SIZE / complex_elem_size, 2);
+        int nblocks = (ncols + blockCols - 1) / blockCols;
+        ColsInvoker body(this, sptr0, src_step, dptr0, dst_step, ncols, blockCols);
+        if( parallelB && nblocks > 1 && (double)ncols*len >= DFT_PARALLEL_MIN_SIZE )
+            parallel_for_(Range(0, nblocks), body);
+        else
+            body(Range(0, nblocks));
 
-            if( i+1 < b )
-                CopyTo2Columns( dbuf0, dbuf1, dptr0, dst_step, len, complex_elem_size );
-            else
-                CopyColumn( dbuf0, complex_elem_size, dptr0, dst_step, len, complex_elem_size );
-            sptr0 += 2*complex_elem_size;
-            dptr0 += 2*complex_elem_size;
-        }
         if(isLastStage && mode == FwdRealToComplex)
             complementComplexOutput(depth, dst_data, dst_step, count, len, 2);
     }
@@ -3043,9 +3185,7 @@ class OcvDftBasicImpl : public hal::DFT1D
 {
 public:
     OcvDftOptions opt;
-    int _factors[34];
-    AutoBuffer<uchar> wave_buf;
-    AutoBuffer<int> itab_buf;
+    Ptr<OcvDftPlan> plan;
 #ifdef USE_IPP_DFT
     AutoBuffer<uchar> ippbuf;
     AutoBuffer<uchar> ippworkbuf;
@@ -3054,14 +3194,10 @@ public:
 public:
     OcvDftBasicImpl()
     {
-        opt.factors = _factors;
     }
     void init(int len, int count, int depth, int flags, bool *needBuffer)
     {
-        int prev_len = opt.n;
-
         int stage = (flags & CV_HAL_DFT_STAGE_COLS) != 0 ? 1 : 0;
-        int complex_elem_size = depth == CV_32F ? sizeof(Complex<float>) : sizeof(Complex<double>);
         opt.isInverse = (flags & CV_HAL_DFT_INVERSE) != 0;
         bool real_transform = (flags & CV_HAL_DFT_REAL_OUTPUT) != 0;
         opt.isComplex = (stage == 0) && (flags & CV_HAL_DFT_COMPLEX_OUTPUT) != 0;
@@ -3126,21 +3262,13 @@ public:
 
         if (!opt.useIpp)
         {
-            if (len != prev_len)
-            {
-                opt.nf = DFTFactorize( opt.n, opt.factors );
-            }
+            plan = OcvDftPlanCache::getInstance().getPlan(opt.n, depth,
+                                  stage == 0 && opt.isInverse && real_transform, false);
+            opt.nf = plan->nf;
+            opt.factors = plan->factors;
+            opt.wave = plan->wave;
+            opt.itab = plan->itab;
             bool inplace_transform = opt.factors[0] == opt.factors[opt.nf-1];
-            if (len != prev_len || (!inplace_transform && opt.isInverse && real_transform))
-            {
-                wave_buf.allocate(opt.n*complex_elem_size);
-                opt.wave = wave_buf;
-                itab_buf.allocate(opt.n);
-                opt.itab = itab_buf;
-                DFTInit( opt.n, opt.nf, opt.factors, opt.itab, complex_elem_size,
-                         opt.wave, stage == 0 && opt.isInverse && real_transform );
-            }
-            // otherwise reuse the tables calculated on the previous stage
             if (needBuffer)
             {
                 if( (stage == 0 && ((*needBuffer && !inplace_transform) || (real_transform && (len & 1)))) ||
@@ -3202,6 +3330,12 @@ public:
     void free() {}
 };
 
+static bool isReentrantDft(const Ptr<hal::DFT1D>& c)
+{
+    const OcvDftBasicImpl* impl = dynamic_cast<const OcvDftBasicImpl*>(c.get());
+    return impl != 0 && !impl->opt.useIpp;
+}
+
 struct ReplacementDFT1D : public hal::DFT1D
 {
     cvhalDFT *context;
@@ -4048,14 +4182,77 @@ static bool ippi_DCT_32f(const uchar * src, size_t src_step, uchar * dst, size_t
 
 namespace cv {
 
+class DctInvoker : public ParallelLoopBody
+{
+public:
+    DctInvoker(const OcvDftOptions& _opt, DCTFunc _dct_func, const void* _dct_wave,
+               const uchar* _src, size_t _sstep0, size_t _sstep1,
+               uchar* _dst, size_t _dstep0, size_t _dstep1,
+               int _count, int _elem_size, bool _inplace_transform, int _blockCols) :
+        opt(_opt), dct_func(_dct_func), dct_wave(_dct_wave),
+        src(_src), sstep0(_sstep0), sstep1(_sstep1),
+        dst(_dst), dstep0(_dstep0), dstep1(_dstep1),
+        count(_count), elem_size(_elem_size), inplace_transform(_inplace_transform), blockCols(_blockCols)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        int len = opt.n;
+        size_t bufsize = len*elem_size;
+        size_t blocksize = blockCols > 0 ? bufsize*blockCols : 0;
+        AutoBuffer<uchar> buf((inplace_transform ? bufsize : bufsize*2) + blocksize*2);
+        uchar* src_dft_buf = buf;
+        uchar* dst_dft_buf = inplace_transform ? src_dft_buf : src_dft_buf + bufsize;
+        uchar* src_block = dst_dft_buf + bufsize;
+        uchar* dst_block = src_block + blocksize;
+
+        if( blockCols == 0 )
+        {
+            for( int i = range.start; i < range.end; i++ )
+                dct_func( opt, src + i*sstep0, sstep1, src_dft_buf, dst_dft_buf,
+                          dst + i*dstep0, dstep1, dct_wave );
+            return;
+        }
+
+        // column-wise transform: a block of adjacent columns is copied row by row
+        // into a small buffer, so that the strided accesses stay within the cache
+        for( int blk = range.start; blk < range.end; blk++ )
+        {
+            int c0 = blk*blockCols, nc = std::min(blockCols, count - c0);
+            size_t rowsize = nc*elem_size;
+            int j, k;
+
+            for( j = 0; j < len; j++ )
+                memcpy( src_block + j*rowsize, src + j*sstep1 + c0*sstep0, rowsize );
+            for( k = 0; k < nc; k++ )
+                dct_func( opt, src_block + k*elem_size, rowsize, src_dft_buf, dst_dft_buf,
+                          dst_block + k*elem_size, rowsize, dct_wave );
+            for( j = 0; j < len; j++ )
+                memcpy( dst + j*dstep1 + c0*dstep0, dst_block + j*rowsize, rowsize );
+        }
+    }
+
+private:
+    const OcvDftOptions& opt;
+    DCTFunc dct_func;
+    const void* dct_wave;
+    const uchar* src;
+    size_t sstep0, sstep1;
+    uchar* dst;
+    size_t dstep0, dstep1;
+    int count;
+    int elem_size;
+    bool inplace_transform;
+    int blockCols;
+};
+
 class OcvDctImpl : public hal::DCT2D
 {
 public:
     OcvDftOptions opt;
 
-    int _factors[34];
-    AutoBuffer<uint> wave_buf;
-    AutoBuffer<int> itab_buf;
+    Ptr<OcvDftPlan> plan;
 
     DCTFunc dct_func;
     bool isRowTransform;
@@ -4067,6 +4264,8 @@ public:
     int height;
     int depth;
 
+    enum { DCT_PARALLEL_MIN_SIZE = 1 << 15, DCT_PARALLEL_STRIPE_SIZE = 1 << 14, DCT_COL_BLOCK_SIZE = 128 };
+
     void init(int _width, int _height, int _depth, int flags)
     {
         width = _width;
@@ -4088,7 +4287,6 @@ public:
         opt.isInverse = false;
         opt.noPermute = false;
         opt.scale = 1.;
-        opt.factors = _factors;
 
         if (isRowTransform || height == 1 || (width == 1 && isContinuous))
         {
@@ -4104,12 +4302,7 @@ public:
     {
         CV_IPP_RUN(IPP_VERSION_X100 >= 700 && depth == CV_32F, ippi_DCT_32f(src, src_step, dst, dst_step, width, height, isInverse, isRowTransform))
 
-        AutoBuffer<uchar> dct_wave;
-        AutoBuffer<uchar> src_buf, dst_buf;
-        uchar *src_dft_buf = 0, *dst_dft_buf = 0;
-        int prev_len = 0;
         int elem_size = (depth == CV_32F) ? sizeof(float) : sizeof(double);
-        int complex_elem_size = elem_size*2;
 
         for(int stage = start_stage ; stage <= end_stage; stage++ )
         {
@@ -4143,41 +4336,28 @@ public:
             opt.n = len;
             opt.tab_size = len;
 
-            if( len != prev_len )
+            if( !plan || plan->n != len )
             {
                 if( len > 1 && (len & 1) )
                     CV_Error( CV_StsNotImplemented, "Odd-size DCT\'s are not implemented" );
 
-                opt.nf = DFTFactorize( len, opt.factors );
-                bool inplace_transform = opt.factors[0] == opt.factors[opt.nf-1];
-
-                wave_buf.allocate(len*complex_elem_size);
-                opt.wave = wave_buf;
-                itab_buf.allocate(len);
-                opt.itab = itab_buf;
-                DFTInit( len, opt.nf, opt.factors, opt.itab, complex_elem_size, opt.wave, isInverse );
-
-                dct_wave.allocate((len/2 + 1)*complex_elem_size);
-                src_buf.allocate(len*elem_size);
-                src_dft_buf = src_buf;
-                if(!inplace_transform)
-                {
-                    dst_buf.allocate(len*elem_size);
-                    dst_dft_buf = dst_buf;
-                }
-                else
-                {
-                    dst_dft_buf = src_buf;
-                }
-                DCTInit( len, complex_elem_size, dct_wave, isInverse);
-                prev_len = len;
+                plan = OcvDftPlanCache::getInstance().getPlan(len, depth, isInverse, true);
+                opt.nf = plan->nf;
+                opt.factors = plan->factors;
+                opt.wave = plan->wave;
+                opt.itab = plan->itab;
             }
             // otherwise reuse the tables calculated on the previous stage
-            for(unsigned i = 0; i < static_cast<unsigned>(count); i++ )
-            {
-                dct_func( opt, sptr + i*sstep0, sstep1, src_dft_buf, dst_dft_buf,
-                          dptr + i*dstep0, dstep1, dct_wave);
-            }
+            bool inplace_transform = opt.factors[0] == opt.factors[opt.nf-1];
+            int blockCols = stage == 0 ? 0 : DCT_COL_BLOCK_SIZE / elem_size;
+            int nblocks = blockCols > 0 ? (count + blockCols - 1) / blockCols : count;
+            DctInvoker body(opt, dct_func, plan->dct_wave, sptr, sstep0, sstep1, dptr, dstep0, dstep1,
+                            count, elem_size, inplace_transform, blockCols);
+            if( nblocks > 1 && (double)len*count >= DCT_PARALLEL_MIN_SIZE )
+                parallel_for_(Range(0, nblocks), body, (double)len*count/DCT_PARALLEL_STRIPE_SIZE);
+            else
+                body(Range(0, nblocks));
+
             src = dst;
             src_step = dst_step;
         }
@@ -0,0 +1,161 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv {
+
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+
+// forward declarations
+int dftRadix24_32f(Complexf* dst, int N, int n0, int& dw0, const Complexf* wave);
+
+#ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+#if CV_AVX2
+
+namespace {
+
+// The helpers below work on 4 complex numbers stored as re0 im0 re1 im1 ...
+
+static inline __m256 v_cmul(const __m256& x, const __m256& w)
+{
+    __m256 t = _mm256_mul_ps(_mm256_permute_ps(x, _MM_SHUFFLE(2,3,0,1)), _mm256_movehdup_ps(w));
+#if CV_FMA3
+    return _mm256_fmaddsub_ps(x, _mm256_moveldup_ps(w), t);
+#else
+    return _mm256_addsub_ps(_mm256_mul_ps(x, _mm256_moveldup_ps(w)), t);
+#endif
+}
+
+// (re, im) * -i = (im, -re)
+static inline __m256 v_mul_neg_i(const __m256& x)
+{
+    const __m256 neg_im = _mm256_setr_ps(0.f, -0.f, 0.f, -0.f, 0.f, -0.f, 0.f, -0.f);
+    return _mm256_xor_ps(_mm256_permute_ps(x, _MM_SHUFFLE(2,3,0,1)), neg_im);
+}
+
+// wave[idx], wave[idx + step], wave[idx + step*2], wave[idx + step*3]
+static inline __m256 v_load_wave(const Complexf* wave, int idx, int step)
+{
+    if( step == 1 )
+        return _mm256_loadu_ps((const float*)(wave + idx));
+    __m128i ofs = _mm_setr_epi32(idx, idx + step, idx + step*2, idx + step*3);
+    return _mm256_castpd_ps(_mm256_i32gather_pd((const double*)wave, ofs, 8));
+}
+
+} // namespace
+
+// Power-of-2 part of the mixed-radix DFT (see DFT() in dxt.cpp): radix-4 passes followed by
+// at most one radix-2 pass. Starting from the second pass each butterfly span holds a multiple
+// of 4 points, so 4 butterflies are computed at once.
+int dftRadix24_32f(Complexf* dst, int N, int n0, int& _dw0, const Complexf* wave)
+{
+    int n = 1, nx, i, j, dw0 = _dw0;
+
+    for( ; n*4 <= N; )
+    {
+        nx = n;
+        n *= 4;
+        dw0 /= 4;
+
+        if( nx == 1 )
+        {
+            // the first pass has no twiddle factors
+            for( i = 0; i < n0; i += 4 )
+            {
+                Complexf* v = dst + i;
+                float r0 = v[0].re + v[1].re, i0 = v[0].im + v[1].im;
+                float r1 = v[0].re - v[1].re, i1 = v[0].im - v[1].im;
+                float r2 = v[2].re + v[3].re, i2 = v[2].im + v[3].im;
+                float r3 = v[2].im - v[3].im, i3 = v[3].re - v[2].re;
+
+                v[0].re = r0 + r2; v[0].im = i0 + i2;
+                v[2].re = r0 - r2; v[2].im = i0 - i2;
+                v[1].re = r1 + r3; v[1].im = i1 + i3;
+                v[3].re = r1 - r3; v[3].im = i1 - i3;
+            }
+            continue;
+        }
+
+        CV_DbgAssert( nx % 4 == 0 );
+        for( i = 0; i < n0; i += n )
+        {
+            for( j = 0; j < nx; j += 4 )
+            {
+                float* v0 = (float*)(dst + i + j);
+                float* v1 = v0 + nx*4;
+                int dw = j*dw0;
+
+                __m256 x0 = _mm256_loadu_ps(v0);
+                __m256 x1 = v_cmul(_mm256_loadu_ps(v0 + nx*2), v_load_wave(wave, dw*2, dw0*2));
+                __m256 x2 = v_cmul(_mm256_loadu_ps(v1), v_load_wave(wave, dw, dw0));
+                __m256 x3 = v_cmul(_mm256_loadu_ps(v1 + nx*2), v_load_wave(wave, dw*3, dw0*3));
+
+                __m256 s = _mm256_add_ps(x2, x3), d = v_mul_neg_i(_mm256_sub_ps(x2, x3));
+                __m256 p = _mm256_add_ps(x0, x1), q = _mm256_sub_ps(x0, x1);
+
+                _mm256_storeu_ps(v0, _mm256_add_ps(p, s));
+                _mm256_storeu_ps(v1, _mm256_sub_ps(p, s));
+                _mm256_storeu_ps(v0 + nx*2, _mm256_add_ps(q, d));
+                _mm256_storeu_ps(v1 + nx*2, _mm256_sub_ps(q, d));
+            }
+        }
+    }
+
+    for( ; n < N; )
+    {
+        // the remaining radix-2 pass
+        nx = n;
+        n *= 2;
+        dw0 /= 2;
+
+        if( nx == 1 )
+        {
+            for( i = 0; i < n0; i += 2 )
+            {
+                Complexf* v = dst + i;
+                float r0 = v[0].re + v[1].re, i0 = v[0].im + v[1].im;
+                float r1 = v[0].re - v[1].re, i1 = v[0].im - v[1].im;
+                v[0].re = r0; v[0].im = i0;
+                v[1].re = r1; v[1].im = i1;
+            }
+            continue;
+        }
+
+        CV_DbgAssert( nx % 4 == 0 );
+        for( i = 0; i < n0; i += n )
+        {
+            for( j = 0; j < nx; j += 4 )
+            {
+                float* v0 = (float*)(dst + i + j);
+                float* v1 = v0 + nx*2;
+
+                __m256 x0 = _mm256_loadu_ps(v0);
+                __m256 x1 = v_cmul(_mm256_loadu_ps(v1), v_load_wave(wave, j*dw0, dw0));
+
+                _mm256_storeu_ps(v0, _mm256_add_ps(x0, x1));
+                _mm256_storeu_ps(v1, _mm256_sub_ps(x0, x1));
+            }
+        }
+    }
+
+    _dw0 = dw0;
+    return n;
+}
+
+#else
+
+int dftRadix24_32f(Complexf*, int, int, int&, const Complexf*)
+{
+    return 1; // the passes are done by DFT() itself
+}
+
+#endif // CV_AVX2
+
+#endif // CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+
+} // namespace cv
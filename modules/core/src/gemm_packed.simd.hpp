@@ -0,0 +1,390 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv {
+
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+
+// forward declarations
+void gemmPacked32f(const float* A, size_t astep, const float* B, size_t bstep, float alpha,
+                   const float* C, size_t cstep, float beta, float* D, size_t dstep,
+                   int M, int N, int K, int flags);
+void gemmPacked64f(const double* A, size_t astep, const double* B, size_t bstep, double alpha,
+                   const double* C, size_t cstep, double beta, double* D, size_t dstep,
+                   int M, int N, int K, int flags);
+
+#ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+namespace {
+
+// Thin wrappers over the widest registers available in the current dispatch mode,
+// so the micro-kernel below is written only once.
+template<typename _Tp> struct GemmVec;
+
+#if CV_AVX512_SKX
+template<> struct GemmVec<float>
+{
+    typedef __m512 reg;
+    enum { nlanes = 16 };
+    static inline reg zero() { return _mm512_setzero_ps(); }
+    static inline reg setall(float v) { return _mm512_set1_ps(v); }
+    static inline reg load(const float* p) { return _mm512_loadu_ps(p); }
+    static inline void store(float* p, const reg& v) { _mm512_storeu_ps(p, v); }
+    static inline reg muladd(const reg& a, const reg& b, const reg& c) { return _mm512_fmadd_ps(a, b, c); }
+};
+
+template<> struct GemmVec<double>
+{
+    typedef __m512d reg;
+    enum { nlanes = 8 };
+    static inline reg zero() { return _mm512_setzero_pd(); }
+    static inline reg setall(double v) { return _mm512_set1_pd(v); }
+    static inline reg load(const double* p) { return _mm512_loadu_pd(p); }
+    static inline void store(double* p, const reg& v) { _mm512_storeu_pd(p, v); }
+    static inline reg muladd(const reg& a, const reg& b, const reg& c) { return _mm512_fmadd_pd(a, b, c); }
+};
+#elif CV_AVX2
+template<> struct GemmVec<float>
+{
+    typedef __m256 reg;
+    enum { nlanes = 8 };
+    static inline reg zero() { return _mm256_setzero_ps(); }
+    static inline reg setall(float v) { return _mm256_set1_ps(v); }
+    static inline reg load(const float* p) { return _mm256_loadu_ps(p); }
+    static inline void store(float* p, const reg& v) { _mm256_storeu_ps(p, v); }
+#if CV_FMA3
+    static inline reg muladd(const reg& a, const reg& b, const reg& c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+    static inline reg muladd(const reg& a, const reg& b, const reg& c) { return _mm256_add_ps(c, _mm256_mul_ps(a, b)); }
+#endif
+};
+
+template<> struct GemmVec<double>
+{
+    typedef __m256d reg;
+    enum { nlanes = 4 };
+    static inline reg zero() { return _mm256_setzero_pd(); }
+    static inline reg setall(double v) { return _mm256_set1_pd(v); }
+    static inline reg load(const double* p) { return _mm256_loadu_pd(p); }
+    static inline void store(double* p, const reg& v) { _mm256_storeu_pd(p, v); }
+#if CV_FMA3
+    static inline reg muladd(const reg& a, const reg& b, const reg& c) { return _mm256_fmadd_pd(a, b, c); }
+#else
+    static inline reg muladd(const reg& a, const reg& b, const reg& c) { return _mm256_add_pd(c, _mm256_mul_pd(a, b)); }
+#endif
+};
+#else
+#if CV_SIMD128
+template<> struct GemmVec<float>
+{
+    typedef v_float32x4 reg;
+    enum { nlanes = 4 };
+    static inline reg zero() { return v_setzero_f32(); }
+    static inline reg setall(float v) { return v_setall_f32(v); }
+    static inline reg load(const float* p) { return v_load(p); }
+    static inline void store(float* p, const reg& v) { v_store(p, v); }
+    static inline reg muladd(const reg& a, const reg& b, const reg& c) { return v_muladd(a, b, c); }
+};
+#endif
+#if CV_SIMD128_64F
+template<> struct GemmVec<double>
+{
+    typedef v_float64x2 reg;
+    enum { nlanes = 2 };
+    static inline reg zero() { return v_setzero_f64(); }
+    static inline reg setall(double v) { return v_setall_f64(v); }
+    static inline reg load(const double* p) { return v_load(p); }
+    static inline void store(double* p, const reg& v) { v_store(p, v); }
+    static inline reg muladd(const reg& a, const reg& b, const reg& c) { return v_muladd(a, b, c); }
+};
+#endif
+#endif
+
+// Scalar fallback for the types not covered above.
+template<typename _Tp> struct GemmVec
+{
+    typedef _Tp reg;
+    enum { nlanes = 1 };
+    static inline reg zero() { return 0; }
+    static inline reg setall(_Tp v) { return v; }
+    static inline reg load(const _Tp* p) { return *p; }
+    static inline void store(_Tp* p, const reg& v) { *p = v; }
+    static inline reg muladd(const reg& a, const reg& b, const reg& c) { return a*b + c; }
+};
+
+/*
+    Blocked matrix multiplication D = alpha*op(A)*op(B) + beta*op(C).
+
+    D is split into tiles of BLOCK_M x BLOCK_N elements which are processed in parallel.
+    For every KC-slice of the inner dimension a tile packs its part of op(A) into
+    panels of MR rows and its part of op(B) into panels of NR columns, so the micro-kernel
+    reads both operands sequentially regardless of the transposition flags.
+    The micro-kernel keeps the whole MR x NR block of D in registers.
+*/
+template<typename _Tp> class GEMMPackedInvoker : public ParallelLoopBody
+{
+public:
+    typedef GemmVec<_Tp> V;
+    enum { MR = 4, NR = V::nlanes*2, BLOCK_M = 64, BLOCK_N = 256, BLOCK_K = 1024/sizeof(_Tp) };
+
+    GEMMPackedInvoker(const _Tp* A_, size_t astep_, const _Tp* B_, size_t bstep_, _Tp alpha_,
+                      const _Tp* C_, size_t cstep_, _Tp beta_, _Tp* D_, size_t dstep_,
+                      int M_, int N_, int K_, int flags_, int nthreads)
+        : A(A_), B(B_), C(C_), D(D_), alpha(alpha_), beta(beta_),
+          astep(astep_/sizeof(_Tp)), bstep(bstep_/sizeof(_Tp)), cstep(cstep_/sizeof(_Tp)), dstep(dstep_/sizeof(_Tp)),
+          M(M_), N(N_), K(K_), flags(flags_), blockM(BLOCK_M), blockN(BLOCK_N)
+    {
+        // make sure that all the threads get some work
+        int tilesM = (M + blockM - 1)/blockM;
+        if( tilesM*((N + blockN - 1)/blockN) < nthreads )
+        {
+            int splitN = (nthreads + tilesM - 1)/tilesM;
+            blockN = std::max((int)alignSize((N + splitN - 1)/splitN, NR), (int)NR);
+        }
+        tilesN = (N + blockN - 1)/blockN;
+        ntiles = tilesM*tilesN;
+    }
+
+    int tiles() const { return ntiles; }
+
+    void operator()(const Range& range) const
+    {
+        CV_AVX_GUARD;
+
+        int kc0 = std::min(K, (int)BLOCK_K);
+        AutoBuffer<_Tp> _buf(alignSize(blockM, MR)*kc0 + alignSize(blockN, NR)*kc0 + MR*NR);
+        _Tp* apack = _buf;
+        _Tp* bpack = apack + alignSize(blockM, MR)*kc0;
+        _Tp* dbuf = bpack + alignSize(blockN, NR)*kc0;
+
+        for( int tile = range.start; tile < range.end; tile++ )
+        {
+            int i0 = (tile / tilesN)*blockM, j0 = (tile % tilesN)*blockN;
+            int m = std::min(blockM, M - i0), n = std::min(blockN, N - j0);
+
+            initTile(i0, j0, m, n);
+
+            for( int k0 = 0; k0 < K; k0 += BLOCK_K )
+            {
+                int kc = std::min(K - k0, (int)BLOCK_K);
+                packA(i0, k0, m, kc, apack);
+                packB(k0, j0, kc, n, bpack);
+
+                for( int jr = 0; jr < n; jr += NR )
+                {
+                    int nr = std::min(n - jr, (int)NR);
+                    for( int ir = 0; ir < m; ir += MR )
+                    {
+                        int mr = std::min(m - ir, (int)MR);
+                        _Tp* d = D + (i0 + ir)*dstep + j0 + jr;
+                        if( mr == MR && nr == NR )
+                            microKernel(kc, apack + ir*kc, bpack + jr*kc, d, dstep);
+                        else
+                        {
+                            // the packed panels are padded with zeros, so the full-size
+                            // block is computed into a temporary buffer
+                            for( int i = 0; i < MR*NR; i++ )
+                                dbuf[i] = 0;
+                            microKernel(kc, apack + ir*kc, bpack + jr*kc, dbuf, NR);
+                            for( int i = 0; i < mr; i++ )
+                                for( int j = 0; j < nr; j++ )
+                                    d[i*dstep + j] += dbuf[i*NR + j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    // d[MR x NR] += alpha * a[MR x kc] * b[kc x NR]
+    void microKernel(int kc, const _Tp* a, const _Tp* b, _Tp* d, size_t ldd) const
+    {
+        typedef typename V::reg reg;
+        const int nlanes = V::nlanes;
+        reg s00 = V::zero(), s01 = V::zero(), s10 = V::zero(), s11 = V::zero();
+        reg s20 = V::zero(), s21 = V::zero(), s30 = V::zero(), s31 = V::zero();
+
+        for( int k = 0; k < kc; k++, a += MR, b += NR )
+        {
+            reg b0 = V::load(b), b1 = V::load(b + nlanes);
+            reg a0 = V::setall(a[0]);
+            s00 = V::muladd(a0, b0, s00);
+            s01 = V::muladd(a0, b1, s01);
+            a0 = V::setall(a[1]);
+            s10 = V::muladd(a0, b0, s10);
+            s11 = V::muladd(a0, b1, s11);
+            a0 = V::setall(a[2]);
+            s20 = V::muladd(a0, b0, s20);
+            s21 = V::muladd(a0, b1, s21);
+            a0 = V::setall(a[3]);
+            s30 = V::muladd(a0, b0, s30);
+            s31 = V::muladd(a0, b1, s31);
+        }
+
+        reg va = V::setall(alpha);
+        V::store(d, V::muladd(s00, va, V::load(d)));
+        V::store(d + nlanes, V::muladd(s01, va, V::load(d + nlanes)));
+        d += ldd;
+        V::store(d, V::muladd(s10, va, V::load(d)));
+        V::store(d + nlanes, V::muladd(s11, va, V::load(d + nlanes)));
+        d += ldd;
+        V::store(d, V::muladd(s20, va, V::load(d)));
+        V::store(d + nlanes, V::muladd(s21, va, V::load(d + nlanes)));
+        d += ldd;
+        V::store(d, V::muladd(s30, va, V::load(d)));
+        V::store(d + nlanes, V::muladd(s31, va, V::load(d + nlanes)));
+    }
+
+    // D[i0:i0+m, j0:j0+n] = beta*op(C) or 0
+    void initTile(int i0, int j0, int m, int n) const
+    {
+        for( int i = 0; i < m; i++ )
+        {
+            _Tp* d = D + (i0 + i)*dstep + j0;
+            int j = 0;
+            if( !C )
+            {
+                for( ; j < n; j++ )
+                    d[j] = 0;
+            }
+            else if( !(flags & GEMM_3_T) )
+            {
+                const _Tp* c = C + (i0 + i)*cstep + j0;
+                for( ; j < n; j++ )
+                    d[j] = beta*c[j];
+            }
+            else
+            {
+                const _Tp* c = C + (size_t)j0*cstep + i0 + i;
+                for( ; j < n; j++ )
+                    d[j] = beta*c[j*cstep];
+            }
+        }
+    }
+
+    // op(A)[i0:i0+m, k0:k0+kc] -> panels of MR rows, k-major inside a panel
+    void packA(int i0, int k0, int m, int kc, _Tp* dst) const
+    {
+        for( int ir = 0; ir < m; ir += MR, dst += MR*kc )
+        {
+            int mr = std::min(m - ir, (int)MR);
+            if( !(flags & GEMM_1_T) )
+            {
+                for( int i = 0; i < MR; i++ )
+                {
+                    if( i < mr )
+                    {
+                        const _Tp* a = A + (i0 + ir + i)*astep + k0;
+                        for( int k = 0; k < kc; k++ )
+                            dst[k*MR + i] = a[k];
+                    }
+                    else
+                    {
+                        for( int k = 0; k < kc; k++ )
+                            dst[k*MR + i] = 0;
+                    }
+                }
+            }
+            else
+            {
+                for( int k = 0; k < kc; k++ )
+                {
+                    const _Tp* a = A + (k0 + k)*astep + i0 + ir;
+                    int i = 0;
+                    for( ; i < mr; i++ )
+                        dst[k*MR + i] = a[i];
+                    for( ; i < MR; i++ )
+                        dst[k*MR + i] = 0;
+                }
+            }
+        }
+    }
+
+    // op(B)[k0:k0+kc, j0:j0+n] -> panels of NR columns, k-major inside a panel
+    void packB(int k0, int j0, int kc, int n, _Tp* dst) const
+    {
+        for( int jr = 0; jr < n; jr += NR, dst += NR*kc )
+        {
+            int nr = std::min(n - jr, (int)NR);
+            if( !(flags & GEMM_2_T) )
+            {
+                for( int k = 0; k < kc; k++ )
+                {
+                    const _Tp* b = B + (k0 + k)*bstep + j0 + jr;
+                    int j = 0;
+                    for( ; j < nr; j++ )
+                        dst[k*NR + j] = b[j];
+                    for( ; j < NR; j++ )
+                        dst[k*NR + j] = 0;
+                }
+            }
+            else
+            {
+                for( int j = 0; j < NR; j++ )
+                {
+                    if( j < nr )
+                    {
+                        const _Tp* b = B + (j0 + jr + j)*bstep + k0;
+                        for( int k = 0; k < kc; k++ )
+                            dst[k*NR + j] = b[k];
+                    }
+                    else
+                    {
+                        for( int k = 0; k < kc; k++ )
+                            dst[k*NR + j] = 0;
+                    }
+                }
+            }
+        }
+    }
+
+    const _Tp *A, *B, *C;
+    _Tp* D;
+    _Tp alpha, beta;
+    size_t astep, bstep, cstep, dstep;
+    int M, N, K, flags;
+    int blockM, blockN, tilesN, ntiles;
+};
+
+template<typename _Tp> static void
+gemmPacked_(const _Tp* A, size_t astep, const _Tp* B, size_t bstep, _Tp alpha,
+            const _Tp* C, size_t cstep, _Tp beta, _Tp* D, size_t dstep,
+            int M, int N, int K, int flags)
+{
+    if( beta == 0 )
+        C = 0;
+    // small products are not worth waking up the thread pool
+    bool parallel = (double)M*N*K >= (1 << 18) && getNumThreads() > 1;
+    GEMMPackedInvoker<_Tp> invoker(A, astep, B, bstep, alpha, C, cstep, beta, D, dstep,
+                                   M, N, K, flags, parallel ? getNumThreads() : 1);
+    if( parallel )
+        parallel_for_(Range(0, invoker.tiles()), invoker, invoker.tiles());
+    else
+        invoker(Range(0, invoker.tiles()));
+}
+
+} // namespace
+
+void gemmPacked32f(const float* A, size_t astep, const float* B, size_t bstep, float alpha,
+                   const float* C, size_t cstep, float beta, float* D, size_t dstep,
+                   int M, int N, int K, int flags)
+{
+    gemmPacked_(A, astep, B, bstep, alpha, C, cstep, beta, D, dstep, M, N, K, flags);
+}
+
+void gemmPacked64f(const double* A, size_t astep, const double* B, size_t bstep, double alpha,
+                   const double* C, size_t cstep, double beta, double* D, size_t dstep,
+                   int M, int N, int K, int flags)
+{
+    gemmPacked_(A, astep, B, bstep, alpha, C, cstep, beta, D, dstep, M, N, K, flags);
+}
+
+#endif // CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+
+} // namespace cv
@@ -48,6 +48,9 @@
 #include "opencv2/core/opencl/runtime/opencl_core.hpp"
 #include "intel_gpu_gemm.inl.hpp"
 
+#include "gemm_packed.simd.hpp"
+#include "gemm_packed.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX2,...,BASELINE based on CMakeLists.txt content
+
 namespace cv
 {
 
@@ -893,6 +896,27 @@ static bool ocl_gemm( InputArray matA, InputArray matB, double alpha,
 }
 #endif
 
+static void gemmPacked32f(const float* A, size_t astep, const float* B, size_t bstep, float alpha,
+                          const float* C, size_t cstep, float beta, float* D, size_t dstep,
+                          int M, int N, int K, int flags)
+{
+    CV_CPU_DISPATCH(gemmPacked32f, (A, astep, B, bstep, alpha, C, cstep, beta, D, dstep, M, N, K, flags),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+static void gemmPacked64f(const double* A, size_t astep, const double* B, size_t bstep, double alpha,
+                          const double* C, size_t cstep, double beta, double* D, size_t dstep,
+                          int M, int N, int K, int flags)
+{
+    CV_CPU_DISPATCH(gemmPacked64f, (A, astep, B, bstep, alpha, C, cstep, beta, D, dstep, M, N, K, flags),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+static inline bool isOverlapped( const Mat& a, const Mat& b )
+{
+    return a.data && b.data && a.data < b.dataend && b.data < a.dataend;
+}
+
 static void gemmImpl( Mat A, Mat B, double alpha,
            Mat C, double beta, Mat D, int flags )
 {
@@ -1185,6 +1209,25 @@ static void gemmImpl( Mat A, Mat B, double alpha,
         }
     }
 
+    // The packed kernels write D tile by tile, so they can't be used when
+    // the output overlaps with any of the operands (except for C updated in-place).
+    if( (type == CV_32FC1 || type == CV_64FC1) &&
+        std::min(d_size.width, d_size.height) >= 8 && len >= 8 &&
+        (double)d_size.width*d_size.height*len >= 2048 &&
+        !isOverlapped(D, A) && !isOverlapped(D, B) &&
+        (!isOverlapped(D, C) || (!(flags & GEMM_3_T) && C.data == D.data && C.step == D.step)) )
+    {
+        if( type == CV_32FC1 )
+            gemmPacked32f(A.ptr<float>(), A.step, B.ptr<float>(), B.step, (float)alpha,
+                          C.ptr<float>(), C.step, (float)beta, D.ptr<float>(), D.step,
+                          d_size.height, d_size.width, len, flags);
+        else
+            gemmPacked64f(A.ptr<double>(), A.step, B.ptr<double>(), B.step, alpha,
+                          C.ptr<double>(), C.step, beta, D.ptr<double>(), D.step,
+                          d_size.height, d_size.width, len, flags);
+        return;
+    }
+
     {
     size_t b_step = B.step;
     GEMMSingleMulFunc singleMulFunc;
@@ -4,6 +4,7 @@
 
 #include "precomp.hpp"
 #include "bufferpool.impl.hpp"
+#include <opencv2/core/utils/configuration.private.hpp>
 
 namespace cv {
 
@@ -176,13 +177,366 @@ public:
     }
 };
 
+// Allocator that keeps released buffers in per-thread pools instead of returning
+// them to the system. Buffer sizes are rounded up to size classes (4 classes per
+// power of two), so a released buffer can be reused by any request of the same class.
+// A released buffer goes back to the pool of the thread that allocated it (the pool is
+// recorded in UMatData::userdata), so buffers handed over to worker threads are reused by
+// the producer. All pools together keep at most getMaxReservedSize() bytes; buffers larger
+// than 1/8 of this limit are not pooled at all. The pool of a thread is freed when the
+// thread exits.
+class PoolMatAllocator : public MatAllocator, public BufferPoolController
+{
+public:
+    enum { MIN_SIZE_SHIFT = 5, MAX_SIZE_SHIFT = 30, NBINS = (MAX_SIZE_SHIFT - MIN_SIZE_SHIFT)*4 };
+
+    PoolMatAllocator() : totalReserved(0)
+    {
+        maxReservedSize = utils::getConfigurationParameterSizeT("OPENCV_BUFFERPOOL_LIMIT", (size_t)1 << 27);
+    }
+
+    virtual ~PoolMatAllocator()
+    {
+        freeAllReservedBuffers();
+    }
+
+    UMatData* allocate(int dims, const int* sizes, int type,
+                       void* data0, size_t* step, int /*flags*/, UMatUsageFlags /*usageFlags*/) const
+    {
+        size_t total = CV_ELEM_SIZE(type);
+        for( int i = dims-1; i >= 0; i-- )
+        {
+            if( step )
+            {
+                if( data0 && step[i] != CV_AUTOSTEP )
+                {
+                    CV_Assert(total <= step[i]);
+                    total = step[i];
+                }
+                else
+                    step[i] = total;
+            }
+            total *= sizes[i];
+        }
+        Arena* arena = 0;
+        uchar* data = data0 ? (uchar*)data0 : (uchar*)allocateBuffer(total, arena);
+        UMatData* u = new UMatData(this);
+        u->data = u->origdata = data;
+        u->size = total;
+        u->userdata = arena;
+        if(data0)
+            u->flags |= UMatData::USER_ALLOCATED;
+
+        return u;
+    }
+
+    bool allocate(UMatData* u, int /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const
+    {
+        if(!u) return false;
+        return true;
+    }
+
+    void deallocate(UMatData* u) const
+    {
+        if(!u)
+            return;
+
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        if( !(u->flags & UMatData::USER_ALLOCATED) )
+        {
+            Arena* arena = (Arena*)u->userdata;
+            releaseBuffer(arena, u->origdata, u->size);
+            if( arena )
+                arena->release();
+            u->origdata = 0;
+            u->userdata = 0;
+        }
+        delete u;
+    }
+
+    BufferPoolController* getBufferPoolController(const char* id) const
+    {
+        (void)id;
+        return const_cast<PoolMatAllocator*>(this);
+    }
+
+    virtual size_t getReservedSize() const
+    {
+        AutoLock lock(reservedMutex);
+        return totalReserved;
+    }
+
+    virtual size_t getMaxReservedSize() const { return maxReservedSize; }
+
+    virtual void setMaxReservedSize(size_t size)
+    {
+        maxReservedSize = size;
+        trimAll(size);
+    }
+
+    virtual void freeAllReservedBuffers()
+    {
+        trimAll(0);
+    }
+
+protected:
+    // Pool of one thread. It is referenced by the thread and by every buffer allocated from
+    // it, so it outlives the thread as long as some of its buffers are in use.
+    struct Arena
+    {
+        Arena() : refcount(1), reserved(0), alive(true) {}
+        ~Arena() { trim(0, 0); }
+
+        void addref() { CV_XADD(&refcount, 1); }
+        void release() { if( CV_XADD(&refcount, -1) == 1 ) delete this; }
+
+        // releases buffers, starting from the largest ones, until at most maxSize
+        // bytes are kept and no kept buffer is larger than maxBufferSize;
+        // returns the number of released bytes
+        size_t trim(size_t maxSize, size_t maxBufferSize)
+        {
+            size_t released = 0;
+            for( int idx = NBINS - 1; idx >= 0 && reserved > 0; idx-- )
+            {
+                std::vector<void*>& bin = bins[idx];
+                size_t capacity = binCapacity(idx);
+                while( !bin.empty() && (reserved > maxSize || capacity > maxBufferSize) )
+                {
+                    fastFree(bin.back());
+                    bin.pop_back();
+                    reserved -= capacity;
+                    released += capacity;
+                }
+            }
+            return released;
+        }
+
+        int refcount;
+        Mutex mutex;
+        std::vector<void*> bins[NBINS];
+        size_t reserved;
+        bool alive; // false once the owning thread has exited
+    };
+
+    // Owns the pool of the calling thread and gives it up when the thread exits
+    struct ArenaHolder
+    {
+        ArenaHolder() : owner(0), arena(0) {}
+        ~ArenaHolder()
+        {
+            if( arena )
+                owner->detachArena(arena);
+        }
+
+        const PoolMatAllocator* owner;
+        Arena* arena;
+    };
+
+    static size_t binCapacity(int idx)
+    {
+        int k = idx/4 + MIN_SIZE_SHIFT, q = idx%4 + 1;
+        return ((size_t)1 << k) + ((size_t)q << (k - 2));
+    }
+
+    // returns the size class index or -1 if buffers of this size are never pooled
+    static int sizeClass(size_t size)
+    {
+        if( size > ((size_t)1 << MAX_SIZE_SHIFT) )
+            return -1;
+        size = std::max(size, ((size_t)1 << MIN_SIZE_SHIFT) + 1);
+        int k = MIN_SIZE_SHIFT;
+        while( ((size_t)1 << (k + 1)) < size )
+            k++;
+        size_t quarter = (size_t)1 << (k - 2);
+        int q = (int)((size - ((size_t)1 << k) + quarter - 1) / quarter);
+        return (k - MIN_SIZE_SHIFT)*4 + q - 1;
+    }
+
+    Arena* threadArena() const
+    {
+#ifdef CV_CXX11
+        // the allocator is a never destroyed singleton, so one holder per thread is enough
+        static thread_local ArenaHolder holder;
+#else
+        // without thread_local the pools of exited threads are kept until they are trimmed
+        ArenaHolder& holder = arenaHolders.getRef();
+#endif
+        if( !holder.arena )
+        {
+            Arena* arena = new Arena;
+            {
+                AutoLock lock(arenasMutex);
+                arenas.push_back(arena);
+            }
+            holder.owner = this;
+            holder.arena = arena;
+        }
+        return holder.arena;
+    }
+
+    void detachArena(Arena* arena) const
+    {
+        {
+            AutoLock lock(arenasMutex);
+            arenas.erase(std::find(arenas.begin(), arenas.end(), arena));
+        }
+        size_t released;
+        {
+            AutoLock lock(arena->mutex);
+            arena->alive = false;
+            released = arena->trim(0, 0);
+        }
+        unreserve(released);
+        arena->release();
+    }
+
+    bool reserve(size_t size, size_t limit) const
+    {
+        AutoLock lock(reservedMutex);
+        if( totalReserved + size > limit )
+            return false;
+        totalReserved += size;
+        return true;
+    }
+
+    void unreserve(size_t size) const
+    {
+        if( size == 0 )
+            return;
+        AutoLock lock(reservedMutex);
+        totalReserved -= size;
+    }
+
+    // the pool the buffer should be returned to is stored to 'arena' (with a new reference)
+    void* allocateBuffer(size_t size, Arena*& arena) const
+    {
+        int idx = sizeClass(size);
+        if( idx < 0 )
+            return fastMalloc(size);
+        size_t capacity = binCapacity(idx);
+        arena = threadArena();
+        arena->addref();
+        if( capacity <= maxReservedSize/8 )
+        {
+            void* ptr = 0;
+            {
+                AutoLock lock(arena->mutex);
+                std::vector<void*>& bin = arena->bins[idx];
+                if( !bin.empty() )
+                {
+                    ptr = bin.back();
+                    bin.pop_back();
+                    arena->reserved -= capacity;
+                }
+            }
+            if( ptr )
+            {
+                unreserve(capacity);
+                return ptr;
+            }
+        }
+        // always allocate the whole class, so that the buffer can be pooled later
+        // even if the limit changes in the meantime
+        return fastMalloc(capacity);
+    }
+
+    void releaseBuffer(Arena* arena, void* ptr, size_t size) const
+    {
+        int idx = sizeClass(size);
+        size_t limit = maxReservedSize;
+        if( arena && idx >= 0 && binCapacity(idx) <= limit/8 )
+        {
+            size_t capacity = binCapacity(idx);
+            AutoLock lock(arena->mutex);
+            if( arena->alive )
+            {
+                bool pooled = reserve(capacity, limit);
+                if( !pooled )
+                {
+                    // make room in the owning pool; other pools are left untouched
+                    size_t keep = arena->reserved > capacity ? arena->reserved - capacity : 0;
+                    unreserve(arena->trim(keep, limit/8));
+                    pooled = reserve(capacity, limit);
+                }
+                if( pooled )
+                {
+                    arena->bins[idx].push_back(ptr);
+                    arena->reserved += capacity;
+                    return;
+                }
+            }
+        }
+        fastFree(ptr);
+    }
+
+    // trims the pools until all of them together keep at most 'limit' bytes
+    void trimAll(size_t limit)
+    {
+        AutoLock lock(arenasMutex);
+        for( size_t i = 0; i < arenas.size(); i++ )
+        {
+            Arena* arena = arenas[i];
+            AutoLock arenaLock(arena->mutex);
+            size_t total = getReservedSize();
+            size_t excess = total > limit ? total - limit : 0;
+            size_t keep = arena->reserved > excess ? arena->reserved - excess : 0;
+            unreserve(arena->trim(keep, limit/8));
+        }
+    }
+
+    mutable Mutex arenasMutex;
+    mutable std::vector<Arena*> arenas; // pools of the running threads
+#ifndef CV_CXX11
+    TLSData<ArenaHolder> arenaHolders;
+#endif
+    mutable Mutex reservedMutex;
+    mutable size_t totalReserved; // bytes kept in all pools
+    volatile size_t maxReservedSize;
+};
+
 namespace
 {
     MatAllocator* volatile g_matAllocator = NULL;
+
+    // number of MatAllocatorScope objects alive in all threads;
+    // while it is zero, Mat::getDefaultAllocator() does not need to look at the TLS
+    volatile int g_scopedAllocatorCount = 0;
+
+    struct ScopedAllocatorData
+    {
+        ScopedAllocatorData() : allocator(0) {}
+        MatAllocator* allocator;
+    };
+}
+
+static TLSData<ScopedAllocatorData>& getScopedAllocatorData()
+{
+    CV_SINGLETON_LAZY_INIT_REF(TLSData<ScopedAllocatorData>, new TLSData<ScopedAllocatorData>())
+}
+
+MatAllocatorScope::MatAllocatorScope(MatAllocator* allocator)
+{
+    ScopedAllocatorData& data = getScopedAllocatorData().getRef();
+    prevAllocator = data.allocator;
+    data.allocator = allocator;
+    CV_XADD(&g_scopedAllocatorCount, 1);
+}
+
+MatAllocatorScope::~MatAllocatorScope()
+{
+    getScopedAllocatorData().getRef().allocator = prevAllocator;
+    CV_XADD(&g_scopedAllocatorCount, -1);
 }
 
 MatAllocator* Mat::getDefaultAllocator()
 {
+    if (g_scopedAllocatorCount > 0)
+    {
+        MatAllocator* a = getScopedAllocatorData().getRef().allocator;
+        if (a)
+            return a;
+    }
     if (g_matAllocator == NULL)
     {
         cv::AutoLock lock(cv::getInitializationMutex());
@@ -201,6 +555,10 @@ MatAllocator* Mat::getStdAllocator()
 {
     CV_SINGLETON_LAZY_INIT(MatAllocator, new StdMatAllocator())
 }
+MatAllocator* Mat::getPoolAllocator()
+{
+    CV_SINGLETON_LAZY_INIT(MatAllocator, new PoolMatAllocator())
+}
 
 //==================================================================================================
 
@@ -442,6 +442,29 @@ static bool ipp_merge(const Mat* mv, Mat& dst, int channels)
 }
 #endif
 
+namespace cv
+{
+
+struct MergeStripes
+{
+    MergeStripes( const Mat* _mv, size_t _n, const Mat& _dst ) : mv(_mv), n(_n), dst(_dst) {}
+
+    void operator()( int, const Range& rows ) const
+    {
+        std::vector<Mat> src(n);
+        for( size_t k = 0; k < n; k++ )
+            src[k] = mv[k].rowRange(rows);
+        Mat d = dst.rowRange(rows);
+        merge(&src[0], n, d);
+    }
+
+    const Mat* mv;
+    size_t n;
+    const Mat& dst;
+};
+
+}
+
 void cv::merge(const Mat* mv, size_t n, OutputArray _dst)
 {
     CV_INSTRUMENT_REGION()
@@ -472,6 +495,13 @@ void cv::merge(const Mat* mv, size_t n, OutputArray _dst)
 
     CV_IPP_RUN_FAST(ipp_merge(mv, dst, (int)n));
 
+    int nstripes = getParallelStripes(dst);
+    if( nstripes > 1 )
+    {
+        parallel_for_stripes(dst.rows, nstripes, MergeStripes(mv, n, dst));
+        return;
+    }
+
     if( !allch1 )
     {
         AutoBuffer<int> pairs(cn*2);
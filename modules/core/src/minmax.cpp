@@ -742,6 +742,75 @@ static bool ipp_minMaxIdx(Mat &src, double* _minVal, double* _maxVal, int* _minI
 
 }
 
+namespace cv
+{
+
+struct MinMaxIdxStripes
+{
+    MinMaxIdxStripes( const Mat& _src, const Mat& _mask, double* _minVal, double* _maxVal,
+                      int* _minIdx, int* _maxIdx )
+        : src(_src), mask(_mask), minVal(_minVal), maxVal(_maxVal), minIdx(_minIdx), maxIdx(_maxIdx) {}
+
+    void operator()( int i, const Range& rows ) const
+    {
+        Mat m = mask.empty() ? Mat() : mask.rowRange(rows);
+        bool withIdx = src.channels() == 1;
+        int* pminIdx = minIdx + i*2;
+        int* pmaxIdx = maxIdx + i*2;
+
+        minMaxIdx(src.rowRange(rows), minVal + i, maxVal + i,
+                  withIdx ? pminIdx : 0, withIdx ? pmaxIdx : 0, m);
+        if( !withIdx )
+            pminIdx[0] = pmaxIdx[0] = 0;
+        else if( pminIdx[0] >= 0 )
+        {
+            pminIdx[0] += rows.start;
+            pmaxIdx[0] += rows.start;
+        }
+    }
+
+    const Mat &src, &mask;
+    double *minVal, *maxVal;
+    int *minIdx, *maxIdx;
+};
+
+// the first occurrences are found like in the serial code,
+// since the stripes are combined in the order of rows
+static void minMaxIdxByStripes( const Mat& src, const Mat& mask, int nstripes,
+                                double* minVal, double* maxVal, int* minIdx, int* maxIdx )
+{
+    std::vector<double> minVals(nstripes), maxVals(nstripes);
+    std::vector<int> minIdxs(nstripes*2), maxIdxs(nstripes*2);
+    parallel_for_stripes(src.rows, nstripes,
+                         MinMaxIdxStripes(src, mask, &minVals[0], &maxVals[0], &minIdxs[0], &maxIdxs[0]));
+
+    int imin = -1, imax = -1;
+    for( int i = 0; i < nstripes; i++ )
+    {
+        // the stripe is completely masked out
+        if( minIdxs[i*2] < 0 )
+            continue;
+        if( imin < 0 || minVals[i] < minVals[imin] )
+            imin = i;
+        if( imax < 0 || maxVals[i] > maxVals[imax] )
+            imax = i;
+    }
+
+    if( minVal )
+        *minVal = imin >= 0 ? minVals[imin] : 0;
+    if( maxVal )
+        *maxVal = imax >= 0 ? maxVals[imax] : 0;
+    for( int k = 0; k < 2; k++ )
+    {
+        if( minIdx )
+            minIdx[k] = imin >= 0 ? minIdxs[imin*2 + k] : -1;
+        if( maxIdx )
+            maxIdx[k] = imax >= 0 ? maxIdxs[imax*2 + k] : -1;
+    }
+}
+
+}
+
 void cv::minMaxIdx(InputArray _src, double* minVal,
                    double* maxVal, int* minIdx, int* maxIdx,
                    InputArray _mask)
@@ -769,6 +838,13 @@ void cv::minMaxIdx(InputArray _src, double* minVal,
     MinMaxIdxFunc func = getMinmaxTab(depth);
     CV_Assert( func != 0 );
 
+    int nstripes = getParallelStripes(src);
+    if( nstripes > 1 && (mask.empty() || mask.size == src.size) )
+    {
+        minMaxIdxByStripes(src, mask, nstripes, minVal, maxVal, minIdx, maxIdx);
+        return;
+    }
+
     const Mat* arrays[] = {&src, &mask, 0};
     uchar* ptrs[2];
     NAryMatIterator it(arrays, ptrs);
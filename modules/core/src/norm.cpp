@@ -623,6 +623,43 @@ static bool ipp_norm(Mat &src, int normType, Mat &mask, double &result)
 
 } // cv::
 
+namespace cv
+{
+
+struct NormStripes
+{
+    NormStripes( const Mat& _src1, const Mat* _src2, int _normType, const Mat& _mask, double* _partial )
+        : src1(_src1), src2(_src2), normType(_normType), mask(_mask), partial(_partial) {}
+
+    void operator()( int i, const Range& rows ) const
+    {
+        Mat m = mask.empty() ? Mat() : mask.rowRange(rows);
+        partial[i] = src2 ? norm(src1.rowRange(rows), src2->rowRange(rows), normType, m) :
+                            norm(src1.rowRange(rows), normType, m);
+    }
+
+    const Mat& src1;
+    const Mat* src2;
+    int normType;
+    const Mat& mask;
+    double* partial;
+};
+
+// L2 norm is combined from the squared norms of stripes
+static double normByStripes( const Mat& src1, const Mat* src2, int normType, const Mat& mask, int nstripes )
+{
+    std::vector<double> partial(nstripes);
+    parallel_for_stripes(src1.rows, nstripes,
+                         NormStripes(src1, src2, normType == NORM_L2 ? NORM_L2SQR : normType, mask, &partial[0]));
+
+    double result = 0;
+    for( int i = 0; i < nstripes; i++ )
+        result = normType == NORM_INF ? std::max(result, partial[i]) : result + partial[i];
+    return normType == NORM_L2 ? std::sqrt(result) : result;
+}
+
+}
+
 double cv::norm( InputArray _src, int normType, InputArray _mask )
 {
     CV_INSTRUMENT_REGION()
@@ -645,6 +682,10 @@ double cv::norm( InputArray _src, int normType, InputArray _mask )
     Mat src = _src.getMat(), mask = _mask.getMat();
     CV_IPP_RUN(IPP_VERSION_X100 >= 700, ipp_norm(src, normType, mask, _result), _result);
 
+    int nstripes = getParallelStripes(src);
+    if( nstripes > 1 && (mask.empty() || (mask.type() == CV_8U && mask.size == src.size)) )
+        return normByStripes(src, 0, normType, mask, nstripes);
+
     int depth = src.depth(), cn = src.channels();
     if( src.isContinuous() && mask.empty() )
     {
@@ -1106,6 +1147,10 @@ double cv::norm( InputArray _src1, InputArray _src2, int normType, InputArray _m
                normType == NORM_L2 || normType == NORM_L2SQR ||
               ((normType == NORM_HAMMING || normType == NORM_HAMMING2) && src1.type() == CV_8U) );
 
+    int nstripes = getParallelStripes(src1);
+    if( nstripes > 1 && (mask.empty() || (mask.type() == CV_8U && mask.size == src1.size)) )
+        return normByStripes(src1, &src2, normType, mask, nstripes);
+
     if( src1.isContinuous() && src2.isContinuous() && mask.empty() )
     {
         size_t len = src1.total()*src1.channels();
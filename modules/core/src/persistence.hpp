@@ -152,6 +152,8 @@ typedef void (*CvWriteString)( struct CvFileStorage* fs, const char* key,
 typedef void (*CvWriteComment)( struct CvFileStorage* fs, const char* comment, int eol_comment );
 typedef void (*CvStartNextStream)( struct CvFileStorage* fs );
 
+struct CvFileStorageLazyIndex;
+
 typedef struct CvFileStorage
 {
     int flags;
@@ -202,6 +204,8 @@ typedef struct CvFileStorage
     char* delayed_type_name;
 
     bool is_opened;
+
+    CvFileStorageLazyIndex* lazy_index; /**< not yet parsed top-level nodes (CV_STORAGE_LAZY) */
 }
 CvFileStorage;
 
@@ -325,4 +329,27 @@ void icvJSONWriteReal( CvFileStorage* fs, const char* key, double value );
 void icvJSONWriteString( CvFileStorage* fs, const char* key, const char* str, int quote CV_DEFAULT(0));
 void icvJSONWriteComment( CvFileStorage* fs, const char* comment, int eol_comment );
 
+//
+// Lazy reading
+//
+bool icvLazyOpen( CvFileStorage* fs );
+void icvLazyLoad( const CvFileStorage* fs, const char* key, int len );
+void icvLazyLoadAll( const CvFileStorage* fs );
+void icvLazyRelease( CvFileStorage* fs );
+
+// Serializes a top-level lookup in a lazily opened storage with the parsing of the nodes:
+// the parser adds to the storage-wide key hash, memory storage and roots that the lookup reads.
+// Does nothing for storages opened without CV_STORAGE_LAZY.
+class CvFileStorageLazyLock
+{
+public:
+    explicit CvFileStorageLazyLock( const CvFileStorage* fs );
+    ~CvFileStorageLazyLock();
+private:
+    CvFileStorageLazyIndex* index;
+
+    CvFileStorageLazyLock( const CvFileStorageLazyLock& ); // disabled
+    CvFileStorageLazyLock& operator=( const CvFileStorageLazyLock& ); // disabled
+};
+
 #endif // SRC_PERSISTENCE_HPP
@@ -406,34 +406,39 @@ cvOpenFileStorage( const char* query, CvMemStorage* dststorage, int flags, const
         fs->roots = cvCreateSeq( 0, sizeof(CvSeq),
                         sizeof(CvFileNode), fs->memstorage );
 
-        fs->buffer = fs->buffer_start = (char*)cvAlloc( buf_size + 256 );
-        fs->buffer_end = fs->buffer_start + buf_size;
-        fs->buffer[0] = '\n';
-        fs->buffer[1] = '\0';
-
-        //mode = cvGetErrMode();
-        //cvSetErrMode( CV_ErrModeSilent );
-        CV_TRY
+        // in the lazy mode only the top-level nodes are located; they are parsed on access
+        bool lazy = (flags & CV_STORAGE_LAZY) != 0 && !mem && !isGZ && icvLazyOpen( fs );
+        if( !lazy )
         {
-            switch (fs->fmt)
+            fs->buffer = fs->buffer_start = (char*)cvAlloc( buf_size + 256 );
+            fs->buffer_end = fs->buffer_start + buf_size;
+            fs->buffer[0] = '\n';
+            fs->buffer[1] = '\0';
+
+            //mode = cvGetErrMode();
+            //cvSetErrMode( CV_ErrModeSilent );
+            CV_TRY
             {
-            case CV_STORAGE_FORMAT_XML : { icvXMLParse ( fs ); break; }
-            case CV_STORAGE_FORMAT_YAML: { icvYMLParse ( fs ); break; }
-            case CV_STORAGE_FORMAT_JSON: { icvJSONParse( fs ); break; }
-            default: break;
+                switch (fs->fmt)
+                {
+                case CV_STORAGE_FORMAT_XML : { icvXMLParse ( fs ); break; }
+                case CV_STORAGE_FORMAT_YAML: { icvYMLParse ( fs ); break; }
+                case CV_STORAGE_FORMAT_JSON: { icvJSONParse( fs ); break; }
+                default: break;
+                }
             }
-        }
-        CV_CATCH_ALL
-        {
-            fs->is_opened = true;
-            cvReleaseFileStorage( &fs );
-            CV_RETHROW();
-        }
-        //cvSetErrMode( mode );
+            CV_CATCH_ALL
+            {
+                fs->is_opened = true;
+                cvReleaseFileStorage( &fs );
+                CV_RETHROW();
+            }
+            //cvSetErrMode( mode );
 
-        // release resources that we do not need anymore
-        cvFree( &fs->buffer_start );
-        fs->buffer = fs->buffer_end = 0;
+            // release resources that we do not need anymore
+            cvFree( &fs->buffer_start );
+            fs->buffer = fs->buffer_end = 0;
+        }
     }
     fs->is_opened = true;
 
@@ -470,6 +475,7 @@ cvReleaseFileStorage( CvFileStorage** p_fs )
         *p_fs = 0;
 
         icvClose(fs, 0);
+        icvLazyRelease(fs);
 
         cvReleaseMemStorage( &fs->strstorage );
         cvFree( &fs->buffer_start );
@@ -651,12 +657,15 @@ cvGetFileNode( CvFileStorage* fs, CvFileNode* _map_node,
     if( !key )
         CV_Error( CV_StsNullPtr, "Null key element" );
 
+    CvFileStorageLazyLock lazy_lock( _map_node ? 0 : fs );
     if( _map_node )
     {
         if( !fs->roots )
             return 0;
         attempts = fs->roots->total;
     }
+    else if( fs->lazy_index )
+        icvLazyLoad( fs, key->str.ptr, key->str.len );
 
     for( k = 0; k < attempts; k++ )
     {
@@ -730,11 +739,14 @@ cvGetFileNodeByName( const CvFileStorage* fs, const CvFileNode* _map_node, const
     hashval &= INT_MAX;
     len = i;
 
+    CvFileStorageLazyLock lazy_lock( _map_node ? 0 : fs );
     if( !_map_node )
     {
         if( !fs->roots )
             return 0;
         attempts = fs->roots->total;
+        if( fs->lazy_index )
+            icvLazyLoad( fs, str, len );
     }
 
     for( k = 0; k < attempts; k++ )
@@ -784,9 +796,13 @@ cvGetRootFileNode( const CvFileStorage* fs, int stream_index )
 {
     CV_CHECK_FILE_STORAGE(fs);
 
+    CvFileStorageLazyLock lazy_lock( fs );
     if( !fs->roots || (unsigned)stream_index >= (unsigned)fs->roots->total )
         return 0;
 
+    if( fs->lazy_index )
+        icvLazyLoadAll( fs );
+
     return (CvFileNode*)cvGetSeqElem( fs->roots, stream_index );
 }
 
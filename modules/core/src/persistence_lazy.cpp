@@ -0,0 +1,726 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+
+#include "precomp.hpp"
+#include "persistence.hpp"
+
+#include <map>
+
+#if defined _WIN32 && !defined WINRT
+#  define CV_FS_USE_WIN32_MAPPING 1
+#  include <windows.h>
+#elif defined __unix__ || defined __APPLE__
+#  define CV_FS_USE_MMAP 1
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+/****************************************************************************************\
+*                     Lazy reading of file storages (CV_STORAGE_LAZY)                    *
+\****************************************************************************************/
+
+/*
+  When a file is opened with CV_STORAGE_LAZY, it is mapped into memory and only split into
+  the top-level nodes of the (single) stream: for every node we remember its key and the
+  byte range of its text. The root map is filled with empty placeholders in the file order,
+  and the text of a node is parsed by the regular XML/YAML/JSON parser the first time the
+  node is requested by name. Requesting the root node (e.g. to iterate over it) parses all
+  the remaining nodes. Files that cannot be split reliably are parsed as usual.
+*/
+
+namespace
+{
+
+class FileMapping
+{
+public:
+    FileMapping() : data_(0), size_(0)
+#ifdef CV_FS_USE_WIN32_MAPPING
+        , file_(INVALID_HANDLE_VALUE), mapping_(0)
+#endif
+    {}
+    ~FileMapping() { close(); }
+
+    bool open( const char* filename )
+    {
+        close();
+#if defined CV_FS_USE_MMAP
+        int fd = ::open( filename, O_RDONLY );
+        if( fd < 0 )
+            return false;
+        struct stat st;
+        if( fstat( fd, &st ) == 0 && st.st_size > 0 )
+        {
+            void* ptr = mmap( 0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if( ptr != MAP_FAILED )
+            {
+                data_ = (const char*)ptr;
+                size_ = (size_t)st.st_size;
+            }
+        }
+        ::close( fd );
+#elif defined CV_FS_USE_WIN32_MAPPING
+        file_ = CreateFileA( filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL, 0 );
+        LARGE_INTEGER sz;
+        if( file_ != INVALID_HANDLE_VALUE && GetFileSizeEx( file_, &sz ) && sz.QuadPart > 0 &&
+            (unsigned long long)sz.QuadPart <= (unsigned long long)(size_t)-1 )
+        {
+            mapping_ = CreateFileMappingA( file_, 0, PAGE_READONLY, 0, 0, 0 );
+            if( mapping_ )
+            {
+                data_ = (const char*)MapViewOfFile( mapping_, FILE_MAP_READ, 0, 0, 0 );
+                size_ = data_ ? (size_t)sz.QuadPart : 0;
+            }
+        }
+        if( !data_ )
+            close();
+#else
+        FILE* f = fopen( filename, "rb" );
+        if( !f )
+            return false;
+        char buf[1 << 16];
+        size_t count;
+        while( (count = fread( buf, 1, sizeof(buf), f )) > 0 )
+            copy_.insert( copy_.end(), buf, buf + count );
+        fclose( f );
+        if( !copy_.empty() )
+        {
+            data_ = &copy_[0];
+            size_ = copy_.size();
+        }
+#endif
+        return data_ != 0;
+    }
+
+    void close()
+    {
+#if defined CV_FS_USE_MMAP
+        if( data_ )
+            munmap( (void*)data_, size_ );
+#elif defined CV_FS_USE_WIN32_MAPPING
+        if( data_ )
+            UnmapViewOfFile( data_ );
+        if( mapping_ )
+            CloseHandle( mapping_ );
+        if( file_ != INVALID_HANDLE_VALUE )
+            CloseHandle( file_ );
+        file_ = INVALID_HANDLE_VALUE;
+        mapping_ = 0;
+#else
+        std::vector<char>().swap( copy_ );
+#endif
+        data_ = 0;
+        size_ = 0;
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_;
+    size_t size_;
+#if defined CV_FS_USE_WIN32_MAPPING
+    HANDLE file_;
+    HANDLE mapping_;
+#elif !defined CV_FS_USE_MMAP
+    std::vector<char> copy_;
+#endif
+
+    FileMapping( const FileMapping& ); // disabled
+    FileMapping& operator=( const FileMapping& ); // disabled
+};
+
+struct LazyNodeRange
+{
+    size_t keyofs;
+    size_t keylen;
+    size_t begin, end;
+    int lineno;
+};
+
+inline int countLines( const char* begin, const char* end )
+{
+    return (int)std::count( begin, end, '\n' );
+}
+
+inline bool isBlankOrComment( const char* ptr, size_t len )
+{
+    for( size_t i = 0; i < len; i++ )
+    {
+        if( ptr[i] == '#' )
+            return true;
+        if( !cv_isspace(ptr[i]) )
+            return false;
+    }
+    return true;
+}
+
+/* A top-level node of a YAML stream starts at the first column with a "key:" line
+   and continues up to the next such line. Flow collections may span several lines,
+   so the brackets are tracked (outside of quoted strings and comments) and the lines
+   inside brackets are never considered as keys. */
+bool indexYML( const char* data, size_t size, size_t pos, std::vector<LazyNodeRange>& nodes )
+{
+    int lineno = 0, depth = 0;
+    bool started = false, finished = false, opened = false;
+
+    while( pos < size )
+    {
+        const char* line = data + pos;
+        const char* eol = (const char*)memchr( line, '\n', size - pos );
+        size_t len = eol ? (size_t)(eol - line) : size - pos;
+        size_t start = 0;
+        char c = len > 0 ? line[0] : ' ';
+        lineno++;
+
+        if( depth == 0 && !cv_isspace(c) && c != '#' )
+        {
+            if( c == '%' )
+            {
+                if( started )
+                    return false;
+                start = len;
+            }
+            else if( len >= 3 && memcmp( line, "---", 3 ) == 0 )
+            {
+                // the second document marker starts another stream
+                if( started || !isBlankOrComment( line + 3, len - 3 ) )
+                    return false;
+                started = true;
+                start = len;
+            }
+            else if( len >= 3 && memcmp( line, "...", 3 ) == 0 )
+            {
+                if( opened )
+                    nodes.back().end = pos;
+                opened = false;
+                finished = true;
+                start = len;
+            }
+            else if( finished )
+                return false;
+            else if( cv_isalnum(c) || c == '_' )
+            {
+                size_t k = 0, keylen;
+                while( k < len && cv_isprint(line[k]) && line[k] != ':' )
+                    k++;
+                if( k == len || line[k] != ':' )
+                    return false;
+                for( keylen = k; line[keylen - 1] == ' '; keylen-- )
+                    ;
+                if( opened )
+                    nodes.back().end = pos;
+                LazyNodeRange node = { pos, keylen, pos, size, lineno };
+                nodes.push_back( node );
+                started = opened = true;
+                start = k + 1;
+            }
+            else if( c != '-' || !opened )
+                return false;
+        }
+
+        char quote = 0;
+        for( size_t k = start; k < len; k++ )
+        {
+            char ch = line[k];
+            if( quote )
+            {
+                if( ch == '\\' && quote == '\"' )
+                    k++;
+                else if( ch == quote )
+                    quote = 0;
+            }
+            else if( ch == '\"' || ch == '\'' )
+                quote = ch;
+            else if( ch == '#' && (k == 0 || cv_isspace(line[k - 1])) )
+                break;
+            else if( ch == '[' || ch == '{' )
+                depth++;
+            else if( (ch == ']' || ch == '}') && --depth < 0 )
+                return false;
+        }
+
+        pos += len + 1;
+    }
+
+    return depth == 0 && !nodes.empty();
+}
+
+/* skips comments and processing instructions; returns false on an unterminated one */
+bool skipXMLMarkup( const char* data, size_t size, size_t& pos )
+{
+    for( ;; )
+    {
+        while( pos < size && cv_isspace(data[pos]) )
+            pos++;
+        if( size - pos >= 4 && memcmp( data + pos, "<!--", 4 ) == 0 )
+        {
+            const char* end = std::search( data + pos + 4, data + size, "-->", "-->" + 3 );
+            if( end == data + size )
+                return false;
+            pos = end - data + 3;
+        }
+        else if( size - pos >= 2 && memcmp( data + pos, "<?", 2 ) == 0 )
+        {
+            const char* end = std::search( data + pos + 2, data + size, "?>", "?>" + 2 );
+            if( end == data + size )
+                return false;
+            pos = end - data + 2;
+        }
+        else
+            return true;
+    }
+}
+
+/* moves pos past the end of the tag that starts at pos; returns the tag kind:
+   +1 - opening tag, 0 - self-closing tag or comment, -1 - closing tag, -2 - error */
+int skipXMLTag( const char* data, size_t size, size_t& pos )
+{
+    if( size - pos >= 4 && memcmp( data + pos, "<!--", 4 ) == 0 )
+        return skipXMLMarkup( data, size, pos ) ? 0 : -2;
+    if( pos + 1 >= size || data[pos + 1] == '!' || data[pos + 1] == '?' )
+        return -2;
+
+    int kind = data[pos + 1] == '/' ? -1 : 1;
+    char quote = 0;
+    for( size_t k = pos + 1; k < size; k++ )
+    {
+        char ch = data[k];
+        if( quote )
+        {
+            if( ch == quote )
+                quote = 0;
+        }
+        else if( ch == '\"' || ch == '\'' )
+            quote = ch;
+        else if( ch == '>' )
+        {
+            if( kind > 0 && data[k - 1] == '/' )
+                kind = 0;
+            pos = k + 1;
+            return kind;
+        }
+    }
+    return -2;
+}
+
+bool indexXML( const char* data, size_t size, size_t pos, std::vector<LazyNodeRange>& nodes )
+{
+    static const char root_tag[] = "<opencv_storage>";
+    static const char root_end_tag[] = "</opencv_storage";
+    const size_t root_tag_len = sizeof(root_tag) - 1, root_end_tag_len = sizeof(root_end_tag) - 1;
+    int lineno = 1;
+    size_t last = 0;
+
+    if( !skipXMLMarkup( data, size, pos ) || size - pos < root_tag_len ||
+        memcmp( data + pos, root_tag, root_tag_len ) != 0 )
+        return false;
+    pos += root_tag_len;
+
+    for( ;; )
+    {
+        if( !skipXMLMarkup( data, size, pos ) || pos >= size || data[pos] != '<' )
+            return false;
+        if( size - pos >= root_end_tag_len && memcmp( data + pos, root_end_tag, root_end_tag_len ) == 0 )
+        {
+            if( skipXMLTag( data, size, pos ) != -1 )
+                return false;
+            break;
+        }
+
+        LazyNodeRange node;
+        node.keyofs = pos + 1;
+        for( node.keylen = 0; node.keyofs + node.keylen < size; node.keylen++ )
+        {
+            char ch = data[node.keyofs + node.keylen];
+            if( cv_isspace(ch) || ch == '>' || ch == '/' )
+                break;
+        }
+        if( node.keylen == 0 )
+            return false;
+        node.begin = pos;
+        lineno += countLines( data + last, data + pos );
+        node.lineno = lineno;
+        last = pos;
+
+        int depth = 0;
+        do
+        {
+            int kind = skipXMLTag( data, size, pos );
+            if( kind == -2 )
+                return false;
+            depth += kind;
+            if( depth > 0 )
+            {
+                const char* next = (const char*)memchr( data + pos, '<', size - pos );
+                if( !next )
+                    return false;
+                pos = next - data;
+            }
+        }
+        while( depth > 0 );
+        if( depth < 0 )
+            return false;
+
+        node.end = pos;
+        nodes.push_back( node );
+    }
+
+    // there should be only one stream
+    return skipXMLMarkup( data, size, pos ) && pos == size && !nodes.empty();
+}
+
+bool skipJSONSpaces( const char* data, size_t size, size_t& pos )
+{
+    for( ;; )
+    {
+        while( pos < size && cv_isspace(data[pos]) )
+            pos++;
+        if( size - pos < 2 || data[pos] != '/' )
+            return true;
+        if( data[pos + 1] == '/' )
+        {
+            const char* end = (const char*)memchr( data + pos, '\n', size - pos );
+            pos = end ? end - data : size;
+        }
+        else if( data[pos + 1] == '*' )
+        {
+            const char* end = std::search( data + pos + 2, data + size, "*/", "*/" + 2 );
+            if( end == data + size )
+                return false;
+            pos = end - data + 2;
+        }
+        else
+            return true;
+    }
+}
+
+bool skipJSONString( const char* data, size_t size, size_t& pos )
+{
+    for( pos++; pos < size; pos++ )
+    {
+        if( data[pos] == '\\' )
+            pos++;
+        else if( data[pos] == '\"' )
+        {
+            pos++;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool indexJSON( const char* data, size_t size, size_t pos, std::vector<LazyNodeRange>& nodes )
+{
+    int lineno = 1;
+    size_t last = 0;
+
+    if( !skipJSONSpaces( data, size, pos ) || pos >= size || data[pos] != '{' )
+        return false;
+    pos++;
+
+    for( ;; )
+    {
+        if( !skipJSONSpaces( data, size, pos ) || pos >= size )
+            return false;
+        if( data[pos] == '}' )
+        {
+            pos++;
+            break;
+        }
+        if( data[pos] != '\"' )
+            return false;
+
+        LazyNodeRange node;
+        node.begin = pos;
+        node.keyofs = pos + 1;
+        if( !skipJSONString( data, size, pos ) )
+            return false;
+        node.keylen = pos - node.keyofs - 1;
+        // type_id is an attribute of the map, not a node
+        if( node.keylen == 0 || memchr( data + node.keyofs, '\\', node.keylen ) ||
+            (node.keylen == 7 && memcmp( data + node.keyofs, "type_id", 7 ) == 0) )
+            return false;
+        lineno += countLines( data + last, data + node.begin );
+        node.lineno = lineno;
+        last = node.begin;
+
+        if( !skipJSONSpaces( data, size, pos ) || pos >= size || data[pos] != ':' )
+            return false;
+
+        int depth = 0;
+        for( pos++; pos < size; )
+        {
+            char ch = data[pos];
+            if( ch == '\"' )
+            {
+                if( !skipJSONString( data, size, pos ) )
+                    return false;
+                continue;
+            }
+            if( ch == '/' )
+            {
+                if( !skipJSONSpaces( data, size, pos ) )
+                    return false;
+                if( pos >= size || data[pos] != '/' )
+                    continue;
+            }
+            else if( ch == '{' || ch == '[' )
+                depth++;
+            else if( ch == '}' || ch == ']' )
+            {
+                if( depth == 0 )
+                    break;
+                depth--;
+            }
+            else if( ch == ',' && depth == 0 )
+                break;
+            pos++;
+        }
+        if( pos >= size )
+            return false;
+
+        node.end = pos;
+        nodes.push_back( node );
+        if( data[pos] == ',' )
+            pos++;
+    }
+
+    return skipJSONSpaces( data, size, pos ) && pos == size && !nodes.empty();
+}
+
+} // namespace
+
+struct CvFileStorageLazyIndex
+{
+    struct Node
+    {
+        CvFileNode* placeholder;
+        size_t begin, end;
+        int lineno;
+        bool loaded;
+    };
+
+    CvFileStorageLazyIndex() : nloaded(0) {}
+
+    FileMapping file;
+    std::vector<Node> nodes;
+    std::map<const CvStringHashNode*, size_t> keys;
+    size_t nloaded;
+    cv::Mutex mutex;
+};
+
+bool icvLazyOpen( CvFileStorage* fs )
+{
+    CvFileStorageLazyIndex* index = new CvFileStorageLazyIndex;
+    std::vector<LazyNodeRange> ranges;
+    bool ok = index->file.open( fs->filename );
+
+    if( ok )
+    {
+        const char* data = index->file.data();
+        size_t size = index->file.size();
+        size_t pos = size >= 3 ? cv_skip_BOM( (char*)data ) - data : 0;
+
+        switch( fs->fmt )
+        {
+        case CV_STORAGE_FORMAT_XML : { ok = indexXML ( data, size, pos, ranges ); break; }
+        case CV_STORAGE_FORMAT_YAML: { ok = indexYML ( data, size, pos, ranges ); break; }
+        case CV_STORAGE_FORMAT_JSON: { ok = indexJSON( data, size, pos, ranges ); break; }
+        default: ok = false;
+        }
+    }
+
+    CvFileNode* root = 0;
+    if( ok )
+    {
+        root = (CvFileNode*)cvSeqPush( fs->roots, 0 );
+        memset( root, 0, sizeof(*root) );
+        icvFSCreateCollection( fs, CV_NODE_MAP, root );
+
+        index->nodes.resize( ranges.size() );
+        for( size_t i = 0; ok && i < ranges.size(); i++ )
+        {
+            const LazyNodeRange& r = ranges[i];
+            CvStringHashNode* key = cvGetHashedKey( fs, index->file.data() + r.keyofs, (int)r.keylen, 1 );
+
+            // duplicated keys are reported by the regular parser
+            ok = cvGetFileNode( fs, root, key, 0 ) == 0;
+            if( ok )
+            {
+                CvFileStorageLazyIndex::Node& node = index->nodes[i];
+                node.placeholder = cvGetFileNode( fs, root, key, 1 );
+                memset( node.placeholder, 0, sizeof(*node.placeholder) );
+                node.begin = r.begin;
+                node.end = r.end;
+                node.lineno = r.lineno;
+                node.loaded = false;
+                index->keys[key] = i;
+            }
+        }
+        if( !ok )
+            cvSeqPop( fs->roots, 0 );
+    }
+
+    if( !ok )
+    {
+        delete index;
+        return false;
+    }
+
+    fs->lazy_index = index;
+    return true;
+}
+
+static void icvLazyEndParse( CvFileStorage* fs, int roots_total )
+{
+    cvFree( &fs->buffer_start );
+    fs->buffer = fs->buffer_end = 0;
+    fs->strbuf = 0;
+    fs->strbufsize = fs->strbufpos = 0;
+    while( fs->roots->total > roots_total )
+        cvSeqPop( fs->roots, 0 );
+}
+
+static void icvLazyLoadNode( CvFileStorage* fs, CvFileStorageLazyIndex* index, size_t idx )
+{
+    CvFileStorageLazyIndex::Node& node = index->nodes[idx];
+    const CvFileMapNode* placeholder = (const CvFileMapNode*)node.placeholder;
+
+    if( node.loaded )
+        return;
+
+    // wrap the text of the node into a single-node document
+    std::string doc;
+    int header_lines = 0;
+    const char* text = index->file.data() + node.begin;
+    size_t textlen = node.end - node.begin;
+    switch( fs->fmt )
+    {
+    case CV_STORAGE_FORMAT_XML:
+        doc.reserve( textlen + 64 );
+        doc.append( "<?xml version=\"1.0\"?>\n<opencv_storage>\n" );
+        doc.append( text, textlen );
+        doc.append( "\n</opencv_storage>\n" );
+        header_lines = 2;
+        break;
+    case CV_STORAGE_FORMAT_YAML:
+        doc.reserve( textlen + 16 );
+        doc.append( "%YAML:1.0\n---\n" );
+        doc.append( text, textlen );
+        doc.append( "\n" );
+        header_lines = 2;
+        break;
+    case CV_STORAGE_FORMAT_JSON:
+        doc.reserve( textlen + 8 );
+        doc.append( "{\n" );
+        doc.append( text, textlen );
+        doc.append( "\n}\n" );
+        header_lines = 1;
+        break;
+    default:
+        CV_Error( CV_StsError, "Unsupported file storage format" );
+    }
+
+    // parse the document the same way as a file storage opened in memory
+    int roots_total = fs->roots->total;
+    size_t buf_size = MIN( doc.size(), (size_t)(1 << 20) );
+    buf_size = MAX( buf_size, (size_t)(CV_FS_MAX_LEN*2 + 1024) );
+
+    fs->strbuf = doc.c_str();
+    fs->strbufsize = doc.size();
+    fs->strbufpos = 0;
+    fs->lineno = node.lineno - 1 - header_lines;
+    fs->dummy_eof = 0;
+    fs->buffer = fs->buffer_start = (char*)cvAlloc( buf_size + 256 );
+    fs->buffer_end = fs->buffer_start + buf_size;
+    fs->buffer[0] = '\n';
+    fs->buffer[1] = '\0';
+
+    CvFileNode* value = 0;
+    CV_TRY
+    {
+        switch( fs->fmt )
+        {
+        case CV_STORAGE_FORMAT_XML : { icvXMLParse ( fs ); break; }
+        case CV_STORAGE_FORMAT_YAML: { icvYMLParse ( fs ); break; }
+        case CV_STORAGE_FORMAT_JSON: { icvJSONParse( fs ); break; }
+        default: break;
+        }
+
+        if( fs->roots->total == roots_total + 1 )
+        {
+            CvFileNode* root = (CvFileNode*)cvGetSeqElem( fs->roots, roots_total );
+            if( CV_NODE_IS_MAP(root->tag) && root->data.map->active_count == 1 )
+                value = cvGetFileNode( fs, root, placeholder->key, 0 );
+        }
+        if( !value )
+            CV_PARSE_ERROR( "The node has been changed since the file storage was opened" );
+    }
+    CV_CATCH_ALL
+    {
+        icvLazyEndParse( fs, roots_total );
+        CV_RETHROW();
+    }
+    icvLazyEndParse( fs, roots_total );
+
+    *node.placeholder = *value;
+    node.loaded = true;
+
+    // the file is not needed anymore once all the nodes are parsed
+    if( ++index->nloaded == index->nodes.size() )
+        index->file.close();
+}
+
+void icvLazyLoad( const CvFileStorage* _fs, const char* str, int len )
+{
+    CvFileStorage* fs = (CvFileStorage*)_fs;
+    CvFileStorageLazyIndex* index = fs->lazy_index;
+    if( !index )
+        return;
+
+    // the caller holds CvFileStorageLazyLock
+    const CvStringHashNode* key = 0;
+    if( index->nloaded < index->nodes.size() && (key = cvGetHashedKey( fs, str, len, 0 )) != 0 )
+    {
+        std::map<const CvStringHashNode*, size_t>::const_iterator it = index->keys.find( key );
+        if( it != index->keys.end() )
+            icvLazyLoadNode( fs, index, it->second );
+    }
+}
+
+void icvLazyLoadAll( const CvFileStorage* _fs )
+{
+    CvFileStorage* fs = (CvFileStorage*)_fs;
+    CvFileStorageLazyIndex* index = fs->lazy_index;
+    if( !index )
+        return;
+
+    // the caller holds CvFileStorageLazyLock
+    for( size_t i = 0; i < index->nodes.size() && index->nloaded < index->nodes.size(); i++ )
+        icvLazyLoadNode( fs, index, i );
+}
+
+CvFileStorageLazyLock::CvFileStorageLazyLock( const CvFileStorage* fs )
+    : index( fs ? fs->lazy_index : 0 )
+{
+    if( index )
+        index->mutex.lock();
+}
+
+CvFileStorageLazyLock::~CvFileStorageLazyLock()
+{
+    if( index )
+        index->mutex.unlock();
+}
+
+void icvLazyRelease( CvFileStorage* fs )
+{
+    delete fs->lazy_index;
+    fs->lazy_index = 0;
+}
@@ -195,6 +195,43 @@ inline Size getContinuousSize( const Mat& m1, const Mat& m2,
                               m1.cols, m1.rows, widthScale);
 }
 
+/* Large 2D arrays are processed by horizontal stripes in parallel.
+   The stripes depend only on the array size, not on the number of threads,
+   so the reductions combining the per-stripe results in order are deterministic. */
+enum { PARALLEL_MIN_SIZE = 1 << 20, PARALLEL_STRIPE_SIZE = 1 << 18 };
+
+// returns the number of stripes to split the array rows into; 1 if it's not worth it
+inline int getParallelStripes( const Mat& m )
+{
+    size_t size = m.total()*m.elemSize();
+    if( m.dims > 2 || m.rows < 2 || size < (size_t)PARALLEL_MIN_SIZE )
+        return 1;
+    return (int)std::min((size_t)m.rows, (size + PARALLEL_STRIPE_SIZE - 1)/PARALLEL_STRIPE_SIZE);
+}
+
+template<typename Op> class StripesLoopBody : public ParallelLoopBody
+{
+public:
+    StripesLoopBody( const Op& op_, int rows_, int nstripes_ )
+        : op(op_), rows(rows_), nstripes(nstripes_) {}
+
+    void operator()( const Range& range ) const
+    {
+        for( int i = range.start; i < range.end; i++ )
+            op(i, Range((int)((int64)rows*i/nstripes), (int)((int64)rows*(i + 1)/nstripes)));
+    }
+
+private:
+    const Op& op;
+    int rows, nstripes;
+};
+
+// calls op(stripe_index, stripe_rows) for every stripe of the rows [0, rows)
+template<typename Op> inline void parallel_for_stripes( int rows, int nstripes, const Op& op )
+{
+    parallel_for_(Range(0, nstripes), StripesLoopBody<Op>(op, rows, nstripes), nstripes);
+}
+
 void setSize( Mat& m, int _dims, const int* _sz, const size_t* _steps, bool autoSteps=false );
 void finalizeHdr(Mat& m);
 
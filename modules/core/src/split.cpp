@@ -461,6 +461,27 @@ static bool ipp_split(const Mat& src, Mat* mv, int channels)
 }
 #endif
 
+namespace cv
+{
+
+struct SplitStripes
+{
+    SplitStripes( const Mat& _src, Mat* _mv ) : src(_src), mv(_mv) {}
+
+    void operator()( int, const Range& rows ) const
+    {
+        std::vector<Mat> dst(src.channels());
+        for( size_t k = 0; k < dst.size(); k++ )
+            dst[k] = mv[k].rowRange(rows);
+        split(src.rowRange(rows), &dst[0]);
+    }
+
+    const Mat& src;
+    Mat* mv;
+};
+
+}
+
 void cv::split(const Mat& src, Mat* mv)
 {
     CV_INSTRUMENT_REGION()
@@ -479,6 +500,13 @@ void cv::split(const Mat& src, Mat* mv)
 
     CV_IPP_RUN_FAST(ipp_split(src, mv, cn));
 
+    int nstripes = getParallelStripes(src);
+    if( nstripes > 1 )
+    {
+        parallel_for_stripes(src.rows, nstripes, SplitStripes(src, mv));
+        return;
+    }
+
     SplitFunc func = getSplitFunc(depth);
     CV_Assert( func != 0 );
 
@@ -580,6 +580,24 @@ static bool ipp_sum(Mat &src, Scalar &_res)
 
 } // cv::
 
+namespace cv
+{
+
+struct SumStripes
+{
+    SumStripes( const Mat& _src, Scalar* _partial ) : src(_src), partial(_partial) {}
+
+    void operator()( int i, const Range& rows ) const
+    {
+        partial[i] = sum(src.rowRange(rows));
+    }
+
+    const Mat& src;
+    Scalar* partial;
+};
+
+}
+
 cv::Scalar cv::sum( InputArray _src )
 {
     CV_INSTRUMENT_REGION()
@@ -601,6 +619,18 @@ cv::Scalar cv::sum( InputArray _src )
     SumFunc func = getSumFunc(depth);
     CV_Assert( cn <= 4 && func != 0 );
 
+    int nstripes = getParallelStripes(src);
+    if( nstripes > 1 )
+    {
+        std::vector<Scalar> partial(nstripes);
+        parallel_for_stripes(src.rows, nstripes, SumStripes(src, &partial[0]));
+
+        Scalar s;
+        for( int i = 0; i < nstripes; i++ )
+            s += partial[i];
+        return s;
+    }
+
     const Mat* arrays[] = {&src, 0};
     uchar* ptrs[1];
     NAryMatIterator it(arrays, ptrs);
@@ -2039,4 +2039,83 @@ TEST(Core_minMaxIdx, regression_9207_2)
     EXPECT_EQ(14, maxIdx[1]);
 }
 
+// Large arrays are processed by stripes in parallel; the same arrays reshaped
+// into a single row go through the serial code, which gives the reference.
+TEST(Core_Arithm, parallel_stripes)
+{
+    const int rows = 1080, cols = 1920;
+    RNG& rng = theRNG();
+    Mat a(rows, cols, CV_8UC3), b(rows, cols, CV_8UC3), mask(rows, cols, CV_8U);
+    rng.fill(a, RNG::UNIFORM, 0, 256);
+    rng.fill(b, RNG::UNIFORM, 0, 256);
+    rng.fill(mask, RNG::UNIFORM, 0, 2);
+    Mat a1 = a.reshape(3, 1), b1 = b.reshape(3, 1), mask1 = mask.reshape(1, 1);
+
+    Mat dst, ref;
+    cv::add(a, b, dst);
+    cv::add(a1, b1, ref);
+    EXPECT_EQ(0, cvtest::norm(dst.reshape(3, 1), ref, NORM_INF));
+
+    dst = Mat::zeros(rows, cols, CV_16SC3);
+    ref = Mat::zeros(1, rows*cols, CV_16SC3);
+    cv::subtract(a, b, dst, mask, CV_16S);
+    cv::subtract(a1, b1, ref, mask1, CV_16S);
+    EXPECT_EQ(0, cvtest::norm(dst.reshape(3, 1), ref, NORM_INF));
+
+    cv::multiply(a, Scalar(0.5, 2, 3), dst, 1, CV_32F);
+    cv::multiply(a1, Scalar(0.5, 2, 3), ref, 1, CV_32F);
+    EXPECT_EQ(0, cvtest::norm(dst.reshape(3, 1), ref, NORM_INF));
+
+    cv::bitwise_xor(a, b, dst);
+    cv::bitwise_xor(a1, b1, ref);
+    EXPECT_EQ(0, cvtest::norm(dst.reshape(3, 1), ref, NORM_INF));
+
+    Mat af, af1;
+    a.convertTo(af, CV_32F, 1./255, -0.5);
+    a1.convertTo(af1, CV_32F, 1./255, -0.5);
+    EXPECT_EQ(0, cvtest::norm(af.reshape(3, 1), af1, NORM_INF));
+
+    std::vector<Mat> planes, planes1;
+    cv::split(af, planes);
+    cv::split(af1, planes1);
+    ASSERT_EQ(3u, planes.size());
+    for( int k = 0; k < 3; k++ )
+        EXPECT_EQ(0, cvtest::norm(planes[k].reshape(1, 1), planes1[k], NORM_INF));
+    std::swap(planes[0], planes[2]);
+    cv::merge(planes, dst);
+    cv::merge(std::vector<Mat>(planes1.rbegin(), planes1.rend()), ref);
+    EXPECT_EQ(0, cvtest::norm(dst.reshape(3, 1), ref, NORM_INF));
+
+    EXPECT_EQ(cv::sum(a1), cv::sum(a));
+    EXPECT_EQ(cv::countNonZero(mask1), cv::countNonZero(mask));
+    EXPECT_EQ(cv::norm(a1, NORM_L1), cv::norm(a, NORM_L1));
+    EXPECT_EQ(cv::norm(a1, b1, NORM_INF), cv::norm(a, b, NORM_INF));
+    EXPECT_EQ(cv::norm(a1, b1, NORM_L2SQR), cv::norm(a, b, NORM_L2SQR));
+    EXPECT_NEAR(cv::norm(af1, NORM_L2), cv::norm(af, NORM_L2), 1e-6*cv::norm(af1, NORM_L2));
+    Scalar s = cv::sum(af), s1 = cv::sum(af1);
+    for( int k = 0; k < 3; k++ )
+        EXPECT_NEAR(s1[k], s[k], 1e-6*rows*cols);
+
+    double minVal, maxVal, minVal1, maxVal1;
+    Point minLoc, maxLoc, minLoc1, maxLoc1;
+    Mat g = planes[1], g1 = g.reshape(1, 1), gmask = mask.clone();
+    gmask.rowRange(0, rows/2) = Scalar::all(0);
+    cv::minMaxLoc(g, &minVal, &maxVal, &minLoc, &maxLoc, gmask);
+    cv::minMaxLoc(g1, &minVal1, &maxVal1, &minLoc1, &maxLoc1, gmask.reshape(1, 1));
+    EXPECT_EQ(minVal1, minVal);
+    EXPECT_EQ(maxVal1, maxVal);
+    EXPECT_EQ(minLoc1.x, minLoc.y*cols + minLoc.x);
+    EXPECT_EQ(maxLoc1.x, maxLoc.y*cols + maxLoc.x);
+    EXPECT_GE(minLoc.y, rows/2);
+
+    // the results don't depend on the number of threads
+    int nthreads = getNumThreads();
+    setNumThreads(1);
+    Scalar s2 = cv::sum(af);
+    double n2 = cv::norm(af, NORM_L2);
+    setNumThreads(nthreads);
+    EXPECT_EQ(s2, s);
+    EXPECT_EQ(n2, cv::norm(af, NORM_L2));
+}
+
 }} // namespace
@@ -983,4 +983,133 @@ protected:
 TEST(Core_DFT, reverse) { Core_DXTReverseTest test(Core_DXTReverseTest::ModeDFT); test.safe_run(); }
 TEST(Core_DCT, reverse) { Core_DXTReverseTest test(Core_DXTReverseTest::ModeDCT); test.safe_run(); }
 
+// large 2D transforms go through the parallel row and blocked column passes;
+// a 2D transform must match two 1D row-wise passes over the transposed data
+static void dxtRowsTwice(const Mat& src, Mat& dst, int flags, bool dct)
+{
+    Mat t;
+    if (dct)
+        cv::dct(src, t, flags | DFT_ROWS);
+    else
+        cv::dft(src, t, flags | DFT_ROWS);
+    t = t.t();
+    if (dct)
+        cv::dct(t, dst, DFT_ROWS);
+    else
+        cv::dft(t, dst, DFT_ROWS);
+    dst = dst.t();
+}
+
+TEST(Core_DFT, large_2d)
+{
+    RNG& rng = theRNG();
+    const Size sizes[] = { Size(640, 480), Size(601, 333) };
+    for (int k = 0; k < 2; k++)
+    {
+        for (int depth = CV_32F; depth <= CV_64F; depth++)
+        {
+            double eps = depth == CV_32F ? 1e-3 : 1e-9;
+            Size sz = sizes[k];
+            Mat src(sz, CV_MAKETYPE(depth, 2)), dst, ref;
+            cvtest::randUni(rng, src, Scalar::all(-1.), Scalar::all(1.));
+            cv::dft(src, dst);
+            dxtRowsTwice(src, ref, 0, false);
+            EXPECT_LE(cvtest::norm(dst, ref, NORM_INF), eps*sz.area()) << sz << " depth " << depth;
+
+            Mat real(sz, depth), ccs, back;
+            cvtest::randUni(rng, real, Scalar::all(-1.), Scalar::all(1.));
+            cv::dft(real, dst, DFT_COMPLEX_OUTPUT);
+            dxtRowsTwice(real, ref, DFT_COMPLEX_OUTPUT, false);
+            EXPECT_LE(cvtest::norm(dst, ref, NORM_INF), eps*sz.area()) << sz << " depth " << depth;
+
+            cv::dft(real, ccs);
+            cv::dft(ccs, back, DFT_INVERSE | DFT_SCALE | DFT_REAL_OUTPUT);
+            EXPECT_LE(cvtest::norm(real, back, NORM_INF), eps) << sz << " depth " << depth;
+
+            // the second call reuses the cached plans and must give the same result
+            Mat ccs2;
+            cv::dft(real, ccs2);
+            EXPECT_EQ(0, cvtest::norm(ccs, ccs2, NORM_INF));
+        }
+    }
+}
+
+TEST(Core_DCT, large_2d)
+{
+    RNG& rng = theRNG();
+    for (int depth = CV_32F; depth <= CV_64F; depth++)
+    {
+        double eps = depth == CV_32F ? 1e-3 : 1e-9;
+        Mat src(480, 642, depth), dst, ref, back;
+        cvtest::randUni(rng, src, Scalar::all(-1.), Scalar::all(1.));
+        cv::dct(src, dst);
+        dxtRowsTwice(src, ref, 0, true);
+        EXPECT_LE(cvtest::norm(dst, ref, NORM_INF), eps) << "depth " << depth;
+        cv::idct(dst, back);
+        EXPECT_LE(cvtest::norm(src, back, NORM_INF), eps) << "depth " << depth;
+    }
+}
+
+// the power-of-2 part of the 32F complex transform has a dispatched implementation
+TEST(Core_DFT, complex_32f_radix2_4)
+{
+    RNG& rng = theRNG();
+    const int lengths[] = { 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 12, 40, 96, 320, 1536 };
+    for (size_t k = 0; k < sizeof(lengths)/sizeof(lengths[0]); k++)
+    {
+        for (int inv = 0; inv < 2; inv++)
+        {
+            int flags = DFT_ROWS | (inv ? DFT_INVERSE : 0);
+            Mat src(3, lengths[k], CV_32FC2), src64, dst, ref;
+            cvtest::randUni(rng, src, Scalar::all(-1.), Scalar::all(1.));
+            src.convertTo(src64, CV_64F);
+            cv::dft(src, dst, flags);
+            cv::dft(src64, ref, flags);
+            ref.convertTo(ref, CV_32F);
+            EXPECT_LE(cvtest::norm(dst, ref, NORM_L2), 1e-5*cvtest::norm(ref, NORM_L2))
+                << "n=" << lengths[k] << " inverse=" << inv;
+        }
+    }
+}
+
+class ConcurrentDFTInvoker : public ParallelLoopBody
+{
+public:
+    ConcurrentDFTInvoker(const Mat& _src, std::vector<Mat>& _dst, int _flags)
+        : src(_src), dst(_dst), flags(_flags) {}
+
+    void operator()(const Range& range) const
+    {
+        for (int i = range.start; i < range.end; i++)
+        {
+            Mat m = src.clone();
+            cv::dft(m, m, flags);
+            dst[i] = m;
+        }
+    }
+
+private:
+    const Mat& src;
+    std::vector<Mat>& dst;
+    int flags;
+};
+
+// all the transforms of the same length share one cached plan
+TEST(Core_DFT, concurrent_same_size)
+{
+    RNG& rng = theRNG();
+    Mat src(288, 600, CV_32F);
+    cvtest::randUni(rng, src, Scalar::all(0.), Scalar::all(255.));
+    const int flags[] = { 0, DFT_INVERSE | DFT_SCALE };
+    for (int k = 0; k < 2; k++)
+    {
+        Mat ref;
+        cv::dft(src, ref, flags[k]);
+        std::vector<Mat> dst(16);
+        parallel_for_(Range(0, (int)dst.size()), ConcurrentDFTInvoker(src, dst, flags[k]));
+        for (size_t i = 0; i < dst.size(); i++)
+            EXPECT_EQ(0, cvtest::norm(dst[i], ref, NORM_INF)) << "flags " << flags[k];
+    }
+}
+
 }} // namespace
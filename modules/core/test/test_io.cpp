@@ -1614,4 +1614,142 @@ TEST(Core_InputOutput, FileStorage_free_file_after_exception)
     ASSERT_EQ(0, std::remove(fileName.c_str()));
 }
 
+TEST(Core_InputOutput, FileStorage_lazy)
+{
+    const char* suffixes[] = { ".xml", ".yml", ".json" };
+    Mat m(17, 31, CV_32FC3), mi(5, 7, CV_16SC1);
+    randu(m, -1, 1);
+    randu(mi, -1000, 1000);
+
+    for (int base64 = 0; base64 < 2; base64++)
+    for (size_t i = 0; i < sizeof(suffixes)/sizeof(suffixes[0]); i++)
+    {
+        SCOPED_TRACE(cv::format("%s%s", suffixes[i], base64 ? " base64" : ""));
+        std::string fname = cv::tempfile(suffixes[i]);
+        {
+            FileStorage fs(fname, FileStorage::WRITE | (base64 ? FileStorage::BASE64 : 0));
+            fs << "int_value" << 42;
+            fs << "mat" << m;
+            fs << "str_value" << "a [string] with {brackets}: #not_a_comment";
+            fs << "seq" << "[" << 1 << 2.5 << "three" << "]";
+            fs << "map" << "{" << "a" << 1 << "inner" << "{" << "b" << mi << "}" << "}";
+            fs << "last" << "value";
+        }
+
+        FileStorage ref(fname, FileStorage::READ);
+        ASSERT_TRUE(ref.isOpened());
+
+        {
+            FileStorage fs(fname, FileStorage::READ | FileStorage::LAZY);
+            ASSERT_TRUE(fs.isOpened());
+
+            Mat m2, mi2;
+            fs["map"]["inner"]["b"] >> mi2;
+            EXPECT_EQ(0, cvtest::norm(mi, mi2, NORM_INF));
+            EXPECT_EQ("value", (std::string)fs["last"]);
+            EXPECT_TRUE(fs["missing"].empty());
+            fs["mat"] >> m2;
+            EXPECT_EQ(0, cvtest::norm(m, m2, NORM_INF));
+            EXPECT_EQ(42, (int)fs["int_value"]);
+            EXPECT_EQ((std::string)ref["str_value"], (std::string)fs["str_value"]);
+            ASSERT_TRUE(fs["seq"].isSeq());
+            EXPECT_EQ("three", (std::string)fs["seq"][2]);
+        }
+
+        {
+            FileStorage fs(fname, FileStorage::READ | FileStorage::LAZY);
+            FileNode root = fs.root(), refroot = ref.root();
+            ASSERT_EQ(refroot.size(), root.size());
+            FileNodeIterator it = root.begin(), refit = refroot.begin();
+            for (; refit != refroot.end(); ++it, ++refit)
+            {
+                EXPECT_EQ((*refit).name(), (*it).name());
+                EXPECT_EQ((*refit).type(), (*it).type());
+            }
+            EXPECT_EQ(1.0, (double)fs["map"]["a"]);
+            EXPECT_EQ((int)fs["seq"][0], 1);
+        }
+        remove(fname.c_str());
+    }
+}
+
+class LazyReadBody : public ParallelLoopBody
+{
+public:
+    LazyReadBody(const FileStorage& fs_, const std::vector<Mat>& mats_, int shift_, std::vector<int>& ok_)
+        : fs(fs_), mats(mats_), shift(shift_), ok(ok_) {}
+
+    void operator()(const Range& r) const
+    {
+        int nkeys = (int)mats.size();
+        for (int j = r.start; j < r.end; j++)
+        {
+            int i = (j * 7 + shift) % nkeys;
+            Mat m;
+            fs[cv::format("mat_%d", i)] >> m;
+            ok[j] = m.size() == mats[i].size() && cvtest::norm(m, mats[i], NORM_INF) == 0 &&
+                    (std::string)fs[cv::format("str_%d", i)] == cv::format("value %d", i) &&
+                    fs[cv::format("missing_%d", i)].empty();
+        }
+    }
+
+private:
+    const FileStorage& fs;
+    const std::vector<Mat>& mats;
+    int shift;
+    std::vector<int>& ok;
+};
+
+TEST(Core_InputOutput, FileStorage_lazy_parallel_read)
+{
+    const int nkeys = 64;
+    std::vector<Mat> mats(nkeys);
+    std::string fname = cv::tempfile(".yml");
+    {
+        FileStorage fs(fname, FileStorage::WRITE);
+        for (int i = 0; i < nkeys; i++)
+        {
+            mats[i].create(8 + i % 5, 9, CV_32FC1);
+            randu(mats[i], -1, 1);
+            fs << cv::format("mat_%d", i) << mats[i];
+            fs << cv::format("str_%d", i) << cv::format("value %d", i);
+        }
+    }
+
+    for (int iter = 0; iter < 5; iter++)
+    {
+        FileStorage fs(fname, FileStorage::READ | FileStorage::LAZY);
+        ASSERT_TRUE(fs.isOpened());
+
+        // every key is read twice, so the lookups race with the parsing of the same node
+        std::vector<int> ok(nkeys * 2, 0);
+        parallel_for_(Range(0, nkeys * 2), LazyReadBody(fs, mats, iter, ok));
+        for (int j = 0; j < nkeys * 2; j++)
+            EXPECT_EQ(1, ok[j]) << "j=" << j;
+    }
+    remove(fname.c_str());
+}
+
+TEST(Core_InputOutput, FileStorage_lazy_fallback)
+{
+    // several streams and duplicated keys are handled by the regular parser
+    std::string fname = cv::tempfile(".yml");
+    {
+        std::ofstream f(fname.c_str());
+        f << "%YAML:1.0\n---\na: 1\nb: [ 1,\n   2 ]\n...\n---\nc: 3\n";
+    }
+    {
+        FileStorage fs(fname, FileStorage::READ | FileStorage::LAZY);
+        EXPECT_EQ(1, (int)fs["a"]);
+        EXPECT_EQ(3, (int)fs["c"]);
+        EXPECT_EQ(1, (int)fs.root(1).size());
+    }
+    {
+        std::ofstream f(fname.c_str());
+        f << "%YAML:1.0\n---\na: 1\na: 2\n";
+    }
+    EXPECT_ANY_THROW(FileStorage(fname, FileStorage::READ | FileStorage::LAZY));
+    remove(fname.c_str());
+}
+
 }} // namespace
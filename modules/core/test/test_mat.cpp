@@ -3,6 +3,10 @@
 // of this distribution and at http://opencv.org/license.html.
 #include "test_precomp.hpp"
 
+#ifdef CV_CXX11
+#include <thread>
+#endif
+
 namespace opencv_test { namespace {
 
 class Core_ReduceTest : public cvtest::BaseTest
@@ -1760,4 +1764,97 @@ TEST(Mat_, template_based_ptr)
 
 #endif
 
+TEST(Mat, pool_allocator)
+{
+    MatAllocator* pool = Mat::getPoolAllocator();
+    BufferPoolController* c = pool->getBufferPoolController();
+    size_t oldMaxReservedSize = c->getMaxReservedSize();
+    c->setMaxReservedSize(1 << 24);
+    c->freeAllReservedBuffers();
+    EXPECT_EQ(0u, c->getReservedSize());
+
+    {
+        MatAllocatorScope scope(pool);
+        EXPECT_EQ(pool, Mat::getDefaultAllocator());
+
+        Mat m(480, 640, CV_8UC3);
+        EXPECT_EQ(pool, m.u->currAllocator);
+        const uchar* data = m.data;
+        m.release();
+        EXPECT_GE(c->getReservedSize(), (size_t)480*640*3);
+
+        // a buffer of the same size class is reused
+        Mat m2(481, 640, CV_8UC3, Scalar::all(1));
+        EXPECT_EQ(data, m2.data);
+        EXPECT_EQ(0u, c->getReservedSize());
+        EXPECT_EQ(481*640*3, countNonZero(m2.reshape(1)));
+
+        {
+            MatAllocatorScope nested(Mat::getStdAllocator());
+            Mat m3(10, 10, CV_32F);
+            EXPECT_EQ(Mat::getStdAllocator(), m3.u->currAllocator);
+        }
+        EXPECT_EQ(pool, Mat::getDefaultAllocator());
+
+        // buffers larger than 1/8 of the limit are not kept
+        Mat big(1024, 1024, CV_32FC3);
+        big.release();
+        EXPECT_EQ(0u, c->getReservedSize());
+    }
+    EXPECT_NE(pool, Mat::getDefaultAllocator());
+    // m2 has been returned to the pool
+    EXPECT_GT(c->getReservedSize(), 0u);
+
+    c->setMaxReservedSize(0);
+    EXPECT_EQ(0u, c->getReservedSize());
+    c->setMaxReservedSize(oldMaxReservedSize);
+}
+
+#ifdef CV_CXX11
+TEST(Mat, pool_allocator_cross_thread)
+{
+    MatAllocator* pool = Mat::getPoolAllocator();
+    BufferPoolController* c = pool->getBufferPoolController();
+    size_t oldMaxReservedSize = c->getMaxReservedSize();
+    c->setMaxReservedSize(1 << 24);
+    c->freeAllReservedBuffers();
+
+    {
+        MatAllocatorScope scope(pool);
+
+        // a buffer released by another thread returns to the pool of the allocating thread
+        Mat m(480, 640, CV_8UC3);
+        const uchar* data = m.data;
+        std::thread consumer([&m]() { m.release(); });
+        consumer.join();
+        EXPECT_GE(c->getReservedSize(), (size_t)480*640*3);
+        Mat m2(480, 640, CV_8UC3);
+        EXPECT_EQ(data, m2.data);
+    }
+
+    // the pool of an exited thread is freed
+    c->freeAllReservedBuffers();
+    std::thread worker([pool]() {
+        MatAllocatorScope scope(pool);
+        Mat m(100, 100, CV_32F);
+    });
+    worker.join();
+    EXPECT_EQ(0u, c->getReservedSize());
+
+    // the limit applies to all pools together
+    c->setMaxReservedSize(1 << 20);
+    std::vector<Mat> mats;
+    {
+        MatAllocatorScope scope(pool);
+        for (int i = 0; i < 32; i++)
+            mats.push_back(Mat(256, 256, CV_8U));
+    }
+    std::thread releaser([&mats]() { mats.clear(); });
+    releaser.join();
+    EXPECT_LE(c->getReservedSize(), (size_t)1 << 20);
+
+    c->setMaxReservedSize(oldMaxReservedSize);
+}
+#endif
+
 }} // namespace
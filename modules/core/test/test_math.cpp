@@ -3065,6 +3065,52 @@ TEST(Core_Pow, special)
     }
 }
 
+TEST(Core_GEMM, packed_accuracy)
+{
+    // sizes are large enough to go through the blocked multi-threaded implementation
+    const int sizes[][3] = { {67, 129, 45}, {128, 300, 513}, {9, 1000, 17}, {301, 11, 260} };
+    RNG& rng = theRNG();
+
+    for( int depth = CV_32F; depth <= CV_64F; depth++ )
+    {
+        double eps = depth == CV_32F ? 1e-5 : 1e-12;
+        for( size_t i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++ )
+        {
+            int M = sizes[i][0], N = sizes[i][1], K = sizes[i][2];
+            for( int flags = 0; flags < 8; flags++ )
+            {
+                SCOPED_TRACE(cv::format("depth=%d M=%d N=%d K=%d flags=%d", depth, M, N, K, flags));
+                Mat A = (flags & GEMM_1_T) ? Mat(K, M, depth) : Mat(M, K, depth);
+                Mat B = (flags & GEMM_2_T) ? Mat(N, K, depth) : Mat(K, N, depth);
+                Mat C = (flags & GEMM_3_T) ? Mat(N, M, depth) : Mat(M, N, depth);
+                // operands are not continuous
+                Mat bigA(A.rows + 2, A.cols + 3, depth);
+                A = bigA(Rect(1, 1, A.cols, A.rows));
+                rng.fill(A, RNG::UNIFORM, -1, 1);
+                rng.fill(B, RNG::UNIFORM, -1, 1);
+                rng.fill(C, RNG::UNIFORM, -1, 1);
+
+                Mat D, ref;
+                cv::gemm(A, B, 0.5, C, -2., D, flags);
+                cvtest::gemm(A, B, 0.5, C, -2., ref, flags);
+                EXPECT_LE(cvtest::norm(D, ref, NORM_L2 | NORM_RELATIVE), eps);
+
+                cv::gemm(A, B, 1., noArray(), 0., D, flags);
+                cvtest::gemm(A, B, 1., Mat(), 0., ref, flags);
+                EXPECT_LE(cvtest::norm(D, ref, NORM_L2 | NORM_RELATIVE), eps);
+
+                if( !(flags & GEMM_3_T) )
+                {
+                    // in-place update of C
+                    cvtest::gemm(A, B, 2., C, 1., ref, flags);
+                    cv::gemm(A, B, 2., C, 1., C, flags);
+                    EXPECT_LE(cvtest::norm(C, ref, NORM_L2 | NORM_RELATIVE), eps);
+                }
+            }
+        }
+    }
+}
+
 TEST(Core_Cholesky, accuracy64f)
 {
     const int n = 5;
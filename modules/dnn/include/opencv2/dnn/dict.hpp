@@ -141,6 +141,12 @@ public:
     template<typename T>
     const T &set(const String &key, const T &value);
 
+    //! Returns an iterator to the first key-value pair of the dictionary.
+    std::map<String, DictValue>::const_iterator begin() const;
+
+    //! Returns an iterator past the last key-value pair of the dictionary.
+    std::map<String, DictValue>::const_iterator end() const;
+
     friend std::ostream &operator<<(std::ostream &stream, const Dict &dict);
 };
 
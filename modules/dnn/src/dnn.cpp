@@ -43,17 +43,34 @@
 #include "op_halide.hpp"
 #include "op_inf_engine.hpp"
 #include "halide_scheduler.hpp"
+#include "layers/layers_common.hpp"
 #include <set>
 #include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <iterator>
 #include <numeric>
+#include <fstream>
 #include <opencv2/dnn/shape_utils.hpp>
 #include <opencv2/imgproc.hpp>
+#include <opencv2/core/hal/intrin.hpp>
 
 #include <opencv2/core/utils/configuration.private.hpp>
 
+#if defined __unix__ || defined __APPLE__
+#define CV_DNN_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef CV_CXX11
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#endif
+
 namespace cv {
 namespace dnn {
 CV__DNN_EXPERIMENTAL_NS_BEGIN
@@ -82,6 +99,194 @@ namespace
     };
 }
 
+// Preprocessing for blobFromImages. Every row of the output blob is computed
+// at once: mean subtraction, scaling, swapping of channels and conversion from
+// interleaved to planar layout.
+class BlobFromImagesInvoker : public ParallelLoopBody
+{
+public:
+    const std::vector<Mat>* images_;
+    Mat* blob_;
+    float mean_[4];
+    float scale_;
+    int srcChannel_[4];
+    int nstripes_;
+
+    BlobFromImagesInvoker() : images_(0), blob_(0), scale_(1.f), nstripes_(0) {}
+
+    class ResizeInvoker : public ParallelLoopBody
+    {
+    public:
+        ResizeInvoker(std::vector<Mat>& images, Size size, bool crop)
+            : images_(images), size_(size), crop_(crop) {}
+
+        void operator()(const Range& r) const
+        {
+            for (int i = r.start; i < r.end; i++)
+            {
+                Mat& image = images_[i];
+                Size imgSize = image.size();
+                if (imgSize == size_)
+                    continue;
+                if (crop_)
+                {
+                    float resizeFactor = std::max(size_.width / (float)imgSize.width,
+                                                  size_.height / (float)imgSize.height);
+                    Mat resized;
+                    cv::resize(image, resized, Size(), resizeFactor, resizeFactor, INTER_LINEAR);
+                    Rect roi(Point(0.5 * (resized.cols - size_.width),
+                                   0.5 * (resized.rows - size_.height)),
+                             size_);
+                    image = resized(roi);
+                }
+                else
+                {
+                    Mat resized;
+                    cv::resize(image, resized, size_, 0, 0, INTER_LINEAR);
+                    image = resized;
+                }
+            }
+        }
+
+        std::vector<Mat>& images_;
+        Size size_;
+        bool crop_;
+    };
+
+    static void resize(std::vector<Mat>& images, Size size, bool crop)
+    {
+        ResizeInvoker p(images, size, crop);
+        // a single image is resized in parallel by cv::resize itself
+        if (images.size() > 1)
+            parallel_for_(Range(0, (int)images.size()), p);
+        else
+            p(Range(0, 1));
+        for (size_t i = 0; i < images.size(); i++)
+            CV_Assert(images[i].size() == size);
+    }
+
+    static void run(const std::vector<Mat>& images, Mat& blob, const Scalar& mean,
+                    double scale, bool swapRB)
+    {
+        BlobFromImagesInvoker p;
+        p.images_ = &images;
+        p.blob_ = &blob;
+        p.scale_ = (float)scale;
+        for (int c = 0; c < 4; c++)
+        {
+            p.mean_[c] = (float)mean[c];
+            p.srcChannel_[c] = c;
+        }
+        if (swapRB)
+            std::swap(p.srcChannel_[0], p.srcChannel_[2]);
+
+        size_t nrows = images.size()*blob.size[2];
+        p.nstripes_ = (int)std::max(std::min(nrows, (size_t)getNumThreads()*4), (size_t)1);
+        parallel_for_(Range(0, p.nstripes_), p, p.nstripes_);
+    }
+
+    void operator()(const Range& r) const
+    {
+        int nch = blob_->size[1], height = blob_->size[2], width = blob_->size[3];
+        size_t nrows = images_->size()*height;
+        size_t stripeSize = (nrows + nstripes_ - 1)/nstripes_;
+        size_t rowStart = r.start*stripeSize, rowEnd = std::min(r.end*stripeSize, nrows);
+
+        for (size_t row = rowStart; row < rowEnd; row++)
+        {
+            int i = (int)(row / height), y = (int)(row % height);
+            const Mat& image = (*images_)[i];
+            float* dst[4];
+            for (int c = 0; c < nch; c++)
+                dst[c] = blob_->ptr<float>(i, c) + (size_t)y*width;
+
+            if (image.depth() == CV_8U)
+                convertRow(image.ptr<uchar>(y), dst, width, nch);
+            else
+                convertRow(image.ptr<float>(y), dst, width, nch);
+        }
+    }
+
+    template<typename T>
+    void convertRow(const T* src, float** dst, int width, int nch) const
+    {
+        int x = 0;
+#if CV_SIMD128
+        x = convertRowSIMD(src, dst, width, nch);
+#endif
+        for (; x < width; x++)
+        {
+            for (int c = 0; c < nch; c++)
+            {
+                int k = srcChannel_[c];
+                dst[c][x] = ((float)src[x*nch + k] - mean_[k])*scale_;
+            }
+        }
+    }
+
+#if CV_SIMD128
+    int convertRowSIMD(const uchar* src, float** dst, int width, int nch) const
+    {
+        v_float32x4 vscale = v_setall_f32(scale_);
+        int x = 0;
+        for (; x <= width - 16; x += 16)
+        {
+            v_uint8x16 v[4];
+            if (nch == 1)
+                v[0] = v_load(src + x);
+            else if (nch == 3)
+                v_load_deinterleave(src + x*3, v[0], v[1], v[2]);
+            else
+                v_load_deinterleave(src + x*4, v[0], v[1], v[2], v[3]);
+
+            for (int c = 0; c < nch; c++)
+            {
+                int k = srcChannel_[c];
+                v_float32x4 vmean = v_setall_f32(mean_[k]);
+                v_uint16x8 w0, w1;
+                v_uint32x4 q[4];
+                v_expand(v[k], w0, w1);
+                v_expand(w0, q[0], q[1]);
+                v_expand(w1, q[2], q[3]);
+                for (int j = 0; j < 4; j++)
+                    v_store(dst[c] + x + j*4, (v_cvt_f32(v_reinterpret_as_s32(q[j])) - vmean)*vscale);
+            }
+        }
+        return x;
+    }
+
+    int convertRowSIMD(const float* src, float** dst, int width, int nch) const
+    {
+        v_float32x4 vscale = v_setall_f32(scale_);
+        const unsigned* usrc = (const unsigned*)src;
+        int x = 0;
+        for (; x <= width - 4; x += 4)
+        {
+            v_float32x4 v[4];
+            if (nch == 1)
+                v[0] = v_load(src + x);
+            else
+            {
+                v_uint32x4 u[4];
+                if (nch == 3)
+                    v_load_deinterleave(usrc + x*3, u[0], u[1], u[2]);
+                else
+                    v_load_deinterleave(usrc + x*4, u[0], u[1], u[2], u[3]);
+                for (int k = 0; k < nch; k++)
+                    v[k] = v_reinterpret_as_f32(u[k]);
+            }
+
+            for (int c = 0; c < nch; c++)
+            {
+                int k = srcChannel_[c];
+                v_store(dst[c] + x, (v[k] - v_setall_f32(mean_[k]))*vscale);
+            }
+        }
+        return x;
+    }
+#endif
+};
+
 Mat blobFromImage(InputArray image, double scalefactor, const Size& size,
                   const Scalar& mean, bool swapRB, bool crop)
 {
@@ -115,81 +320,30 @@ void blobFromImages(InputArrayOfArrays images_, OutputArray blob_, double scalef
     std::vector<Mat> images;
     images_.getMatVector(images);
     CV_Assert(!images.empty());
-    for (int i = 0; i < images.size(); i++)
-    {
-        Size imgSize = images[i].size();
-        if (size == Size())
-            size = imgSize;
-        if (size != imgSize)
-        {
-            if(crop)
-            {
-              float resizeFactor = std::max(size.width / (float)imgSize.width,
-                                            size.height / (float)imgSize.height);
-              resize(images[i], images[i], Size(), resizeFactor, resizeFactor, INTER_LINEAR);
-              Rect crop(Point(0.5 * (images[i].cols - size.width),
-                              0.5 * (images[i].rows - size.height)),
-                        size);
-              images[i] = images[i](crop);
-            }
-            else
-              resize(images[i], images[i], size, 0, 0, INTER_LINEAR);
-        }
-        if(images[i].depth() == CV_8U)
-            images[i].convertTo(images[i], CV_32F);
-        Scalar mean = mean_;
-        if (swapRB)
-            std::swap(mean[0], mean[2]);
-
-        images[i] -= mean;
-        images[i] *= scalefactor;
-    }
+    if (size == Size())
+        size = images[0].size();
 
-    size_t i, nimages = images.size();
-    Mat image0 = images[0];
-    int nch = image0.channels();
-    CV_Assert(image0.dims == 2);
-    Mat image;
-    if (nch == 3 || nch == 4)
+    int nimages = (int)images.size(), nch = images[0].channels();
+    CV_Assert(nch == 1 || nch == 3 || nch == 4);
+    for (int i = 0; i < nimages; i++)
     {
-        int sz[] = { (int)nimages, nch, image0.rows, image0.cols };
-        blob_.create(4, sz, CV_32F);
-        Mat blob = blob_.getMat();
-        Mat ch[4];
-
-        for( i = 0; i < nimages; i++ )
-        {
-            image = images[i];
-            CV_Assert(image.depth() == CV_32F);
-            nch = image.channels();
-            CV_Assert(image.dims == 2 && (nch == 3 || nch == 4));
-            CV_Assert(image.size() == image0.size());
-
-            for( int j = 0; j < nch; j++ )
-                ch[j] = Mat(image.rows, image.cols, CV_32F, blob.ptr((int)i, j));
-            if(swapRB)
-                std::swap(ch[0], ch[2]);
-            split(image, ch);
-        }
+        const Mat& image = images[i];
+        CV_Assert(image.dims == 2, image.channels() == nch,
+                  image.depth() == CV_8U || image.depth() == CV_32F);
     }
-    else
-    {
-       CV_Assert(nch == 1);
-       int sz[] = { (int)nimages, 1, image0.rows, image0.cols };
-       blob_.create(4, sz, CV_32F);
-       Mat blob = blob_.getMat();
 
-       for( i = 0; i < nimages; i++ )
-       {
-           Mat image = images[i];
-           CV_Assert(image.depth() == CV_32F);
-           nch = image.channels();
-           CV_Assert(image.dims == 2 && (nch == 1));
-           CV_Assert(image.size() == image0.size());
+    // Images are resized concurrently (if there are several of them) and then
+    // converted to the blob directly without intermediate floating-point copies.
+    BlobFromImagesInvoker::resize(images, size, crop);
 
-           image.copyTo(Mat(image.rows, image.cols, CV_32F, blob.ptr((int)i, 0)));
-       }
-    }
+    int sz[] = { nimages, nch, size.height, size.width };
+    blob_.create(4, sz, CV_32F);
+    Mat blob = blob_.getMat();
+
+    Scalar mean = mean_;
+    if (swapRB)
+        std::swap(mean[0], mean[2]);
+    BlobFromImagesInvoker::run(images, blob, mean, scalefactor, swapRB && nch >= 3);
 }
 
 void imagesFromBlob(const cv::Mat& blob_, OutputArrayOfArrays images_)
@@ -372,6 +526,8 @@ struct LayerData
     bool skip;
 
     int flag;
+    // Copies of the layer data share the mutex, so a layer processes one inference request at a time.
+    Mutex forwardMutex;
 
     Ptr<Layer> getLayerInstance()
     {
@@ -409,6 +565,11 @@ struct DataLayer : public Layer
         outNames.assign(names.begin(), names.end());
     }
 
+    const std::vector<String>& getNames() const
+    {
+        return outNames;
+    }
+
     bool getMemoryShapes(const std::vector<MatShape> &inputs,
                          const int requiredOutputs,
                          std::vector<MatShape> &outputs,
@@ -423,9 +584,17 @@ private:
     std::vector<String> outNames;
 };
 
+// Blobs are either allocated one by one and reused greedily when all their consumers
+// are computed, or planned in advance and packed into a single memory arena.
+// In the latter case every allocated blob gets a lifetime (from the layer which produces
+// it to the last layer which consumes it) and blobs with intersecting lifetimes are placed
+// at not intersecting offsets. The arena is allocated and the blobs are bound to it by
+// allocateArena() after all the layers have been processed.
 struct BlobManager
 {
 public:
+    BlobManager() : useArena(false), step(0), plannedTotal(0) {}
+
     // Increase references counter to layer output.
     void addReference(const LayerPin& lp)
     {
@@ -487,6 +656,11 @@ public:
         CV_Assert(refIt != refCounter.end());
         CV_Assert(refIt->second > 0);
         refIt->second -= 1;
+
+        // the memory is not used after the current layer
+        std::map<LayerPin, ArenaHost>::iterator hostIt;
+        if (refIt->second == 0 && (hostIt = arenaHosts.find(refIt->first)) != arenaHosts.end())
+            hostIt->second.end = step;
     }
 
     void releaseReferences(const std::vector<LayerPin>& pins)
@@ -499,6 +673,16 @@ public:
 
     void reuseOrCreate(const MatShape& shape, const LayerPin& lp, Mat& dst, bool forceCreate)
     {
+        // Network inputs are set before allocation and keep their memory.
+        if (useArena && !forceCreate && lp.lid != 0)
+        {
+            CV_Assert(reuseMap.find(lp) == reuseMap.end());
+            reuseMap[lp] = lp;
+            arenaHosts[lp] = ArenaHost(total(shape), step);
+            arenaBlobs.push_back(ArenaBlob(&dst, shape, lp));
+            return;
+        }
+
         if (!DNN_DISABLE_MEMORY_OPTIMIZATIONS && !forceCreate)
         {
             Mat bestBlob;
@@ -543,13 +727,16 @@ public:
         }
     }
 
+    // View layers (see Impl::isViewLayer) share memory of their inputs
+    // even if there are other consumers of the same blobs.
     void allocateBlobsForLayer(LayerData &ld, const LayerShapes& layerShapes,
                                std::vector<LayerPin>& pinsForInternalBlobs,
-                               bool forceCreate = false)
+                               bool forceCreate = false, bool isView = false)
     {
         CV_TRACE_FUNCTION();
 
         pinsForInternalBlobs.clear();
+        step = ld.id;
 
         std::vector<Mat>& outputBlobs = ld.outputBlobs,
                 &internalBlobs = ld.internals;
@@ -562,16 +749,38 @@ public:
 
         CV_Assert(ld.requiredOutputs.size() <= outShapes.size());
 
-        // Check that layer could work in-place.
-        bool inPlace = false;
-        if (layerShapes.supportInPlace)
+        // Check that layer could work in-place. Layers with several inputs
+        // (i.e. element-wise operations) may reuse memory of one of the inputs
+        // if they produce a single output. inputIdx[i] is an index of the input
+        // which memory is used by the i-th output or -1.
+        std::vector<int> inputIdx(outShapes.size(), -1);
+        if (isView)
+        {
+            CV_Assert(ld.inputBlobs.size() == 1 || ld.inputBlobs.size() == outShapes.size());
+            for (size_t i = 0; i < outShapes.size(); i++)
+                inputIdx[i] = ld.inputBlobs.size() == 1 ? 0 : (int)i;
+        }
+        else if (layerShapes.supportInPlace)
         {
             if (ld.inputBlobs.size() == 1)
             {
-                // Get number of references to the input memory.
-                int numRef = numReferences(ld.inputBlobsId[0]);
                 // If current layer is one and only customer of this blob.
-                inPlace = numRef == 1;
+                if (numReferences(ld.inputBlobsId[0]) == 1)
+                    std::fill(inputIdx.begin(), inputIdx.end(), 0);
+            }
+            else if (!ld.inputBlobs.empty() && outShapes.size() == 1)
+            {
+                // Element-wise operations may overwrite either of the first two inputs.
+                // The input which is computed later is preferred: its producer then
+                // writes to the output directly (see fusion with Eltwise layer).
+                int ncandidates = ld.type == "Eltwise" ? std::min((int)ld.inputBlobs.size(), 2) : 1;
+                for (int k = 0; k < ncandidates; k++)
+                {
+                    if (numReferences(ld.inputBlobsId[k]) == 1 &&
+                        (k == 0 || layerShapes.in[k] == outShapes[0]) &&
+                        (inputIdx[0] < 0 || ld.inputBlobsId[k].lid > ld.inputBlobsId[inputIdx[0]].lid))
+                        inputIdx[0] = k;
+                }
             }
         }
 
@@ -609,11 +818,21 @@ public:
                 if (total(shapes[index]))
                 {
                     LayerPin blobPin(ld.id, index);
-                    if (index < outShapes.size() && inPlace)
+                    if (index < outShapes.size() && inputIdx[index] >= 0)
                     {
-                        CV_Assert(ld.inputBlobs[0]->total() == total(shapes[index]));
-                        ld.outputBlobs[index] = ld.inputBlobs[0]->reshape(1, shapes[index]);
-                        reuse(ld.inputBlobsId[0], blobPin);
+                        int k = inputIdx[index];
+                        reuse(ld.inputBlobsId[k], blobPin);
+                        const LayerPin& memHost = reuseMap[blobPin];
+                        if (arenaHosts.find(memHost) != arenaHosts.end())
+                        {
+                            CV_Assert(arenaHosts[memHost].total == (size_t)total(shapes[index]));
+                            arenaBlobs.push_back(ArenaBlob(&ld.outputBlobs[index], shapes[index], memHost));
+                        }
+                        else
+                        {
+                            CV_Assert(ld.inputBlobs[k]->total() == total(shapes[index]));
+                            ld.outputBlobs[index] = ld.inputBlobs[k]->reshape(1, shapes[index]);
+                        }
                     }
                     else
                         reuseOrCreate(shapes[index], blobPin, *blobs[index], forceCreate);
@@ -622,14 +841,135 @@ public:
         }
     }
 
+    // Assigns offsets to the planned blobs, allocates the arena and binds the blobs to it.
+    void allocateArena()
+    {
+        CV_TRACE_FUNCTION();
+
+        plannedTotal = 0;
+        if (arenaBlobs.empty())
+        {
+            arena.release();
+            return;
+        }
+
+        // Hosts are placed from the largest to the smallest one at the lowest offset
+        // which doesn't intersect with the already placed hosts that are alive
+        // at the same time. Placed hosts are kept sorted by offsets.
+        std::vector<ArenaHost*> hosts, placed;
+        std::map<LayerPin, ArenaHost>::iterator it;
+        for (it = arenaHosts.begin(); it != arenaHosts.end(); ++it)
+            hosts.push_back(&it->second);
+        std::stable_sort(hosts.begin(), hosts.end(), ArenaHost::greaterSize);
+
+        size_t arenaSize = 0;
+        for (size_t i = 0; i < hosts.size(); i++)
+        {
+            ArenaHost& host = *hosts[i];
+            size_t offset = 0, pos = 0;
+            for (size_t j = 0; j < placed.size(); j++)
+            {
+                const ArenaHost& other = *placed[j];
+                if (other.offset >= offset + host.total)
+                    break;
+                if (other.end >= host.start && host.end >= other.start)
+                    offset = std::max(offset, alignSize(other.offset + other.total, ARENA_ALIGN));
+            }
+            while (pos < placed.size() && placed[pos]->offset <= offset)
+                pos++;
+            host.offset = offset;
+            placed.insert(placed.begin() + pos, &host);
+            arenaSize = std::max(arenaSize, offset + host.total);
+        }
+        plannedTotal = arenaSize;
+
+        // A single row Mat can't address more than INT_MAX elements. Such huge
+        // networks get a separate buffer per host instead (without the arena the
+        // memory is still shared by the blobs of the same host).
+        if (arenaSize > (size_t)INT_MAX)
+        {
+            arena.release();
+            std::map<LayerPin, Mat> hostMats;
+            plannedTotal = 0;
+            for (it = arenaHosts.begin(); it != arenaHosts.end(); ++it)
+                plannedTotal += it->second.total;
+            for (size_t i = 0; i < arenaBlobs.size(); i++)
+            {
+                const ArenaBlob& blob = arenaBlobs[i];
+                Mat& hostMat = hostMats[blob.host];
+                if (hostMat.empty())
+                {
+                    size_t hostTotal = arenaHosts[blob.host].total;
+                    CV_Assert(hostTotal <= (size_t)INT_MAX);
+                    hostMat.create(1, (int)hostTotal, CV_32F);
+                }
+                *blob.dst = hostMat.colRange(0, (int)total(blob.shape)).reshape(1, blob.shape);
+            }
+            arenaBlobs.clear();
+            return;
+        }
+
+        // The arena only grows: if the input shape is changed, the blobs are placed
+        // to the existing memory when it's enough, so switching between several input
+        // resolutions doesn't allocate memory once the largest one has been processed.
+        if (arena.total() < arenaSize)
+        {
+            arena.release();
+            arena.create(1, (int)arenaSize, CV_32F);
+        }
+        for (size_t i = 0; i < arenaBlobs.size(); i++)
+        {
+            const ArenaBlob& blob = arenaBlobs[i];
+            size_t offset = arenaHosts[blob.host].offset, len = total(blob.shape);
+            *blob.dst = arena.colRange((int)offset, (int)(offset + len)).reshape(1, blob.shape);
+        }
+        arenaBlobs.clear();
+    }
+
     // Clear internal state. Calls before an every reallocation.
-    void reset()
+    void reset(bool planArena = false)
     {
         CV_TRACE_FUNCTION();
 
         refCounter.clear();
         reuseMap.clear();
         memHosts.clear();
+        arenaHosts.clear();
+        arenaBlobs.clear();
+        plannedTotal = 0;
+        useArena = planArena && !DNN_DISABLE_MEMORY_OPTIMIZATIONS;
+    }
+
+    // The arena the planned blobs are bound to (empty if the blobs got a separate
+    // buffer per host) and the number of its elements used by the current plan.
+    const Mat& arenaMemory() const { return arena; }
+    size_t plannedSize() const { return plannedTotal; }
+
+    // Takes a plan of planSize elements computed before (see Net::Impl::AllocationPlan)
+    // instead of allocating the blobs one by one. The network inputs keep their memory.
+    const Mat& usePlan(size_t planSize, const std::vector<Mat>& inputs)
+    {
+        reset(true);
+        for (size_t i = 0; i < inputs.size(); i++)
+            addHost(LayerPin(0, (int)i), inputs[i]);
+        if (arena.total() < planSize)
+        {
+            arena.release();
+            arena.create(1, (int)planSize, CV_32F);
+        }
+        plannedTotal = planSize;
+        return arena;
+    }
+
+    // Number of elements which the allocated blobs occupy: the planned part
+    // of the arena plus the blobs allocated one by one.
+    size_t allocatedTotal() const
+    {
+        size_t sum = plannedTotal;
+        std::map<LayerPin, Mat>::const_iterator it;
+        for (it = memHosts.begin(); it != memHosts.end(); ++it)
+            sum += it->second.total();
+        return sum;
     }
 
 private:
@@ -641,18 +981,55 @@ private:
         memHosts[lp] = mat;
     }
 
+    // offsets inside the arena are aligned to 64 bytes
+    enum { ARENA_ALIGN = 16 };
+
+    struct ArenaHost
+    {
+        ArenaHost(size_t total_ = 0, int start_ = 0)
+            : total(total_), offset(0), start(start_), end(INT_MAX) {}
+
+        static bool greaterSize(const ArenaHost* a, const ArenaHost* b)
+        {
+            return a->total > b->total;
+        }
+
+        size_t total, offset;
+        // ids of the first and the last layers which use the memory
+        int start, end;
+    };
+
+    struct ArenaBlob
+    {
+        ArenaBlob(Mat* dst_, const MatShape& shape_, const LayerPin& host_)
+            : dst(dst_), shape(shape_), host(host_) {}
+
+        Mat* dst;
+        MatShape shape;
+        LayerPin host;
+    };
+
     std::map<LayerPin, int> refCounter;
     // Maps pin to origin blob (for whom memory was allocated firstly).
     // For origin blobs key == value.
     std::map<LayerPin, LayerPin> reuseMap;
     std::map<LayerPin, Mat> memHosts;
+
+    bool useArena;
+    // id of the layer which blobs are allocated
+    int step;
+    std::map<LayerPin, ArenaHost> arenaHosts;
+    std::vector<ArenaBlob> arenaBlobs;
+    Mat arena;
+    // size of the current plan, the arena may be larger (see allocateArena)
+    size_t plannedTotal;
 };
 
 static Ptr<BackendWrapper> wrapMat(int backendId, int targetId, cv::Mat& m)
 {
     if (backendId == DNN_BACKEND_DEFAULT)
     {
-        if (targetId == DNN_TARGET_CPU)
+        if (targetId == DNN_TARGET_CPU || targetId == DNN_TARGET_CPU_FP16)
             return Ptr<BackendWrapper>();
         else if (targetId == DNN_TARGET_OPENCL)
             return OpenCLBackendWrapper::create(m);
@@ -683,6 +1060,41 @@ struct Net::Impl
     typedef std::map<int, LayerShapes> LayersShapesMap;
     typedef std::map<int, LayerData> MapIdToLayerData;
 
+    // Number of input shape sets which layers shapes are kept for.
+    enum { SHAPES_CACHE_SIZE = 8 };
+
+    // Blobs of the layers bound to the arena (see BlobManager) for a set of input shapes,
+    // before fusion. Each blob is stored as an offset in the arena or, if the blob is a view
+    // of a network input, in that input. Switching back to the same input shapes binds
+    // the blobs to the same memory without allocating them again.
+    struct AllocationPlan
+    {
+        struct Blob
+        {
+            Blob() : input(-1), offset(0) {}
+
+            int input;
+            size_t offset;
+            MatShape shape;
+        };
+
+        AllocationPlan() : valid(false), arenaSize(0) {}
+
+        bool valid;
+        std::vector<LayerPin> blobsToKeep;
+        size_t arenaSize;
+        std::map<int, std::vector<Blob> > outputs, internals;
+    };
+
+    struct CachedShapes
+    {
+        CachedShapes() : lastUse(0) {}
+
+        LayersShapesMap shapes;
+        AllocationPlan plan;
+        int64 lastUse;
+    };
+
     Impl()
     {
         //allocate fake net input layer
@@ -696,9 +1108,20 @@ struct Net::Impl
 
         lastLayerId = 0;
         netWasAllocated = false;
+        sharedLayers = false;
         fusion = true;
+        profiling = false;
+        shapesCacheTick = 0;
         preferableBackend = DNN_BACKEND_DEFAULT;
         preferableTarget = DNN_TARGET_CPU;
+#ifdef CV_CXX11
+        numRunningRequests = 0;
+#endif
+    }
+
+    ~Impl()
+    {
+        waitAsyncRequests();
     }
 
     Ptr<DataLayer> netInputLayer;
@@ -716,12 +1139,38 @@ struct Net::Impl
     int lastLayerId;
 
     bool netWasAllocated;
+    // Layers instances are shared with other networks (see Net::clone).
+    bool sharedLayers;
+    // Shapes of the layers and allocation plans for the recently used input shapes,
+    // so switching between several input resolutions doesn't infer the shapes
+    // and doesn't plan the memory again.
+    // At most SHAPES_CACHE_SIZE least recently used entries are kept.
+    // It's cleared if the layers may be modified.
+    std::map<ShapesVec, CachedShapes> layersShapesCache;
+    int64 shapesCacheTick;
     bool fusion;
     std::vector<int64> layersTimings;
+    // Profiling mode: start ticks of the layers and fusion decisions per layer id.
+    bool profiling;
+    std::vector<int64> layersStartTicks;
+    std::map<int, std::vector<String> > layersFusion;
+    // Ids of the layers which scales and shifts are folded into the weights
+    // of another layer by its id (see Net::save).
+    std::map<int, int> layersFoldedInto;
+
+    // Memory of the blobs which is owned by an inference request.
+    std::vector<Mat> requestBuffers;
+#ifdef CV_CXX11
+    std::mutex requestsMutex;
+    std::condition_variable requestsCond;
+    std::vector<Ptr<Impl> > idleRequests;
+    int numRunningRequests;
+#endif
 
     Ptr<BackendWrapper> wrap(Mat& host)
     {
-        if (preferableBackend == DNN_BACKEND_DEFAULT && preferableTarget == DNN_TARGET_CPU)
+        if (preferableBackend == DNN_BACKEND_DEFAULT &&
+            (preferableTarget == DNN_TARGET_CPU || preferableTarget == DNN_TARGET_CPU_FP16))
             return Ptr<BackendWrapper>();
 
         MatShape shape(host.dims);
@@ -806,10 +1255,70 @@ struct Net::Impl
     }
 #endif
 
+    // Waits for the started inference requests and releases the idle ones.
+    void waitAsyncRequests()
+    {
+#ifdef CV_CXX11
+        std::unique_lock<std::mutex> lock(requestsMutex);
+        while (numRunningRequests > 0)
+            requestsCond.wait(lock);
+        idleRequests.clear();
+#endif
+    }
+
+    // A new instance of the layer created from the blobs of the source one shares its
+    // prepared (padded, transformed, quantized) weights instead of preparing them again.
+    // Note that the quantized weights can't be prepared again because the blobs keep them
+    // 8-bit (see Net::quantize).
+    static void shareLayerState(const Ptr<Layer>& src, const Ptr<Layer>& dst)
+    {
+        const CompiledLayerState* srcState = dynamic_cast<const CompiledLayerState*>(src.get());
+        CompiledLayerState* dstState = dynamic_cast<CompiledLayerState*>(dst.get());
+        if (srcState && dstState)
+            dstState->shareState(*srcState);
+    }
+
+    // Layers are configured for the network they are allocated in, so the network
+    // which is going to be reconfigured gets its own instances of layers.
+    // Weights stay shared: new instances are created from the blobs of the shared ones.
+    void detachLayers()
+    {
+        CV_TRACE_FUNCTION();
+
+        Ptr<DataLayer> inputLayer(new DataLayer());
+        inputLayer->setNames(netInputLayer->getNames());
+        netInputLayer = inputLayer;
+
+        MapIdToLayerData::iterator it;
+        for (it = layers.begin(); it != layers.end(); it++)
+        {
+            LayerData& ld = it->second;
+            if (ld.id == 0)
+                ld.layerInstance = inputLayer;
+            else if (!ld.layerInstance.empty())
+            {
+                // the new instance gets the weights and quantization of the shared one
+                Ptr<Layer> shared = ld.layerInstance;
+                ld.params.blobs = shared->blobs;
+                ld.layerInstance.release();
+                shareLayerState(shared, ld.getLayerInstance());
+            }
+            ld.backendNodes.clear();
+            ld.forwardMutex = Mutex();
+        }
+        netWasAllocated = false;
+        sharedLayers = false;
+        layersShapesCache.clear();
+    }
+
     void clear()
     {
         CV_TRACE_FUNCTION();
 
+        waitAsyncRequests();
+        if (sharedLayers)
+            detachLayers();
+
         MapIdToLayerData::iterator it;
         for (it = layers.begin(); it != layers.end(); it++)
         {
@@ -838,6 +1347,7 @@ struct Net::Impl
         it->second.skip = true;
 
         layersTimings.clear();
+        layersStartTicks.clear();
     }
 
     void setUpNet(const std::vector<LayerPin>& blobsToKeep_ = std::vector<LayerPin>())
@@ -1009,6 +1519,7 @@ struct Net::Impl
         addLayerInput(ldInp, inNum, LayerPin(outLayerId, outNum));
         ldOut.requiredOutputs.insert(outNum);
         ldOut.consumers.push_back(LayerPin(inLayerId, outNum));
+        layersShapesCache.clear();
     }
 
     void computeNetOutputLayers()
@@ -1038,7 +1549,8 @@ struct Net::Impl
     {
         CV_TRACE_FUNCTION();
         if (preferableBackend == DNN_BACKEND_DEFAULT)
-            CV_Assert(preferableTarget == DNN_TARGET_CPU || preferableTarget == DNN_TARGET_OPENCL);
+            CV_Assert(preferableTarget == DNN_TARGET_CPU || preferableTarget == DNN_TARGET_OPENCL ||
+                      preferableTarget == DNN_TARGET_CPU_FP16);
         else if (preferableBackend == DNN_BACKEND_HALIDE)
             initHalideBackend();
         else if (preferableBackend == DNN_BACKEND_INFERENCE_ENGINE)
@@ -1271,6 +1783,35 @@ struct Net::Impl
 #endif  // HAVE_INF_ENGINE
     }
 
+    // Layers which don't change data (Split, Dropout, Reshape, Flatten and
+    // Permute without actual permutation) return views of their inputs on CPU.
+    // Their forward passes don't copy anything then.
+    bool isViewLayer(LayerData& ld, const LayerShapes& layerShapes)
+    {
+        if (!fusion || preferableBackend != DNN_BACKEND_DEFAULT ||
+            (preferableTarget != DNN_TARGET_CPU && preferableTarget != DNN_TARGET_CPU_FP16) ||
+            ld.inputBlobsId.empty() || DNN_DISABLE_MEMORY_OPTIMIZATIONS)
+            return false;
+
+        Ptr<Layer> layer = ld.getLayerInstance();
+        bool isView = !layer.dynamicCast<SplitLayer>().empty() ||
+                      !layer.dynamicCast<BlankLayer>().empty() ||
+                      !layer.dynamicCast<ReshapeLayer>().empty() ||
+                      !layer.dynamicCast<FlattenLayer>().empty() ||
+                      (!layer.dynamicCast<PermuteLayer>().empty() && layerShapes.supportInPlace);
+        if (!isView || !layerShapes.internal.empty() ||
+            (ld.inputBlobsId.size() != 1 && ld.inputBlobsId.size() != layerShapes.out.size()))
+            return false;
+
+        for (size_t i = 0; i < layerShapes.out.size(); i++)
+        {
+            const MatShape& inpShape = layerShapes.in[ld.inputBlobsId.size() == 1 ? 0 : i];
+            if (total(inpShape) != total(layerShapes.out[i]))
+                return false;
+        }
+        return true;
+    }
+
     void allocateLayer(int lid, const LayersShapesMap& layersShapes)
     {
         CV_TRACE_FUNCTION();
@@ -1310,14 +1851,12 @@ struct Net::Impl
 
         //bind inputs
         ld.inputBlobs.resize(ninputs);
-        ld.inputBlobsWrappers.resize(ninputs);
         for (size_t i = 0; i < ninputs; i++)
         {
             LayerPin from = ld.inputBlobsId[i];
             CV_Assert(from.valid());
             CV_DbgAssert(layers.count(from.lid) && (int)layers[from.lid].outputBlobs.size() > from.oid);
             ld.inputBlobs[i] = &layers[from.lid].outputBlobs[from.oid];
-            ld.inputBlobsWrappers[i] = layers[from.lid].outputBlobsWrappers[from.oid];
         }
 
         LayersShapesMap::const_iterator layerShapesIt = layersShapes.find(lid);
@@ -1326,7 +1865,27 @@ struct Net::Impl
 
         std::vector<LayerPin> pinsForInternalBlobs;
         blobManager.allocateBlobsForLayer(ld, layerShapesIt->second, pinsForInternalBlobs,
-                                          preferableBackend == DNN_BACKEND_INFERENCE_ENGINE);
+                                          preferableBackend == DNN_BACKEND_INFERENCE_ENGINE,
+                                          isViewLayer(ld, layerShapesIt->second));
+
+        // After allocation of layer, we decrease counters to it's input blobs.
+        blobManager.releaseReferences(ld.inputBlobsId);
+        blobManager.releaseReferences(pinsForInternalBlobs);
+
+        ld.flag = 1;
+    }
+
+    // Wraps the allocated blobs for the backend and finalizes the layer.
+    void finalizeLayer(LayerData &ld)
+    {
+        CV_TRACE_FUNCTION();
+
+        ld.inputBlobsWrappers.resize(ld.inputBlobsId.size());
+        for (size_t i = 0; i < ld.inputBlobsId.size(); i++)
+        {
+            LayerPin from = ld.inputBlobsId[i];
+            ld.inputBlobsWrappers[i] = layers[from.lid].outputBlobsWrappers[from.oid];
+        }
         ld.outputBlobsWrappers.resize(ld.outputBlobs.size());
         for (int i = 0; i < ld.outputBlobs.size(); ++i)
         {
@@ -1340,8 +1899,12 @@ struct Net::Impl
 
         Ptr<Layer> layerPtr = ld.getLayerInstance();
         {
-            layerPtr->finalize(ld.inputBlobs, ld.outputBlobs);
             layerPtr->preferableTarget = preferableTarget;
+            layerPtr->finalize(ld.inputBlobs, ld.outputBlobs);
+            // the weights may be replaced by half precision ones (see DNN_TARGET_CPU_FP16),
+            // so the single precision ones are not kept by the layer parameters either
+            if (dynamic_cast<CompiledLayerState*>(layerPtr.get()))
+                ld.params.blobs = layerPtr->blobs;
 #if 0
             std::cout << "\toutputs:";
             size_t noutputs = ld.outputBlobs.size();
@@ -1352,12 +1915,6 @@ struct Net::Impl
             std::cout << "\n";
 #endif
         }
-
-        // After allocation of layer, we decrease counters to it's input blobs.
-        blobManager.releaseReferences(ld.inputBlobsId);
-        blobManager.releaseReferences(pinsForInternalBlobs);
-
-        ld.flag = 1;
     }
 
 #if 0
@@ -1366,8 +1923,15 @@ struct Net::Impl
 #define printf_(args)
 #endif
 
+    void addFusionNote(int lid, const String& note)
+    {
+        layersFusion[lid].push_back(note);
+    }
+
     void fuseLayers(const std::vector<LayerPin>& blobsToKeep_)
     {
+        layersFusion.clear();
+        layersFoldedInto.clear();
         if( !fusion || preferableBackend != DNN_BACKEND_DEFAULT)
             return;
 
@@ -1414,6 +1978,9 @@ struct Net::Impl
                     if (currLayer->tryFuse(nextLayer))
                     {
                         printf_(("\tfused with %s\n", nextLayer->name.c_str()));
+                        addFusionNote(ld.id, "fused with " + nextLayer->name);
+                        addFusionNote(nextData->id, "fused into " + ld.name);
+                        layersFoldedInto[nextData->id] = ld.id;
                         nextData->skip = true;
                         ld.outputBlobs = layers[lpNext.lid].outputBlobs;
                         ld.outputBlobsWrappers = layers[lpNext.lid].outputBlobsWrappers;
@@ -1433,6 +2000,8 @@ struct Net::Impl
                         break;
                 }
 
+                bool activFused = false;
+
                 // For now, OpenCL target support fusion with activation of ReLU/ChannelsPReLU/Power/Tanh
                 if ( preferableTarget != DNN_TARGET_OPENCL ||
                         (preferableTarget == DNN_TARGET_OPENCL &&
@@ -1453,7 +2022,10 @@ struct Net::Impl
                     {
                         LayerData *activData = nextData;
                         printf_(("\tfused with %s\n", nextActivLayer->name.c_str()));
+                        addFusionNote(ld.id, "fused with " + nextActivLayer->name);
+                        addFusionNote(activData->id, "fused into " + ld.name);
                         activData->skip = true;
+                        activFused = true;
                         ld.outputBlobs = layers[lpNext.lid].outputBlobs;
                         ld.outputBlobsWrappers = layers[lpNext.lid].outputBlobsWrappers;
 
@@ -1468,6 +2040,70 @@ struct Net::Impl
                     }
                 }
 
+                // fuse convolution layer followed by eltwise (sum) and, optionally, activation on CPU.
+                // The convolution adds the second input of eltwise layer to its output:
+                //
+                // some_layer   conv
+                //   |             |
+                //   +-- eltwise --+
+                //          |
+                //        activ
+                //
+                // Eltwise layer works in-place over the convolution output (see BlobManager)
+                // so the convolution already writes to the right memory.
+                if ( preferableTarget != DNN_TARGET_OPENCL && !activFused && nextData &&
+                     ld.type == "Convolution" && nextData->type == "Eltwise" &&
+                     nextData->inputBlobsId.size() == 2 && pinsToKeep.count(lpNext) == 0 &&
+                     ld.inputBlobs.size() == 1 && ld.outputBlobs.size() == 1 )
+                {
+                    LayerData *eltwiseData = nextData;
+                    bool unitSum = eltwiseData->params.get<String>("operation", "sum").toLowerCase() == "sum";
+                    if (unitSum && eltwiseData->params.has("coeff"))
+                    {
+                        DictValue coeffs = eltwiseData->params.get("coeff");
+                        for (int i = 0; i < coeffs.size(); i++)
+                            unitSum = unitSum && coeffs.get<float>(i) == 1.f;
+                    }
+
+                    int k = eltwiseData->inputBlobs[0]->data == ld.outputBlobs[0].data ? 0 : 1;
+                    Mat* residual = eltwiseData->inputBlobs[1 - k];
+                    const Mat& output = eltwiseData->outputBlobs[0];
+                    if( unitSum && eltwiseData->inputBlobs[k]->data == ld.outputBlobs[0].data &&
+                        output.data == ld.outputBlobs[0].data &&
+                        eltwiseData->inputBlobsId[1 - k].lid < ld.id &&
+                        shape(*residual) == shape(output) && residual->isContinuous() &&
+                        residual->data != output.data )
+                    {
+                        printf_(("\tfused with %s\n", eltwiseData->layerInstance->name.c_str()));
+                        addFusionNote(ld.id, "fused with " + eltwiseData->name);
+                        addFusionNote(eltwiseData->id, "fused into " + ld.name);
+                        eltwiseData->skip = true;
+                        ld.inputBlobs.push_back(residual);
+                        ld.inputBlobsWrappers.push_back(eltwiseData->inputBlobsWrappers[1 - k]);
+                        ld.outputBlobs = eltwiseData->outputBlobs;
+                        ld.outputBlobsWrappers = eltwiseData->outputBlobsWrappers;
+
+                        Ptr<ActivationLayer> nextActivLayer;
+                        if( eltwiseData->consumers.size() == 1 )
+                        {
+                            nextData = &layers[eltwiseData->consumers[0].lid];
+                            lpNext = LayerPin(eltwiseData->consumers[0].lid, 0);
+                            nextActivLayer = nextData->layerInstance.dynamicCast<ActivationLayer>();
+                        }
+                        if( !nextActivLayer.empty() && pinsToKeep.count(lpNext) == 0 &&
+                            nextData->outputBlobs[0].data == output.data &&
+                            currLayer->setActivation(nextActivLayer) )
+                        {
+                            printf_(("\tfused with %s\n", nextActivLayer->name.c_str()));
+                            addFusionNote(ld.id, "fused with " + nextActivLayer->name);
+                            addFusionNote(nextData->id, "fused into " + ld.name);
+                            nextData->skip = true;
+                            ld.outputBlobs = nextData->outputBlobs;
+                            ld.outputBlobsWrappers = nextData->outputBlobsWrappers;
+                        }
+                    }
+                }
+
                 // fuse convlution layer followed by eltwise + relu
                 if ( preferableTarget == DNN_TARGET_OPENCL )
                 {
@@ -1525,6 +2161,10 @@ struct Net::Impl
                                         ld.inputBlobsWrappers.push_back(firstConvLayerData->outputBlobsWrappers[0]);
                                         printf_(("\tfused with %s\n", nextEltwiseLayer->name.c_str()));
                                         printf_(("\tfused with %s\n", nextActivLayer->name.c_str()));
+                                        addFusionNote(ld.id, "fused with " + nextEltwiseLayer->name);
+                                        addFusionNote(ld.id, "fused with " + nextActivLayer->name);
+                                        addFusionNote(eltwiseData->id, "fused into " + ld.name);
+                                        addFusionNote(nextData->id, "fused into " + ld.name);
                                         eltwiseData->skip = true;
                                         nextData->skip = true;
                                         // This optimization for cases like
@@ -1590,6 +2230,7 @@ struct Net::Impl
                 {
                     poolingLayer->computeMaxIdx = false;
                     printf_(("\tsimplified pooling layer %s\n", poolingLayer->name.c_str()));
+                    addFusionNote(ld.id, "max indices are not computed");
                 }
             }
 
@@ -1649,6 +2290,7 @@ struct Net::Impl
                             chrange[1] = Range(ofs, ofs + channels_i);
                             printf_(("\toutput %s(%d) to channels (%d, %d)\n", inp_i_data->layerInstance->name.c_str(),
                                    pin.oid, ofs, ofs + channels_i));
+                            addFusionNote(inp_i_data->id, "writes to output of " + ld.name);
                             ofs += channels_i;
                             Mat output_slice = output(chrange);
                             Mat& curr_output = inp_i_data->outputBlobs[pin.oid];
@@ -1661,6 +2303,7 @@ struct Net::Impl
                         }
                         ld.skip = true;
                         printf_(("\toptimized out Concat layer %s\n", concatLayer->name.c_str()));
+                        addFusionNote(ld.id, "optimized out");
                     }
                 }
             }
@@ -1682,11 +2325,51 @@ struct Net::Impl
             CV_Assert(layers[0].outputBlobs[i].total());
             inputShapes.push_back(shape(layers[0].outputBlobs[i]));
         }
-        LayersShapesMap layersShapes;
-        getLayersShapes(inputShapes, layersShapes);
-
-        blobManager.reset();
+        std::map<ShapesVec, CachedShapes>::iterator shapesIt = layersShapesCache.find(inputShapes);
+        if (shapesIt == layersShapesCache.end())
+        {
+            if (layersShapesCache.size() >= SHAPES_CACHE_SIZE)
+            {
+                std::map<ShapesVec, CachedShapes>::iterator lru = layersShapesCache.begin(), cit;
+                for (cit = layersShapesCache.begin(); cit != layersShapesCache.end(); ++cit)
+                    if (cit->second.lastUse < lru->second.lastUse)
+                        lru = cit;
+                layersShapesCache.erase(lru);
+            }
+            shapesIt = layersShapesCache.insert(std::make_pair(inputShapes, CachedShapes())).first;
+            getLayersShapes(inputShapes, shapesIt->second.shapes);
+        }
+        shapesIt->second.lastUse = ++shapesCacheTick;
+        const LayersShapesMap& layersShapes = shapesIt->second.shapes;
+        AllocationPlan& plan = shapesIt->second.plan;
+
+        // The arena is used by CPU targets only: blobs of other targets are wrapped
+        // to their backends one by one.
+        bool useArena = preferableBackend == DNN_BACKEND_DEFAULT &&
+                        (preferableTarget == DNN_TARGET_CPU || preferableTarget == DNN_TARGET_CPU_FP16);
         backendWrappers.clear();
+        if (useArena && plan.valid && plan.blobsToKeep == blobsToKeep_)
+            bindPlannedBlobs(plan);
+        else
+        {
+            blobManager.reset(useArena);
+            planBlobs(layersShapes, blobsToKeep_);
+            if (useArena)
+                recordPlan(plan, blobsToKeep_);
+        }
+
+        for (it = layers.begin(); it != layers.end(); it++)
+            finalizeLayer(it->second);
+
+        layersTimings.resize(lastLayerId + 1, 0);
+        layersStartTicks.resize(lastLayerId + 1, 0);
+        fuseLayers(blobsToKeep_);
+    }
+
+    // Allocates the blobs of all the layers, see BlobManager.
+    void planBlobs(const LayersShapesMap& layersShapes, const std::vector<LayerPin>& blobsToKeep_)
+    {
+        MapIdToLayerData::iterator it;
         // Fake references to input blobs.
         for (int i = 0; i < layers[0].outputBlobs.size(); ++i)
             blobManager.addReference(LayerPin(0, i));
@@ -1706,18 +2389,108 @@ struct Net::Impl
             int lid = it->first;
             allocateLayer(lid, layersShapes);
         }
+        blobManager.allocateArena();
+    }
 
-        layersTimings.resize(lastLayerId + 1, 0);
-        fuseLayers(blobsToKeep_);
+    static bool containsBlob(const Mat& host, const Mat& m)
+    {
+        return !host.empty() && host.isContinuous() && m.isContinuous() &&
+               host.data <= m.data && m.dataend <= host.dataend;
+    }
+
+    // Stores the blobs bound to the arena by planBlobs(). The plan is not kept
+    // if some of the blobs are not in the arena (e.g. it's too large, see BlobManager).
+    void recordPlan(AllocationPlan& plan, const std::vector<LayerPin>& blobsToKeep_)
+    {
+        const Mat& arena = blobManager.arenaMemory();
+        const std::vector<Mat>& inputs = layers[0].outputBlobs;
+        plan = AllocationPlan();
+        for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
+        {
+            if (it->first == 0)
+                continue;
+            for (int k = 0; k < 2; k++)
+            {
+                const std::vector<Mat>& blobs = k == 0 ? it->second.outputBlobs : it->second.internals;
+                std::vector<AllocationPlan::Blob>& planned = (k == 0 ? plan.outputs : plan.internals)[it->first];
+                planned.resize(blobs.size());
+                for (size_t i = 0; i < blobs.size(); i++)
+                {
+                    const Mat& m = blobs[i];
+                    AllocationPlan::Blob& blob = planned[i];
+                    if (m.empty())
+                        continue;
+                    // the blob is in the arena or it's a view of a network input
+                    const Mat* host = &arena;
+                    while (!containsBlob(*host, m))
+                    {
+                        if (++blob.input >= (int)inputs.size())
+                            return;
+                        host = &inputs[blob.input];
+                    }
+                    blob.offset = (m.data - host->data) / sizeof(float);
+                    blob.shape = shape(m);
+                }
+            }
+        }
+        plan.blobsToKeep = blobsToKeep_;
+        plan.arenaSize = blobManager.plannedSize();
+        plan.valid = true;
+    }
+
+    void bindPlannedBlobs(const AllocationPlan& plan)
+    {
+        const std::vector<Mat>& inputs = layers[0].outputBlobs;
+        const Mat& arena = blobManager.usePlan(plan.arenaSize, inputs);
+        for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
+        {
+            LayerData& ld = it->second;
+            ld.flag = 1;
+            if (ld.id == 0)
+                continue;
+
+            size_t ninputs = ld.inputBlobsId.size();
+            ld.inputBlobs.resize(ninputs);
+            for (size_t i = 0; i < ninputs; i++)
+            {
+                LayerPin from = ld.inputBlobsId[i];
+                ld.inputLayersId.insert(from.lid);
+                ld.inputBlobs[i] = &layers[from.lid].outputBlobs[from.oid];
+            }
+            for (int k = 0; k < 2; k++)
+            {
+                std::vector<Mat>& blobs = k == 0 ? ld.outputBlobs : ld.internals;
+                const std::vector<AllocationPlan::Blob>& planned = (k == 0 ? plan.outputs : plan.internals).find(ld.id)->second;
+                blobs.resize(planned.size());
+                for (size_t i = 0; i < planned.size(); i++)
+                {
+                    const AllocationPlan::Blob& blob = planned[i];
+                    if (blob.shape.empty())
+                        continue;
+                    Mat host = (blob.input < 0 ? arena : inputs[blob.input]).reshape(1, 1);
+                    blobs[i] = host.colRange((int)blob.offset, (int)(blob.offset + total(blob.shape))).reshape(1, blob.shape);
+                }
+            }
+        }
     }
 
     void forwardLayer(LayerData &ld)
     {
         CV_TRACE_FUNCTION();
 
+        AutoLock lock(ld.forwardMutex);
         Ptr<Layer> layer = ld.layerInstance;
+        CV_TRACE_ARG_VALUE(name, "name", ld.name.c_str());
+        CV_TRACE_ARG_VALUE(type, "type", ld.type.c_str());
+        if (profiling && !ld.skip)
+        {
+            CV_TRACE_ARG_VALUE(kernel, "kernel", layer->getKernelName().c_str());
+            CV_TRACE_ARG_VALUE(flops, "flops", getLayerFLOPS(ld));
+        }
 
         TickMeter tm;
+        if (profiling)
+            layersStartTicks[ld.id] = getTickCount();
         tm.start();
 
         if (preferableBackend == DNN_BACKEND_DEFAULT ||
@@ -1884,7 +2657,7 @@ struct Net::Impl
                                            "the #%d was requested", ld.name.c_str(),
                                            ld.outputBlobs.size(), pin.oid));
         }
-        if (preferableTarget != DNN_TARGET_CPU)
+        if (preferableTarget != DNN_TARGET_CPU && preferableTarget != DNN_TARGET_CPU_FP16)
         {
             CV_Assert(!ld.outputBlobsWrappers.empty() && !ld.outputBlobsWrappers[pin.oid].empty());
             // Transfer data to CPU if it's require.
@@ -1897,8 +2670,363 @@ struct Net::Impl
     {
         return getBlob(getPinByAlias(outputName));
     }
+
+    int64 getLayerFLOPS(const LayerData& ld) const
+    {
+        ShapesVec inpShapes, outShapes;
+        for (size_t i = 0; i < ld.inputBlobs.size(); ++i)
+            inpShapes.push_back(shape(*ld.inputBlobs[i]));
+        for (size_t i = 0; i < ld.outputBlobs.size(); ++i)
+            outShapes.push_back(shape(ld.outputBlobs[i]));
+        return ld.layerInstance->getFLOPS(inpShapes, outShapes);
+    }
+
+    String getBackendName(const LayerData& ld) const
+    {
+        int backendId = preferableBackend;
+        if (backendId != DNN_BACKEND_DEFAULT && !ld.layerInstance->supportBackend(backendId))
+            backendId = DNN_BACKEND_DEFAULT;
+        String backend = backendId == DNN_BACKEND_HALIDE ? "Halide" :
+                         backendId == DNN_BACKEND_INFERENCE_ENGINE ? "InferenceEngine" : "OpenCV";
+        String target = preferableTarget == DNN_TARGET_OPENCL ? "OpenCL" :
+                        preferableTarget == DNN_TARGET_CPU_FP16 ? "CPU_FP16" : "CPU";
+        return backend + "/" + target;
+    }
+
+    static int64 blobsSize(const std::vector<Mat>& blobs)
+    {
+        int64 size = 0;
+        for (size_t i = 0; i < blobs.size(); ++i)
+            size += (int64)(blobs[i].total() * blobs[i].elemSize());
+        return size;
+    }
+
+    void getProfile(std::vector<LayerProfile>& profile)
+    {
+        profile.clear();
+        double ticksPerMs = getTickFrequency() * 1e-3;
+        int64 firstTick = 0;
+        for (size_t i = 1; i < layersStartTicks.size(); ++i)
+        {
+            if (layersStartTicks[i] != 0 && (firstTick == 0 || layersStartTicks[i] < firstTick))
+                firstTick = layersStartTicks[i];
+        }
+
+        // Without recorded start times layers are placed one after another.
+        double nextStartMs = 0;
+        for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); ++it)
+        {
+            LayerData& ld = it->second;
+            if (ld.id == 0)
+                continue;
+            LayerProfile p;
+            p.id = ld.id;
+            p.name = ld.name;
+            p.type = ld.type;
+            p.skipped = ld.skip;
+            p.backend = getBackendName(ld);
+
+            size_t lid = ld.id;
+            int64 startTick = lid < layersStartTicks.size() ? layersStartTicks[lid] : 0;
+            p.timeMs = lid < layersTimings.size() ? layersTimings[lid] / ticksPerMs : 0;
+            p.startMs = startTick != 0 ? (startTick - firstTick) / ticksPerMs : nextStartMs;
+            nextStartMs = std::max(nextStartMs, p.startMs + p.timeMs);
+
+            std::map<int, std::vector<String> >::iterator fusionIt = layersFusion.find(ld.id);
+            for (size_t i = 0; fusionIt != layersFusion.end() && i < fusionIt->second.size(); ++i)
+                p.fusion += (i ? "; " : "") + fusionIt->second[i];
+
+            if (netWasAllocated && !ld.skip)
+            {
+                p.kernel = ld.layerInstance->getKernelName();
+                p.flops = getLayerFLOPS(ld);
+                for (size_t i = 0; i < ld.inputBlobs.size(); ++i)
+                    p.bytesRead += (int64)(ld.inputBlobs[i]->total() * ld.inputBlobs[i]->elemSize());
+                p.bytesRead += blobsSize(ld.layerInstance->blobs);
+                p.bytesWritten = blobsSize(ld.outputBlobs);
+                p.blobsMemory = p.bytesWritten + blobsSize(ld.internals);
+            }
+            profile.push_back(p);
+        }
+    }
+
+    // Runs a forward pass and updates maximal absolute values of layers inputs.
+    void updateInputRanges(std::map<int, float>& ranges)
+    {
+        CV_TRACE_FUNCTION();
+
+        MapIdToLayerData::iterator it;
+        for (it = layers.begin(); it != layers.end(); it++)
+            it->second.flag = 0;
+
+        for (it = layers.begin(); it != layers.end(); it++)
+        {
+            LayerData &ld = it->second;
+            if (ld.id != 0 && !ld.skip && !ld.inputBlobs.empty())
+            {
+                float range = (float)norm(*ld.inputBlobs[0], NORM_INF);
+                std::map<int, float>::iterator rangeIt = ranges.find(ld.id);
+                if (rangeIt == ranges.end())
+                    ranges[ld.id] = range;
+                else
+                    rangeIt->second = std::max(rangeIt->second, range);
+            }
+            forwardLayer(ld);
+        }
+    }
+
+    void quantize(const std::vector<Mat>& calibData)
+    {
+        CV_TRACE_FUNCTION();
+
+        if (preferableBackend != DNN_BACKEND_DEFAULT || preferableTarget != DNN_TARGET_CPU)
+            CV_Error(Error::StsNotImplemented, "Quantization is supported only for the default CPU backend");
+
+        waitAsyncRequests();
+
+        std::map<int, float> ranges;
+        for (size_t i = 0; i < calibData.size(); ++i)
+        {
+            LayerData &inpLd = layers[0];
+            CV_Assert(inpLd.outputBlobs.size() <= 1);
+            inpLd.outputBlobs.resize(1);
+            inpLd.outputBlobsWrappers.resize(1);
+            bool oldShape = shape(inpLd.outputBlobs[0]) == shape(calibData[i]);
+            if (oldShape)
+                calibData[i].copyTo(inpLd.outputBlobs[0]);
+            else
+                inpLd.outputBlobs[0] = calibData[i].clone();
+            netWasAllocated = netWasAllocated && oldShape;
+
+            setUpNet();
+            updateInputRanges(ranges);
+        }
+
+        for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
+        {
+            LayerData &ld = it->second;
+            if (ld.id == 0)
+                continue;
+            // 8-bit values are in [-127, 127] range to keep quantization symmetric.
+            std::map<int, float>::iterator rangeIt = ranges.find(ld.id);
+            float inputScale = rangeIt != ranges.end() ? rangeIt->second / 127.f : 0.f;
+            Ptr<Layer> layer = ld.getLayerInstance();
+            // the single precision weights are released
+            if (layer->tryQuantize(inputScale))
+                ld.params.blobs = layer->blobs;
+        }
+        // Layers are finalized again to apply fusion to the quantized weights.
+        netWasAllocated = false;
+    }
+
+    // Sets blobs of the network inputs in order. Doesn't copy data if shapes are kept.
+    void setInputs(const std::vector<Mat>& inputs, bool copyData)
+    {
+        LayerData &inpLd = layers[0];
+        inpLd.outputBlobs.resize(std::max(inputs.size(), inpLd.requiredOutputs.size()));
+        inpLd.outputBlobsWrappers.resize(inpLd.outputBlobs.size());
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            Mat& blob = inpLd.outputBlobs[i];
+            bool oldShape = shape(blob) == shape(inputs[i]) && blob.type() == inputs[i].type();
+            if (!oldShape)
+                blob = inputs[i].clone();
+            else if (copyData)
+                inputs[i].copyTo(blob);
+            if (!inpLd.outputBlobsWrappers[i].empty())
+                inpLd.outputBlobsWrappers[i]->setHostDirty();
+            netWasAllocated = netWasAllocated && oldShape;
+        }
+    }
+
+    static Mat remapBlob(const Mat& m, std::map<UMatData*, Mat>& buffers)
+    {
+        if (m.empty())
+            return Mat();
+        if (!m.u)
+            return m.clone();
+        Mat& buf = buffers[m.u];
+        if (buf.empty())
+        {
+            // Internal blobs may keep values which were set at layers finalization.
+            buf.create(1, (int)m.u->size, CV_8U);
+            memcpy(buf.data, m.u->data, m.u->size);
+        }
+        size_t offset = m.data - m.u->data;
+        return Mat(m.dims, m.size.p, m.type(), buf.data + offset, m.step.p);
+    }
+
+    // Creates a copy of the allocated network which shares layers (and their weights)
+    // with this one but has own memory for all the blobs.
+    Ptr<Impl> createInferRequest()
+    {
+        CV_TRACE_FUNCTION();
+        CV_Assert(netWasAllocated);
+
+        Ptr<Impl> req(new Impl());
+        req->netInputLayer = netInputLayer;
+        req->netOutputs = netOutputs;
+        req->blobsToKeep = blobsToKeep;
+        req->layers = layers;
+        req->layerNameToId = layerNameToId;
+        req->preferableBackend = preferableBackend;
+        req->preferableTarget = preferableTarget;
+        req->lastLayerId = lastLayerId;
+        req->fusion = fusion;
+        req->netWasAllocated = true;
+        req->layersTimings.resize(layersTimings.size(), 0);
+        req->layersStartTicks.resize(layersStartTicks.size(), 0);
+        req->layersFusion = layersFusion;
+
+        // Blobs which share memory (in-place layers, reused blobs, concatenation
+        // outputs) are mapped to the same buffer with the same offsets.
+        std::map<UMatData*, Mat> buffers;
+        std::map<const Mat*, Mat*> outputsMap;
+        MapIdToLayerData::iterator it;
+        for (it = layers.begin(); it != layers.end(); ++it)
+        {
+            LayerData &ld = it->second;
+            LayerData &reqLd = req->layers[ld.id];
+            for (size_t i = 0; i < ld.outputBlobs.size(); ++i)
+            {
+                reqLd.outputBlobs[i] = remapBlob(ld.outputBlobs[i], buffers);
+                outputsMap[&ld.outputBlobs[i]] = &reqLd.outputBlobs[i];
+            }
+            for (size_t i = 0; i < ld.internals.size(); ++i)
+                reqLd.internals[i] = remapBlob(ld.internals[i], buffers);
+        }
+        for (it = layers.begin(); it != layers.end(); ++it)
+        {
+            LayerData &ld = it->second;
+            LayerData &reqLd = req->layers[ld.id];
+            for (size_t i = 0; i < ld.inputBlobs.size(); ++i)
+            {
+                std::map<const Mat*, Mat*>::iterator inpIt = outputsMap.find(ld.inputBlobs[i]);
+                CV_Assert(inpIt != outputsMap.end());
+                reqLd.inputBlobs[i] = inpIt->second;
+            }
+        }
+        for (std::map<UMatData*, Mat>::iterator bufIt = buffers.begin(); bufIt != buffers.end(); ++bufIt)
+            req->requestBuffers.push_back(bufIt->second);
+        return req;
+    }
+
+#ifdef CV_CXX11
+    Ptr<Impl> acquireInferRequest()
+    {
+        Ptr<Impl> req;
+        {
+            std::lock_guard<std::mutex> lock(requestsMutex);
+            ++numRunningRequests;
+            if (!idleRequests.empty())
+            {
+                req = idleRequests.back();
+                idleRequests.pop_back();
+                return req;
+            }
+        }
+        try
+        {
+            req = createInferRequest();
+        }
+        catch (...)
+        {
+            releaseInferRequest(Ptr<Impl>());
+            throw;
+        }
+        return req;
+    }
+
+    void releaseInferRequest(const Ptr<Impl>& req)
+    {
+        std::lock_guard<std::mutex> lock(requestsMutex);
+        if (req)
+            idleRequests.push_back(req);
+        --numRunningRequests;
+        requestsCond.notify_all();
+    }
+
+    std::vector<Mat> runInferRequest(Ptr<Impl> req, std::vector<LayerPin> pins)
+    {
+        CV_TRACE_FUNCTION();
+
+        std::vector<Mat> outputs;
+        try
+        {
+            req->forwardToLayer(req->getLayerData(getLatestLayerPin(pins).lid));
+            for (size_t i = 0; i < pins.size(); ++i)
+                outputs.push_back(req->getBlob(pins[i]).clone());
+        }
+        catch (...)
+        {
+            releaseInferRequest(req);
+            throw;
+        }
+        releaseInferRequest(req);
+        return outputs;
+    }
+#endif
 };
 
+struct AsyncResult::Impl
+{
+#ifdef CV_CXX11
+    std::shared_future<std::vector<Mat> > result;
+#else
+    std::vector<Mat> result;
+#endif
+};
+
+LayerProfile::LayerProfile()
+    : id(0), skipped(false), startMs(0), timeMs(0), flops(0),
+      bytesRead(0), bytesWritten(0), blobsMemory(0)
+{
+}
+
+AsyncResult::AsyncResult()
+{
+}
+
+bool AsyncResult::valid() const
+{
+#ifdef CV_CXX11
+    return impl && impl->result.valid();
+#else
+    return !impl.empty();
+#endif
+}
+
+bool AsyncResult::wait(int timeoutMs) const
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(valid());
+#ifdef CV_CXX11
+    if (timeoutMs < 0)
+    {
+        impl->result.wait();
+        return true;
+    }
+    return impl->result.wait_for(std::chrono::milliseconds(timeoutMs)) == std::future_status::ready;
+#else
+    (void)timeoutMs;
+    return true;
+#endif
+}
+
+void AsyncResult::get(OutputArrayOfArrays outputBlobs)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(valid());
+    CV_Assert(outputBlobs.isMatVector());
+
+    std::vector<Mat> & outputvec = *(std::vector<Mat> *)outputBlobs.getObj();
+#ifdef CV_CXX11
+    outputvec = impl->result.get();
+#else
+    outputvec = impl->result;
+#endif
+}
+
 Net::Net() : impl(new Net::Impl)
 {
 }
@@ -1926,6 +3054,7 @@ int Net::addLayer(const String &name, const String &type, LayerParams &params)
     int id = ++impl->lastLayerId;
     impl->layerNameToId.insert(std::make_pair(name, id));
     impl->layers.insert(std::make_pair(id, LayerData(id, name, type, params)));
+    impl->layersShapesCache.clear();
 
     return id;
 }
@@ -2000,7 +3129,7 @@ void Net::forward(OutputArrayOfArrays outputBlobs, const String& outputName)
     }
     else if (outputBlobs.isMatVector())
     {
-        if (impl->preferableTarget != DNN_TARGET_CPU)
+        if (impl->preferableTarget != DNN_TARGET_CPU && impl->preferableTarget != DNN_TARGET_CPU_FP16)
         {
             for (int i = 0; i < ld.outputBlobsWrappers.size(); ++i)
             {
@@ -2029,6 +3158,78 @@ void Net::forward(OutputArrayOfArrays outputBlobs, const String& outputName)
     }
 }
 
+AsyncResult Net::forwardAsync(InputArrayOfArrays inputBlobs, const std::vector<String>& outBlobNames)
+{
+    CV_TRACE_FUNCTION();
+
+    std::vector<Mat> inputs;
+    if (inputBlobs.isMatVector() || inputBlobs.isUMatVector())
+        inputBlobs.getMatVector(inputs);
+    else
+        inputs.push_back(inputBlobs.getMat());
+    CV_Assert(!inputs.empty());
+
+    std::vector<LayerPin> pins;
+    for (size_t i = 0; i < outBlobNames.size(); i++)
+    {
+        pins.push_back(impl->getPinByAlias(outBlobNames[i]));
+    }
+    // Keep the same allocation as forward() does for the last layer's output.
+    std::vector<LayerPin> blobsToKeep = pins;
+    if (pins.empty())
+        pins.push_back(impl->getPinByAlias(getLayerNames().back()));
+
+    AsyncResult result;
+    result.impl = makePtr<AsyncResult::Impl>();
+
+#ifdef CV_CXX11
+    if (impl->preferableBackend == DNN_BACKEND_DEFAULT &&
+        (impl->preferableTarget == DNN_TARGET_CPU || impl->preferableTarget == DNN_TARGET_CPU_FP16))
+    {
+        // Inputs of the network are used only to keep the shapes.
+        impl->setInputs(inputs, false);
+        impl->setUpNet(blobsToKeep);
+
+        Ptr<Impl> req = impl->acquireInferRequest();
+        LayerData &reqInpLd = req->layers[0];
+        CV_Assert(reqInpLd.outputBlobs.size() >= inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            inputs[i].copyTo(reqInpLd.outputBlobs[i]);
+        }
+        try
+        {
+            result.impl->result = std::async(std::launch::async, &Impl::runInferRequest,
+                                             impl.get(), req, pins).share();
+        }
+        catch (...)
+        {
+            impl->releaseInferRequest(req);
+            throw;
+        }
+        return result;
+    }
+#endif
+
+    impl->setInputs(inputs, true);
+    impl->setUpNet(blobsToKeep);
+    impl->forwardToLayer(impl->getLayerData(impl->getLatestLayerPin(pins).lid));
+
+    std::vector<Mat> outputs;
+    for (size_t i = 0; i < pins.size(); i++)
+    {
+        outputs.push_back(impl->getBlob(pins[i]).clone());
+    }
+#ifdef CV_CXX11
+    std::promise<std::vector<Mat> > promise;
+    promise.set_value(outputs);
+    result.impl->result = promise.get_future().share();
+#else
+    result.impl->result = outputs;
+#endif
+    return result;
+}
+
 void Net::forward(OutputArrayOfArrays outputBlobs,
                   const std::vector<String>& outBlobNames)
 {
@@ -2156,8 +3357,13 @@ Mat Net::getParam(LayerId layer, int numParam)
 {
     LayerData &ld = impl->getLayerData(layer);
 
-    std::vector<Mat> &layerBlobs = ld.layerInstance->blobs;
+    Ptr<Layer> layerInstance = ld.getLayerInstance();
+    std::vector<Mat> &layerBlobs = layerInstance->blobs;
     CV_Assert(numParam < (int)layerBlobs.size());
+    // quantized and half precision weights are returned in single precision
+    const CompiledLayerState* compiled = dynamic_cast<const CompiledLayerState*>(layerInstance.get());
+    if (compiled && layerBlobs[numParam].depth() != CV_32F)
+        return compiled->unpackBlob(numParam);
     return layerBlobs[numParam];
 }
 
@@ -2165,10 +3371,12 @@ void Net::setParam(LayerId layer, int numParam, const Mat &blob)
 {
     LayerData &ld = impl->getLayerData(layer);
 
-    std::vector<Mat> &layerBlobs = ld.layerInstance->blobs;
+    std::vector<Mat> &layerBlobs = ld.getLayerInstance()->blobs;
     CV_Assert(numParam < (int)layerBlobs.size());
     //we don't make strong checks, use this function carefully
+    impl->waitAsyncRequests();
     layerBlobs[numParam] = blob;
+    impl->layersShapesCache.clear();
 }
 
 int Net::getLayerId(const String &layer)
@@ -2184,6 +3392,8 @@ void Net::deleteLayer(LayerId)
 Ptr<Layer> Net::getLayer(LayerId layerId)
 {
     LayerData &ld = impl->getLayerData(layerId);
+    // the layer may be modified by the caller
+    impl->layersShapesCache.clear();
     return ld.getLayerInstance();
 }
 
@@ -2222,6 +3432,47 @@ bool Net::empty() const
     return impl->layers.size() <= 1; //first layer is default Data layer
 }
 
+Net Net::clone() const
+{
+    CV_TRACE_FUNCTION();
+
+    Net net;
+    if (impl->netWasAllocated)
+    {
+        net.impl = impl->createInferRequest();
+        net.impl->halideConfigFile = impl->halideConfigFile;
+        net.impl->netInputLayer = Ptr<DataLayer>(new DataLayer());
+        net.impl->netInputLayer->setNames(impl->netInputLayer->getNames());
+        net.impl->layers[0].layerInstance = net.impl->netInputLayer;
+        impl->sharedLayers = net.impl->sharedLayers = true;
+        return net;
+    }
+
+    net.setInputsNames(impl->netInputLayer->getNames());
+    Impl::MapIdToLayerData::const_iterator it;
+    for (it = impl->layers.begin(); it != impl->layers.end(); ++it)
+    {
+        const LayerData& ld = it->second;
+        if (ld.id == 0)
+            continue;
+        LayerParams params = ld.params;
+        // weights may be changed by setParam() or through getLayer()
+        if (!ld.layerInstance.empty())
+            params.blobs = ld.layerInstance->blobs;
+        int id = net.addLayer(ld.name, ld.type, params);
+        CV_Assert(id == ld.id);
+        for (size_t i = 0; i < ld.inputBlobsId.size(); i++)
+            net.impl->connect(ld.inputBlobsId[i].lid, ld.inputBlobsId[i].oid, id, (int)i);
+        if (!ld.layerInstance.empty())
+            Impl::shareLayerState(ld.layerInstance, net.impl->layers[id].getLayerInstance());
+    }
+    net.impl->preferableBackend = impl->preferableBackend;
+    net.impl->preferableTarget = impl->preferableTarget;
+    net.impl->fusion = impl->fusion;
+    net.impl->halideConfigFile = impl->halideConfigFile;
+    return net;
+}
+
 std::vector<int> Net::getUnconnectedOutLayers() const
 {
     std::vector<int> layersIds;
@@ -2483,6 +3734,11 @@ void Net::setHalideScheduler(const String& scheduler)
     impl->halideConfigFile = scheduler;
 }
 
+size_t Net::getAllocatedBlobsMemory() const
+{
+    return impl->blobManager.allocatedTotal() * sizeof(float);
+}
+
 int64 Net::getPerfProfile(std::vector<double>& timings)
 {
     timings = std::vector<double>(impl->layersTimings.begin() + 1, impl->layersTimings.end());
@@ -2490,6 +3746,487 @@ int64 Net::getPerfProfile(std::vector<double>& timings)
     return total;
 }
 
+void Net::enableProfiling(bool enable)
+{
+    impl->profiling = enable;
+}
+
+void Net::getProfile(std::vector<LayerProfile>& profile)
+{
+    CV_TRACE_FUNCTION();
+    impl->getProfile(profile);
+}
+
+static String jsonString(const String& str)
+{
+    String res = "\"";
+    for (size_t i = 0; i < str.size(); ++i)
+    {
+        char c = str[i];
+        if (c == '"' || c == '\\')
+            res += '\\';
+        if ((unsigned char)c >= ' ')
+            res += c;
+    }
+    return res + "\"";
+}
+
+void Net::dumpProfile(const String& filename)
+{
+    CV_TRACE_FUNCTION();
+
+    std::vector<LayerProfile> profile;
+    impl->getProfile(profile);
+
+    std::ofstream ofs(filename.c_str());
+    if (!ofs.is_open())
+        CV_Error(Error::StsError, "Failed to open " + filename);
+
+    // Complete events ("ph": "X") with time in microseconds, see Trace Event Format.
+    ofs << "{\"traceEvents\": [";
+    for (size_t i = 0; i < profile.size(); ++i)
+    {
+        const LayerProfile& p = profile[i];
+        ofs << (i ? "," : "") << "\n  {\"name\": " << jsonString(p.name)
+            << ", \"cat\": " << jsonString(p.type)
+            << ", \"ph\": \"X\", \"pid\": 0, \"tid\": 0"
+            << format(", \"ts\": %.3f, \"dur\": %.3f", p.startMs * 1e3, p.timeMs * 1e3)
+            << ", \"args\": {\"id\": " << p.id
+            << ", \"backend\": " << jsonString(p.backend)
+            << ", \"kernel\": " << jsonString(p.kernel)
+            << ", \"fusion\": " << jsonString(p.fusion)
+            << ", \"skipped\": " << (p.skipped ? "true" : "false")
+            << ", \"flops\": " << p.flops
+            << ", \"bytes_read\": " << p.bytesRead
+            << ", \"bytes_written\": " << p.bytesWritten
+            << ", \"blobs_memory\": " << p.blobsMemory << "}}";
+    }
+    ofs << "\n], \"displayTimeUnit\": \"ms\"}\n";
+    if (!ofs.good())
+        CV_Error(Error::StsError, "Failed to write " + filename);
+}
+
+void Net::quantize(InputArrayOfArrays calibData)
+{
+    CV_TRACE_FUNCTION();
+
+    std::vector<Mat> blobs;
+    if (!calibData.empty())
+    {
+        if (calibData.kind() == _InputArray::STD_VECTOR_MAT)
+            calibData.getMatVector(blobs);
+        else
+            blobs.push_back(calibData.getMat());
+    }
+    impl->quantize(blobs);
+}
+
+// Compiled network file consists of a header (with the target which the network was prepared
+// for), names of the network inputs and the layers in order of their ids. The layers are saved
+// after fusion: scales and shifts (e.g. batch normalization) which are folded into the weights
+// of convolutions are not saved, the folded weights are saved instead. Every layer is stored
+// with its type, parameters, blobs, input connections and the prepared weights (see
+// CompiledLayerState). Data of blobs is aligned from the beginning of the file, so the file
+// is mapped to memory by readNetFromCompiled() and the blobs refer to the mapping directly.
+static const char compiledNetMagic[8] = {'C', 'V', 'D', 'N', 'N', 'N', 'E', 'T'};
+static const int compiledNetVersion = 4;
+static const int compiledNetAlign = 64;
+
+enum { COMPILED_PARAM_INT = 0, COMPILED_PARAM_REAL = 1, COMPILED_PARAM_STRING = 2 };
+
+template<typename T>
+static void writeValue(std::ostream& os, const T& value)
+{
+    os.write((const char*)&value, sizeof(value));
+}
+
+static void writeString(std::ostream& os, const String& str)
+{
+    writeValue(os, (int)str.size());
+    os.write(str.c_str(), str.size());
+}
+
+static void writeBlob(std::ostream& os, const Mat& blob_)
+{
+    Mat blob = blob_.isContinuous() ? blob_ : blob_.clone();
+    writeValue(os, blob.type());
+    writeValue(os, blob.empty() ? 0 : blob.dims);
+    if (blob.empty())
+        return;
+    for (int i = 0; i < blob.dims; i++)
+        writeValue(os, blob.size[i]);
+    size_t pos = (size_t)os.tellp();
+    std::vector<char> padding(alignSize(pos, compiledNetAlign) - pos, 0);
+    os.write(padding.empty() ? 0 : &padding[0], padding.size());
+    os.write((const char*)blob.data, blob.total()*blob.elemSize());
+}
+
+// Memory of compiled network files. The files are mapped privately (copy-on-write),
+// so the layers may modify the blobs in place. Blobs refer to the memory by UMatData,
+// which is released when the last of them is released.
+class CompiledNetAllocator : public MatAllocator
+{
+public:
+    UMatData* load(const String& path) const
+    {
+        UMatData* u = 0;
+#ifdef CV_DNN_USE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return 0;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void* ptr = mmap(0, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (ptr != MAP_FAILED)
+            {
+                u = new UMatData(this);
+                u->data = u->origdata = (uchar*)ptr;
+                u->size = (size_t)st.st_size;
+            }
+        }
+        ::close(fd);
+#else
+        std::ifstream ifs(path.c_str(), std::ios::binary | std::ios::ate);
+        if (!ifs.is_open())
+            return 0;
+        size_t size = (size_t)ifs.tellg();
+        ifs.seekg(0);
+        if (size > 0)
+        {
+            u = new UMatData(this);
+            u->data = u->origdata = (uchar*)fastMalloc(size);
+            u->size = size;
+            if (!ifs.read((char*)u->data, size))
+            {
+                deallocate(u);
+                return 0;
+            }
+        }
+#endif
+        if (u)
+            u->refcount = 1;
+        return u;
+    }
+
+    UMatData* allocate(int, const int*, int, void*, size_t*, int, UMatUsageFlags) const
+    {
+        CV_Error(Error::StsNotImplemented, "");
+        return 0;
+    }
+
+    bool allocate(UMatData*, int, UMatUsageFlags) const
+    {
+        return false;
+    }
+
+    void deallocate(UMatData* u) const
+    {
+        if (!u)
+            return;
+        CV_Assert(u->urefcount == 0 && u->refcount == 0);
+#ifdef CV_DNN_USE_MMAP
+        munmap(u->origdata, u->size);
+#else
+        fastFree(u->origdata);
+#endif
+        delete u;
+    }
+};
+
+static CompiledNetAllocator* getCompiledNetAllocator()
+{
+    static CompiledNetAllocator* instance = new CompiledNetAllocator();
+    return instance;
+}
+
+class CompiledNetReader
+{
+public:
+    CompiledNetReader(const String& path) : u(getCompiledNetAllocator()->load(path)), pos(0)
+    {
+        if (!u)
+            CV_Error(Error::StsError, "Failed to open " + path);
+    }
+
+    ~CompiledNetReader()
+    {
+        if (CV_XADD(&u->refcount, -1) == 1)
+            u->currAllocator->unmap(u);
+    }
+
+    void read(void* data, size_t size)
+    {
+        if (size > u->size - pos)
+            CV_Error(Error::StsParseError, "Unexpected end of compiled network file");
+        memcpy(data, u->data + pos, size);
+        pos += size;
+    }
+
+    template<typename T>
+    T value()
+    {
+        T v;
+        read(&v, sizeof(v));
+        return v;
+    }
+
+    // Reads the number of the following items, each of them takes at least itemSize bytes,
+    // so a corrupted file can't request more items than the rest of the file holds.
+    int count(size_t itemSize)
+    {
+        int n = value<int>();
+        CV_Assert(n >= 0, itemSize > 0);
+        if ((size_t)n > (u->size - pos) / itemSize)
+            CV_Error(Error::StsParseError, "Unexpected end of compiled network file");
+        return n;
+    }
+
+    String string()
+    {
+        int size = count(1);
+        String str((const char*)u->data + pos, size);
+        pos += size;
+        return str;
+    }
+
+    // The blob refers to the file memory, nothing is copied.
+    Mat blob()
+    {
+        int type = value<int>(), dims = value<int>();
+        CV_Assert(type == CV_MAT_TYPE(type), 0 <= dims && dims <= CV_MAX_DIM);
+        if (dims == 0)
+            return Mat();
+        std::vector<int> sizes(dims);
+        size_t total = CV_ELEM_SIZE(type);
+        for (int i = 0; i < dims; i++)
+        {
+            sizes[i] = value<int>();
+            CV_Assert(sizes[i] > 0);
+            if ((size_t)sizes[i] > u->size / total)
+                CV_Error(Error::StsParseError, "Unexpected end of compiled network file");
+            total *= sizes[i];
+        }
+        pos = std::min(alignSize(pos, compiledNetAlign), u->size);
+        if (total > u->size - pos)
+            CV_Error(Error::StsParseError, "Unexpected end of compiled network file");
+        Mat m(dims, &sizes[0], type, u->data + pos);
+        m.u = u;
+        CV_XADD(&u->refcount, 1);
+        pos += total;
+        return m;
+    }
+
+private:
+    UMatData* u;
+    size_t pos;
+};
+
+void Net::save(const String& path) const
+{
+    CV_TRACE_FUNCTION();
+
+    if (impl->preferableBackend != DNN_BACKEND_DEFAULT ||
+        (impl->preferableTarget != DNN_TARGET_CPU && impl->preferableTarget != DNN_TARGET_CPU_FP16))
+        CV_Error(Error::StsNotImplemented, "Only networks for the default backend and CPU targets can be saved");
+    const std::vector<Mat>& inputs = impl->layers[0].outputBlobs;
+    if (inputs.empty() || inputs[0].empty())
+        CV_Error(Error::StsError, "Input of the network must be set before saving it (see setInput)");
+    // fusion and weights depend on the input shapes
+    impl->setUpNet(impl->blobsToKeep);
+
+    std::ofstream ofs(path.c_str(), std::ios::binary);
+    if (!ofs.is_open())
+        CV_Error(Error::StsError, "Failed to open " + path);
+
+    ofs.write(compiledNetMagic, sizeof(compiledNetMagic));
+    writeValue(ofs, compiledNetVersion);
+    writeValue(ofs, impl->preferableTarget);
+
+    const std::vector<String>& inputNames = impl->netInputLayer->getNames();
+    writeValue(ofs, (int)inputNames.size());
+    for (size_t i = 0; i < inputNames.size(); i++)
+        writeString(ofs, inputNames[i]);
+
+    // Folded layers are omitted if the weights are saved with them,
+    // their consumers are connected to the layers with the folded weights.
+    std::map<int, int> folded;
+    std::map<int, int>::const_iterator foldedIt;
+    for (foldedIt = impl->layersFoldedInto.begin(); foldedIt != impl->layersFoldedInto.end(); ++foldedIt)
+    {
+        const Ptr<Layer>& owner = impl->layers[foldedIt->second].layerInstance;
+        if (dynamic_cast<CompiledLayerState*>(owner.get()))
+            folded.insert(*foldedIt);
+    }
+
+    writeValue(ofs, (int)(impl->layers.size() - folded.size()) - 1);
+    Impl::MapIdToLayerData::const_iterator it;
+    for (it = impl->layers.begin(); it != impl->layers.end(); ++it)
+    {
+        const LayerData& ld = it->second;
+        if (ld.id == 0 || folded.count(ld.id))
+            continue;
+
+        LayerParams params = ld.params;
+        if (!ld.layerInstance.empty())
+            params.blobs = ld.layerInstance->blobs;
+        std::vector<Mat> state;
+        CompiledLayerState* compiled = dynamic_cast<CompiledLayerState*>(ld.layerInstance.get());
+        if (compiled)
+            compiled->exportState(params, state);
+
+        writeValue(ofs, ld.id);
+        writeString(ofs, ld.name);
+        writeString(ofs, ld.type);
+
+        int nparams = (int)std::distance(params.begin(), params.end());
+        writeValue(ofs, nparams);
+        std::map<String, DictValue>::const_iterator paramIt;
+        for (paramIt = params.begin(); paramIt != params.end(); ++paramIt)
+        {
+            const DictValue& value = paramIt->second;
+            writeString(ofs, paramIt->first);
+            writeValue(ofs, (int)(value.isInt() ? COMPILED_PARAM_INT :
+                                  value.isReal() ? COMPILED_PARAM_REAL : COMPILED_PARAM_STRING));
+            writeValue(ofs, value.size());
+            for (int i = 0; i < value.size(); i++)
+            {
+                if (value.isInt())
+                    writeValue(ofs, value.get<int64>(i));
+                else if (value.isReal())
+                    writeValue(ofs, value.get<double>(i));
+                else
+                    writeString(ofs, value.get<String>(i));
+            }
+        }
+
+        writeValue(ofs, (int)params.blobs.size());
+        for (size_t i = 0; i < params.blobs.size(); i++)
+            writeBlob(ofs, params.blobs[i]);
+
+        writeValue(ofs, (int)ld.inputBlobsId.size());
+        for (size_t i = 0; i < ld.inputBlobsId.size(); i++)
+        {
+            LayerPin pin = ld.inputBlobsId[i];
+            foldedIt = folded.find(pin.lid);
+            if (foldedIt != folded.end())
+                pin = LayerPin(foldedIt->second, 0);
+            writeValue(ofs, pin.lid);
+            writeValue(ofs, pin.oid);
+        }
+
+        writeValue(ofs, (int)state.size());
+        for (size_t i = 0; i < state.size(); i++)
+            writeBlob(ofs, state[i]);
+    }
+    if (!ofs.good())
+        CV_Error(Error::StsError, "Failed to write " + path);
+}
+
+Net readNetFromCompiled(const String& path)
+{
+    CV_TRACE_FUNCTION();
+
+    CompiledNetReader reader(path);
+
+    char magic[sizeof(compiledNetMagic)];
+    reader.read(magic, sizeof(magic));
+    if (memcmp(magic, compiledNetMagic, sizeof(magic)) != 0)
+        CV_Error(Error::StsParseError, path + " is not a compiled network file");
+    int version = reader.value<int>();
+    if (version != compiledNetVersion)
+        CV_Error(Error::StsNotImplemented, format("Unsupported version of compiled network: %d", version));
+    int target = reader.value<int>();
+    if (target != DNN_TARGET_CPU && target != DNN_TARGET_CPU_FP16)
+        CV_Error(Error::StsParseError, format("Unsupported target of compiled network: %d", target));
+
+    Net net;
+    net.setPreferableTarget(target);
+    // minimal sizes of the stored items: a string is its length, a blob is its type and
+    // dimensionality, a parameter is its name, kind and size, a layer is its id, name, type
+    // and four counts
+    const size_t stringSize = sizeof(int), blobSize = 2*sizeof(int), paramSize = stringSize + 2*sizeof(int),
+                 layerSize = 5*sizeof(int) + 2*stringSize;
+    std::vector<String> inputNames(reader.count(stringSize));
+    for (size_t i = 0; i < inputNames.size(); i++)
+        inputNames[i] = reader.string();
+    net.setInputsNames(inputNames);
+
+    std::map<int, int> layersIds;
+    layersIds[0] = 0;
+    int nlayers = reader.count(layerSize);
+    for (int i = 0; i < nlayers; i++)
+    {
+        int savedId = reader.value<int>();
+        LayerParams params;
+        params.name = reader.string();
+        params.type = reader.string();
+
+        int nparams = reader.count(paramSize);
+        for (int j = 0; j < nparams; j++)
+        {
+            String key = reader.string();
+            int kind = reader.value<int>();
+            int size = reader.count(kind == COMPILED_PARAM_INT ? sizeof(int64) :
+                                    kind == COMPILED_PARAM_REAL ? sizeof(double) : stringSize);
+            if (kind == COMPILED_PARAM_INT)
+            {
+                std::vector<int64> values(size);
+                for (int k = 0; k < size; k++)
+                    values[k] = reader.value<int64>();
+                params.set(key, DictValue::arrayInt(values.begin(), size));
+            }
+            else if (kind == COMPILED_PARAM_REAL)
+            {
+                std::vector<double> values(size);
+                for (int k = 0; k < size; k++)
+                    values[k] = reader.value<double>();
+                params.set(key, DictValue::arrayReal(values.begin(), size));
+            }
+            else if (kind == COMPILED_PARAM_STRING)
+            {
+                std::vector<String> values(size);
+                for (int k = 0; k < size; k++)
+                    values[k] = reader.string();
+                params.set(key, DictValue::arrayString(values.begin(), size));
+            }
+            else
+                CV_Error(Error::StsParseError, format("Unknown type of parameter \"%s\"", key.c_str()));
+        }
+
+        params.blobs.resize(reader.count(blobSize));
+        for (size_t j = 0; j < params.blobs.size(); j++)
+            params.blobs[j] = reader.blob();
+
+        int id = net.addLayer(params.name, params.type, params);
+        layersIds[savedId] = id;
+
+        int ninputs = reader.count(2*sizeof(int));
+        for (int j = 0; j < ninputs; j++)
+        {
+            int lid = reader.value<int>(), oid = reader.value<int>();
+            CV_Assert(oid >= 0);
+            std::map<int, int>::iterator inpIt = layersIds.find(lid);
+            if (inpIt == layersIds.end())
+                CV_Error(Error::StsParseError, "Layer \"" + params.name + "\" refers to an unknown input");
+            net.connect(inpIt->second, oid, id, j);
+        }
+
+        std::vector<Mat> state(reader.count(blobSize));
+        for (size_t j = 0; j < state.size(); j++)
+            state[j] = reader.blob();
+        if (!state.empty())
+        {
+            Ptr<Layer> layer = net.getLayer(id);
+            CompiledLayerState* compiled = dynamic_cast<CompiledLayerState*>(layer.get());
+            if (!compiled)
+                CV_Error(Error::StsParseError, "Layer \"" + params.name + "\" doesn't have prepared weights");
+            compiled->importState(state);
+        }
+    }
+    return net;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 Layer::Layer() { preferableTarget = DNN_TARGET_CPU; }
@@ -2612,6 +4349,8 @@ Ptr<BackendNode> Layer::tryAttach(const Ptr<BackendNode>& node)
 
 bool Layer::setActivation(const Ptr<ActivationLayer>&) { return false; }
 bool Layer::tryFuse(Ptr<Layer>&) { return false; }
+bool Layer::tryQuantize(float) { return false; }
+String Layer::getKernelName() const { return String(); }
 void Layer::getScaleShift(Mat& scale, Mat& shift) const
 {
     scale = Mat();
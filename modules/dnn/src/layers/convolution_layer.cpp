@@ -165,14 +165,31 @@ public:
 #define IS_POWER_LAYER(layer) \
             (!layer.empty() && !layer->type.compare("Power"))
 //TODO: simultaneously convolution and bias addition for cache optimization
-class ConvolutionLayerImpl : public BaseConvolutionLayerImpl
+class ConvolutionLayerImpl : public BaseConvolutionLayerImpl, public CompiledLayerState
 {
 public:
-    enum { VEC_ALIGN = 8, DFT_TYPE = CV_32F };
+    enum { VEC_ALIGN = 8, VEC_ALIGN_INT8 = 16, DFT_TYPE = CV_32F };
     Mat weightsMat, weightsMat_doubles;
     std::vector<float> biasvec;
     std::vector<float> reluslope;
     Ptr<ActivationLayer> activ;
+    // 8-bit weights with a scale per output channel (see tryQuantize).
+    Mat weightsMatInt8;
+    std::vector<float> weightsScales, weightsScalesOrig;
+    float inputScaleInt8;
+    // transformed weights for Winograd convolution (see WinogradConv)
+    Mat weightsWinograd;
+    // half precision weights for DNN_TARGET_CPU_FP16 with a scale per output channel
+    // (weightsScales, the same as for 8-bit weights)
+    Mat weightsMatFp16;
+    // implementation chosen in finalize(), see getKernelName()
+    String kernelName, cpuKernelName;
+    // Single precision weights are prepared once and kept by the next finalize() calls
+    // (i.e. when the input shape is changed) while the same scales and shifts are fused.
+    // blobs[0] which weightsMat is prepared from, scales and shifts (pairs of w and b,
+    // see fuseWeights) fused into weightsMat and the ones requested after finalize().
+    Mat weightsSource;
+    std::vector<Mat> fusedScaleShift, requestedScaleShift;
 
 #ifdef HAVE_OPENCL
     Ptr<OCL4DNNConvSpatial<float> > convolutionOp;
@@ -185,6 +202,7 @@ public:
 #endif
     ConvolutionLayerImpl(const LayerParams &params) : BaseConvolutionLayerImpl(params)
     {
+        inputScaleInt8 = 0.f;
 #ifdef HAVE_OPENCL
         fusedBias = false;
         newWeightAndBias = false;
@@ -194,6 +212,13 @@ public:
 #endif
     }
 
+    virtual bool supportBackend(int backendId)
+    {
+        // 8-bit and half precision weights are computed by the default backend only
+        return BaseConvolutionLayerImpl::supportBackend(backendId) &&
+               (backendId == DNN_BACKEND_DEFAULT || blobs[0].type() == CV_32F);
+    }
+
     MatShape computeColRowShape(const MatShape &inpShape, const MatShape &outShape) const
     {
         Size out(outShape[3], outShape[2]);
@@ -244,6 +269,95 @@ public:
         BaseConvolutionLayerImpl::finalize(inputs, outputs);
 
         CV_Assert(!blobs.empty());
+        const int outCn = blobs[0].size[0];
+        requestedScaleShift.clear();
+        // single precision weights set after the quantization (see Net::setParam)
+        if( !weightsMatInt8.empty() && blobs[0].type() == CV_32F )
+            tryQuantize(inputScaleInt8);
+        if( weightsMatInt8.empty() )
+        {
+            if( preferableTarget == DNN_TARGET_CPU_FP16 )
+            {
+                if( blobs[0].type() == CV_32F )
+                    convertToFp16();
+            }
+            else if( blobs[0].type() == CV_16S )
+            {
+                // switching from DNN_TARGET_CPU_FP16 keeps the rounding to half precision
+                blobs[0] = unpackBlob(0);
+                weightsMatFp16.release();
+            }
+        }
+        if( hasScaledWeights() )
+        {
+            // 8-bit and half precision weights are kept as is, fusion modifies the scales only
+            weightsScales = weightsScalesOrig;
+            resetBias();
+        }
+        else
+        {
+            // Winograd algorithm is used for 3x3 convolutions with unit strides.
+            // It is not worth it for a few channels because of the transformations overhead.
+            bool useWinograd = preferableTarget == DNN_TARGET_CPU &&
+                               kernel == Size(3, 3) && stride == Size(1, 1) && dilation == Size(1, 1) &&
+                               inputs[0]->size[1] == blobs[0].size[1] && blobs[0].size[1] >= 8 && outCn >= 16;
+            if( preferableTarget == DNN_TARGET_OPENCL || weightsMat.empty() ||
+                weightsSource.data != blobs[0].data || useWinograd == weightsWinograd.empty() )
+                prepareWeights(useWinograd);
+        }
+
+        int ngroups = inputs[0]->size[1] / blobs[0].size[1];
+        bool isDepthwise = ngroups == outCn && blobs[0].size[1] == 1;
+        cpuKernelName = !weightsMatInt8.empty() ? "int8" :
+                        isDepthwise && DepthwiseConv::isSupported(kernel, stride, dilation) ? "depthwise" :
+                        !weightsMatFp16.empty() ? "fp16" :
+                        !weightsWinograd.empty() ? "winograd" : "im2row";
+        // forward() reports the CPU kernel if the OpenCL one fails and the layer falls back to CPU
+        kernelName = preferableTarget == DNN_TARGET_OPENCL && weightsMatInt8.empty() ? "ocl4dnn" : cpuKernelName;
+
+    }
+
+    bool hasScaledWeights() const
+    {
+        return !weightsMatInt8.empty() || !weightsMatFp16.empty();
+    }
+
+    // Half precision weights replace the single precision ones (including blobs[0]),
+    // see unpackBlob() for the single precision ones.
+    void convertToFp16()
+    {
+        const int outCn = blobs[0].size[0];
+        convertWeightsFp16(blobs[0].reshape(1, outCn), weightsMatFp16, VEC_ALIGN);
+        blobs[0] = blobFromRows(weightsMatFp16, shape(blobs[0]));
+        weightsScalesOrig.assign(outCn + 2, 1.f);
+        weightsMat.release();
+        weightsMat_doubles.release();
+        weightsWinograd.release();
+        weightsSource.release();
+#ifdef HAVE_OPENCL
+        umat_blobs.clear();
+#endif
+    }
+
+    void resetBias()
+    {
+        const int outCn = blobs[0].size[0];
+        Mat biasMat = hasBias() ? blobs[1].reshape(1, outCn) : Mat();
+        biasvec.resize(outCn+2);
+        if( biasMat.empty() )
+        {
+            for(int i = 0; i < outCn; i++ )
+                biasvec[i] = 0.f;
+        }
+        else
+        {
+            for(int i = 0; i < outCn; i++ )
+                biasvec[i] = biasMat.at<float>(i);
+        }
+    }
+
+    void prepareWeights(bool useWinograd)
+    {
         const int outCn = blobs[0].size[0];
         // prepare weightsMat where each row is aligned and has enough zero padding on the right to
         // use vectorized (i.e. with intrinsics) loops without tail processing
@@ -259,20 +373,49 @@ public:
             wm = wm_aligned;
         }
         weightsMat = wm;
+        // new matrices, since the old ones may be shared (see shareState)
+        weightsMat_doubles.release();
         weightsMat.convertTo(weightsMat_doubles, CV_64F);
 
-        Mat biasMat = hasBias() ? blobs[1].reshape(1, outCn) : Mat();
-        biasvec.resize(outCn+2);
-        if( biasMat.empty() )
-        {
-            for(int i = 0; i < outCn; i++ )
-                biasvec[i] = 0.f;
-        }
-        else
-        {
-            for(int i = 0; i < outCn; i++ )
-                biasvec[i] = biasMat.at<float>(i);
-        }
+        weightsWinograd.release();
+        if( useWinograd )
+            WinogradConv::transformWeights(weightsMat, blobs[0].size[1], weightsWinograd);
+
+        weightsMatFp16.release();
+        resetBias();
+        weightsSource = blobs[0];
+        fusedScaleShift.clear();
+    }
+
+    static bool equalScaleShift(const Mat& a, const Mat& b)
+    {
+        if( a.empty() || b.empty() )
+            return a.empty() && b.empty();
+        return a.total() == b.total() && a.type() == b.type() && b.isContinuous() &&
+               norm(a.reshape(1, 1), b.reshape(1, 1), NORM_INF) == 0;
+    }
+
+    // Prepares the weights again if the requested scales and shifts
+    // differ from the fused ones (e.g. some of them are not fused anymore).
+    void syncWeights()
+    {
+        if( hasScaledWeights() || weightsMat.empty() )
+            return;
+        bool same = requestedScaleShift.size() == fusedScaleShift.size();
+        for( size_t i = 0; same && i < requestedScaleShift.size(); i++ )
+            same = equalScaleShift(fusedScaleShift[i], requestedScaleShift[i]);
+        if( same )
+            return;
+
+        prepareWeights(!weightsWinograd.empty());
+        for( size_t i = 0; i < requestedScaleShift.size(); i += 2 )
+            applyScaleShift(requestedScaleShift[i], requestedScaleShift[i + 1]);
+        fusedScaleShift = requestedScaleShift;
+    }
+
+    virtual String getKernelName() const
+    {
+        return kernelName;
     }
 
     bool setActivation(const Ptr<ActivationLayer>& layer)
@@ -321,24 +464,262 @@ public:
         return false;
     }
 
+    virtual bool tryQuantize(float inputScale)
+    {
+        CV_Assert(!blobs.empty());
+        inputScaleInt8 = inputScale;
+        if( blobs[0].type() == CV_8S )
+            return true;
+        if( blobs[0].type() == CV_16S )
+            blobs[0] = unpackBlob(0);
+        CV_Assert(blobs[0].type() == CV_32F);
+        const int outCn = blobs[0].size[0];
+        Mat wm = blobs[0].reshape(1, outCn);
+        int vecsize = wm.cols;
+        int vecsize_aligned = (int)alignSize(vecsize, VEC_ALIGN_INT8);
+
+        // the padding must be zero because the integer kernels process
+        // the whole aligned rows without tail processing
+        Mat wmInt8 = Mat::zeros(outCn, vecsize_aligned, CV_8S);
+        weightsScalesOrig.resize(outCn + 2);
+        for (int i = 0; i < outCn; ++i)
+        {
+            double maxVal = norm(wm.row(i), NORM_INF);
+            float scale = maxVal > 0 ? (float)(maxVal / 127) : 1.f;
+            wm.row(i).convertTo(wmInt8.row(i).colRange(0, vecsize), CV_8S, 1. / scale);
+            weightsScalesOrig[i] = scale;
+        }
+        weightsScalesOrig[outCn] = weightsScalesOrig[outCn+1] = weightsScalesOrig[outCn-1];
+        weightsScales = weightsScalesOrig;
+
+        weightsMatInt8 = wmInt8.colRange(0, vecsize);
+        // 8-bit weights replace the floating point ones (including blobs[0]),
+        // see unpackBlob() for the single precision ones.
+        blobs[0] = blobFromRows(weightsMatInt8, shape(blobs[0]));
+        weightsMat.release();
+        weightsMat_doubles.release();
+        weightsWinograd.release();
+        weightsMatFp16.release();
+        weightsSource.release();
+#ifdef HAVE_OPENCL
+        umat_blobs.clear();
+#endif
+        return true;
+    }
+
     void fuseWeights(const Mat& w, const Mat& b)
+    {
+        if( !hasScaledWeights() )
+        {
+            size_t k = requestedScaleShift.size();
+            requestedScaleShift.push_back(w.clone());
+            requestedScaleShift.push_back(b.clone());
+            // already fused before the last finalize() call
+            if( k + 2 <= fusedScaleShift.size() &&
+                equalScaleShift(fusedScaleShift[k], w) && equalScaleShift(fusedScaleShift[k + 1], b) )
+                return;
+            if( k != fusedScaleShift.size() )
+            {
+                syncWeights();
+                return;
+            }
+            fusedScaleShift = requestedScaleShift;
+        }
+        applyScaleShift(w, b);
+    }
+
+    // Compiled network state: single precision weights (only if the rows are padded,
+    // otherwise they are blobs[0]), Winograd weights, 8-bit weights, the scales of
+    // 8-bit or half precision weights, the input scale and half precision weights.
+    enum { STATE_WEIGHTS, STATE_WINOGRAD, STATE_INT8, STATE_SCALES, STATE_INPUT_SCALE, STATE_FP16, STATE_COUNT };
+
+    virtual void exportState(LayerParams& params, std::vector<Mat>& state)
+    {
+        CV_Assert(!blobs.empty());
+        const int outCn = blobs[0].size[0];
+        state.assign(STATE_COUNT, Mat());
+
+        params.blobs.resize(2);
+        if( !weightsMatInt8.empty() )
+        {
+            // fusion modifies the scales of 8-bit weights only
+            params.blobs[0] = blobs[0];
+            state[STATE_INT8] = paddedRows(weightsMatInt8);
+            state[STATE_SCALES] = Mat(weightsScales, true).reshape(1, 1);
+            state[STATE_INPUT_SCALE] = Mat(1, 1, CV_32F, Scalar(inputScaleInt8));
+        }
+        else if( !weightsMatFp16.empty() )
+        {
+            // the same for half precision weights
+            params.blobs[0] = blobs[0];
+            state[STATE_FP16] = paddedRows(weightsMatFp16);
+            state[STATE_SCALES] = Mat(weightsScales, true).reshape(1, 1);
+        }
+        else
+        {
+            if( weightsMat.step1() != (size_t)weightsMat.cols )
+                state[STATE_WEIGHTS] = paddedRows(weightsMat);
+            state[STATE_WINOGRAD] = weightsWinograd;
+            params.blobs[0] = Mat(blobs[0].dims, blobs[0].size.p, CV_32F);
+            Mat wdst = params.blobs[0].reshape(1, outCn);
+            weightsMat.copyTo(wdst);
+        }
+        params.blobs[1] = Mat(1, outCn, CV_32F, &biasvec[0]).clone();
+        params.set("bias_term", true);
+    }
+
+    virtual void importState(const std::vector<Mat>& state)
+    {
+        CV_Assert(state.size() == (size_t)STATE_COUNT, blobs.size() == 2,
+                  blobs[0].dims == 4, blobs[1].type() == CV_32F,
+                  blobs[1].total() == (size_t)blobs[0].size[0]);
+        const int outCn = blobs[0].size[0];
+        const int vecsize = (int)(blobs[0].total() / outCn);
+
+        const Mat& wInt8 = state[STATE_INT8];
+        const Mat& wFp16 = state[STATE_FP16];
+        CV_Assert(blobs[0].type() == (!wInt8.empty() ? CV_8S : !wFp16.empty() ? CV_16S : CV_32F));
+        if( !wInt8.empty() )
+        {
+            const Mat& scales = state[STATE_SCALES];
+            CV_Assert(wInt8.type() == CV_8S, wInt8.rows == outCn, wInt8.cols >= vecsize,
+                      wInt8.cols % VEC_ALIGN_INT8 == 0, scales.type() == CV_32F,
+                      scales.total() == (size_t)outCn + 2, state[STATE_INPUT_SCALE].total() == 1);
+            weightsMatInt8 = wInt8.colRange(0, vecsize);
+            blobs[0] = blobFromRows(weightsMatInt8, shape(blobs[0]));
+            scales.reshape(1, 1).copyTo(weightsScalesOrig);
+            weightsScales = weightsScalesOrig;
+            inputScaleInt8 = state[STATE_INPUT_SCALE].at<float>(0);
+            weightsMat.release();
+            weightsWinograd.release();
+            weightsMatFp16.release();
+        }
+        else if( !wFp16.empty() )
+        {
+            const Mat& scales = state[STATE_SCALES];
+            CV_Assert(wFp16.type() == CV_16S, wFp16.rows == outCn, wFp16.cols >= vecsize,
+                      wFp16.cols % VEC_ALIGN == 0, scales.type() == CV_32F,
+                      scales.total() == (size_t)outCn + 2);
+            weightsMatFp16 = wFp16.colRange(0, vecsize);
+            blobs[0] = blobFromRows(weightsMatFp16, shape(blobs[0]));
+            scales.reshape(1, 1).copyTo(weightsScalesOrig);
+            weightsScales = weightsScalesOrig;
+            weightsMat.release();
+            weightsWinograd.release();
+        }
+        else
+        {
+            const Mat& wm = state[STATE_WEIGHTS];
+            CV_Assert(wm.empty() ? vecsize % VEC_ALIGN == 0 :
+                      wm.type() == CV_32F && wm.rows == outCn && wm.cols >= vecsize && wm.cols % VEC_ALIGN == 0);
+            weightsMat = wm.empty() ? blobs[0].reshape(1, outCn) : wm.colRange(0, vecsize);
+            weightsWinograd = state[STATE_WINOGRAD];
+            weightsSource = blobs[0];
+        }
+        weightsMat_doubles.release();
+        fusedScaleShift.clear();
+        requestedScaleShift.clear();
+        resetBias();
+    }
+
+    virtual bool isQuantized(float& inputScale) const
+    {
+        inputScale = inputScaleInt8;
+        return !weightsMatInt8.empty();
+    }
+
+    virtual Mat unpackBlob(int idx) const
+    {
+        CV_Assert(0 <= idx && idx < (int)blobs.size());
+        if( idx != 0 || blobs[0].type() == CV_32F )
+            return blobs[idx];
+        const int outCn = blobs[0].size[0];
+        Mat wm(blobs[0].dims, blobs[0].size.p, CV_32F);
+        Mat wrows = wm.reshape(1, outCn);
+        if( blobs[0].type() == CV_16S )
+            convertFp16(weightsMatFp16, wrows);
+        for( int i = 0; i < outCn; i++ )
+        {
+            if( blobs[0].type() == CV_8S )
+                weightsMatInt8.row(i).convertTo(wrows.row(i), CV_32F, weightsScalesOrig[i]);
+            else
+                wrows.row(i).convertTo(wrows.row(i), CV_32F, weightsScalesOrig[i]);
+        }
+        return wm;
+    }
+
+    virtual void shareState(const CompiledLayerState& src_)
+    {
+        const ConvolutionLayerImpl& src = dynamic_cast<const ConvolutionLayerImpl&>(src_);
+        CV_Assert(src.blobs.size() == blobs.size(), src.blobs[0].data == blobs[0].data);
+        weightsMatInt8 = src.weightsMatInt8;
+        weightsScalesOrig = src.weightsScalesOrig;
+        weightsScales = src.weightsScales;
+        inputScaleInt8 = src.inputScaleInt8;
+        weightsMatFp16 = src.weightsMatFp16;
+        // prepared single precision weights with the fused scales and shifts;
+        // they are never modified in place, so the instances can use them at the same time
+        weightsMat = src.weightsMat;
+        weightsMat_doubles = src.weightsMat_doubles;
+        weightsWinograd = src.weightsWinograd;
+        weightsSource = src.weightsSource;
+        fusedScaleShift = src.fusedScaleShift;
+        biasvec = src.biasvec;
+    }
+
+    void applyScaleShift(const Mat& w, const Mat& b)
     {
         // Convolution weights have OIHW data layout. Parameters fusion in case of
         // (conv(I) + b1 ) * w + b2
         // means to replace convolution's weights to [w*conv(I)] and bias to [b1 * w + b2]
-        const int outCn = weightsMat.size[0];
-        CV_Assert(!weightsMat.empty(), biasvec.size() == outCn + 2,
+        const int outCn = blobs[0].size[0];
+        CV_Assert(!weightsMat.empty() || hasScaledWeights(), biasvec.size() == outCn + 2,
                   w.empty() || outCn == w.total(), b.empty() || outCn == b.total());
 
         if (!w.empty())
         {
-            for (int i = 0; i < outCn; ++i)
+            if (hasScaledWeights())
             {
-                double wi = w.at<float>(i);
-                cv::multiply(slice(weightsMat_doubles, i), wi, slice(weightsMat_doubles, i));
-                biasvec[i] *= wi;
+                for (int i = 0; i < outCn; ++i)
+                {
+                    float wi = w.at<float>(i);
+                    weightsScales[i] *= wi;
+                    biasvec[i] *= wi;
+                }
+                weightsScales[outCn] = weightsScales[outCn+1] = weightsScales[outCn-1];
+            }
+            else
+            {
+                // The weights may be shared with blobs[0] (weights of a loaded compiled network)
+                // or with the layers of cloned networks (see shareState), so the scaled ones
+                // are stored in new matrices. Weights of a loaded compiled network are not
+                // converted to double precision in advance.
+                Mat wd;
+                if (weightsMat_doubles.empty())
+                    weightsMat.convertTo(wd, CV_64F);
+                else
+                    wd = weightsMat_doubles.clone();
+                for (int i = 0; i < outCn; ++i)
+                {
+                    double wi = w.at<float>(i);
+                    cv::multiply(slice(wd, i), wi, slice(wd, i));
+                    biasvec[i] *= wi;
+                }
+                weightsMat_doubles = wd;
+                int vecsize = weightsMat.cols;
+                Mat wbuf = Mat::zeros(outCn, (int)alignSize(vecsize, VEC_ALIGN), CV_32F);
+                weightsMat = wbuf.colRange(0, vecsize);
+                wd.convertTo(weightsMat, CV_32F);
+
+                if (!weightsWinograd.empty())
+                    weightsWinograd = weightsWinograd.clone();
+                for (int i = 0; !weightsWinograd.empty() && i < weightsWinograd.rows; ++i)
+                {
+                    float* wptr = weightsWinograd.ptr<float>(i);
+                    for (int j = 0; j < outCn; ++j)
+                        wptr[j] *= w.at<float>(j);
+                }
             }
-            weightsMat_doubles.convertTo(weightsMat, weightsMat.type());
         }
 
         if (!b.empty())
@@ -446,6 +827,7 @@ public:
         const Mat* input_;
         const Mat* weights_;
         Mat* output_;
+        const Mat* residual_;
         int outShape[4];
         Size kernel_, pad_, stride_, dilation_;
         int ngroups_, nstripes_;
@@ -453,37 +835,67 @@ public:
         const std::vector<float>* biasvec_;
         const std::vector<float>* reluslope_;
         const ActivationLayer* activ_;
+        const std::vector<float>* weightsScales_;
+        float inputScale_;
         bool is1x1_;
+        bool isInt8_;
+        bool isFp16_;
         bool useAVX;
         bool useAVX2;
         bool useAVX512;
 
         ParallelConv()
-            : input_(0), weights_(0), output_(0), ngroups_(0), nstripes_(0),
-              biasvec_(0), reluslope_(0), activ_(0), is1x1_(false), useAVX(false), useAVX2(false), useAVX512(false)
+            : input_(0), weights_(0), output_(0), residual_(0), ngroups_(0), nstripes_(0),
+              biasvec_(0), reluslope_(0), activ_(0), weightsScales_(0), inputScale_(0.f),
+              is1x1_(false), isInt8_(false), isFp16_(false), useAVX(false), useAVX2(false), useAVX512(false)
         {}
 
+        // weights are CV_32F, CV_8S or CV_16S (half precision floats). 8-bit and half precision
+        // weights are scaled by weightsScales (per output channel). For 8-bit weights the input
+        // is quantized with inputScale or, if inputScale is not positive, with the scale
+        // computed from the input range.
+        // residual (if any) is added to the result before the activation.
         static void run( const Mat& input, Mat& output, const Mat& weights,
                          const std::vector<float>& biasvec,
                          const std::vector<float>& reluslope,
                          Size kernel, Size pad, Size stride, Size dilation,
-                         const ActivationLayer* activ, int ngroups, int nstripes )
+                         const ActivationLayer* activ, int ngroups, int nstripes,
+                         const Mat* residual,
+                         const std::vector<float>* weightsScales = 0, float inputScale = 0.f )
         {
             CV_Assert( input.dims == 4 && output.dims == 4,
                        input.size[0] == output.size[0],
                        weights.rows == output.size[1],
                        weights.cols == (input.size[1]/ngroups)*kernel.width*kernel.height,
                        input.type() == output.type(),
-                       input.type() == weights.type(),
+                       weights.type() == CV_32F || weights.type() == CV_8S || weights.type() == CV_16S,
                        input.type() == CV_32F,
                        input.isContinuous(),
                        output.isContinuous(),
                        biasvec.size() == (size_t)output.size[1]+2);
             ParallelConv p;
 
+            p.isInt8_ = weights.type() == CV_8S;
+            p.isFp16_ = weights.type() == CV_16S;
+            if( p.isInt8_ || p.isFp16_ )
+            {
+                CV_Assert( weightsScales && weightsScales->size() == (size_t)output.size[1]+2 );
+                p.weightsScales_ = weightsScales;
+            }
+            if( p.isInt8_ )
+            {
+                if( inputScale <= 0.f )
+                {
+                    double maxVal = norm(input, NORM_INF);
+                    inputScale = maxVal > 0 ? (float)(maxVal / 127) : 1.f;
+                }
+                p.inputScale_ = inputScale;
+            }
+
             p.input_ = &input;
             p.weights_ = &weights;
             p.output_ = &output;
+            p.residual_ = residual;
             for( int i = 0; i < 4; i++ ) p.outShape[i] = output.size[i];
             p.outShape[1] /= ngroups;
             p.kernel_ = kernel; p.pad_ = pad; p.stride_ = stride; p.dilation_ = dilation;
@@ -497,7 +909,9 @@ public:
             p.useAVX2 = checkHardwareSupport(CPU_AVX2);
             p.useAVX512 = CV_CPU_HAS_SUPPORT_AVX512_SKX;
 
-            int ncn = std::min(inpCn, (int)BLK_SIZE_CN);
+            // the quantized path processes all the input channels at once,
+            // so that the integer dot products are accumulated over the whole kernel
+            int ncn = p.isInt8_ ? inpCn : std::min(inpCn, (int)BLK_SIZE_CN);
             p.ofstab_.resize(kernel.width*kernel.height*ncn);
             int* ofstab = &p.ofstab_[0];
 
@@ -553,15 +967,37 @@ public:
 
             const float* data_inp0_ = input_->ptr<float>();
             const int* ofstab = &ofstab_[0];
-            const float* wptr_orig_ = weights_->ptr<float>();
+            const float* wptr_orig_ = isInt8_ || isFp16_ ? 0 : weights_->ptr<float>();
+            const schar* wptr8_orig_ = isInt8_ ? weights_->ptr<schar>() : 0;
+            const short* wptr16_orig_ = isFp16_ ? weights_->ptr<short>() : 0;
             size_t wstep = weights_->step1();
             const float* biasptr_ = &biasvec_->at(0);
             const float* reluptr_ = reluslope_->empty() ? 0 : &reluslope_->at(0);
             float* data_out0_ = output_->ptr<float>();
-            size_t rowbufsz = (size_t)karea*BLK_SIZE_CN*BLK_SIZE;
+            int blkSizeCn = isInt8_ ? inpCn : (int)BLK_SIZE_CN;
+            size_t rowbufsz = alignSize(karea*blkSizeCn, valign)*BLK_SIZE;
             AutoBuffer<float> rowbuf0_(rowbufsz + valign);
             float* rowbuf0 = alignPtr((float*)rowbuf0_, (int)(valign*sizeof(float)));
 
+            // with F16C (always available together with AVX2) the half precision weights
+            // are expanded in registers inside the kernel. Otherwise they are converted
+            // block by block (all the output channels of the group by blkSizeCn input channels);
+            // the block is reused for the whole stripe
+            bool fp16InRegs = isFp16_ && useAVX2;
+            size_t wbufstep = isFp16_ && !fp16InRegs ? alignSize(karea*std::min(inpCn, blkSizeCn), valign) : 0;
+            AutoBuffer<float> wbuf_(wbufstep*outCn + valign);
+            float* wbuf = alignPtr((float*)wbuf_, (int)(valign*sizeof(float)));
+
+            // quantized copy of rowbuf0; its rows are padded with zeros up to vsz8_a
+            const int valign8 = ConvolutionLayerImpl::VEC_ALIGN_INT8;
+            int vsz8_a = isInt8_ ? (int)alignSize(karea*inpCn, valign8) : 0;
+            AutoBuffer<schar> rowbuf8_((size_t)vsz8_a*BLK_SIZE + valign8);
+            schar* rowbuf8 = alignPtr((schar*)rowbuf8_, valign8);
+            const float* wscales_ = isInt8_ || isFp16_ ? &weightsScales_->at(0) : 0;
+            float invInputScale = isInt8_ ? 1.f/inputScale_ : 0.f;
+            if( isInt8_ )
+                memset(rowbuf8, 0, (size_t)vsz8_a*BLK_SIZE);
+
             // we clear the buffer once; ultimately, it lets us to avoid
             // tail processing after running the unrolled/vectorized loop.
             // the main idea is to make sure that the tail (a.k.a. padding) of each row
@@ -586,14 +1022,27 @@ public:
                 const float* wptr_orig = wptr_orig_ + wstep*startOutCn;
                 const float* biasptr = biasptr_ + startOutCn;
 
-                for( int cn0 = 0; cn0 < inpCn; cn0 += BLK_SIZE_CN )
+                for( int cn0 = 0; cn0 < inpCn; cn0 += blkSizeCn )
                 {
-                    int cn1 = std::min(cn0 + BLK_SIZE_CN, inpCn);
+                    int cn1 = std::min(cn0 + blkSizeCn, inpCn);
                     int ncn = cn1 - cn0, vsz = karea*ncn;
                     int vsz_a = (int)alignSize(vsz, valign);
                     const float* wptr = wptr_orig + cn0*karea;
-                    // we apply [Channels][P]ReLU (if any) during the final pass only.
-                    const float* relu = cn1 == inpCn && reluptr_ ? reluptr_ + startOutCn : 0;
+                    size_t wstep_blk = wstep;
+                    if( isFp16_ && !fp16InRegs )
+                    {
+                        Mat wblk(outCn, vsz_a, CV_16S, (void*)(wptr16_orig_ + wstep*startOutCn + cn0*karea),
+                                 wstep*sizeof(short));
+                        Mat wblk32(outCn, vsz_a, CV_32F, wbuf, wbufstep*sizeof(float));
+                        convertFp16(wblk, wblk32);
+                        for( int i = 0; i < outCn; i++ )
+                            wblk32.row(i).convertTo(wblk32.row(i), CV_32F, wscales_[startOutCn + i]);
+                        wptr = wbuf;
+                        wstep_blk = wbufstep;
+                    }
+                    // we apply [Channels][P]ReLU (if any) during the final pass only
+                    // or after adding the residual.
+                    const float* relu = cn1 == inpCn && reluptr_ && !residual_ ? reluptr_ + startOutCn : 0;
 
                     for( int ofs0 = stripeStart; ofs0 < stripeEnd; ofs0 += BLK_SIZE )
                     {
@@ -675,29 +1124,79 @@ public:
                         // now compute dot product of the weights
                         // and im2row-transformed part of the tensor
                         int bsz = ofs1 - ofs0;
+                        if( isInt8_ )
+                        {
+                            for( j = 0; j < bsz; j++ )
+                                quantizeToInt8(rowbuf0 + j*vsz_a, rowbuf8 + j*vsz8_a, vsz, invInputScale);
+
+                            const schar* wptr8 = wptr8_orig_ + wstep*startOutCn;
+                            const float* wscales = wscales_ + startOutCn;
+                        #if CV_TRY_AVX512_SKX
+                            if(useAVX512)
+                                opt_AVX512_SKX::fastConvInt8(wptr8, wstep, wscales, inputScale_, biasptr, rowbuf8,
+                                                             data_out0 + ofs0, outShape, bsz, vsz8_a, relu, true);
+                            else
+                        #endif
+                        #if CV_TRY_AVX2
+                            if(useAVX2)
+                                opt_AVX2::fastConvInt8(wptr8, wstep, wscales, inputScale_, biasptr, rowbuf8,
+                                                       data_out0 + ofs0, outShape, bsz, vsz8_a, relu, true);
+                            else
+                        #endif
+                        #if CV_TRY_AVX
+                            if(useAVX)
+                                opt_AVX::fastConvInt8(wptr8, wstep, wscales, inputScale_, biasptr, rowbuf8,
+                                                      data_out0 + ofs0, outShape, bsz, vsz8_a, relu, true);
+                            else
+                        #endif
+                            for( i = 0; i < outCn; i++ )
+                            {
+                                const schar* wptr0 = wptr8 + i*wstep;
+                                float* outptr0 = data_out0 + ofs0 + i*outPlaneSize;
+                                float scale0 = wscales[i]*inputScale_, bias0 = biasptr[i];
+                                float r0 = relu ? relu[i] : 1.f;
+
+                                for( j = 0; j < bsz; j++ )
+                                {
+                                    float s0 = dotProdInt8(wptr0, rowbuf8 + j*vsz8_a, vsz8_a)*scale0 + bias0;
+                                    outptr0[j] = s0 > 0.f || !relu ? s0 : s0*r0;
+                                }
+                            }
+                            continue;
+                        }
+
+                    #if CV_TRY_AVX2
+                        if( fp16InRegs )
+                        {
+                            opt_AVX2::fastConvFp16(wptr16_orig_ + wstep*startOutCn + cn0*karea, wstep,
+                                                   wscales_ + startOutCn, biasptr,
+                                                   rowbuf0, data_out0 + ofs0, outShape, bsz, vsz, vsz_a, relu, cn0 == 0);
+                            continue;
+                        }
+                    #endif
                     #if CV_TRY_AVX512_SKX
                         /* AVX512 convolution requires an alignment of 16, and ROI is only there for larger vector sizes */
                         if(useAVX512)
-                            opt_AVX512_SKX::fastConv(wptr, wstep, biasptr, rowbuf0, data_out0 + ofs0,
+                            opt_AVX512_SKX::fastConv(wptr, wstep_blk, biasptr, rowbuf0, data_out0 + ofs0,
                                           outShape, bsz, vsz, vsz_a, relu, cn0 == 0);
                         else
                     #endif
                     #if CV_TRY_AVX2
                         if(useAVX2)
-                            opt_AVX2::fastConv(wptr, wstep, biasptr, rowbuf0, data_out0 + ofs0,
+                            opt_AVX2::fastConv(wptr, wstep_blk, biasptr, rowbuf0, data_out0 + ofs0,
                                           outShape, bsz, vsz, vsz_a, relu, cn0 == 0);
                         else
                     #endif
                     #if CV_TRY_AVX
                         if(useAVX)
-                            opt_AVX::fastConv(wptr, wstep, biasptr, rowbuf0, data_out0 + ofs0,
+                            opt_AVX::fastConv(wptr, wstep_blk, biasptr, rowbuf0, data_out0 + ofs0,
                                          outShape, bsz, vsz, vsz_a, relu, cn0 == 0);
                         else
                     #endif
                         for( int i = 0; i < outCn; i += 2 )
                         {
-                            const float* wptr0 = wptr + i*wstep;
-                            const float* wptr1 = wptr0 + wstep;
+                            const float* wptr0 = wptr + i*wstep_blk;
+                            const float* wptr1 = wptr0 + wstep_blk;
                             float* outptr0 = data_out0 + ofs0 + i*outPlaneSize;
                             float* outptr1 = outptr0 + outPlaneSize;
                             float bias0 = biasptr[i], bias1 = biasptr[i+1];
@@ -803,6 +1302,33 @@ public:
                     }
                 }
 
+                if( residual_ )
+                {
+                    const float* resptr0 = residual_->ptr<float>() + (data_out0 - data_out0_);
+                    for( i = 0; i < outCn; i++ )
+                    {
+                        float* outptr = data_out0 + i*outPlaneSize;
+                        const float* resptr = resptr0 + i*outPlaneSize;
+                        float slope = reluptr_ ? reluptr_[startOutCn + i] : 1.f;
+                        j = stripeStart;
+                    #if CV_SIMD128
+                        v_float32x4 vslope = v_setall_f32(slope), z = v_setzero_f32();
+                        for( ; j <= stripeEnd - 4; j += 4 )
+                        {
+                            v_float32x4 v = v_load(outptr + j) + v_load(resptr + j);
+                            if( reluptr_ )
+                                v = v_select(v > z, v, v*vslope);
+                            v_store(outptr + j, v);
+                        }
+                    #endif
+                        for( ; j < stripeEnd; j++ )
+                        {
+                            float v = outptr[j] + resptr[j];
+                            outptr[j] = reluptr_ && v < 0.f ? v*slope : v;
+                        }
+                    }
+                }
+
                 if( activ_ )
                     activ_->forwardSlice(data_out0 + stripeStart, data_out0 + stripeStart,
                                          (int)(stripeEnd - stripeStart),
@@ -811,6 +1337,537 @@ public:
         }
     };
 
+    // Winograd F(4x4, 3x3) convolution: each 4x4 output tile is computed from the 6x6 input tile
+    // as A^T*[(G*g*G^T) .* (B^T*d*B)]*A. The elementwise products over all the input channels turn
+    // into 36 independent matrix products of (tiles x inpCn) by (inpCn x outCn) matrices.
+    // The weights G*g*G^T are computed in finalize() and are stored in weightsWinograd.
+    class WinogradConv : public cv::ParallelLoopBody
+    {
+    public:
+        enum { TILE_SIZE = 4, WIN_SIZE = 6, WIN_AREA = 36, BLK_TILES = 16, CN_ALIGN = 4 };
+
+        const Mat* input_;
+        const Mat* weights_;
+        Mat* output_;
+        const Mat* residual_;
+        Size pad_;
+        int tilesX_, tilesY_, nblocks_, nstripes_;
+        const std::vector<float>* biasvec_;
+        const std::vector<float>* reluslope_;
+        const ActivationLayer* activ_;
+        bool useAVX;
+        bool useAVX2;
+        bool useAVX512;
+
+        WinogradConv()
+            : input_(0), weights_(0), output_(0), residual_(0), tilesX_(0), tilesY_(0), nblocks_(0), nstripes_(0),
+              biasvec_(0), reluslope_(0), activ_(0), useAVX(false), useAVX2(false), useAVX512(false)
+        {}
+
+        static void run( const Mat& input, Mat& output, const Mat& weights,
+                         const std::vector<float>& biasvec,
+                         const std::vector<float>& reluslope,
+                         Size pad, const ActivationLayer* activ, int nstripes,
+                         const Mat* residual )
+        {
+            int inpCn = input.size[1], outCn = output.size[1];
+            CV_Assert( input.dims == 4 && output.dims == 4,
+                       input.size[0] == output.size[0],
+                       input.type() == CV_32F && output.type() == CV_32F && weights.type() == CV_32F,
+                       input.isContinuous() && output.isContinuous(),
+                       weights.rows == WIN_AREA*inpCn &&
+                       weights.cols == (int)alignSize(outCn, CN_ALIGN),
+                       biasvec.size() == (size_t)outCn+2 );
+            WinogradConv p;
+
+            p.input_ = &input;
+            p.weights_ = &weights;
+            p.output_ = &output;
+            p.residual_ = residual;
+            p.pad_ = pad;
+            p.tilesX_ = (output.size[3] + TILE_SIZE - 1)/TILE_SIZE;
+            p.tilesY_ = (output.size[2] + TILE_SIZE - 1)/TILE_SIZE;
+            p.nblocks_ = (p.tilesX_*p.tilesY_ + BLK_TILES - 1)/BLK_TILES;
+            p.biasvec_ = &biasvec;
+            p.reluslope_ = &reluslope;
+            p.activ_ = reluslope.empty() ? activ : 0;
+            p.useAVX = checkHardwareSupport(CPU_AVX);
+            p.useAVX2 = checkHardwareSupport(CPU_AVX2);
+            p.useAVX512 = CV_CPU_HAS_SUPPORT_AVX512_SKX;
+
+            int total = input.size[0]*p.nblocks_;
+            p.nstripes_ = std::max(std::min(nstripes, total), 1);
+            parallel_for_(Range(0, p.nstripes_), p, p.nstripes_);
+        }
+
+        virtual void operator ()(const Range& r) const
+        {
+            int batchSize = input_->size[0];
+            int inpCn = input_->size[1], height = input_->size[2], width = input_->size[3];
+            int outCn = output_->size[1], outH = output_->size[2], outW = output_->size[3];
+            int inpCnAligned = (int)alignSize(inpCn, CN_ALIGN), outCnAligned = weights_->cols;
+            size_t inpPlaneSize = (size_t)width*height, outPlaneSize = (size_t)outW*outH;
+            int ntiles = tilesX_*tilesY_;
+            int total = batchSize*nblocks_;
+            int stripeStart = (int)((int64)r.start*total/nstripes_);
+            int stripeEnd = (int)((int64)r.end*total/nstripes_);
+
+            // transformed input and output tiles: WIN_AREA matrices of BLK_TILES rows each
+            size_t vstep = (size_t)BLK_TILES*inpCnAligned, mstep = (size_t)BLK_TILES*outCnAligned;
+            AutoBuffer<float> vbuf_(vstep*WIN_AREA + CN_ALIGN), mbuf_(mstep*WIN_AREA + CN_ALIGN);
+            float* vbuf = alignPtr((float*)vbuf_, (int)(CN_ALIGN*sizeof(float)));
+            float* mbuf = alignPtr((float*)mbuf_, (int)(CN_ALIGN*sizeof(float)));
+
+            const float* wptr = weights_->ptr<float>();
+            size_t wstep = weights_->step1();
+            const float* biasptr = &biasvec_->at(0);
+            const float* reluptr = reluslope_->empty() ? 0 : &reluslope_->at(0);
+
+            for( int blk = stripeStart; blk < stripeEnd; blk++ )
+            {
+                int sampleIdx = blk / nblocks_;
+                int tile0 = (blk - sampleIdx*nblocks_)*BLK_TILES;
+                int tile1 = std::min(tile0 + BLK_TILES, ntiles);
+                int ntilesBlk = tile1 - tile0;
+                const float* inptr = input_->ptr<float>() + sampleIdx*inpPlaneSize*inpCn;
+                float* outptr = output_->ptr<float>() + sampleIdx*outPlaneSize*outCn;
+                const float* resptr = residual_ ? residual_->ptr<float>() + sampleIdx*outPlaneSize*outCn : 0;
+
+                for( int tile = tile0; tile < tile1; tile++ )
+                {
+                    int ty = tile / tilesX_, tx = tile - ty*tilesX_;
+                    int y0 = ty*TILE_SIZE - pad_.height, x0 = tx*TILE_SIZE - pad_.width;
+                    float* vptr = vbuf + (tile - tile0)*inpCnAligned;
+                    bool inside = 0 <= y0 && y0 + WIN_SIZE <= height && 0 <= x0 && x0 + WIN_SIZE <= width;
+
+                    for( int c = 0; c < inpCnAligned; c += CN_ALIGN )
+                    {
+                        float d[WIN_AREA][CN_ALIGN];
+                        for( int k = 0; k < CN_ALIGN; k++ )
+                        {
+                            const float* imgptr = inptr + (c + k)*inpPlaneSize;
+                            if( inside && c + k < inpCn )
+                            {
+                                imgptr += y0*width + x0;
+                                for( int i = 0; i < WIN_SIZE; i++, imgptr += width )
+                                    for( int j = 0; j < WIN_SIZE; j++ )
+                                        d[i*WIN_SIZE + j][k] = imgptr[j];
+                            }
+                            else
+                            {
+                                for( int i = 0; i < WIN_SIZE; i++ )
+                                    for( int j = 0; j < WIN_SIZE; j++ )
+                                    {
+                                        int y = y0 + i, x = x0 + j;
+                                        d[i*WIN_SIZE + j][k] = c + k < inpCn && 0 <= y && y < height &&
+                                                               0 <= x && x < width ? imgptr[y*width + x] : 0.f;
+                                    }
+                            }
+                        }
+                        winogradInputTransform(d[0], vptr + c, vstep);
+                    }
+                }
+
+                for( int k = 0; k < WIN_AREA; k++ )
+                {
+                    const float* aptr = vbuf + vstep*k;
+                    const float* bptr = wptr + wstep*inpCn*k;
+                    float* cptr = mbuf + mstep*k;
+                #if CV_TRY_AVX512_SKX
+                    if( useAVX512 )
+                        opt_AVX512_SKX::fastGEMM( aptr, inpCnAligned, bptr, wstep, cptr, outCnAligned,
+                                                  ntilesBlk, inpCn, outCnAligned );
+                    else
+                #endif
+                #if CV_TRY_AVX2
+                    if( useAVX2 )
+                        opt_AVX2::fastGEMM( aptr, inpCnAligned, bptr, wstep, cptr, outCnAligned,
+                                            ntilesBlk, inpCn, outCnAligned );
+                    else
+                #endif
+                #if CV_TRY_AVX
+                    if( useAVX )
+                        opt_AVX::fastGEMM( aptr, inpCnAligned, bptr, wstep, cptr, outCnAligned,
+                                           ntilesBlk, inpCn, outCnAligned );
+                    else
+                #endif
+                    for( int m = 0; m < ntilesBlk; m++ )
+                    {
+                        const float* aptr0 = aptr + m*inpCnAligned;
+                        float* cptr0 = cptr + m*outCnAligned;
+                        for( int n = 0; n < outCnAligned; n++ )
+                            cptr0[n] = 0.f;
+                        for( int i = 0; i < inpCn; i++ )
+                        {
+                            const float* bptr0 = bptr + i*wstep;
+                            float a = aptr0[i];
+                            int n = 0;
+                        #if CV_SIMD128
+                            v_float32x4 va = v_setall_f32(a);
+                            for( ; n <= outCnAligned - 4; n += 4 )
+                                v_store(cptr0 + n, v_load(cptr0 + n) + va*v_load(bptr0 + n));
+                        #endif
+                            for( ; n < outCnAligned; n++ )
+                                cptr0[n] += a*bptr0[n];
+                        }
+                    }
+                }
+
+                for( int tile = tile0; tile < tile1; tile++ )
+                {
+                    int ty = tile / tilesX_, tx = tile - ty*tilesX_;
+                    int y0 = ty*TILE_SIZE, x0 = tx*TILE_SIZE;
+                    int ny = std::min(outH - y0, (int)TILE_SIZE), nx = std::min(outW - x0, (int)TILE_SIZE);
+                    const float* mptr = mbuf + (tile - tile0)*outCnAligned;
+
+                    for( int c = 0; c < outCn; c += CN_ALIGN )
+                    {
+                        float o[TILE_SIZE*TILE_SIZE][CN_ALIGN];
+                        winogradOutputTransform(mptr + c, mstep, o[0]);
+
+                        for( int k = 0; k < CN_ALIGN && c + k < outCn; k++ )
+                        {
+                            float bias = biasptr[c + k];
+                            float slope = reluptr ? reluptr[c + k] : 1.f;
+                            size_t ofs = (c + k)*outPlaneSize + y0*outW + x0;
+                            float* dst = outptr + ofs;
+                            const float* res = resptr ? resptr + ofs : 0;
+                            for( int i = 0; i < ny; i++, dst += outW )
+                                for( int j = 0; j < nx; j++ )
+                                {
+                                    float v = o[i*TILE_SIZE + j][k] + bias + (res ? res[i*outW + j] : 0.f);
+                                    dst[j] = reluptr && v < 0.f ? v*slope : v;
+                                }
+                        }
+                    }
+
+                    if( activ_ )
+                    {
+                        // the tile is not continuous, so the activation is applied row by row
+                        for( int i = 0; i < ny; i++ )
+                            activ_->forwardSlice(outptr + (y0 + i)*outW + x0, outptr + (y0 + i)*outW + x0,
+                                                 nx, outPlaneSize, 0, outCn);
+                    }
+                }
+            }
+        }
+
+        // The transformations process CN_ALIGN channels at once: either as a single
+        // vector or, if there are no intrinsics, as CN_ALIGN scalar passes.
+    #if CV_SIMD128
+        typedef v_float32x4 vtype;
+        enum { NPASSES = 1 };
+        static inline vtype vload(const float* p) { return v_load(p); }
+        static inline void vstore(float* p, const vtype& v) { v_store(p, v); }
+        static inline vtype vsetall(float x) { return v_setall_f32(x); }
+    #else
+        typedef float vtype;
+        enum { NPASSES = CN_ALIGN };
+        static inline vtype vload(const float* p) { return *p; }
+        static inline void vstore(float* p, vtype v) { *p = v; }
+        static inline vtype vsetall(float x) { return x; }
+    #endif
+
+        // V = B^T*d*B, where d is a 6x6 tile of CN_ALIGN channels (interleaved);
+        // the 36 results are written to dst with the given step.
+        static void winogradInputTransform(const float* d, float* dst, size_t step)
+        {
+            const vtype c2 = vsetall(2.f), c4 = vsetall(4.f), c5 = vsetall(5.f);
+
+            for( int l = 0; l < NPASSES; l++ )
+            {
+                vtype t[WIN_AREA];
+                for( int j = 0; j < WIN_SIZE; j++ )
+                {
+                    const float* p = d + j*CN_ALIGN + l;
+                    vtype d0 = vload(p), d1 = vload(p + 6*CN_ALIGN),
+                          d2 = vload(p + 12*CN_ALIGN), d3 = vload(p + 18*CN_ALIGN),
+                          d4 = vload(p + 24*CN_ALIGN), d5 = vload(p + 30*CN_ALIGN);
+                    t[j] = c4*d0 - c5*d2 + d4;
+                    t[6 + j] = d3 + d4 - c4*(d1 + d2);
+                    t[12 + j] = c4*(d1 - d2) + d4 - d3;
+                    t[18 + j] = c2*(d3 - d1) + d4 - d2;
+                    t[24 + j] = c2*(d1 - d3) + d4 - d2;
+                    t[30 + j] = c4*d1 - c5*d3 + d5;
+                }
+                for( int i = 0; i < WIN_SIZE; i++ )
+                {
+                    const vtype* q = t + i*WIN_SIZE;
+                    float* p = dst + i*WIN_SIZE*step + l;
+                    vstore(p, c4*q[0] - c5*q[2] + q[4]);
+                    vstore(p + step, q[3] + q[4] - c4*(q[1] + q[2]));
+                    vstore(p + step*2, c4*(q[1] - q[2]) + q[4] - q[3]);
+                    vstore(p + step*3, c2*(q[3] - q[1]) + q[4] - q[2]);
+                    vstore(p + step*4, c2*(q[1] - q[3]) + q[4] - q[2]);
+                    vstore(p + step*5, c4*q[1] - c5*q[3] + q[5]);
+                }
+            }
+        }
+
+        // o = A^T*m*A, where the 36 elements of m (CN_ALIGN channels each)
+        // are read from src with the given step; o is a 4x4 tile (interleaved).
+        static void winogradOutputTransform(const float* src, size_t step, float* o)
+        {
+            const vtype c2 = vsetall(2.f), c4 = vsetall(4.f), c8 = vsetall(8.f);
+
+            for( int l = 0; l < NPASSES; l++ )
+            {
+                vtype t[TILE_SIZE*WIN_SIZE];
+                for( int j = 0; j < WIN_SIZE; j++ )
+                {
+                    const float* p = src + j*step + l;
+                    vtype m0 = vload(p), m1 = vload(p + step*6),
+                          m2 = vload(p + step*12), m3 = vload(p + step*18),
+                          m4 = vload(p + step*24), m5 = vload(p + step*30);
+                    vtype s12 = m1 + m2, d12 = m1 - m2, s34 = m3 + m4, d34 = m3 - m4;
+                    t[j] = m0 + s12 + s34;
+                    t[6 + j] = d12 + c2*d34;
+                    t[12 + j] = s12 + c4*s34;
+                    t[18 + j] = d12 + c8*d34 + m5;
+                }
+                for( int i = 0; i < TILE_SIZE; i++ )
+                {
+                    const vtype* q = t + i*WIN_SIZE;
+                    float* p = o + i*TILE_SIZE*CN_ALIGN + l;
+                    vtype s12 = q[1] + q[2], d12 = q[1] - q[2], s34 = q[3] + q[4], d34 = q[3] - q[4];
+                    vstore(p, q[0] + s12 + s34);
+                    vstore(p + CN_ALIGN, d12 + c2*d34);
+                    vstore(p + CN_ALIGN*2, s12 + c4*s34);
+                    vstore(p + CN_ALIGN*3, d12 + c8*d34 + q[5]);
+                }
+            }
+        }
+
+        // Computes G*g*G^T for every 3x3 kernel g. The result consists of 36 matrices
+        // of (inpCn x outCn) size, outCn is aligned to CN_ALIGN and padded with zeros.
+        static void transformWeights(const Mat& weights, int inpCn, Mat& dst)
+        {
+            static const float G[WIN_SIZE][3] =
+            {
+                { 1.f/4,     0.f,     0.f },
+                { -1.f/6, -1.f/6,  -1.f/6 },
+                { -1.f/6,  1.f/6,  -1.f/6 },
+                { 1.f/24,  1.f/12,  1.f/6 },
+                { 1.f/24, -1.f/12,  1.f/6 },
+                { 0.f,     0.f,     1.f   }
+            };
+            int outCn = weights.rows;
+            CV_Assert(weights.type() == CV_32F && weights.cols == inpCn*9);
+
+            dst = Mat::zeros(WIN_AREA*inpCn, (int)alignSize(outCn, CN_ALIGN), CV_32F);
+            for( int oc = 0; oc < outCn; oc++ )
+            {
+                for( int ic = 0; ic < inpCn; ic++ )
+                {
+                    const float* g = weights.ptr<float>(oc) + ic*9;
+                    float t[WIN_SIZE][3];
+                    for( int i = 0; i < WIN_SIZE; i++ )
+                        for( int j = 0; j < 3; j++ )
+                            t[i][j] = G[i][0]*g[j] + G[i][1]*g[3 + j] + G[i][2]*g[6 + j];
+                    for( int i = 0; i < WIN_SIZE; i++ )
+                        for( int j = 0; j < WIN_SIZE; j++ )
+                            dst.at<float>((i*WIN_SIZE + j)*inpCn + ic, oc) =
+                                t[i][0]*G[j][0] + t[i][1]*G[j][1] + t[i][2]*G[j][2];
+                }
+            }
+        }
+    };
+
+    // Direct depthwise convolution: every channel is convolved with its own 3x3 or 5x5 kernel
+    // using unit or double strides. One-channel groups make im2row of ParallelConv
+    // a waste of memory bandwidth, so here the input planes are read as is.
+    class DepthwiseConv : public cv::ParallelLoopBody
+    {
+    public:
+        enum { MAX_KSIZE = 5 };
+
+        const Mat* input_;
+        const Mat* weights_;
+        Mat* output_;
+        const Mat* residual_;
+        Size kernel_, pad_, stride_;
+        int nrowblocks_, nstripes_;
+        const std::vector<float>* biasvec_;
+        const std::vector<float>* reluslope_;
+        const ActivationLayer* activ_;
+        const std::vector<float>* weightsScales_;
+
+        DepthwiseConv()
+            : input_(0), weights_(0), output_(0), residual_(0), nrowblocks_(0), nstripes_(0),
+              biasvec_(0), reluslope_(0), activ_(0), weightsScales_(0)
+        {}
+
+        static bool isSupported( Size kernel, Size stride, Size dilation )
+        {
+            return (kernel == Size(3, 3) || kernel == Size(5, 5)) && dilation == Size(1, 1) &&
+                   1 <= stride.width && stride.width <= 2 && 1 <= stride.height && stride.height <= 2;
+        }
+
+        // weights are CV_32F or CV_16S (half precision floats scaled by weightsScales),
+        // one row per channel.
+        static void run( const Mat& input, Mat& output, const Mat& weights,
+                         const std::vector<float>& biasvec,
+                         const std::vector<float>& reluslope,
+                         Size kernel, Size pad, Size stride,
+                         const ActivationLayer* activ, int nstripes,
+                         const Mat* residual, const std::vector<float>* weightsScales = 0 )
+        {
+            CV_Assert( input.dims == 4 && output.dims == 4,
+                       input.size[0] == output.size[0],
+                       input.size[1] == output.size[1],
+                       weights.rows == output.size[1],
+                       weights.cols == kernel.area(),
+                       weights.type() == CV_32F || weights.type() == CV_16S,
+                       input.type() == CV_32F && output.type() == CV_32F,
+                       input.isContinuous() && output.isContinuous(),
+                       kernel.width <= MAX_KSIZE && kernel.height <= MAX_KSIZE,
+                       biasvec.size() == (size_t)output.size[1]+2 );
+            CV_Assert( weights.type() == CV_32F ||
+                       (weightsScales && weightsScales->size() == (size_t)output.size[1]+2) );
+            DepthwiseConv p;
+
+            p.input_ = &input;
+            p.weights_ = &weights;
+            p.output_ = &output;
+            p.residual_ = residual;
+            p.kernel_ = kernel; p.pad_ = pad; p.stride_ = stride;
+            p.biasvec_ = &biasvec;
+            p.reluslope_ = &reluslope;
+            p.activ_ = reluslope.empty() ? activ : 0;
+            p.weightsScales_ = weights.type() == CV_16S ? weightsScales : 0;
+
+            // planes are split into blocks of rows if there are not enough of them
+            int nplanes = input.size[0]*input.size[1], outH = output.size[2];
+            nstripes = std::max(nstripes, 1);
+            p.nrowblocks_ = nplanes >= nstripes ? 1 : std::min((nstripes + nplanes - 1)/nplanes, outH);
+            p.nstripes_ = std::min(nstripes, nplanes*p.nrowblocks_);
+            parallel_for_(Range(0, p.nstripes_), p, p.nstripes_);
+        }
+
+        virtual void operator ()(const Range& r) const
+        {
+            int ncn = input_->size[1], height = input_->size[2], width = input_->size[3];
+            int outH = output_->size[2], outW = output_->size[3];
+            int kernel_w = kernel_.width, kernel_h = kernel_.height, karea = kernel_w*kernel_h;
+            int pad_w = pad_.width, pad_h = pad_.height;
+            int stride_w = stride_.width, stride_h = stride_.height;
+            size_t inpPlaneSize = (size_t)width*height, outPlaneSize = (size_t)outW*outH;
+            int total = input_->size[0]*ncn*nrowblocks_;
+            int stripeStart = (int)((int64)r.start*total/nstripes_);
+            int stripeEnd = (int)((int64)r.end*total/nstripes_);
+            bool isFp16 = weights_->type() == CV_16S;
+            const float* biasptr = &biasvec_->at(0);
+            const float* reluptr = reluslope_->empty() ? 0 : &reluslope_->at(0);
+
+            // the aperture is inside the row for x0 <= x < x1; vectorized loop
+            // additionally requires the pairs of elements to be loaded for stride 2
+            int x0 = std::min((pad_w + stride_w - 1)/stride_w, outW);
+            int x1 = width - kernel_w + pad_w >= 0 ? std::min((width - kernel_w + pad_w)/stride_w + 1, outW) : 0;
+            x1 = std::max(x1, x0);
+            int xv1 = width - kernel_w - stride_w + 1 + pad_w >= 0 ?
+                      std::min((width - kernel_w - stride_w + 1 + pad_w)/stride_w + 1, x1) : 0;
+
+            float wbuf[MAX_KSIZE*MAX_KSIZE];
+
+            for( int blk = stripeStart; blk < stripeEnd; blk++ )
+            {
+                int plane = blk / nrowblocks_, rowblk = blk - plane*nrowblocks_;
+                int c = plane % ncn;
+                int y0 = (int)((int64)rowblk*outH/nrowblocks_);
+                int y1 = (int)((int64)(rowblk + 1)*outH/nrowblocks_);
+                const float* inptr = input_->ptr<float>() + plane*inpPlaneSize;
+                float* outptr0 = output_->ptr<float>() + plane*outPlaneSize;
+                const float* resptr0 = residual_ ? residual_->ptr<float>() + plane*outPlaneSize : 0;
+
+                const float* wptr = wbuf;
+                if( isFp16 )
+                {
+                    Mat wrow(1, karea, CV_32F, wbuf);
+                    convertFp16(weights_->row(c), wrow);
+                    float scale = weightsScales_->at(c);
+                    for( int k = 0; k < karea; k++ )
+                        wbuf[k] *= scale;
+                }
+                else
+                    wptr = weights_->ptr<float>(c);
+
+                float bias = biasptr[c];
+                float slope = reluptr ? reluptr[c] : 1.f;
+            #if CV_SIMD128
+                v_float32x4 vw[MAX_KSIZE*MAX_KSIZE];
+                for( int k = 0; k < karea; k++ )
+                    vw[k] = v_setall_f32(wptr[k]);
+                v_float32x4 vbias = v_setall_f32(bias), vslope = v_setall_f32(slope), z = v_setzero_f32();
+            #endif
+
+                for( int y = y0; y < y1; y++ )
+                {
+                    int in_i = y*stride_h - pad_h;
+                    int ky0 = std::max(-in_i, 0), ky1 = std::min(kernel_h, height - in_i);
+                    const float* imgptr = inptr + in_i*width - pad_w;
+                    float* outptr = outptr0 + y*outW;
+                    const float* resptr = resptr0 ? resptr0 + y*outW : 0;
+
+                    for( int x = 0; x < outW; x++ )
+                    {
+                    #if CV_SIMD128
+                        if( x0 <= x )
+                        {
+                            for( ; x <= xv1 - 4; x += 4 )
+                            {
+                                v_float32x4 s = vbias;
+                                for( int ky = ky0; ky < ky1; ky++ )
+                                {
+                                    const float* rptr = imgptr + ky*width + x*stride_w;
+                                    const v_float32x4* vwrow = vw + ky*kernel_w;
+                                    if( stride_w == 1 )
+                                    {
+                                        for( int kx = 0; kx < kernel_w; kx++ )
+                                            s += v_load(rptr + kx)*vwrow[kx];
+                                    }
+                                    else
+                                    {
+                                        for( int kx = 0; kx < kernel_w; kx++ )
+                                        {
+                                            v_float32x4 v0, v1;
+                                            v_load_deinterleave(rptr + kx, v0, v1);
+                                            s += v0*vwrow[kx];
+                                        }
+                                    }
+                                }
+                                if( resptr )
+                                    s += v_load(resptr + x);
+                                if( reluptr )
+                                    s = v_select(s > z, s, s*vslope);
+                                v_store(outptr + x, s);
+                            }
+                            if( x >= outW )
+                                break;
+                        }
+                    #endif
+                        int in_j = x*stride_w - pad_w;
+                        int kx0 = std::max(-in_j, 0), kx1 = std::min(kernel_w, width - in_j);
+                        float s = bias;
+                        for( int ky = ky0; ky < ky1; ky++ )
+                        {
+                            const float* rptr = imgptr + ky*width + x*stride_w;
+                            const float* wrow = wptr + ky*kernel_w;
+                            for( int kx = kx0; kx < kx1; kx++ )
+                                s += rptr[kx]*wrow[kx];
+                        }
+                        if( resptr )
+                            s += resptr[x];
+                        outptr[x] = reluptr && s < 0.f ? s*slope : s;
+                    }
+                }
+
+                if( activ_ )
+                    activ_->forwardSlice(outptr0 + y0*outW, outptr0 + y0*outW, (y1 - y0)*outW,
+                                         outPlaneSize, c, c + 1);
+            }
+        }
+    };
+
 #ifdef HAVE_OPENCL
     bool forward_ocl(InputArrayOfArrays inps, OutputArrayOfArrays outs, OutputArrayOfArrays internals)
     {
@@ -831,6 +1888,13 @@ public:
         if (out_h != outputs[0].size[2] || out_w != outputs[0].size[3])
             return false;
 
+        // released when the weights are replaced by the 8-bit ones
+        if (umat_blobs.empty())
+        {
+            for (size_t i = 0; i < blobs.size(); i++)
+                umat_blobs.push_back(blobs[i].getUMat(ACCESS_READ));
+        }
+
         int group = inputs[0].size[1] / umat_blobs[0].size[1];
 
         if (convolutionOp.empty())
@@ -920,12 +1984,15 @@ public:
         UMat& outMat = outputs[0];
         int batch_size = inpMat.size[0];
 
-        return convolutionOp->Forward(inpMat,
-                                      inputs.size() == 2 ? inputs[1] : UMat(),
-                                      umat_blobs[0],
-                                      (hasBias() || fusedBias) ? umat_blobs[1] : UMat(),
-                                      outMat,
-                                      batch_size);
+        if (!convolutionOp->Forward(inpMat,
+                                    inputs.size() == 2 ? inputs[1] : UMat(),
+                                    umat_blobs[0],
+                                    (hasBias() || fusedBias) ? umat_blobs[1] : UMat(),
+                                    outMat,
+                                    batch_size))
+            return false;
+        kernelName = "ocl4dnn";
+        return true;
     }
 #endif
 
@@ -934,7 +2001,7 @@ public:
         CV_TRACE_FUNCTION();
         CV_TRACE_ARG_VALUE(name, "name", name.c_str());
 
-        CV_OCL_RUN((preferableTarget == DNN_TARGET_OPENCL) &&
+        CV_OCL_RUN((preferableTarget == DNN_TARGET_OPENCL) && weightsMatInt8.empty() &&
                    OCL_PERFORMANCE_CHECK(ocl::Device::getDefault().isIntel()),
                    forward_ocl(inputs_arr, outputs_arr, internals_arr))
 
@@ -950,13 +2017,22 @@ public:
                name.c_str(), inputs[0]->size[0], inputs[0]->size[1], inputs[0]->size[2], inputs[0]->size[3],
                kernel.width, kernel.height, pad.width, pad.height,
                stride.width, stride.height, dilation.width, dilation.height);*/
-        CV_Assert(inputs.size() == (size_t)1, inputs[0]->size[1] % blobs[0].size[1] == 0,
+        CV_Assert(inputs.size() == (size_t)1 || inputs.size() == (size_t)2,
+                  inputs[0]->size[1] % blobs[0].size[1] == 0,
                   outputs.size() == 1, inputs[0]->data != outputs[0].data);
+        kernelName = cpuKernelName;
+
+        // the second input is added to the output (see fusion with Eltwise layer in dnn.cpp)
+        const Mat* residual = inputs.size() == 2 ? inputs[1] : 0;
+        CV_Assert(!residual || (shape(*residual) == shape(outputs[0]) && residual->isContinuous() &&
+                                residual->type() == CV_32F));
 
         int ngroups = inputs[0]->size[1]/blobs[0].size[1];
         CV_Assert(outputs[0].size[1] % ngroups == 0);
         int outCn = blobs[0].size[0];
 
+        syncWeights();
+
         reluslope.clear();
         if( activ )
         {
@@ -980,19 +2056,37 @@ public:
 
         int nstripes = std::max(getNumThreads(), 1);
 
-        ParallelConv::run(*inputs[0], outputs[0], weightsMat, biasvec, reluslope,
-                          kernel, pad, stride, dilation, activ.get(), ngroups, nstripes);
+        bool isDepthwise = ngroups == outCn && blobs[0].size[1] == 1;
+
+        if( !weightsMatInt8.empty() )
+            ParallelConv::run(*inputs[0], outputs[0], weightsMatInt8, biasvec, reluslope,
+                              kernel, pad, stride, dilation, activ.get(), ngroups, nstripes,
+                              residual, &weightsScales, inputScaleInt8);
+        else if( isDepthwise && DepthwiseConv::isSupported(kernel, stride, dilation) )
+            DepthwiseConv::run(*inputs[0], outputs[0], weightsMatFp16.empty() ? weightsMat : weightsMatFp16,
+                               biasvec, reluslope, kernel, pad, stride, activ.get(), nstripes, residual,
+                               &weightsScales);
+        else if( !weightsMatFp16.empty() )
+            ParallelConv::run(*inputs[0], outputs[0], weightsMatFp16, biasvec, reluslope,
+                              kernel, pad, stride, dilation, activ.get(), ngroups, nstripes, residual,
+                              &weightsScales);
+        else if( !weightsWinograd.empty() )
+            WinogradConv::run(*inputs[0], outputs[0], weightsWinograd, biasvec, reluslope,
+                              pad, activ.get(), nstripes, residual);
+        else
+            ParallelConv::run(*inputs[0], outputs[0], weightsMat, biasvec, reluslope,
+                              kernel, pad, stride, dilation, activ.get(), ngroups, nstripes, residual);
     }
 
     virtual int64 getFLOPS(const std::vector<MatShape> &inputs,
                            const std::vector<MatShape> &outputs) const
     {
-        CV_Assert(inputs.size() == outputs.size());
+        CV_Assert(!inputs.empty());
 
         int64 flops = 0;
-        for (int i = 0; i < inputs.size(); i++)
+        for (int i = 0; i < outputs.size(); i++)
         {
-            flops += total(outputs[i])*(CV_BIG_INT(2)*kernel.area()*inputs[i][1] + 1);
+            flops += total(outputs[i])*(CV_BIG_INT(2)*kernel.area()*blobs[0].size[1] + 1);
         }
 
         return flops;
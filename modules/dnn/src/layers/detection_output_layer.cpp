@@ -84,10 +84,6 @@ static inline bool SortScorePairDescend(const std::pair<float, T>& pair1,
     return pair1.first > pair2.first;
 }
 
-static inline float caffe_box_overlap(const util::NormalizedBBox& a, const util::NormalizedBBox& b);
-
-static inline float caffe_norm_box_overlap(const util::NormalizedBBox& a, const util::NormalizedBBox& b);
-
 } // namespace
 
 class DetectionOutputLayerImpl : public DetectionOutputLayer
@@ -492,32 +488,91 @@ public:
         return count;
     }
 
+    // Packs boxes to the 5 x N matrix with rows xmin, ymin, xmax, ymax and size.
+    static Mat BBoxesToSoA(const std::vector<util::NormalizedBBox>& bboxes, bool normalized)
+    {
+        Mat soa(5, (int)bboxes.size(), CV_32F);
+        float *xmin = soa.ptr<float>(0), *ymin = soa.ptr<float>(1),
+              *xmax = soa.ptr<float>(2), *ymax = soa.ptr<float>(3),
+              *size = soa.ptr<float>(4);
+        for (size_t i = 0; i < bboxes.size(); ++i)
+        {
+            const util::NormalizedBBox& bbox = bboxes[i];
+            xmin[i] = bbox.xmin;
+            ymin[i] = bbox.ymin;
+            xmax[i] = bbox.xmax;
+            ymax[i] = bbox.ymax;
+            size[i] = BBoxSize(bbox, normalized);
+        }
+        return soa;
+    }
+
+    // Runs NMS for the classes of a single image.
+    class NMSInvoker : public ParallelLoopBody
+    {
+    public:
+        NMSInvoker(const DetectionOutputLayerImpl& layer_, const std::vector<Mat>& boxes_,
+                   const Mat& confidenceScores_, std::vector<std::vector<int> >& indices_)
+            : layer(layer_), boxes(boxes_), confidenceScores(confidenceScores_), indices(indices_) {}
+
+        void operator()(const Range& r) const
+        {
+            int numPriors = confidenceScores.cols;
+            AutoBuffer<int> order(numPriors), keep(numPriors);
+            AutoBuffer<float> buf(numPriors*5);
+            // Sizes of boxes which are not normalized include boundary pixels.
+            float offset = layer._bboxesNormalized ? 0.f : 1.f;
+
+            for (int c = r.start; c < r.end; ++c)
+            {
+                if (c == layer._backgroundLabelId)
+                    continue;
+                const Mat& bboxes = boxes[layer._shareLocation ? 0 : c];
+                int n = GetMaxScoreIndex(confidenceScores.ptr<float>(c), numPriors,
+                                         layer._confidenceThreshold, layer._topK, order);
+                int nkept = NMSFast(bboxes, order, n, layer._nmsThreshold, 1.f, offset, false, buf, keep);
+                indices[c].assign((int*)keep, (int*)keep + nkept);
+            }
+        }
+
+    private:
+        const DetectionOutputLayerImpl& layer;
+        const std::vector<Mat>& boxes;
+        const Mat& confidenceScores;
+        std::vector<std::vector<int> >& indices;
+    };
+
     size_t processDetections_(
             const LabelBBox& decodeBBoxes, Mat& confidenceScores,
             std::vector<std::map<int, std::vector<int> > >& allIndices
     )
     {
-        std::map<int, std::vector<int> > indices;
-        size_t numDetections = 0;
-        for (int c = 0; c < (int)_numClasses; ++c)
+        if ((int)_numClasses > confidenceScores.rows)
+            CV_ErrorNoReturn_(cv::Error::StsError, ("Could not find confidence predictions for label %d", confidenceScores.rows));
+
+        std::vector<Mat> boxes(_shareLocation ? 1 : _numClasses);
+        for (int c = 0; c < (int)boxes.size(); ++c)
         {
-            if (c == _backgroundLabelId)
+            if (c == _backgroundLabelId && !_shareLocation)
                 continue; // Ignore background class.
-            if (c >= confidenceScores.rows)
-                CV_ErrorNoReturn_(cv::Error::StsError, ("Could not find confidence predictions for label %d", c));
-
-            const std::vector<float> scores = confidenceScores.row(c);
             int label = _shareLocation ? -1 : c;
-
             LabelBBox::const_iterator label_bboxes = decodeBBoxes.find(label);
             if (label_bboxes == decodeBBoxes.end())
                 CV_ErrorNoReturn_(cv::Error::StsError, ("Could not find location predictions for label %d", label));
-            if (_bboxesNormalized)
-                NMSFast_(label_bboxes->second, scores, _confidenceThreshold, _nmsThreshold, 1.0, _topK,
-                         indices[c], util::caffe_norm_box_overlap);
-            else
-                NMSFast_(label_bboxes->second, scores, _confidenceThreshold, _nmsThreshold, 1.0, _topK,
-                         indices[c], util::caffe_box_overlap);
+            CV_Assert((int)label_bboxes->second.size() == confidenceScores.cols);
+            boxes[c] = BBoxesToSoA(label_bboxes->second, _bboxesNormalized);
+        }
+
+        std::vector<std::vector<int> > classIndices(_numClasses);
+        parallel_for_(Range(0, _numClasses), NMSInvoker(*this, boxes, confidenceScores, classIndices));
+
+        std::map<int, std::vector<int> > indices;
+        size_t numDetections = 0;
+        for (int c = 0; c < (int)_numClasses; ++c)
+        {
+            if (c == _backgroundLabelId)
+                continue; // Ignore background class.
+            indices[c].swap(classIndices[c]);
             numDetections += indices[c].size();
         }
         if (_keepTopK > -1 && numDetections > (size_t)_keepTopK)
@@ -883,16 +938,6 @@ public:
     }
 };
 
-float util::caffe_box_overlap(const util::NormalizedBBox& a, const util::NormalizedBBox& b)
-{
-    return DetectionOutputLayerImpl::JaccardOverlap<false>(a, b);
-}
-
-float util::caffe_norm_box_overlap(const util::NormalizedBBox& a, const util::NormalizedBBox& b)
-{
-    return DetectionOutputLayerImpl::JaccardOverlap<true>(a, b);
-}
-
 const std::string DetectionOutputLayerImpl::_layerName = std::string("DetectionOutput");
 
 Ptr<DetectionOutputLayer> DetectionOutputLayer::create(const LayerParams &params)
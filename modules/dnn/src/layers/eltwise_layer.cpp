@@ -114,7 +114,8 @@ public:
 
         outputs.assign(1, inputs[0]);
 
-        return false;
+        // output may replace the first input
+        return true;
     }
 
     class EltwiseInvoker : public ParallelLoopBody
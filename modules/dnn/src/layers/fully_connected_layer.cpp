@@ -56,10 +56,10 @@ namespace cv
 namespace dnn
 {
 
-class FullyConnectedLayerImpl : public InnerProductLayer
+class FullyConnectedLayerImpl : public InnerProductLayer, public CompiledLayerState
 {
 public:
-    enum { VEC_ALIGN = 8 };
+    enum { VEC_ALIGN = 8, VEC_ALIGN_INT8 = 16 };
 
 #ifdef HAVE_OPENCL
     Ptr<OCL4DNNInnerProduct<float> > innerProductOp;
@@ -70,6 +70,7 @@ public:
     {
         setParamsFrom(params);
         CV_Assert(1 <= blobs.size() && blobs.size() <= 2);
+        inputScaleInt8 = 0.f;
 
         int numOutput = params.get<int>("num_output");
         int innerSize = (int)blobs[0].total() / numOutput;
@@ -79,22 +80,15 @@ public:
         CV_Assert(blobs[0].dims >= 2 && (size_t)(innerSize * numOutput) == blobs[0].total());
         CV_Assert(!bias || (blobs.size() == 2 && (size_t)numOutput == blobs[1].total()));
 
-        weightsMat = blobs[0] = blobs[0].reshape(1, numOutput);
-        int vecsize = weightsMat.cols;
-        if( vecsize % VEC_ALIGN != 0 )
-        {
-            int vecsize_aligned = (int)alignSize(vecsize, VEC_ALIGN);
-            Mat weightsBuf(weightsMat.rows, vecsize_aligned, weightsMat.type());
-            Mat wpadding = weightsBuf.colRange(vecsize, vecsize_aligned);
-            wpadding.setTo(Scalar::all(0.));
-            weightsMat = weightsBuf.colRange(0, vecsize);
-            blobs[0].copyTo(weightsMat);
-        }
+        blobs[0] = blobs[0].reshape(1, numOutput);
+        // 8-bit and half precision weights of a compiled network are passed to importState()
+        if (blobs[0].type() == CV_32F)
+            prepareWeights();
 
         if (bias)
             biasMat = blobs[1] = blobs[1].reshape(1, 1);
         else
-            biasMat = Mat::zeros(1, numOutput, weightsMat.type());
+            biasMat = Mat::zeros(1, numOutput, CV_32F);
 
 #ifdef HAVE_OPENCL
         size_t n = blobs.size();
@@ -103,6 +97,22 @@ public:
 #endif
     }
 
+    // weightsMat shares the data with blobs[0] or, if the rows are not aligned, is a padded copy
+    void prepareWeights()
+    {
+        weightsMat = blobs[0];
+        int vecsize = weightsMat.cols;
+        if( vecsize % VEC_ALIGN != 0 )
+        {
+            int vecsize_aligned = (int)alignSize(vecsize, VEC_ALIGN);
+            Mat weightsBuf(weightsMat.rows, vecsize_aligned, weightsMat.type());
+            Mat wpadding = weightsBuf.colRange(vecsize, vecsize_aligned);
+            wpadding.setTo(Scalar::all(0.));
+            weightsMat = weightsBuf.colRange(0, vecsize);
+            blobs[0].copyTo(weightsMat);
+        }
+    }
+
     bool getMemoryShapes(const std::vector<MatShape> &inputs,
                          const int requiredOutputs,
                          std::vector<MatShape> &outputs,
@@ -127,9 +137,46 @@ public:
 
     virtual bool supportBackend(int backendId)
     {
+        // 8-bit and half precision weights are computed by the default backend only
         return backendId == DNN_BACKEND_DEFAULT ||
-               backendId == DNN_BACKEND_HALIDE && haveHalide() && axis == 1 ||
-               backendId == DNN_BACKEND_INFERENCE_ENGINE && haveInfEngine() && axis == 1;
+               backendId == DNN_BACKEND_HALIDE && haveHalide() && axis == 1 && blobs[0].type() == CV_32F ||
+               backendId == DNN_BACKEND_INFERENCE_ENGINE && haveInfEngine() && axis == 1 && blobs[0].type() == CV_32F;
+    }
+
+    void finalize(const std::vector<Mat*>&, std::vector<Mat>&)
+    {
+        // single precision weights set after the quantization (see Net::setParam)
+        if (!weightsMatInt8.empty() && blobs[0].type() == CV_32F)
+            tryQuantize(inputScaleInt8);
+        if (preferableTarget == DNN_TARGET_CPU_FP16 && weightsMatInt8.empty())
+        {
+            // half precision weights replace the single precision ones (including blobs[0])
+            if (blobs[0].type() == CV_32F)
+            {
+                convertWeightsFp16(blobs[0], weightsMatFp16, VEC_ALIGN);
+                blobs[0] = weightsMatFp16;
+                weightsMat.release();
+#ifdef HAVE_OPENCL
+                umat_blobs.clear();
+#endif
+            }
+        }
+        else
+        {
+            // switching from DNN_TARGET_CPU_FP16 keeps the rounding to half precision
+            if (blobs[0].type() == CV_16S)
+                blobs[0] = unpackBlob(0);
+            weightsMatFp16.release();
+            if (weightsMat.empty() && weightsMatInt8.empty())
+                prepareWeights();
+        }
+        // forward() reports the CPU kernel if the OpenCL one fails and the layer falls back to CPU
+        kernelName = preferableTarget == DNN_TARGET_OPENCL && weightsMatInt8.empty() ? "ocl4dnn" : cpuKernelName();
+    }
+
+    String cpuKernelName() const
+    {
+        return !weightsMatInt8.empty() ? "int8" : !weightsMatFp16.empty() ? "fp16" : "fp32";
     }
 
     virtual bool setActivation(const Ptr<ActivationLayer>& layer)
@@ -138,23 +185,154 @@ public:
         return !activ.empty();
     }
 
+    virtual bool tryQuantize(float inputScale)
+    {
+        inputScaleInt8 = inputScale;
+        if (blobs[0].type() == CV_8S)
+            return true;
+        if (blobs[0].type() == CV_16S)
+            blobs[0] = unpackBlob(0);
+        CV_Assert(blobs[0].type() == CV_32F);
+        int numOutput = blobs[0].rows, vecsize = blobs[0].cols;
+        int vecsize_aligned = (int)alignSize(vecsize, VEC_ALIGN_INT8);
+
+        Mat wm = Mat::zeros(numOutput, vecsize_aligned, CV_8S);
+        weightsScales.resize(numOutput);
+        for (int i = 0; i < numOutput; i++)
+        {
+            double maxVal = norm(blobs[0].row(i), NORM_INF);
+            float scale = maxVal > 0 ? (float)(maxVal / 127) : 1.f;
+            blobs[0].row(i).convertTo(wm.row(i).colRange(0, vecsize), CV_8S, 1. / scale);
+            weightsScales[i] = scale;
+        }
+        weightsMatInt8 = wm.colRange(0, vecsize);
+        // 8-bit weights replace the floating point ones (including blobs[0]),
+        // see unpackBlob() for the single precision ones.
+        blobs[0] = weightsMatInt8;
+        weightsMat.release();
+        weightsMatFp16.release();
+#ifdef HAVE_OPENCL
+        umat_blobs.clear();
+#endif
+        return true;
+    }
+
+    // Compiled network state: single precision weights, 8-bit weights, their scales,
+    // the input scale and half precision weights (all of them are padded). 8-bit or
+    // half precision weights are blobs[0] as well.
+    enum { STATE_WEIGHTS, STATE_INT8, STATE_SCALES, STATE_INPUT_SCALE, STATE_FP16, STATE_COUNT };
+
+    virtual void exportState(LayerParams&, std::vector<Mat>& state)
+    {
+        state.assign(STATE_COUNT, Mat());
+        if (!weightsMat.empty())
+            state[STATE_WEIGHTS] = paddedRows(weightsMat);
+        if (!weightsMatInt8.empty())
+        {
+            state[STATE_INT8] = paddedRows(weightsMatInt8);
+            state[STATE_SCALES] = Mat(weightsScales, true).reshape(1, 1);
+            state[STATE_INPUT_SCALE] = Mat(1, 1, CV_32F, Scalar(inputScaleInt8));
+        }
+        if (!weightsMatFp16.empty())
+            state[STATE_FP16] = paddedRows(weightsMatFp16);
+    }
+
+    virtual void importState(const std::vector<Mat>& state)
+    {
+        CV_Assert(state.size() == (size_t)STATE_COUNT);
+        int numOutput = blobs[0].rows, vecsize = blobs[0].cols;
+
+        const Mat& wm = state[STATE_WEIGHTS];
+        CV_Assert(wm.empty() || (wm.type() == CV_32F && wm.rows == numOutput &&
+                                 wm.cols >= vecsize && wm.cols % VEC_ALIGN == 0));
+        weightsMat = wm.empty() ? Mat() : wm.colRange(0, vecsize);
+
+        const Mat& wInt8 = state[STATE_INT8];
+        const Mat& wFp16 = state[STATE_FP16];
+        CV_Assert(blobs[0].type() == (!wInt8.empty() ? CV_8S : !wFp16.empty() ? CV_16S : CV_32F));
+        if (!wInt8.empty())
+        {
+            const Mat& scales = state[STATE_SCALES];
+            CV_Assert(wInt8.type() == CV_8S, wInt8.rows == numOutput, wInt8.cols >= vecsize,
+                      wInt8.cols % VEC_ALIGN_INT8 == 0, scales.type() == CV_32F,
+                      scales.total() == (size_t)numOutput, state[STATE_INPUT_SCALE].total() == 1);
+            weightsMatInt8 = wInt8.colRange(0, vecsize);
+            blobs[0] = weightsMatInt8;
+            scales.reshape(1, 1).copyTo(weightsScales);
+            inputScaleInt8 = state[STATE_INPUT_SCALE].at<float>(0);
+        }
+
+        CV_Assert(wFp16.empty() || (wFp16.type() == CV_16S && wFp16.rows == numOutput &&
+                                    wFp16.cols >= vecsize && wFp16.cols % VEC_ALIGN == 0));
+        weightsMatFp16 = wFp16.empty() ? Mat() : wFp16.colRange(0, vecsize);
+        if (blobs[0].type() == CV_16S)
+            blobs[0] = weightsMatFp16;
+        CV_Assert(!weightsMat.empty() || !weightsMatInt8.empty() || !weightsMatFp16.empty());
+    }
+
+    virtual bool isQuantized(float& inputScale) const
+    {
+        inputScale = inputScaleInt8;
+        return !weightsMatInt8.empty();
+    }
+
+    virtual Mat unpackBlob(int idx) const
+    {
+        CV_Assert(0 <= idx && idx < (int)blobs.size());
+        if (idx != 0 || blobs[0].type() == CV_32F)
+            return blobs[idx];
+        Mat wm(blobs[0].size(), CV_32F);
+        if (blobs[0].type() == CV_16S)
+        {
+            convertFp16(weightsMatFp16, wm);
+            return wm;
+        }
+        for (int i = 0; i < wm.rows; i++)
+            weightsMatInt8.row(i).convertTo(wm.row(i), CV_32F, weightsScales[i]);
+        return wm;
+    }
+
+    virtual void shareState(const CompiledLayerState& src_)
+    {
+        const FullyConnectedLayerImpl& src = dynamic_cast<const FullyConnectedLayerImpl&>(src_);
+        CV_Assert(src.blobs.size() == blobs.size(), src.blobs[0].data == blobs[0].data);
+        weightsMatInt8 = src.weightsMatInt8;
+        weightsScales = src.weightsScales;
+        inputScaleInt8 = src.inputScaleInt8;
+        weightsMatFp16 = src.weightsMatFp16;
+        // replaces the padded copy of single precision weights made by the constructor
+        weightsMat = src.weightsMat;
+    }
+
     class FullyConnected : public ParallelLoopBody
     {
     public:
-        FullyConnected() : srcMat(0), weights(0), biasMat(0), activ(0), dstMat(0), nstripes(0), useAVX(false), useAVX2(false), useAVX512(false) {}
+        FullyConnected() : srcMat(0), weights(0), biasMat(0), activ(0), dstMat(0), nstripes(0),
+                           weightsScales(0), inputScale(0.f), useAVX(false), useAVX2(false), useAVX512(false) {}
 
+        // weights are CV_32F, CV_8S or CV_16S (half precision floats). 8-bit weights are
+        // scaled by weightsScales (one per row); each input row is quantized with inputScale
+        // or, if it is not positive, with the scale computed from the row range.
         static void run(const Mat& srcMat, const Mat& weights, const Mat& biasMat,
-                        Mat& dstMat, const ActivationLayer* activ, int nstripes)
+                        Mat& dstMat, const ActivationLayer* activ, int nstripes,
+                        const std::vector<float>* weightsScales = 0, float inputScale = 0.f)
         {
             CV_Assert( srcMat.dims == 2 && srcMat.cols == weights.cols &&
                        dstMat.rows == srcMat.rows && dstMat.cols == weights.rows &&
-                       srcMat.type() == weights.type() && weights.type() == dstMat.type() &&
+                       (weights.type() == CV_32F || weights.type() == CV_8S ||
+                        weights.type() == CV_16S) &&
+                       srcMat.type() == dstMat.type() &&
                        srcMat.type() == CV_32F &&
+                       (weights.type() != CV_8S ||
+                        (weightsScales && (int)weightsScales->size() == weights.rows)) &&
                        (biasMat.empty() || (biasMat.type() == srcMat.type() &&
                                            biasMat.isContinuous() && (int)biasMat.total() == dstMat.cols)) );
 
             FullyConnected p;
 
+            p.weightsScales = weights.type() == CV_8S ? weightsScales : 0;
+            p.inputScale = inputScale;
+
             p.srcMat = &srcMat;
             p.weights = &weights;
             p.biasMat = &biasMat;
@@ -186,6 +364,18 @@ public:
             for( k = vecsize; k < vecsize_aligned; k++ )
                 sptr[k] = 0.f;
 
+            if( weightsScales )
+            {
+                runInt8(stripeStart, stripeEnd);
+                return;
+            }
+
+            if( weights->type() == CV_16S )
+            {
+                runFp16(stripeStart, stripeEnd, sptr);
+                return;
+            }
+
             for( size_t ofs = stripeStart; ofs < stripeEnd; )
             {
                 int sampleIdx = (int)(ofs / nw0);
@@ -257,10 +447,122 @@ public:
             }
         }
 
+        void runInt8(size_t stripeStart, size_t stripeEnd) const
+        {
+            const int valign = FullyConnectedLayerImpl::VEC_ALIGN_INT8;
+            int nw0 = weights->rows, vecsize = srcMat->cols;
+            int vecsize_aligned = (int)alignSize(vecsize, valign);
+            size_t wstep = weights->step1();
+            AutoBuffer<schar> srcbuf(vecsize_aligned + valign);
+            schar* sptr = alignPtr((schar*)srcbuf, valign);
+            int prevSampleIdx = -1;
+            float scale = inputScale;
+
+            memset(sptr, 0, vecsize_aligned);
+
+            for( size_t ofs = stripeStart; ofs < stripeEnd; )
+            {
+                int sampleIdx = (int)(ofs / nw0);
+                int delta = (int)(ofs - (size_t)sampleIdx*nw0);
+                const schar* wptr = weights->ptr<schar>(delta);
+                const float* wscales = &weightsScales->at(delta);
+                float* dptr = dstMat->ptr<float>(sampleIdx) + delta;
+                const float* biasptr = biasMat->ptr<float>() + delta;
+                int nw = std::min(nw0 - delta, (int)(stripeEnd - ofs));
+
+                if( sampleIdx != prevSampleIdx )
+                {
+                    const float* sptr_ = srcMat->ptr<float>(sampleIdx);
+                    if( inputScale <= 0.f )
+                    {
+                        double maxVal = norm(srcMat->row(sampleIdx), NORM_INF);
+                        scale = maxVal > 0 ? (float)(maxVal / 127) : 1.f;
+                    }
+                    quantizeToInt8(sptr_, sptr, vecsize, 1.f/scale);
+                    prevSampleIdx = sampleIdx;
+                }
+
+            #if CV_TRY_AVX512_SKX
+                if( useAVX512 )
+                    opt_AVX512_SKX::fastGEMM1TInt8( sptr, scale, wptr, wstep, wscales, biasptr, dptr, nw, vecsize_aligned);
+                else
+            #endif
+            #if CV_TRY_AVX2
+                if( useAVX2 )
+                    opt_AVX2::fastGEMM1TInt8( sptr, scale, wptr, wstep, wscales, biasptr, dptr, nw, vecsize_aligned);
+                else
+            #endif
+            #if CV_TRY_AVX
+                if( useAVX )
+                    opt_AVX::fastGEMM1TInt8( sptr, scale, wptr, wstep, wscales, biasptr, dptr, nw, vecsize_aligned);
+                else
+            #endif
+                for( int i = 0; i < nw; i++, wptr += wstep )
+                    dptr[i] = dotProdInt8(sptr, wptr, vecsize_aligned)*wscales[i]*scale + biasptr[i];
+
+                if(activ)
+                    activ->forwardSlice(dptr, dptr, 1, 1, delta, delta + nw);
+
+                ofs += nw;
+            }
+        }
+
+        void runFp16(size_t stripeStart, size_t stripeEnd, float* sptr) const
+        {
+            const int valign = FullyConnectedLayerImpl::VEC_ALIGN;
+            int nw0 = weights->rows, vecsize = srcMat->cols;
+            int vecsize_aligned = (int)alignSize(vecsize, valign);
+            size_t wstep = weights->step1();
+            // single precision copy of the weights row for the generic branch
+            AutoBuffer<float> wbuf_(vecsize_aligned + valign);
+            float* wbuf = alignPtr((float*)wbuf_, (int)(valign*sizeof(float)));
+            Mat wrow32(1, vecsize_aligned, CV_32F, wbuf);
+
+            for( size_t ofs = stripeStart; ofs < stripeEnd; )
+            {
+                int sampleIdx = (int)(ofs / nw0);
+                int delta = (int)(ofs - (size_t)sampleIdx*nw0);
+                const short* wptr = weights->ptr<short>(delta);
+                float* dptr = dstMat->ptr<float>(sampleIdx) + delta;
+                const float* biasptr = biasMat->ptr<float>() + delta;
+                int nw = std::min(nw0 - delta, (int)(stripeEnd - ofs));
+
+                memcpy(sptr, srcMat->ptr<float>(sampleIdx), vecsize*sizeof(sptr[0]));
+
+            #if CV_TRY_AVX2
+                if( useAVX2 )
+                    opt_AVX2::fastGEMM1TFp16( sptr, wptr, wstep, biasptr, dptr, nw, vecsize);
+                else
+            #endif
+                for( int i = 0; i < nw; i++, wptr += wstep )
+                {
+                    convertFp16(Mat(1, vecsize_aligned, CV_16S, (void*)wptr), wrow32);
+                    float s0 = biasptr[i];
+                    int k = 0;
+            #if CV_SIMD128
+                    v_float32x4 vs0 = v_setall_f32(0.f);
+                    for( ; k < vecsize_aligned; k += 4 )
+                        vs0 += v_load_aligned(sptr + k)*v_load_aligned(wbuf + k);
+                    s0 += v_reduce_sum(vs0);
+            #endif
+                    for( ; k < vecsize; k++ )
+                        s0 += sptr[k]*wbuf[k];
+                    dptr[i] = s0;
+                }
+
+                if(activ)
+                    activ->forwardSlice(dptr, dptr, 1, 1, delta, delta + nw);
+
+                ofs += nw;
+            }
+        }
+
         const Mat *srcMat, *weights, *biasMat;
         const ActivationLayer* activ;
         Mat* dstMat;
         int nstripes;
+        const std::vector<float>* weightsScales;
+        float inputScale;
         bool useAVX;
         bool useAVX2;
         bool useAVX512;
@@ -275,6 +577,13 @@ public:
         inps.getUMatVector(inputs);
         outs.getUMatVector(outputs);
 
+        // released when the weights are replaced by the 8-bit or half precision ones
+        if (umat_blobs.empty())
+        {
+            for (size_t i = 0; i < blobs.size(); i++)
+                umat_blobs.push_back(blobs[i].getUMat(ACCESS_READ));
+        }
+
         int axisCan = clamp(axis, inputs[0].dims);
         int numOutput = umat_blobs[0].size[0];
         int innerSize = umat_blobs[0].size[1];
@@ -317,7 +626,11 @@ public:
             }
         }
 
-        if (ret) return true;
+        if (ret)
+        {
+            kernelName = "ocl4dnn";
+            return true;
+        }
 
         UMat& weights = umat_blobs[0];
         for (size_t i = 0; i < inputs.size(); i++)
@@ -339,6 +652,7 @@ public:
             }
         }
 
+        kernelName = "ocl_gemm";
         return true;
     }
 #endif
@@ -348,7 +662,7 @@ public:
         CV_TRACE_FUNCTION();
         CV_TRACE_ARG_VALUE(name, "name", name.c_str());
 
-        CV_OCL_RUN((preferableTarget == DNN_TARGET_OPENCL) &&
+        CV_OCL_RUN((preferableTarget == DNN_TARGET_OPENCL) && weightsMatInt8.empty() &&
                    OCL_PERFORMANCE_CHECK(ocl::Device::getDefault().isIntel()),
                    forward_ocl(inputs_arr, outputs_arr, internals_arr))
 
@@ -362,6 +676,7 @@ public:
 
         int axisCan = clamp(axis, input[0]->dims);
         int outerSize = input[0]->total(0, axisCan);
+        kernelName = cpuKernelName();
 
         for (size_t i = 0; i < input.size(); i++)
         {
@@ -369,7 +684,13 @@ public:
             Mat dstMat = output[i].reshape(1, outerSize);
 
             const int nstripes = getNumThreads();
-            FullyConnected::run(srcMat, weightsMat, biasMat, dstMat, activ.get(), nstripes);
+            if (!weightsMatInt8.empty())
+                FullyConnected::run(srcMat, weightsMatInt8, biasMat, dstMat, activ.get(), nstripes,
+                                    &weightsScales, inputScaleInt8);
+            else if (!weightsMatFp16.empty())
+                FullyConnected::run(srcMat, weightsMatFp16, biasMat, dstMat, activ.get(), nstripes);
+            else
+                FullyConnected::run(srcMat, weightsMat, biasMat, dstMat, activ.get(), nstripes);
         }
     }
 
@@ -415,6 +736,11 @@ public:
         return Ptr<BackendNode>();
     }
 
+    virtual String getKernelName() const
+    {
+        return kernelName;
+    }
+
     virtual int64 getFLOPS(const std::vector<MatShape> &inputs,
                            const std::vector<MatShape> &outputs) const
     {
@@ -433,7 +759,15 @@ public:
 
     bool bias;
     Mat weightsMat, biasMat;
+    // 8-bit weights with a scale per output (see tryQuantize).
+    Mat weightsMatInt8;
+    std::vector<float> weightsScales;
+    float inputScaleInt8;
+    // half precision weights for DNN_TARGET_CPU_FP16
+    Mat weightsMatFp16;
     Ptr<ActivationLayer> activ;
+    // implementation used by the last forward pass, see getKernelName()
+    String kernelName;
 };
 
 Ptr<InnerProductLayer> InnerProductLayer::create(const LayerParams& params)
@@ -41,6 +41,7 @@
 //M*/
 
 #include "layers_common.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 namespace cv
 {
@@ -203,5 +204,71 @@ void getConvPoolPaddings(const Size& inp, const Size& out,
     }
 }
 
+void quantizeToInt8(const float* src, schar* dst, int len, float invScale)
+{
+    int i = 0;
+#if CV_SIMD128
+    v_float32x4 s = v_setall_f32(invScale);
+    for( ; i <= len - 16; i += 16 )
+    {
+        v_int32x4 r0 = v_round(v_load(src + i)*s), r1 = v_round(v_load(src + i + 4)*s);
+        v_int32x4 r2 = v_round(v_load(src + i + 8)*s), r3 = v_round(v_load(src + i + 12)*s);
+        v_store(dst + i, v_pack(v_pack(r0, r1), v_pack(r2, r3)));
+    }
+#endif
+    for( ; i < len; i++ )
+        dst[i] = saturate_cast<schar>(cvRound(src[i]*invScale));
+}
+
+int dotProdInt8(const schar* a, const schar* b, int len)
+{
+    int k = 0, s = 0;
+#if CV_SIMD128
+    v_int32x4 vs = v_setzero_s32();
+    for( ; k <= len - 16; k += 16 )
+    {
+        v_int16x8 a0, a1, b0, b1;
+        v_expand(v_load_aligned(a + k), a0, a1);
+        v_expand(v_load_aligned(b + k), b0, b1);
+        vs += v_dotprod(a0, b0) + v_dotprod(a1, b1);
+    }
+    s = v_reduce_sum(vs);
+#endif
+    for( ; k < len; k++ )
+        s += a[k]*b[k];
+    return s;
+}
+
+void convertWeightsFp16(const Mat& src, Mat& dst, int align)
+{
+    CV_Assert(src.dims == 2 && src.type() == CV_32F);
+    Mat buf = Mat::zeros(src.rows, (int)alignSize(src.cols, align), CV_16S);
+    dst = buf.colRange(0, src.cols);
+    convertFp16(src, dst);
+}
+
+Mat paddedRows(const Mat& m)
+{
+    CV_Assert(m.dims == 2);
+    return Mat(m.rows, (int)m.step1(), m.type(), m.data, m.step);
+}
+
+Mat blobFromRows(const Mat& rows, const MatShape& shape)
+{
+    CV_Assert(rows.dims == 2, !shape.empty(), shape[0] == rows.rows, total(shape) == (int)rows.total());
+    if (shape.size() == 2)
+        return rows;
+    // Mat checks the step of the last dimension as well, though it is the element size
+    std::vector<size_t> steps(shape.size());
+    steps[0] = rows.step[0];
+    for (size_t i = 1; i < steps.size(); i++)
+        steps[i] = total(shape, (int)i + 1) * rows.elemSize();
+    Mat blob((int)shape.size(), &shape[0], rows.type(), rows.data, &steps[0]);
+    blob.u = rows.u;
+    if (blob.u)
+        CV_XADD(&blob.u->refcount, 1);
+    return blob;
+}
+
 }
 }
@@ -74,6 +74,46 @@ void getConvPoolPaddings(const Size& inp, const Size& out,
                          const Size &kernel, const Size &stride,
                          const String &padMode, const Size &dilation, Size &pad);
 
+// dst[i] = saturate_cast<schar>(cvRound(src[i]*invScale)), i = 0..len-1
+void quantizeToInt8(const float* src, schar* dst, int len, float invScale);
+
+// dot product of two 8-bit vectors with 32-bit accumulation.
+// len must be a multiple of 16 and both pointers must be 16-byte aligned.
+int dotProdInt8(const schar* a, const schar* b, int len);
+
+// converts CV_32F matrix to half precision floats which are stored as CV_16S.
+// dst is a submatrix of rows padded with zeros up to a multiple of align elements.
+void convertWeightsFp16(const Mat& src, Mat& dst, int align);
+
+// whole rows of a submatrix including the alignment padding on the right
+Mat paddedRows(const Mat& m);
+
+// header of the given shape over the rows of a submatrix (shape[0] is the number of rows),
+// it refers to the memory of rows, so the padding is kept in between.
+Mat blobFromRows(const Mat& rows, const MatShape& shape);
+
+// Implemented by layers which prepare their weights for forward() (fold scales and shifts,
+// pad rows, transform or quantize them). Net::save() stores the prepared weights and
+// readNetFromCompiled() passes them back, so the loaded layers don't prepare them again.
+class CompiledLayerState
+{
+public:
+    virtual ~CompiledLayerState() {}
+    // Replaces params.blobs by the weights with all the fusions applied (if any)
+    // and fills state by the prepared weights.
+    virtual void exportState(LayerParams& params, std::vector<Mat>& state) = 0;
+    // Restores the weights returned by exportState(). Called before the first finalize().
+    virtual void importState(const std::vector<Mat>& state) = 0;
+    // Returns true if the weights are quantized by tryQuantize() (or imported quantized).
+    virtual bool isQuantized(float& inputScale) const = 0;
+    // Returns the blob in single precision. Quantized weights are kept as 8-bit blobs[0]
+    // and the weights for DNN_TARGET_CPU_FP16 are kept as half precision blobs[0].
+    virtual Mat unpackBlob(int idx) const = 0;
+    // Takes the prepared weights of another instance of the same layer which is created
+    // from the same blobs (see Net::clone), so the instances share them.
+    virtual void shareState(const CompiledLayerState& src) = 0;
+};
+
 }
 }
 
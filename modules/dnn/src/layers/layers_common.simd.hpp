@@ -56,6 +56,21 @@ void fastGEMM1T( const float* vec, const float* weights,
 void fastGEMM( const float* aptr, size_t astep, const float* bptr,
                size_t bstep, float* cptr, size_t cstep,
                int ma, int na, int nb );
+void fastConvInt8( const schar* weights, size_t wstep, const float* wscale,
+                   float inpScale, const float* bias,
+                   const schar* rowbuf, float* output, const int* outShape,
+                   int blockSize, int vecsize_aligned,
+                   const float* relu, bool initOutput );
+void fastGEMM1TInt8( const schar* vec, float vecScale, const schar* weights,
+                     size_t wstep, const float* wscale, const float* bias,
+                     float* dst, int nvecs, int vecsize_aligned );
+void fastGEMM1TFp16( const float* vec, const short* weights,
+                     size_t wstep, const float* bias,
+                     float* dst, int nvecs, int vecsize );
+void fastConvFp16( const short* weights, size_t wstep, const float* wscale, const float* bias,
+                   const float* rowbuf, float* output, const int* outShape,
+                   int blockSize, int vecsize, int vecsize_aligned,
+                   const float* relu, bool initOutput );
 
 #if !defined(CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY) && CV_AVX
 
@@ -475,6 +490,417 @@ void fastGEMM( const float* aptr, size_t astep, const float* bptr,
     _mm256_zeroupper();
 }
 
+// int8 dot products are computed by sign-extending both operands to 16 bits
+// and using pairwise multiply-add into 32-bit accumulators, so that
+// -127..127 x -127..127 products never saturate.
+#if CV_AVX2
+static inline __m256i dotprod16_i8( const schar* a, const schar* b )
+{
+    __m256i a16 = _mm256_cvtepi8_epi16(_mm_load_si128((const __m128i*)a));
+    __m256i b16 = _mm256_cvtepi8_epi16(_mm_load_si128((const __m128i*)b));
+    return _mm256_madd_epi16(a16, b16);
+}
+
+static inline int reduce_sum_i32( const __m256i& v )
+{
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_hadd_epi32(s, s);
+    s = _mm_hadd_epi32(s, s);
+    return _mm_cvtsi128_si32(s);
+}
+#define CV_DOT_I8_ZERO _mm256_setzero_si256()
+#define CV_DOT_I8_ADD _mm256_add_epi32
+typedef __m256i dotacc_i8;
+#else
+static inline __m128i dotprod16_i8( const schar* a, const schar* b )
+{
+    __m128i a0 = _mm_load_si128((const __m128i*)a), b0 = _mm_load_si128((const __m128i*)b);
+    __m128i s0 = _mm_madd_epi16(_mm_cvtepi8_epi16(a0), _mm_cvtepi8_epi16(b0));
+    __m128i s1 = _mm_madd_epi16(_mm_cvtepi8_epi16(_mm_srli_si128(a0, 8)),
+                                _mm_cvtepi8_epi16(_mm_srli_si128(b0, 8)));
+    return _mm_add_epi32(s0, s1);
+}
+
+static inline int reduce_sum_i32( const __m128i& v )
+{
+    __m128i s = _mm_hadd_epi32(v, v);
+    s = _mm_hadd_epi32(s, s);
+    return _mm_cvtsi128_si32(s);
+}
+#define CV_DOT_I8_ZERO _mm_setzero_si128()
+#define CV_DOT_I8_ADD _mm_add_epi32
+typedef __m128i dotacc_i8;
+#endif
+
+void fastConvInt8( const schar* weights, size_t wstep, const float* wscale,
+                   float inpScale, const float* bias,
+                   const schar* rowbuf, float* output, const int* outShape,
+                   int blockSize, int vecsize_aligned,
+                   const float* relu, bool initOutput )
+{
+    int outCn = outShape[1];
+    size_t outPlaneSize = outShape[2]*outShape[3];
+    float r0 = 1.f, r1 = 1.f;
+
+    for( int i = 0; i < outCn; i += 2 )
+    {
+        const schar* wptr0 = weights + i*wstep;
+        const schar* wptr1 = wptr0 + wstep;
+        float* outptr0 = output + i*outPlaneSize;
+        float* outptr1 = outptr0 + outPlaneSize;
+        float bias0 = bias[i], bias1 = bias[i+1];
+        float scale0 = wscale[i]*inpScale, scale1 = wscale[i+1]*inpScale;
+
+        if( i+1 >= outCn )
+        {
+            wptr1 = wptr0;
+            outptr1 = outptr0;
+            bias1 = bias0;
+            scale1 = scale0;
+        }
+
+        if( relu )
+        {
+            r0 = relu[i];
+            r1 = relu[i+1];
+        }
+
+        for( int j = 0; j < blockSize; j += 2 )
+        {
+            const schar* rptr0 = rowbuf + j*vecsize_aligned;
+            const schar* rptr1 = j+1 < blockSize ? rptr0 + vecsize_aligned : rptr0;
+            dotacc_i8 vs00 = CV_DOT_I8_ZERO, vs01 = CV_DOT_I8_ZERO,
+                      vs10 = CV_DOT_I8_ZERO, vs11 = CV_DOT_I8_ZERO;
+
+            for( int k = 0; k < vecsize_aligned; k += 16 )
+            {
+                vs00 = CV_DOT_I8_ADD(vs00, dotprod16_i8(wptr0 + k, rptr0 + k));
+                vs01 = CV_DOT_I8_ADD(vs01, dotprod16_i8(wptr0 + k, rptr1 + k));
+                vs10 = CV_DOT_I8_ADD(vs10, dotprod16_i8(wptr1 + k, rptr0 + k));
+                vs11 = CV_DOT_I8_ADD(vs11, dotprod16_i8(wptr1 + k, rptr1 + k));
+            }
+
+            float s00 = reduce_sum_i32(vs00)*scale0, s01 = reduce_sum_i32(vs01)*scale0;
+            float s10 = reduce_sum_i32(vs10)*scale1, s11 = reduce_sum_i32(vs11)*scale1;
+
+            if( initOutput )
+            {
+                s00 += bias0; s01 += bias0;
+                s10 += bias1; s11 += bias1;
+            }
+            else
+            {
+                s00 += outptr0[j]; s10 += outptr1[j];
+                if( j+1 < blockSize )
+                {
+                    s01 += outptr0[j+1];
+                    s11 += outptr1[j+1];
+                }
+            }
+
+            if( relu )
+            {
+                s00 = s00 > 0.f ? s00 : s00*r0;
+                s01 = s01 > 0.f ? s01 : s01*r0;
+                s10 = s10 > 0.f ? s10 : s10*r1;
+                s11 = s11 > 0.f ? s11 : s11*r1;
+            }
+
+            outptr0[j] = s00;
+            outptr1[j] = s10;
+            if( j+1 < blockSize )
+            {
+                outptr0[j+1] = s01;
+                outptr1[j+1] = s11;
+            }
+        }
+    }
+    _mm256_zeroupper();
+}
+
+// dst = (vec * weights^t) * scales + bias, where vec and weights are quantized
+void fastGEMM1TInt8( const schar* vec, float vecScale, const schar* weights,
+                     size_t wstep, const float* wscale, const float* bias,
+                     float* dst, int nvecs, int vecsize_aligned )
+{
+    int i = 0;
+
+    for( ; i <= nvecs - 4; i += 4 )
+    {
+        const schar* wptr = weights + i*wstep;
+        dotacc_i8 vs0 = CV_DOT_I8_ZERO, vs1 = CV_DOT_I8_ZERO,
+                  vs2 = CV_DOT_I8_ZERO, vs3 = CV_DOT_I8_ZERO;
+
+        for( int k = 0; k < vecsize_aligned; k += 16 )
+        {
+            vs0 = CV_DOT_I8_ADD(vs0, dotprod16_i8(wptr + k, vec + k));
+            vs1 = CV_DOT_I8_ADD(vs1, dotprod16_i8(wptr + wstep + k, vec + k));
+            vs2 = CV_DOT_I8_ADD(vs2, dotprod16_i8(wptr + wstep*2 + k, vec + k));
+            vs3 = CV_DOT_I8_ADD(vs3, dotprod16_i8(wptr + wstep*3 + k, vec + k));
+        }
+
+        dst[i] = reduce_sum_i32(vs0)*wscale[i]*vecScale + bias[i];
+        dst[i+1] = reduce_sum_i32(vs1)*wscale[i+1]*vecScale + bias[i+1];
+        dst[i+2] = reduce_sum_i32(vs2)*wscale[i+2]*vecScale + bias[i+2];
+        dst[i+3] = reduce_sum_i32(vs3)*wscale[i+3]*vecScale + bias[i+3];
+    }
+
+    for( ; i < nvecs; i++ )
+    {
+        const schar* wptr = weights + i*wstep;
+        dotacc_i8 vs0 = CV_DOT_I8_ZERO;
+
+        for( int k = 0; k < vecsize_aligned; k += 16 )
+            vs0 = CV_DOT_I8_ADD(vs0, dotprod16_i8(wptr + k, vec + k));
+
+        dst[i] = reduce_sum_i32(vs0)*wscale[i]*vecScale + bias[i];
+    }
+
+    _mm256_zeroupper();
+}
+
+#undef CV_DOT_I8_ZERO
+#undef CV_DOT_I8_ADD
+
+#if CV_FP16
+static inline __m256 load_fp16( const short* ptr )
+{
+    return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)ptr));
+}
+
+// dst = vec * weights^t + bias, where weights are half precision floats
+void fastGEMM1TFp16( const float* vec, const short* weights,
+                     size_t wstep, const float* bias,
+                     float* dst, int nvecs, int vecsize )
+{
+    int i = 0;
+
+    for( ; i <= nvecs - 4; i += 4 )
+    {
+        const short* wptr = weights + i*wstep;
+        __m256 vs0 = _mm256_setzero_ps(), vs1 = _mm256_setzero_ps(),
+               vs2 = _mm256_setzero_ps(), vs3 = _mm256_setzero_ps();
+
+        for( int k = 0; k < vecsize; k += 8, wptr += 8 )
+        {
+            __m256 v = _mm256_load_ps(vec + k);
+
+            vs0 = _mm256_fmadd_ps(load_fp16(wptr), v, vs0);
+            vs1 = _mm256_fmadd_ps(load_fp16(wptr + wstep), v, vs1);
+            vs2 = _mm256_fmadd_ps(load_fp16(wptr + wstep*2), v, vs2);
+            vs3 = _mm256_fmadd_ps(load_fp16(wptr + wstep*3), v, vs3);
+        }
+
+        __m256 s0 = _mm256_hadd_ps(_mm256_hadd_ps(vs0, vs1), _mm256_hadd_ps(vs2, vs3));
+        s0 = _mm256_add_ps(s0, _mm256_permute2f128_ps(s0, s0, 1));
+        s0 = _mm256_add_ps(s0, _mm256_castps128_ps256(_mm_loadu_ps(bias + i)));
+        _mm_storeu_ps(dst + i, _mm256_castps256_ps128(s0));
+    }
+
+    float temp = 0.f;
+    for( ; i < nvecs; i++ )
+    {
+        const short* wptr = weights + i*wstep;
+        __m256 vs0 = _mm256_setzero_ps();
+
+        for( int k = 0; k < vecsize; k += 8, wptr += 8 )
+        {
+            __m256 v = _mm256_load_ps(vec + k);
+            vs0 = _mm256_fmadd_ps(load_fp16(wptr), v, vs0);
+        }
+
+        __m256 s0 = _mm256_hadd_ps(_mm256_hadd_ps(vs0, vs0), vs0);
+        s0 = _mm256_add_ps(s0, _mm256_permute2f128_ps(s0, s0, 1));
+        _mm_store_ss(&temp, _mm256_castps256_ps128(s0));
+        dst[i] = temp + bias[i];
+    }
+
+    _mm256_zeroupper();
+}
+
+static inline float reduce_sum_avx( __m256 v )
+{
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_hadd_ps(s, s);
+    s = _mm_hadd_ps(s, s);
+    return _mm_cvtss_f32(s);
+}
+
+// the same as fastConv(), but the weights are half precision floats scaled by wscale
+// (one per output channel); they are expanded to single precision in registers,
+// right before the multiplication
+void fastConvFp16( const short* weights, size_t wstep, const float* wscale, const float* bias,
+                   const float* rowbuf, float* output, const int* outShape,
+                   int blockSize, int vecsize, int vecsize_aligned,
+                   const float* relu, bool initOutput )
+{
+    int outCn = outShape[1];
+    size_t outPlaneSize = outShape[2]*outShape[3];
+    float r0 = 1.f, r1 = 1.f, r2 = 1.f;
+    __m128 vr0 = _mm_set1_ps(1.f), vr1 = vr0, vr2 = vr0, z = _mm_setzero_ps();
+
+    for( int i = 0; i < outCn; i += 3 )
+    {
+        const short* wptr0 = weights + i*wstep;
+        const short* wptr1 = wptr0 + wstep;
+        const short* wptr2 = wptr1 + wstep;
+        float* outptr0 = output + i*outPlaneSize;
+        float* outptr1 = outptr0 + outPlaneSize;
+        float* outptr2 = outptr1 + outPlaneSize;
+        float bias0 = bias[i], bias1 = bias[i+1], bias2 = bias[i+2];
+        float scale0 = wscale[i], scale1 = wscale[i+1], scale2 = wscale[i+2];
+
+        if( i+2 >= outCn )
+        {
+            wptr2 = wptr1;
+            outptr2 = outptr1;
+            bias2 = bias1;
+            scale2 = scale1;
+            if( i+1 >= outCn )
+            {
+                wptr2 = wptr1 = wptr0;
+                outptr2 = outptr1 = outptr0;
+                bias2 = bias1 = bias0;
+                scale2 = scale1 = scale0;
+            }
+        }
+        __m128 vscale0 = _mm_set1_ps(scale0), vscale1 = _mm_set1_ps(scale1), vscale2 = _mm_set1_ps(scale2);
+
+        if( relu )
+        {
+            r0 = relu[i];
+            r1 = relu[i+1];
+            r2 = relu[i+2];
+            vr0 = _mm_set1_ps(r0);
+            vr1 = _mm_set1_ps(r1);
+            vr2 = _mm_set1_ps(r2);
+        }
+
+        int j = 0;
+        for( ; j <= blockSize - 4; j += 4 )
+        {
+            const float* rptr = rowbuf + j*vecsize_aligned;
+
+            __m256 vs00 = _mm256_setzero_ps(), vs01 = _mm256_setzero_ps(),
+                   vs02 = _mm256_setzero_ps(), vs03 = _mm256_setzero_ps(),
+                   vs10 = _mm256_setzero_ps(), vs11 = _mm256_setzero_ps(),
+                   vs12 = _mm256_setzero_ps(), vs13 = _mm256_setzero_ps(),
+                   vs20 = _mm256_setzero_ps(), vs21 = _mm256_setzero_ps(),
+                   vs22 = _mm256_setzero_ps(), vs23 = _mm256_setzero_ps();
+
+            for( int k = 0; k < vecsize; k += 8, rptr += 8 )
+            {
+                __m256 w0 = load_fp16(wptr0 + k);
+                __m256 w1 = load_fp16(wptr1 + k);
+                __m256 w2 = load_fp16(wptr2 + k);
+                __m256 r0 = _mm256_load_ps(rptr);
+
+                vs00 = _mm256_fmadd_ps(w0, r0, vs00);
+                vs10 = _mm256_fmadd_ps(w1, r0, vs10);
+                vs20 = _mm256_fmadd_ps(w2, r0, vs20);
+
+                r0 = _mm256_load_ps(rptr + vecsize_aligned);
+                vs01 = _mm256_fmadd_ps(w0, r0, vs01);
+                vs11 = _mm256_fmadd_ps(w1, r0, vs11);
+                vs21 = _mm256_fmadd_ps(w2, r0, vs21);
+
+                r0 = _mm256_load_ps(rptr + vecsize_aligned*2);
+                vs02 = _mm256_fmadd_ps(w0, r0, vs02);
+                vs12 = _mm256_fmadd_ps(w1, r0, vs12);
+                vs22 = _mm256_fmadd_ps(w2, r0, vs22);
+
+                r0 = _mm256_load_ps(rptr + vecsize_aligned*3);
+                vs03 = _mm256_fmadd_ps(w0, r0, vs03);
+                vs13 = _mm256_fmadd_ps(w1, r0, vs13);
+                vs23 = _mm256_fmadd_ps(w2, r0, vs23);
+            }
+
+            __m256 t0 = _mm256_hadd_ps(_mm256_hadd_ps(vs00, vs01), _mm256_hadd_ps(vs02, vs03));
+            __m256 t1 = _mm256_hadd_ps(_mm256_hadd_ps(vs10, vs11), _mm256_hadd_ps(vs12, vs13));
+            __m256 t2 = _mm256_hadd_ps(_mm256_hadd_ps(vs20, vs21), _mm256_hadd_ps(vs22, vs23));
+
+            t0 = _mm256_add_ps(t0, _mm256_permute2f128_ps(t0, t0, 1));
+            t1 = _mm256_add_ps(t1, _mm256_permute2f128_ps(t1, t1, 1));
+            t2 = _mm256_add_ps(t2, _mm256_permute2f128_ps(t2, t2, 1));
+
+            __m128 s0, s1, s2;
+
+            if( initOutput )
+            {
+                s0 = _mm_set1_ps(bias0);
+                s1 = _mm_set1_ps(bias1);
+                s2 = _mm_set1_ps(bias2);
+            }
+            else
+            {
+                s0 = _mm_loadu_ps(outptr0 + j);
+                s1 = _mm_loadu_ps(outptr1 + j);
+                s2 = _mm_loadu_ps(outptr2 + j);
+            }
+
+            s0 = _mm_add_ps(s0, _mm_mul_ps(_mm256_castps256_ps128(t0), vscale0));
+            s1 = _mm_add_ps(s1, _mm_mul_ps(_mm256_castps256_ps128(t1), vscale1));
+            s2 = _mm_add_ps(s2, _mm_mul_ps(_mm256_castps256_ps128(t2), vscale2));
+
+            if( relu )
+            {
+                __m128 m0 = _mm_cmp_ps(s0, z, _CMP_GT_OS);
+                __m128 m1 = _mm_cmp_ps(s1, z, _CMP_GT_OS);
+                __m128 m2 = _mm_cmp_ps(s2, z, _CMP_GT_OS);
+                s0 = _mm_xor_ps(s0, _mm_andnot_ps(m0, _mm_xor_ps(_mm_mul_ps(s0, vr0), s0)));
+                s1 = _mm_xor_ps(s1, _mm_andnot_ps(m1, _mm_xor_ps(_mm_mul_ps(s1, vr1), s1)));
+                s2 = _mm_xor_ps(s2, _mm_andnot_ps(m2, _mm_xor_ps(_mm_mul_ps(s2, vr2), s2)));
+            }
+
+            _mm_storeu_ps(outptr0 + j, s0);
+            _mm_storeu_ps(outptr1 + j, s1);
+            _mm_storeu_ps(outptr2 + j, s2);
+        }
+
+        for( ; j < blockSize; j++ )
+        {
+            const float* rptr = rowbuf + j*vecsize_aligned;
+            __m256 vs0 = _mm256_setzero_ps(), vs1 = _mm256_setzero_ps(), vs2 = _mm256_setzero_ps();
+
+            for( int k = 0; k < vecsize; k += 8 )
+            {
+                __m256 r = _mm256_load_ps(rptr + k);
+                vs0 = _mm256_fmadd_ps(load_fp16(wptr0 + k), r, vs0);
+                vs1 = _mm256_fmadd_ps(load_fp16(wptr1 + k), r, vs1);
+                vs2 = _mm256_fmadd_ps(load_fp16(wptr2 + k), r, vs2);
+            }
+
+            float s00 = reduce_sum_avx(vs0)*scale0, s10 = reduce_sum_avx(vs1)*scale1, s20 = reduce_sum_avx(vs2)*scale2;
+
+            if( initOutput )
+            {
+                s00 += bias0;
+                s10 += bias1;
+                s20 += bias2;
+            }
+            else
+            {
+                s00 += outptr0[j];
+                s10 += outptr1[j];
+                s20 += outptr2[j];
+            }
+
+            if( relu )
+            {
+                s00 = s00 > 0.f ? s00 : s00*r0;
+                s10 = s10 > 0.f ? s10 : s10*r1;
+                s20 = s20 > 0.f ? s20 : s20*r2;
+            }
+
+            outptr0[j] = s00;
+            outptr1[j] = s10;
+            outptr2[j] = s20;
+        }
+    }
+    _mm256_zeroupper();
+}
+#endif
+
 #endif // CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
 
 CV_CPU_OPTIMIZATION_NAMESPACE_END
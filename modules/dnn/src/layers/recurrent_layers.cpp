@@ -41,6 +41,9 @@
 //M*/
 
 #include "../precomp.hpp"
+#include "layers_common.hpp"
+#include <opencv2/core/hal/hal.hpp>
+#include <opencv2/core/hal/intrin.hpp>
 #include <iostream>
 #include <iterator>
 #include <cmath>
@@ -80,6 +83,91 @@ static void sigmoid(const Mat &src, Mat &dst)
     cv::pow(1 + dst, -1, dst);
 }
 
+// dst[i] = bias[i] + dot(vec, weights.row(i)), i = 0..nw-1.
+// vec and rows of weights are 32-byte aligned and padded with zeros
+// up to multiple of 8 elements.
+static void fastGEMV(const float* vec, const float* weights, size_t wstep,
+                     const float* bias, float* dst, int nw, int vecsize,
+                     bool useAVX, bool useAVX2, bool useAVX512)
+{
+#if CV_TRY_AVX512_SKX
+    if( useAVX512 )
+    {
+        opt_AVX512_SKX::fastGEMM1T( vec, weights, wstep, bias, dst, nw, vecsize );
+        return;
+    }
+#endif
+#if CV_TRY_AVX2
+    if( useAVX2 )
+    {
+        opt_AVX2::fastGEMM1T( vec, weights, wstep, bias, dst, nw, vecsize );
+        return;
+    }
+#endif
+#if CV_TRY_AVX
+    if( useAVX )
+    {
+        opt_AVX::fastGEMM1T( vec, weights, wstep, bias, dst, nw, vecsize );
+        return;
+    }
+#endif
+    (void)useAVX; (void)useAVX2; (void)useAVX512;
+    int i = 0, k;
+    const float* wptr = weights;
+#if CV_SIMD128
+    for( ; i <= nw - 4; i += 4, wptr += 4*wstep )
+    {
+        v_float32x4 vs0 = v_setall_f32(0.f), vs1 = v_setall_f32(0.f);
+        v_float32x4 vs2 = v_setall_f32(0.f), vs3 = v_setall_f32(0.f);
+
+        for( k = 0; k < vecsize; k += 4 )
+        {
+            v_float32x4 v = v_load_aligned(vec + k);
+            vs0 += v*v_load_aligned(wptr + k);
+            vs1 += v*v_load_aligned(wptr + wstep + k);
+            vs2 += v*v_load_aligned(wptr + wstep*2 + k);
+            vs3 += v*v_load_aligned(wptr + wstep*3 + k);
+        }
+
+        v_float32x4 s = v_reduce_sum4(vs0, vs1, vs2, vs3);
+        v_store(dst + i, s + v_load(bias + i));
+    }
+#endif
+    for( ; i < nw; i++, wptr += wstep )
+    {
+        float s0 = bias[i];
+        for( k = 0; k < vecsize; k++ )
+            s0 += vec[k]*wptr[k];
+        dst[i] = s0;
+    }
+}
+
+// Replaces x by 1/(1 + x). Along with exp(-x) it gives sigmoid(x),
+// along with exp(-2x) the expression 2/(1 + x) - 1 gives tanh(x).
+static void invOnePlus(float* x, int len, float scale = 1.f, float delta = 0.f)
+{
+    int i = 0;
+#if CV_SIMD128
+    v_float32x4 one = v_setall_f32(1.f), vscale = v_setall_f32(scale), vdelta = v_setall_f32(delta);
+    for( ; i <= len - 4; i += 4 )
+        v_store(x + i, vscale / (one + v_load(x + i)) + vdelta);
+#endif
+    for( ; i < len; i++ )
+        x[i] = scale / (1.f + x[i]) + delta;
+}
+
+static void scale(float* x, int len, float alpha)
+{
+    int i = 0;
+#if CV_SIMD128
+    v_float32x4 valpha = v_setall_f32(alpha);
+    for( ; i <= len - 4; i += 4 )
+        v_store(x + i, v_load(x + i)*valpha);
+#endif
+    for( ; i < len; i++ )
+        x[i] *= alpha;
+}
+
 class LSTMLayerImpl : public LSTMLayer
 {
     int numTimeStamps, numSamples;
@@ -93,6 +181,151 @@ class LSTMLayerImpl : public LSTMLayer
     float forgetBias, cellClip;
     bool useCellClip, usePeephole;
 
+    // Wh with rows padded for the vectorized kernels (Wh itself if its rows are
+    // aligned already) and the bias with forget_bias added to the forget gate.
+    Mat WhPadded, biasFused;
+
+    enum { VEC_ALIGN = 8, BLOCK_SIZE = 32 };
+
+    // Single precision layers without peephole connections are computed by
+    // the fused kernels: the input projection is computed for all the time steps
+    // at once (by the blocked parallel cv::gemm) and every time step is a single
+    // parallel pass over the hidden units.
+    bool useFusedForward() const
+    {
+        return !usePeephole && blobs[0].type() == CV_32F;
+    }
+
+    static Mat alignWeights(const Mat& weights)
+    {
+        const size_t align = VEC_ALIGN*sizeof(float);
+        if (weights.cols % VEC_ALIGN == 0 && weights.step % align == 0 && (size_t)weights.data % align == 0)
+            return weights;
+        Mat buf = Mat::zeros(weights.rows, (int)alignSize(weights.cols, VEC_ALIGN), weights.type());
+        Mat dst = buf.colRange(0, weights.cols);
+        weights.copyTo(dst);
+        return dst;
+    }
+
+    // Single time step. For every sample and block of hidden units adds
+    // h_{t-1} * Wh^T to the precomputed gates, applies the activations and
+    // updates the cell state c and the output h_t.
+    class TimeStep : public ParallelLoopBody
+    {
+    public:
+        TimeStep(const Mat& Wh_, const Mat& hPrev_, const Mat& gates_, Mat& c_,
+                 Mat& hOut_, Mat& cOut_, bool useCellClip_, float cellClip_)
+            : Wh(&Wh_), hPrev(&hPrev_), gates(&gates_), c(&c_), hOut(&hOut_), cOut(&cOut_),
+              numOut(Wh_.cols), nblocks((Wh_.cols + BLOCK_SIZE - 1) / BLOCK_SIZE),
+              useCellClip(useCellClip_), cellClip(cellClip_),
+              useAVX(checkHardwareSupport(CPU_AVX)), useAVX2(checkHardwareSupport(CPU_AVX2)),
+              useAVX512(CV_CPU_HAS_SUPPORT_AVX512_SKX) {}
+
+        // hPrev is empty at the first time step; cOut may be empty.
+        static void run(const Mat& Wh, const Mat& hPrev, const Mat& gates, Mat& c,
+                        Mat& hOut, Mat& cOut, bool useCellClip, float cellClip)
+        {
+            TimeStep p(Wh, hPrev, gates, c, hOut, cOut, useCellClip, cellClip);
+            int total = gates.rows*p.nblocks;
+            parallel_for_(Range(0, total), p, std::min(total, getNumThreads()*4));
+        }
+
+        void operator()(const Range& r) const
+        {
+            int numOut_aligned = (int)alignSize(numOut, VEC_ALIGN);
+            size_t wstep = Wh->step1();
+            AutoBuffer<float> buf(numOut_aligned + VEC_ALIGN + BLOCK_SIZE*4);
+            float* hptr = alignPtr((float*)buf, (int)(VEC_ALIGN*sizeof(float)));
+            float* gptr = hptr + numOut_aligned;
+            int prevSample = -1;
+
+            for( int k = numOut; k < numOut_aligned; k++ )
+                hptr[k] = 0.f;
+
+            for( int i = r.start; i < r.end; i++ )
+            {
+                int sample = i / nblocks;
+                int j0 = (i - sample*nblocks)*BLOCK_SIZE;
+                int len = std::min((int)BLOCK_SIZE, numOut - j0);
+                const float* xproj = gates->ptr<float>(sample) + j0;
+                float* gateI = gptr;
+                float* gateF = gateI + len;
+                float* gateO = gateF + len;
+                float* gateG = gateO + len;
+
+                if( hPrev->empty() )
+                {
+                    for( int k = 0; k < 4; k++ )
+                        memcpy(gptr + k*len, xproj + k*numOut, len*sizeof(float));
+                }
+                else
+                {
+                    if( sample != prevSample )
+                    {
+                        memcpy(hptr, hPrev->ptr<float>(sample), numOut*sizeof(float));
+                        prevSample = sample;
+                    }
+                    for( int k = 0; k < 4; k++ )
+                        fastGEMV(hptr, Wh->ptr<float>(k*numOut + j0), wstep, xproj + k*numOut,
+                                 gptr + k*len, len, numOut, useAVX, useAVX2, useAVX512);
+                }
+
+                // i, f, o = sigmoid(.), g = tanh(.)
+                scale(gateI, len*3, -1.f);
+                scale(gateG, len, -2.f);
+                hal::exp32f(gptr, gptr, len*4);
+                invOnePlus(gateI, len*3);
+                invOnePlus(gateG, len, 2.f, -1.f);
+
+                // c_t = f_t (*) c_{t-1} + i_t (*) g_t, the argument of tanh(c_t) goes to gateG
+                float* cptr = c->ptr<float>(sample) + j0;
+                int k = 0;
+#if CV_SIMD128
+                v_float32x4 vclip = v_setall_f32(cellClip), vnclip = v_setall_f32(-cellClip);
+                v_float32x4 vm2 = v_setall_f32(-2.f);
+                for( ; k <= len - 4; k += 4 )
+                {
+                    v_float32x4 v = v_load(gateF + k)*v_load(cptr + k) + v_load(gateI + k)*v_load(gateG + k);
+                    if( useCellClip )
+                        v = v_min(v_max(v, vnclip), vclip);
+                    v_store(cptr + k, v);
+                    v_store(gateG + k, v*vm2);
+                }
+#endif
+                for( ; k < len; k++ )
+                {
+                    float v = gateF[k]*cptr[k] + gateI[k]*gateG[k];
+                    if( useCellClip )
+                        v = std::min(std::max(v, -cellClip), cellClip);
+                    cptr[k] = v;
+                    gateG[k] = v*-2.f;
+                }
+
+                // h_t = o_t (*) tanh(c_t)
+                hal::exp32f(gateG, gateG, len);
+                invOnePlus(gateG, len, 2.f, -1.f);
+                float* hptrOut = hOut->ptr<float>(sample) + j0;
+                k = 0;
+#if CV_SIMD128
+                for( ; k <= len - 4; k += 4 )
+                    v_store(hptrOut + k, v_load(gateO + k)*v_load(gateG + k));
+#endif
+                for( ; k < len; k++ )
+                    hptrOut[k] = gateO[k]*gateG[k];
+
+                if( !cOut->empty() )
+                    memcpy(cOut->ptr<float>(sample) + j0, cptr, len*sizeof(float));
+            }
+        }
+
+        const Mat *Wh, *hPrev, *gates;
+        Mat *c, *hOut, *cOut;
+        int numOut, nblocks;
+        bool useCellClip;
+        float cellClip;
+        bool useAVX, useAVX2, useAVX512;
+    };
+
 public:
 
     LSTMLayerImpl(const LayerParams& params)
@@ -212,7 +445,9 @@ public:
         internals.assign(1, shape(_numSamples, _numOut)); // hInternal
         internals.push_back(shape(_numSamples, _numOut)); // cInternal
         internals.push_back(shape(_numSamples, 1)); // dummyOnes
-        internals.push_back(shape(_numSamples, 4*_numOut)); // gates
+        // The fused implementation keeps the input projection for all the time steps.
+        internals.push_back(shape(useFusedForward() ? _numTimeStamps*_numSamples : _numSamples,
+                                  4*_numOut)); // gates
 
         return false;
     }
@@ -249,6 +484,14 @@ public:
         outTsShape.push_back(numSamples);
         outTsShape.insert(outTsShape.end(), outTailShape.begin(), outTailShape.end());
 
+        if (useFusedForward())
+        {
+            WhPadded = alignWeights(Wh);
+            biasFused = blobs[2].clone();
+            if (forgetBias)
+                add(biasFused.colRange(numOut, 2*numOut), forgetBias, biasFused.colRange(numOut, 2*numOut));
+        }
+
         allocated = true;
     }
 
@@ -283,6 +526,26 @@ public:
         Mat hOutTs = output[0].reshape(1, numSamplesTotal);
         Mat cOutTs = produceCellOutput ? output[1].reshape(1, numSamplesTotal) : Mat();
 
+        if (useFusedForward())
+        {
+            CV_Assert(gates.rows == numSamplesTotal && !WhPadded.empty());
+            // gates = x * Wx^T + bias
+            repeat(biasFused.reshape(1, 1), numSamplesTotal, 1, gates);
+            gemm(xTs, Wx, 1, gates, 1, gates, GEMM_2_T);
+
+            Mat hPrev;
+            for (int ts = 0; ts < numTimeStamps; ts++)
+            {
+                Range curRowRange(ts*numSamples, (ts + 1)*numSamples);
+                Mat hCurr = hOutTs.rowRange(curRowRange);
+                Mat cCurr = produceCellOutput ? cOutTs.rowRange(curRowRange) : Mat();
+                TimeStep::run(WhPadded, hPrev, gates.rowRange(curRowRange), cInternal,
+                              hCurr, cCurr, useCellClip, cellClip);
+                hPrev = hCurr;
+            }
+            return;
+        }
+
         for (int ts = 0; ts < numTimeStamps; ts++)
         {
             Range curRowRange(ts*numSamples, (ts + 1)*numSamples);
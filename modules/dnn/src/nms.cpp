@@ -7,25 +7,249 @@
 
 #include "precomp.hpp"
 #include <nms.inl.hpp>
+#include "opencv2/core/hal/intrin.hpp"
 
 namespace cv
 {
 namespace dnn
 {
-CV__DNN_EXPERIMENTAL_NS_BEGIN
 
-static inline float rectOverlap(const Rect& a, const Rect& b)
+namespace
+{
+
+// Descending order of scores, equal scores are ordered by index.
+struct ScoreIndexGreater
+{
+    ScoreIndexGreater(const float* scores_) : scores(scores_) {}
+
+    bool operator()(int a, int b) const
+    {
+        return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+    }
+
+    const float* scores;
+};
+
+// Ascending order of classes, candidates of the same class are ordered by rank.
+struct ClassRankLess
+{
+    ClassRankLess(const int* classIds_, const int* ranks_) : classIds(classIds_), ranks(ranks_) {}
+
+    bool operator()(int a, int b) const
+    {
+        return classIds[a] < classIds[b] || (classIds[a] == classIds[b] && ranks[a] < ranks[b]);
+    }
+
+    const int *classIds, *ranks;
+};
+
+struct RankLess
+{
+    RankLess(const int* ranks_) : ranks(ranks_) {}
+
+    bool operator()(int a, int b) const { return ranks[a] < ranks[b]; }
+
+    const int* ranks;
+};
+
+} // namespace
+
+int GetMaxScoreIndex(const float* scores, int n, float threshold, int top_k, int* indices)
 {
-    return 1.f - static_cast<float>(jaccardDistance(a, b));
+    int count = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        if (scores[i] > threshold)
+            indices[count++] = i;
+    }
+
+    ScoreIndexGreater cmp(scores);
+    if (top_k > 0 && top_k < count)
+    {
+        std::partial_sort(indices, indices + top_k, indices + count, cmp);
+        return top_k;
+    }
+    std::sort(indices, indices + count, cmp);
+    return count;
 }
 
+int NMSFast(const Mat& boxes, const int* order, int n, float nms_threshold, float eta,
+            float offset, bool emptyUnionOverlap, float* buf, int* keep)
+{
+    CV_Assert(boxes.dims == 2 && boxes.rows == 5 && boxes.type() == CV_32F);
+    const float *xmin = boxes.ptr<float>(0), *ymin = boxes.ptr<float>(1),
+                *xmax = boxes.ptr<float>(2), *ymax = boxes.ptr<float>(3),
+                *area = boxes.ptr<float>(4);
+    // Kept boxes are packed to make the overlap computation contiguous.
+    float *kxmin = buf, *kymin = buf + n, *kxmax = buf + n*2, *kymax = buf + n*3,
+          *karea = buf + n*4;
+
+    float adaptive_threshold = nms_threshold;
+    int nkept = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        const int idx = order[i];
+        const float bxmin = xmin[idx], bymin = ymin[idx], bxmax = xmax[idx], bymax = ymax[idx];
+        const float barea = area[idx];
+        bool keepBox = true;
+        int k = 0;
+#if CV_SIMD128
+        v_float32x4 vxmin = v_setall_f32(bxmin), vymin = v_setall_f32(bymin);
+        v_float32x4 vxmax = v_setall_f32(bxmax), vymax = v_setall_f32(bymax);
+        v_float32x4 varea = v_setall_f32(barea), voffset = v_setall_f32(offset);
+        v_float32x4 vthreshold = v_setall_f32(adaptive_threshold);
+        v_float32x4 vzero = v_setzero_f32(), vone = v_setall_f32(1.f);
+        for (; k <= nkept - 4 && keepBox; k += 4)
+        {
+            v_float32x4 ixmin = v_max(vxmin, v_load(kxmin + k));
+            v_float32x4 iymin = v_max(vymin, v_load(kymin + k));
+            v_float32x4 ixmax = v_min(vxmax, v_load(kxmax + k));
+            v_float32x4 iymax = v_min(vymax, v_load(kymax + k));
+            v_float32x4 inter = (ixmax - ixmin + voffset)*(iymax - iymin + voffset);
+            inter = v_select((ixmax >= ixmin) & (iymax >= iymin), inter, vzero);
+            v_float32x4 areas = varea + v_load(karea + k);
+            v_float32x4 overlap = v_select(inter > vzero, inter / (areas - inter), vzero);
+            if (emptyUnionOverlap)
+                overlap = v_select(areas <= vzero, vone, overlap);
+            keepBox = !v_check_any(overlap > vthreshold);
+        }
+#endif
+        for (; k < nkept && keepBox; ++k)
+        {
+            float ixmin = std::max(bxmin, kxmin[k]), iymin = std::max(bymin, kymin[k]);
+            float ixmax = std::min(bxmax, kxmax[k]), iymax = std::min(bymax, kymax[k]);
+            float inter = ixmax < ixmin || iymax < iymin ? 0.f :
+                          (ixmax - ixmin + offset)*(iymax - iymin + offset);
+            float areas = barea + karea[k];
+            float overlap = inter > 0 ? inter / (areas - inter) : 0.f;
+            if (emptyUnionOverlap && areas <= 0)
+                overlap = 1.f;
+            keepBox = overlap <= adaptive_threshold;
+        }
+        if (keepBox)
+        {
+            kxmin[nkept] = bxmin;
+            kymin[nkept] = bymin;
+            kxmax[nkept] = bxmax;
+            kymax[nkept] = bymax;
+            karea[nkept] = barea;
+            keep[nkept++] = idx;
+            if (eta < 1 && adaptive_threshold > 0.5)
+                adaptive_threshold *= eta;
+        }
+    }
+    return nkept;
+}
+
+static Mat rectsToBoxes(const std::vector<Rect>& bboxes)
+{
+    Mat boxes(5, (int)bboxes.size(), CV_32F);
+    float *xmin = boxes.ptr<float>(0), *ymin = boxes.ptr<float>(1),
+          *xmax = boxes.ptr<float>(2), *ymax = boxes.ptr<float>(3),
+          *area = boxes.ptr<float>(4);
+    for (size_t i = 0; i < bboxes.size(); ++i)
+    {
+        const Rect& r = bboxes[i];
+        xmin[i] = (float)r.x;
+        ymin[i] = (float)r.y;
+        xmax[i] = (float)(r.x + r.width);
+        ymax[i] = (float)(r.y + r.height);
+        area[i] = (float)r.area();
+    }
+    return boxes;
+}
+
+// NMS for every class of the candidates which are grouped by classes.
+class NMSBatchedInvoker : public ParallelLoopBody
+{
+public:
+    NMSBatchedInvoker(const Mat& boxes_, const int* order_, const std::vector<int>& groups_,
+                      float nms_threshold_, float eta_, float* buf_, int* keep_, int* counts_)
+        : boxes(boxes_), order(order_), groups(groups_), nms_threshold(nms_threshold_),
+          eta(eta_), buf(buf_), keep(keep_), counts(counts_) {}
+
+    void operator()(const Range& r) const
+    {
+        for (int i = r.start; i < r.end; ++i)
+        {
+            int start = groups[i], n = groups[i + 1] - start;
+            counts[i] = NMSFast(boxes, order + start, n, nms_threshold, eta, 0.f, true,
+                                buf + start*5, keep + start);
+        }
+    }
+
+private:
+    const Mat& boxes;
+    const int* order;
+    const std::vector<int>& groups;
+    float nms_threshold, eta;
+    float* buf;
+    int *keep, *counts;
+};
+
+CV__DNN_EXPERIMENTAL_NS_BEGIN
+
 void NMSBoxes(const std::vector<Rect>& bboxes, const std::vector<float>& scores,
                           const float score_threshold, const float nms_threshold,
                           std::vector<int>& indices, const float eta, const int top_k)
 {
     CV_Assert(bboxes.size() == scores.size(), score_threshold >= 0,
         nms_threshold >= 0, eta > 0);
-    NMSFast_(bboxes, scores, score_threshold, nms_threshold, eta, top_k, indices, rectOverlap);
+    indices.clear();
+    int n = (int)bboxes.size();
+    if (n == 0)
+        return;
+
+    Mat boxes = rectsToBoxes(bboxes);
+    AutoBuffer<int> order(n);
+    int count = GetMaxScoreIndex(&scores[0], n, score_threshold, top_k, order);
+
+    AutoBuffer<float> buf(count*5 + 1);
+    indices.resize(count);
+    if (count > 0)
+        indices.resize(NMSFast(boxes, order, count, nms_threshold, eta, 0.f, true, buf, &indices[0]));
+}
+
+void NMSBoxesBatched(const std::vector<Rect>& bboxes, const std::vector<float>& scores,
+                     const std::vector<int>& class_ids, const float score_threshold,
+                     const float nms_threshold, std::vector<int>& indices,
+                     const float eta, const int top_k)
+{
+    CV_Assert(bboxes.size() == scores.size(), bboxes.size() == class_ids.size(),
+        score_threshold >= 0, nms_threshold >= 0, eta > 0);
+    indices.clear();
+    int n = (int)bboxes.size();
+    if (n == 0)
+        return;
+
+    Mat boxes = rectsToBoxes(bboxes);
+    std::vector<int> order(n), ranks(n);
+    int count = GetMaxScoreIndex(&scores[0], n, score_threshold, top_k, &order[0]);
+    if (count == 0)
+        return;
+    for (int i = 0; i < count; ++i)
+        ranks[order[i]] = i;
+
+    // Group candidates by classes keeping the order of scores inside of every group.
+    std::sort(order.begin(), order.begin() + count, ClassRankLess(&class_ids[0], &ranks[0]));
+    std::vector<int> groups(1, 0);
+    for (int i = 1; i < count; ++i)
+    {
+        if (class_ids[order[i]] != class_ids[order[i - 1]])
+            groups.push_back(i);
+    }
+    groups.push_back(count);
+    int ngroups = (int)groups.size() - 1;
+
+    std::vector<float> buf(count*5);
+    std::vector<int> keep(count), counts(ngroups);
+    NMSBatchedInvoker invoker(boxes, &order[0], groups, nms_threshold, eta,
+                              &buf[0], &keep[0], &counts[0]);
+    parallel_for_(Range(0, ngroups), invoker);
+
+    for (int i = 0; i < ngroups; ++i)
+        indices.insert(indices.end(), keep.begin() + groups[i], keep.begin() + groups[i] + counts[i]);
+    std::sort(indices.begin(), indices.end(), RankLess(&ranks[0]));
 }
 
 CV__DNN_EXPERIMENTAL_NS_END
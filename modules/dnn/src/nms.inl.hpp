@@ -94,6 +94,28 @@ inline void NMSFast_(const std::vector<BoxType>& bboxes,
     }
 }
 
+// Selects indices of the scores which are higher than the threshold and sorts them
+// in descending order of scores (equal scores are ordered by index). It gives
+// the same order as GetMaxScoreIndex without allocations.
+//    scores: n scores.
+//    top_k: if > 0, keep at most top_k indices.
+//    indices: room for n indices.
+// Returns the number of selected indices.
+int GetMaxScoreIndex(const float* scores, int n, float threshold, int top_k, int* indices);
+
+// Vectorized version of NMSFast_ for boxes stored as structure of arrays.
+// Overlap is computed as in Caffe: the intersection area is
+// (xmax - xmin + offset)*(ymax - ymin + offset) and it is zero if the intersection is empty.
+//    boxes: 5 x N matrix with rows xmin, ymin, xmax, ymax and area of the boxes.
+//    order: n indices of candidates sorted by descending scores.
+//    emptyUnionOverlap: consider boxes with zero total area as fully overlapped
+//      (to match jaccardDistance for cv::Rect).
+//    buf: workspace for 5*n floats.
+//    keep: room for n kept indices.
+// Returns the number of kept indices.
+int NMSFast(const Mat& boxes, const int* order, int n, float nms_threshold, float eta,
+            float offset, bool emptyUnionOverlap, float* buf, int* keep);
+
 }// dnn
 }// cv
 
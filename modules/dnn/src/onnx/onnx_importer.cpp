@@ -0,0 +1,1345 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+/*
+Implementation of ONNX models parser.
+
+Models are serialized ModelProto messages of onnx.proto. Only a part of the
+scheme which is required to build a network is decoded here, so the importer
+doesn't need sources generated by protoc.
+*/
+
+#include "../precomp.hpp"
+#include <opencv2/dnn/shape_utils.hpp>
+
+#include <fstream>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace cv {
+namespace dnn {
+CV__DNN_EXPERIMENTAL_NS_BEGIN
+
+namespace
+{
+
+// Reader of protobuf binary wire format. Fixed-size values are read
+// assuming little-endian host.
+class ProtoReader
+{
+public:
+    enum WireType
+    {
+        WIRE_VARINT = 0,
+        WIRE_FIXED64 = 1,
+        WIRE_LENGTH_DELIMITED = 2,
+        WIRE_FIXED32 = 5
+    };
+
+    ProtoReader(const char* data, size_t size)
+        : ptr((const uchar*)data), end((const uchar*)data + size), field(0), wireType(0) {}
+
+    // Reads a key of the next field. Returns false at the end of message.
+    bool next()
+    {
+        if (ptr >= end)
+            return false;
+        uint64 key = readVarint();
+        field = (int)(key >> 3);
+        wireType = (int)(key & 7);
+        check(field > 0);
+        return true;
+    }
+
+    int getField() const { return field; }
+
+    uint64 readVarint()
+    {
+        uint64 value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            check(ptr < end);
+            uchar b = *ptr++;
+            value |= (uint64)(b & 0x7f) << shift;
+            if (!(b & 0x80))
+                return value;
+        }
+        check(false);
+        return 0;
+    }
+
+    int64 readInt64() { return (int64)readVarint(); }
+
+    float readFloat()
+    {
+        check(wireType == WIRE_FIXED32 && end - ptr >= 4);
+        float value;
+        memcpy(&value, ptr, sizeof(value));
+        ptr += sizeof(value);
+        return value;
+    }
+
+    double readDouble()
+    {
+        check(wireType == WIRE_FIXED64 && end - ptr >= 8);
+        double value;
+        memcpy(&value, ptr, sizeof(value));
+        ptr += sizeof(value);
+        return value;
+    }
+
+    void readBytes(const char*& data, size_t& size)
+    {
+        check(wireType == WIRE_LENGTH_DELIMITED);
+        uint64 len = readVarint();
+        check(len <= (uint64)(end - ptr));
+        data = (const char*)ptr;
+        size = (size_t)len;
+        ptr += len;
+    }
+
+    std::string readString()
+    {
+        const char* data;
+        size_t size;
+        readBytes(data, size);
+        return std::string(data, size);
+    }
+
+    ProtoReader readMessage()
+    {
+        const char* data;
+        size_t size;
+        readBytes(data, size);
+        return ProtoReader(data, size);
+    }
+
+    // Repeated numeric fields may be packed or not.
+    void readInt64s(std::vector<int64>& values)
+    {
+        if (wireType != WIRE_LENGTH_DELIMITED)
+        {
+            values.push_back(readInt64());
+            return;
+        }
+        ProtoReader packed = readMessage();
+        while (packed.ptr < packed.end)
+            values.push_back(packed.readInt64());
+    }
+
+    void readFloats(std::vector<float>& values)
+    {
+        if (wireType != WIRE_LENGTH_DELIMITED)
+        {
+            values.push_back(readFloat());
+            return;
+        }
+        ProtoReader packed = readMessage();
+        packed.wireType = WIRE_FIXED32;
+        while (packed.ptr < packed.end)
+            values.push_back(packed.readFloat());
+    }
+
+    void readDoubles(std::vector<double>& values)
+    {
+        if (wireType != WIRE_LENGTH_DELIMITED)
+        {
+            values.push_back(readDouble());
+            return;
+        }
+        ProtoReader packed = readMessage();
+        packed.wireType = WIRE_FIXED64;
+        while (packed.ptr < packed.end)
+            values.push_back(packed.readDouble());
+    }
+
+    void skip()
+    {
+        switch (wireType)
+        {
+        case WIRE_VARINT: readVarint(); break;
+        case WIRE_FIXED64: check(end - ptr >= 8); ptr += 8; break;
+        case WIRE_FIXED32: check(end - ptr >= 4); ptr += 4; break;
+        case WIRE_LENGTH_DELIMITED: { const char* data; size_t size; readBytes(data, size); break; }
+        default: check(false);
+        }
+    }
+
+private:
+    static void check(bool condition)
+    {
+        if (!condition)
+            CV_Error(Error::StsParseError, "Failed to parse ONNX model: the data is corrupted");
+    }
+
+    const uchar* ptr;
+    const uchar* end;
+    int field;
+    int wireType;
+};
+
+enum TensorDataType
+{
+    TENSOR_FLOAT = 1,
+    TENSOR_UINT8 = 2,
+    TENSOR_INT8 = 3,
+    TENSOR_UINT16 = 4,
+    TENSOR_INT16 = 5,
+    TENSOR_INT32 = 6,
+    TENSOR_INT64 = 7,
+    TENSOR_BOOL = 9,
+    TENSOR_FLOAT16 = 10,
+    TENSOR_DOUBLE = 11
+};
+
+struct TensorProto
+{
+    TensorProto() : dataType(0), rawData(0), rawSize(0) {}
+
+    std::string name;
+    std::vector<int64> dims;
+    int dataType;
+    std::vector<float> floatData;
+    std::vector<int64> intData;  // int32_data and int64_data fields
+    std::vector<double> doubleData;
+    const char* rawData;  // points to the model data
+    size_t rawSize;
+};
+
+struct AttributeProto
+{
+    AttributeProto() : f(0.f), i(0), hasTensor(false) {}
+
+    std::string name;
+    float f;
+    int64 i;
+    std::string s;
+    TensorProto t;
+    bool hasTensor;
+    std::vector<float> floats;
+    std::vector<int64> ints;
+};
+
+struct NodeProto
+{
+    std::vector<std::string> inputs;
+    std::vector<std::string> outputs;
+    std::string name;
+    std::string opType;
+    std::vector<AttributeProto> attributes;
+};
+
+struct ValueInfoProto
+{
+    ValueInfoProto() : hasShape(false) {}
+
+    std::string name;
+    std::vector<int64> dims;  // -1 for symbolic dimensions
+    bool hasShape;
+};
+
+struct GraphProto
+{
+    std::vector<NodeProto> nodes;
+    std::vector<TensorProto> initializers;
+    std::vector<ValueInfoProto> inputs;
+    std::vector<ValueInfoProto> outputs;
+};
+
+static void parseTensor(ProtoReader reader, TensorProto& tensor)
+{
+    while (reader.next())
+    {
+        switch (reader.getField())
+        {
+        case 1: reader.readInt64s(tensor.dims); break;
+        case 2: tensor.dataType = (int)reader.readInt64(); break;
+        case 4: reader.readFloats(tensor.floatData); break;
+        case 5: reader.readInt64s(tensor.intData); break;
+        case 7: reader.readInt64s(tensor.intData); break;
+        case 8: tensor.name = reader.readString(); break;
+        case 9: reader.readBytes(tensor.rawData, tensor.rawSize); break;
+        case 10: reader.readDoubles(tensor.doubleData); break;
+        case 14:
+            if (reader.readInt64() != 0)
+                CV_Error(Error::StsNotImplemented, "ONNX tensors with external data are not supported");
+            break;
+        default: reader.skip();
+        }
+    }
+}
+
+static void parseAttribute(ProtoReader reader, AttributeProto& attr)
+{
+    while (reader.next())
+    {
+        switch (reader.getField())
+        {
+        case 1: attr.name = reader.readString(); break;
+        case 2: attr.f = reader.readFloat(); break;
+        case 3: attr.i = reader.readInt64(); break;
+        case 4: attr.s = reader.readString(); break;
+        case 5: parseTensor(reader.readMessage(), attr.t); attr.hasTensor = true; break;
+        case 7: reader.readFloats(attr.floats); break;
+        case 8: reader.readInt64s(attr.ints); break;
+        default: reader.skip();
+        }
+    }
+}
+
+static void parseNode(ProtoReader reader, NodeProto& node)
+{
+    while (reader.next())
+    {
+        switch (reader.getField())
+        {
+        case 1: node.inputs.push_back(reader.readString()); break;
+        case 2: node.outputs.push_back(reader.readString()); break;
+        case 3: node.name = reader.readString(); break;
+        case 4: node.opType = reader.readString(); break;
+        case 5:
+            node.attributes.push_back(AttributeProto());
+            parseAttribute(reader.readMessage(), node.attributes.back());
+            break;
+        default: reader.skip();
+        }
+    }
+}
+
+// TensorShapeProto.Dimension
+static int64 parseDimension(ProtoReader reader)
+{
+    int64 value = -1;
+    while (reader.next())
+    {
+        if (reader.getField() == 1)
+            value = reader.readInt64();
+        else
+            reader.skip();
+    }
+    return value;
+}
+
+static void parseValueInfo(ProtoReader reader, ValueInfoProto& info)
+{
+    while (reader.next())
+    {
+        if (reader.getField() == 1)
+        {
+            info.name = reader.readString();
+            continue;
+        }
+        if (reader.getField() != 2)
+        {
+            reader.skip();
+            continue;
+        }
+        // TypeProto -> TypeProto.Tensor -> TensorShapeProto
+        ProtoReader type = reader.readMessage();
+        while (type.next())
+        {
+            if (type.getField() != 1)
+            {
+                type.skip();
+                continue;
+            }
+            ProtoReader tensorType = type.readMessage();
+            while (tensorType.next())
+            {
+                if (tensorType.getField() != 2)
+                {
+                    tensorType.skip();
+                    continue;
+                }
+                info.hasShape = true;
+                ProtoReader shape = tensorType.readMessage();
+                while (shape.next())
+                {
+                    if (shape.getField() == 1)
+                        info.dims.push_back(parseDimension(shape.readMessage()));
+                    else
+                        shape.skip();
+                }
+            }
+        }
+    }
+}
+
+static void parseGraph(ProtoReader reader, GraphProto& graph)
+{
+    while (reader.next())
+    {
+        switch (reader.getField())
+        {
+        case 1:
+            graph.nodes.push_back(NodeProto());
+            parseNode(reader.readMessage(), graph.nodes.back());
+            break;
+        case 5:
+            graph.initializers.push_back(TensorProto());
+            parseTensor(reader.readMessage(), graph.initializers.back());
+            break;
+        case 11:
+            graph.inputs.push_back(ValueInfoProto());
+            parseValueInfo(reader.readMessage(), graph.inputs.back());
+            break;
+        case 12:
+            graph.outputs.push_back(ValueInfoProto());
+            parseValueInfo(reader.readMessage(), graph.outputs.back());
+            break;
+        default: reader.skip();
+        }
+    }
+}
+
+static bool parseModel(ProtoReader reader, GraphProto& graph)
+{
+    bool hasGraph = false;
+    while (reader.next())
+    {
+        if (reader.getField() == 7)
+        {
+            parseGraph(reader.readMessage(), graph);
+            hasGraph = true;
+        }
+        else
+            reader.skip();
+    }
+    return hasGraph;
+}
+
+// Converts tensor to Mat. Floating point data is converted to CV_32F, integer one to CV_32S.
+// Tensors with less than 2 dimensions are stored as a single row.
+static Mat getMatFromTensor(const TensorProto& tensor)
+{
+    std::vector<int> sizes(tensor.dims.begin(), tensor.dims.end());
+    if (sizes.size() < 2)
+    {
+        int len = sizes.empty() ? 1 : sizes[0];
+        sizes.assign(1, 1);
+        sizes.push_back(len);
+    }
+    const int dims = (int)sizes.size();
+    const size_t numElems = (size_t)total(MatShape(sizes));
+    if (numElems == 0)
+        return Mat();
+
+    static const int elemSizes[] = {0, 4, 1, 1, 2, 2, 4, 8, 0, 1, 2, 8};
+    if (tensor.rawData &&
+        (tensor.dataType >= (int)(sizeof(elemSizes) / sizeof(elemSizes[0])) ||
+         tensor.rawSize != numElems * elemSizes[tensor.dataType]))
+    {
+        CV_Error(Error::StsParseError, "Size of ONNX tensor \"" + tensor.name + "\" doesn't match its data");
+    }
+
+    Mat blob;
+    switch (tensor.dataType)
+    {
+    case TENSOR_FLOAT:
+        CV_Assert(tensor.rawData || tensor.floatData.size() == numElems);
+        Mat(dims, &sizes[0], CV_32F, tensor.rawData ? (void*)tensor.rawData :
+                                                      (void*)&tensor.floatData[0]).copyTo(blob);
+        break;
+    case TENSOR_DOUBLE:
+        CV_Assert(tensor.rawData || tensor.doubleData.size() == numElems);
+        Mat(dims, &sizes[0], CV_64F, tensor.rawData ? (void*)tensor.rawData :
+                                                      (void*)&tensor.doubleData[0]).convertTo(blob, CV_32F);
+        break;
+    case TENSOR_FLOAT16:
+    {
+        // Values are stored in the lower bits of int32_data if raw_data is not used.
+        Mat halfs(1, (int)numElems, CV_16S);
+        if (tensor.rawData)
+            memcpy(halfs.data, tensor.rawData, numElems * sizeof(short));
+        else
+        {
+            CV_Assert(tensor.intData.size() == numElems);
+            for (size_t i = 0; i < numElems; ++i)
+                halfs.at<short>((int)i) = (short)tensor.intData[i];
+        }
+        blob.create(dims, &sizes[0], CV_32F);
+        Mat dst = blob.reshape(1, 1);
+        convertFp16(halfs, dst);
+        break;
+    }
+    case TENSOR_INT64:
+    case TENSOR_INT32:
+    case TENSOR_INT16:
+    case TENSOR_UINT16:
+    case TENSOR_INT8:
+    case TENSOR_UINT8:
+    case TENSOR_BOOL:
+    {
+        blob.create(dims, &sizes[0], CV_32S);
+        int* dst = blob.ptr<int>();
+        if (!tensor.rawData)
+        {
+            CV_Assert(tensor.intData.size() == numElems);
+            for (size_t i = 0; i < numElems; ++i)
+                dst[i] = saturate_cast<int>(tensor.intData[i]);
+        }
+        else
+        {
+            const char* src = tensor.rawData;
+            for (size_t i = 0; i < numElems; ++i)
+            {
+                switch (tensor.dataType)
+                {
+                case TENSOR_INT64: { int64 v; memcpy(&v, src + i * 8, 8); dst[i] = saturate_cast<int>(v); break; }
+                case TENSOR_INT32: memcpy(&dst[i], src + i * 4, 4); break;
+                case TENSOR_INT16: { short v; memcpy(&v, src + i * 2, 2); dst[i] = v; break; }
+                case TENSOR_UINT16: { ushort v; memcpy(&v, src + i * 2, 2); dst[i] = v; break; }
+                case TENSOR_INT8: dst[i] = (schar)src[i]; break;
+                default: dst[i] = (uchar)src[i];
+                }
+            }
+        }
+        break;
+    }
+    default:
+        CV_Error_(Error::StsNotImplemented, ("Unsupported data type %d of ONNX tensor \"%s\"",
+                                             tensor.dataType, tensor.name.c_str()));
+    }
+    return blob;
+}
+
+static std::vector<int> getIntValues(const Mat& blob)
+{
+    Mat values;
+    blob.convertTo(values, CV_32S);
+    return std::vector<int>(values.ptr<int>(), values.ptr<int>() + values.total());
+}
+
+static MatShape squeezeShape(MatShape shape, std::vector<int> axes, bool unsqueeze)
+{
+    int outDims = (int)shape.size() + (unsqueeze ? (int)axes.size() : 0);
+    for (size_t i = 0; i < axes.size(); ++i)
+    {
+        if (axes[i] < 0)
+            axes[i] += outDims;
+        CV_Assert(0 <= axes[i] && axes[i] < outDims);
+    }
+    std::sort(axes.begin(), axes.end());
+    if (unsqueeze)
+    {
+        for (size_t i = 0; i < axes.size(); ++i)
+            shape.insert(shape.begin() + axes[i], 1);
+    }
+    else
+    {
+        for (int i = (int)axes.size() - 1; i >= 0; --i)
+        {
+            CV_Assert(shape[axes[i]] == 1);
+            shape.erase(shape.begin() + axes[i]);
+        }
+    }
+    return shape;
+}
+
+// Resolves zero (copy input dimension) and -1 (inferred) values of Reshape dimensions.
+static MatShape reshapeShape(const MatShape& inpShape, const std::vector<int>& dims)
+{
+    MatShape outShape(dims);
+    int inferredIdx = -1, knownTotal = 1;
+    for (int i = 0; i < (int)outShape.size(); ++i)
+    {
+        if (outShape[i] == 0)
+        {
+            CV_Assert(i < (int)inpShape.size());
+            outShape[i] = inpShape[i];
+        }
+        if (outShape[i] == -1)
+            inferredIdx = i;
+        else
+            knownTotal *= outShape[i];
+    }
+    if (inferredIdx >= 0)
+        outShape[inferredIdx] = total(inpShape) / knownTotal;
+    CV_Assert(total(outShape) == total(inpShape));
+    return outShape;
+}
+
+struct LayerInfo
+{
+    LayerInfo(int _layerId = -1, int _outputId = -1) : layerId(_layerId), outputId(_outputId) {}
+
+    int layerId;
+    int outputId;
+};
+
+class ONNXImporter
+{
+public:
+    ONNXImporter(const char* onnxFile)
+    {
+        std::ifstream ifs(onnxFile, std::ios::binary);
+        if (!ifs.is_open())
+            CV_Error(Error::StsObjectNotFound, format("Failed to open ONNX model file: %s", onnxFile));
+        modelData.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        parse(modelData.empty() ? 0 : &modelData[0], modelData.size());
+    }
+
+    ONNXImporter(const char* buffer, size_t sizeBuffer)
+    {
+        parse(buffer, sizeBuffer);
+    }
+
+    void populateNet(Net dstNet);
+
+private:
+    void parse(const char* data, size_t size)
+    {
+        if (!parseModel(ProtoReader(data, size), graph))
+            CV_Error(Error::StsParseError, "ONNX model doesn't contain a graph");
+    }
+
+    LayerParams getLayerParams(const NodeProto& node);
+    void handleNode(const NodeProto& node, Net& dstNet);
+    bool foldConstants(const NodeProto& node, const LayerParams& layerParams);
+    void addLayer(Net& dstNet, LayerParams& layerParams, const NodeProto& node,
+                  const std::vector<std::string>& inputs);
+    void addConstant(const std::string& name, const Mat& blob, const MatShape& blobShape);
+    // Output of the node is the same tensor as the input.
+    void setAlias(const std::string& output, const std::string& input);
+    bool isConst(const std::string& name) const { return constBlobs.find(name) != constBlobs.end(); }
+    bool hasShape(const std::string& name) const { return outShapes.find(name) != outShapes.end(); }
+    const Mat& getBlob(const NodeProto& node, int idx) const;
+    // Values of the attribute or of the constant input which replaces it in newer opsets.
+    std::vector<int> getInts(const NodeProto& node, const LayerParams& layerParams,
+                             int inputIdx, const char* attrName) const;
+    std::vector<int> getSqueezeAxes(const NodeProto& node, const LayerParams& layerParams,
+                                    const MatShape& inpShape) const;
+    bool onlyConsumedByFullyConnected(const std::string& name) const;
+    const std::vector<int>* getBatchPositions(const std::string& name) const;
+
+    std::vector<char> modelData;
+    GraphProto graph;
+    std::map<std::string, Mat> constBlobs;
+    std::map<std::string, LayerInfo> layerIds;
+    // Known shapes of tensors including constant ones.
+    std::map<std::string, MatShape> outShapes;
+    std::map<std::string, std::vector<std::string> > consumers;
+    std::map<std::string, int> layerNames;
+    // Positions of the values of folded shape computations which are the batch size.
+    // The batch size is not baked into Reshape layers, so the network works with any batch.
+    std::map<std::string, std::vector<int> > batchPositions;
+};
+
+LayerParams ONNXImporter::getLayerParams(const NodeProto& node)
+{
+    LayerParams lp;
+    for (size_t i = 0; i < node.attributes.size(); ++i)
+    {
+        const AttributeProto& attr = node.attributes[i];
+        const std::string& name = attr.name;
+        if (name == "kernel_shape" || name == "strides" || name == "dilations")
+        {
+            CV_Assert(attr.ints.size() == 2);
+            std::string base = name == "kernel_shape" ? "kernel" :
+                               name == "strides" ? "stride" : "dilation";
+            lp.set(base + "_h", (int)attr.ints[0]);
+            lp.set(base + "_w", (int)attr.ints[1]);
+        }
+        else if (name == "pads" && attr.ints.size() == 4 && node.opType != "Pad")
+        {
+            // [top, left, bottom, right]
+            if (attr.ints[0] != attr.ints[2] || attr.ints[1] != attr.ints[3])
+                CV_Error(Error::StsNotImplemented, "Asymmetric paddings are not supported, node: " + node.name);
+            lp.set("pad_h", (int)attr.ints[0]);
+            lp.set("pad_w", (int)attr.ints[1]);
+        }
+        else if (name == "auto_pad")
+        {
+            if (attr.s == "SAME_UPPER")
+                lp.set("pad_mode", "SAME");
+            else if (attr.s == "VALID")
+                lp.set("pad_mode", "VALID");
+            else if (attr.s != "NOTSET")
+                CV_Error(Error::StsNotImplemented, "Unsupported padding mode " + attr.s);
+        }
+        else if (attr.hasTensor)
+        {
+            lp.blobs.push_back(getMatFromTensor(attr.t));
+        }
+        else if (!attr.ints.empty())
+        {
+            lp.set(name, DictValue::arrayInt(attr.ints.begin(), (int)attr.ints.size()));
+        }
+        else if (!attr.floats.empty())
+        {
+            lp.set(name, DictValue::arrayReal(attr.floats.begin(), (int)attr.floats.size()));
+        }
+        else if (!attr.s.empty())
+        {
+            lp.set(name, String(attr.s));
+        }
+        else if (attr.f != 0.f)
+        {
+            lp.set(name, attr.f);
+        }
+        else
+        {
+            lp.set(name, attr.i);
+        }
+    }
+
+    // Names of nodes are optional, use name of the first output instead.
+    std::string name = !node.name.empty() ? node.name : node.outputs[0];
+    int& counter = layerNames[name];
+    if (counter++ > 0)
+        name += format("_%d", counter);
+    lp.name = name;
+    lp.type = node.opType;
+    return lp;
+}
+
+const Mat& ONNXImporter::getBlob(const NodeProto& node, int idx) const
+{
+    CV_Assert(idx < (int)node.inputs.size());
+    std::map<std::string, Mat>::const_iterator it = constBlobs.find(node.inputs[idx]);
+    if (it == constBlobs.end())
+        CV_Error(Error::StsNotImplemented, format("Input #%d of node \"%s\" (%s) must be a constant",
+                                                  idx, node.name.c_str(), node.opType.c_str()));
+    return it->second;
+}
+
+std::vector<int> ONNXImporter::getInts(const NodeProto& node, const LayerParams& layerParams,
+                                       int inputIdx, const char* attrName) const
+{
+    if (inputIdx < (int)node.inputs.size() && !node.inputs[inputIdx].empty())
+        return getIntValues(getBlob(node, inputIdx));
+    if (!layerParams.has(attrName))
+        CV_Error(Error::StsBadArg, format("Attribute %s of node \"%s\" is not specified",
+                                          attrName, layerParams.name.c_str()));
+    const DictValue& param = layerParams.get(attrName);
+    std::vector<int> values(param.size());
+    for (int i = 0; i < param.size(); ++i)
+        values[i] = param.get<int>(i);
+    return values;
+}
+
+std::vector<int> ONNXImporter::getSqueezeAxes(const NodeProto& node, const LayerParams& layerParams,
+                                              const MatShape& inpShape) const
+{
+    if (node.opType == "Squeeze" && node.inputs.size() < 2 && !layerParams.has("axes"))
+    {
+        // All single dimensions are removed.
+        std::vector<int> axes;
+        for (int i = 0; i < (int)inpShape.size(); ++i)
+        {
+            if (inpShape[i] == 1)
+                axes.push_back(i);
+        }
+        return axes;
+    }
+    return getInts(node, layerParams, 1, "axes");
+}
+
+bool ONNXImporter::onlyConsumedByFullyConnected(const std::string& name) const
+{
+    std::map<std::string, std::vector<std::string> >::const_iterator it = consumers.find(name);
+    if (it == consumers.end())
+        return false;
+    for (size_t i = 0; i < it->second.size(); ++i)
+    {
+        if (it->second[i] != "Gemm" && it->second[i] != "MatMul")
+            return false;
+    }
+    return true;
+}
+
+const std::vector<int>* ONNXImporter::getBatchPositions(const std::string& name) const
+{
+    std::map<std::string, std::vector<int> >::const_iterator it = batchPositions.find(name);
+    return it != batchPositions.end() ? &it->second : 0;
+}
+
+void ONNXImporter::addConstant(const std::string& name, const Mat& blob, const MatShape& blobShape)
+{
+    constBlobs[name] = blob;
+    outShapes[name] = blobShape;
+}
+
+void ONNXImporter::setAlias(const std::string& output, const std::string& input)
+{
+    if (isConst(input))
+        constBlobs[output] = constBlobs[input];
+    else
+    {
+        std::map<std::string, LayerInfo>::iterator it = layerIds.find(input);
+        CV_Assert(it != layerIds.end());
+        layerIds[output] = it->second;
+    }
+    if (hasShape(input))
+        outShapes[output] = outShapes[input];
+    if (getBatchPositions(input))
+        batchPositions[output] = batchPositions[input];
+}
+
+void ONNXImporter::addLayer(Net& dstNet, LayerParams& layerParams, const NodeProto& node,
+                            const std::vector<std::string>& inputs)
+{
+    int id = dstNet.addLayer(layerParams.name, layerParams.type, layerParams);
+    std::vector<MatShape> inpShapes;
+    for (int i = 0; i < (int)inputs.size(); ++i)
+    {
+        std::map<std::string, LayerInfo>::iterator it = layerIds.find(inputs[i]);
+        if (it == layerIds.end())
+            CV_Error(Error::StsObjectNotFound, "Unknown input \"" + inputs[i] + "\" of node " + layerParams.name);
+        dstNet.connect(it->second.layerId, it->second.outputId, id, i);
+        if (hasShape(inputs[i]))
+            inpShapes.push_back(outShapes[inputs[i]]);
+    }
+    for (int i = 0; i < (int)node.outputs.size(); ++i)
+        layerIds[node.outputs[i]] = LayerInfo(id, i);
+
+    // Shapes are tracked to resolve shape computations over constants.
+    if (!inputs.empty() && inpShapes.size() == inputs.size())
+    {
+        std::vector<MatShape> layerOutShapes, layerInternals;
+        dstNet.getLayer(id)->getMemoryShapes(inpShapes, (int)node.outputs.size(),
+                                            layerOutShapes, layerInternals);
+        for (int i = 0; i < (int)node.outputs.size() && i < (int)layerOutShapes.size(); ++i)
+            outShapes[node.outputs[i]] = layerOutShapes[i];
+    }
+}
+
+// Computes outputs of nodes which depend only on constants or on known shapes.
+bool ONNXImporter::foldConstants(const NodeProto& node, const LayerParams& layerParams)
+{
+    const std::string& type = node.opType;
+    const std::string& output = node.outputs[0];
+    if (type == "Constant")
+    {
+        for (size_t i = 0; i < node.attributes.size(); ++i)
+        {
+            const AttributeProto& attr = node.attributes[i];
+            if (attr.hasTensor)
+            {
+                addConstant(output, getMatFromTensor(attr.t), MatShape(attr.t.dims.begin(), attr.t.dims.end()));
+                return true;
+            }
+        }
+        CV_Error(Error::StsNotImplemented, "Constant node \"" + layerParams.name + "\" has no tensor value");
+    }
+    if (type == "Shape")
+    {
+        if (!hasShape(node.inputs[0]))
+            CV_Error(Error::StsNotImplemented, "Shape of tensor \"" + node.inputs[0] + "\" is unknown. "
+                     "Specify shapes of the network inputs in the model");
+        const MatShape& inpShape = outShapes[node.inputs[0]];
+        addConstant(output, Mat(inpShape, true).reshape(1, 1), shape((int)inpShape.size()));
+        // The first dimension of the computed tensors is the batch.
+        if (!isConst(node.inputs[0]) && !inpShape.empty())
+            batchPositions[output] = std::vector<int>(1, 0);
+        return true;
+    }
+
+    for (size_t i = 0; i < node.inputs.size(); ++i)
+    {
+        if (!node.inputs[i].empty() && !isConst(node.inputs[i]))
+            return false;
+    }
+    if (node.inputs.empty())
+        return false;
+
+    const Mat& inp = constBlobs[node.inputs[0]];
+    MatShape inpShape = outShapes[node.inputs[0]];
+    if (type == "Identity" || type == "Cast" || type == "Dropout")
+    {
+        setAlias(output, node.inputs[0]);
+    }
+    else if (type == "Unsqueeze" || type == "Squeeze" || type == "Flatten" || type == "Reshape")
+    {
+        MatShape outShape;
+        if (type == "Unsqueeze" || type == "Squeeze")
+            outShape = squeezeShape(inpShape, getSqueezeAxes(node, layerParams, inpShape), type == "Unsqueeze");
+        else if (type == "Flatten")
+        {
+            int axis = layerParams.get<int>("axis", 1);
+            outShape = shape(total(inpShape, 0, axis), total(inpShape, axis));
+        }
+        else
+            outShape = reshapeShape(inpShape, getInts(node, layerParams, 1, "shape"));
+
+        std::vector<int> sizes(outShape);
+        if (sizes.size() < 2)
+            sizes.insert(sizes.begin(), 2 - sizes.size(), 1);
+        addConstant(output, inp.reshape(1, (int)sizes.size(), &sizes[0]), outShape);
+        // Order of values is kept.
+        if (getBatchPositions(node.inputs[0]))
+            batchPositions[output] = batchPositions[node.inputs[0]];
+    }
+    else if (type == "Gather")
+    {
+        CV_Assert(layerParams.get<int>("axis", 0) == 0, inpShape.size() == 1);
+        std::vector<int> data = getIntValues(inp);
+        std::vector<int> indices = getIntValues(getBlob(node, 1));
+        const std::vector<int>* inpBatch = getBatchPositions(node.inputs[0]);
+        std::vector<int> outBatch;
+        Mat values(1, (int)indices.size(), CV_32S);
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            int idx = indices[i] < 0 ? indices[i] + (int)data.size() : indices[i];
+            CV_Assert(0 <= idx && idx < (int)data.size());
+            values.at<int>(i) = data[idx];
+            if (inpBatch && std::find(inpBatch->begin(), inpBatch->end(), idx) != inpBatch->end())
+                outBatch.push_back((int)i);
+        }
+        if (!outBatch.empty())
+            batchPositions[output] = outBatch;
+        MatShape outShape = outShapes[node.inputs[1]];
+        addConstant(output, values, outShape);
+    }
+    else if (type == "Concat")
+    {
+        // Concatenation of shapes.
+        std::vector<int> values, outBatch;
+        for (size_t i = 0; i < node.inputs.size(); ++i)
+        {
+            CV_Assert(outShapes[node.inputs[i]].size() <= 1);
+            std::vector<int> part = getIntValues(constBlobs[node.inputs[i]]);
+            const std::vector<int>* inpBatch = getBatchPositions(node.inputs[i]);
+            for (size_t j = 0; inpBatch && j < inpBatch->size(); ++j)
+                outBatch.push_back((int)values.size() + (*inpBatch)[j]);
+            values.insert(values.end(), part.begin(), part.end());
+        }
+        addConstant(output, Mat(values, true).reshape(1, 1), shape((int)values.size()));
+        if (!outBatch.empty())
+            batchPositions[output] = outBatch;
+    }
+    else
+        return false;
+    return true;
+}
+
+void ONNXImporter::handleNode(const NodeProto& node, Net& dstNet)
+{
+    CV_Assert(!node.outputs.empty());
+    LayerParams layerParams = getLayerParams(node);
+    if (foldConstants(node, layerParams))
+        return;
+
+    const std::string& type = node.opType;
+    // Non-constant inputs of the layer in order of connection.
+    std::vector<std::string> inputs;
+    for (size_t i = 0; i < node.inputs.size(); ++i)
+    {
+        if (!node.inputs[i].empty() && !isConst(node.inputs[i]))
+            inputs.push_back(node.inputs[i]);
+    }
+    const std::string& inpName = node.inputs[0];
+    MatShape inpShape = hasShape(inpName) ? outShapes[inpName] : MatShape();
+
+    if (type == "Conv" || type == "ConvTranspose")
+    {
+        const Mat& weights = getBlob(node, 1);
+        CV_Assert(weights.dims == 4);
+        layerParams.blobs.push_back(weights);
+        if (node.inputs.size() > 2)
+            layerParams.blobs.push_back(getBlob(node, 2));
+        layerParams.set("bias_term", node.inputs.size() > 2);
+        if (!layerParams.has("kernel_h"))
+        {
+            layerParams.set("kernel_h", weights.size[2]);
+            layerParams.set("kernel_w", weights.size[3]);
+        }
+        int group = layerParams.get<int>("group", 1);
+        if (type == "Conv")
+        {
+            layerParams.type = "Convolution";
+            layerParams.set("num_output", weights.size[0]);
+        }
+        else
+        {
+            layerParams.type = "Deconvolution";
+            layerParams.set("num_output", weights.size[1] * group);
+            if (layerParams.has("output_shape"))
+                CV_Error(Error::StsNotImplemented, "Attribute output_shape of ConvTranspose is not supported");
+            if (layerParams.has("output_padding"))
+            {
+                DictValue adj = layerParams.get("output_padding");
+                layerParams.set("adj_h", adj.get<int>(0));
+                layerParams.set("adj_w", adj.get<int>(1));
+            }
+        }
+    }
+    else if (type == "MaxPool" || type == "AveragePool")
+    {
+        layerParams.type = "Pooling";
+        layerParams.set("pool", type == "MaxPool" ? "max" : "ave");
+        layerParams.set("ceil_mode", layerParams.get<int>("ceil_mode", 0) != 0);
+        // Average pooling of the default backend includes padded area.
+        if (type == "AveragePool" && layerParams.get<int>("pad_h", 0) + layerParams.get<int>("pad_w", 0) != 0 &&
+            layerParams.get<int>("count_include_pad", 0) == 0)
+        {
+            CV_Error(Error::StsNotImplemented, "AveragePool with paddings is supported only with count_include_pad=1");
+        }
+    }
+    else if (type == "GlobalAveragePool" || type == "GlobalMaxPool")
+    {
+        layerParams.type = "Pooling";
+        layerParams.set("pool", type == "GlobalMaxPool" ? "max" : "ave");
+        layerParams.set("global_pooling", true);
+    }
+    else if (type == "Relu" || type == "LeakyRelu")
+    {
+        layerParams.type = "ReLU";
+        if (type == "LeakyRelu")
+            layerParams.set("negative_slope", layerParams.get<float>("alpha", 0.01f));
+    }
+    else if (type == "PRelu")
+    {
+        const Mat& slope = getBlob(node, 1);
+        if (slope.total() == 1)
+        {
+            layerParams.type = "ReLU";
+            layerParams.set("negative_slope", slope.at<float>(0));
+        }
+        else
+        {
+            layerParams.type = "ChannelsPReLU";
+            layerParams.blobs.push_back(slope.reshape(1, 1));
+        }
+    }
+    else if (type == "Clip")
+    {
+        layerParams.type = "ReLU6";
+        float minValue = layerParams.get<float>("min", -FLT_MAX);
+        float maxValue = layerParams.get<float>("max", FLT_MAX);
+        if (node.inputs.size() > 1 && !node.inputs[1].empty())
+            minValue = getBlob(node, 1).at<float>(0);
+        if (node.inputs.size() > 2 && !node.inputs[2].empty())
+            maxValue = getBlob(node, 2).at<float>(0);
+        layerParams.set("min_value", minValue);
+        layerParams.set("max_value", maxValue);
+    }
+    else if (type == "Sigmoid" || type == "Tanh" || type == "Abs" || type == "Softplus" || type == "Elu")
+    {
+        layerParams.type = type == "Tanh" ? "TanH" : type == "Abs" ? "AbsVal" :
+                           type == "Softplus" ? "BNLL" : type == "Elu" ? "ELU" : type;
+        if (type == "Elu" && layerParams.get<float>("alpha", 1.f) != 1.f)
+            CV_Error(Error::StsNotImplemented, "Elu is supported only with alpha=1");
+    }
+    else if (type == "Neg" || type == "Sqrt")
+    {
+        layerParams.type = "Power";
+        layerParams.set(type == "Neg" ? "scale" : "power", type == "Neg" ? -1.f : 0.5f);
+    }
+    else if (type == "BatchNormalization")
+    {
+        layerParams.type = "BatchNorm";
+        layerParams.blobs.push_back(getBlob(node, 3));  // mean
+        layerParams.blobs.push_back(getBlob(node, 4));  // variance
+        layerParams.blobs.push_back(getBlob(node, 1));  // scale
+        layerParams.blobs.push_back(getBlob(node, 2));  // shift
+        layerParams.set("has_weight", true);
+        layerParams.set("has_bias", true);
+        layerParams.set("eps", layerParams.get<float>("epsilon", 1e-5f));
+        inputs.resize(1);
+    }
+    else if (type == "Gemm" || type == "MatMul")
+    {
+        if (layerParams.get<int>("transA", 0) != 0)
+            CV_Error(Error::StsNotImplemented, "Gemm with transposed first input is not supported");
+        const Mat& B = getBlob(node, 1);
+        CV_Assert(B.dims == 2);
+        // Weights of InnerProduct layer are stored as (num_output x K) matrix.
+        Mat weights;
+        if (layerParams.get<int>("transB", 0) == 0)
+            transpose(B, weights);
+        else
+            B.copyTo(weights);
+        float alpha = layerParams.get<float>("alpha", 1.f);
+        if (alpha != 1.f)
+            weights *= alpha;
+        layerParams.blobs.push_back(weights);
+
+        bool hasBias = type == "Gemm" && node.inputs.size() > 2;
+        if (hasBias)
+        {
+            Mat bias = getBlob(node, 2).reshape(1, 1) * layerParams.get<float>("beta", 1.f);
+            if (bias.total() == 1)
+                bias = Mat(1, weights.rows, CV_32F, Scalar(bias.at<float>(0)));
+            CV_Assert(bias.total() == (size_t)weights.rows);
+            layerParams.blobs.push_back(bias);
+        }
+        layerParams.type = "InnerProduct";
+        layerParams.set("num_output", weights.rows);
+        layerParams.set("bias_term", hasBias);
+        if (type == "MatMul" && inpShape.size() > 2)
+            layerParams.set("axis", (int)inpShape.size() - 1);
+    }
+    else if (type == "Add" || type == "Sum" || type == "Sub" || type == "Mul" || type == "Div" || type == "Max")
+    {
+        if (inputs.size() > 1 || type == "Max")
+        {
+            CV_Assert(inputs.size() == node.inputs.size());
+            layerParams.type = "Eltwise";
+            if (type == "Mul")
+                layerParams.set("operation", "prod");
+            else if (type == "Max")
+                layerParams.set("operation", "max");
+            else if (type == "Sub")
+            {
+                CV_Assert(inputs.size() == 2);
+                static const float coeffs[] = {1.f, -1.f};
+                layerParams.set("coeff", DictValue::arrayReal(coeffs, 2));
+            }
+            else if (type == "Div")
+                CV_Error(Error::StsNotImplemented, "Division of non-constant tensors is not supported");
+        }
+        else
+        {
+            CV_Assert(node.inputs.size() == 2 && inputs.size() == 1);
+            bool constFirst = isConst(node.inputs[0]);
+            if (constFirst && (type == "Sub" || type == "Div"))
+                CV_Error(Error::StsNotImplemented, "Subtraction or division from a constant is not supported");
+            Mat blob = constBlobs[node.inputs[constFirst ? 0 : 1]].reshape(1, 1).clone();
+            if (type == "Sub")
+                blob *= -1.f;
+            else if (type == "Div")
+                divide(1.f, blob, blob);
+            bool isScale = type == "Mul" || type == "Div";
+            if (blob.total() == 1)
+            {
+                layerParams.type = "Power";
+                layerParams.set(isScale ? "scale" : "shift", blob.at<float>(0));
+            }
+            else
+            {
+                // Channel-wise operations are handled by Scale layer which can be fused.
+                if (inpShape.size() > 1 && blob.total() != (size_t)inpShape[1])
+                    CV_Error(Error::StsNotImplemented, "Only channel-wise broadcasting of constants is supported, node: " + layerParams.name);
+                layerParams.type = "Scale";
+                if (isScale)
+                    layerParams.blobs.push_back(blob);
+                else
+                {
+                    layerParams.blobs.push_back(Mat::ones(1, (int)blob.total(), CV_32F));
+                    layerParams.blobs.push_back(blob);
+                    layerParams.set("bias_term", true);
+                }
+            }
+        }
+    }
+    else if (type == "Concat")
+    {
+        layerParams.set("axis", layerParams.get<int>("axis", 1));
+        CV_Assert(inputs.size() == node.inputs.size());
+    }
+    else if (type == "Softmax" || type == "LogSoftmax")
+    {
+        layerParams.type = "Softmax";
+        layerParams.set("log_softmax", type == "LogSoftmax");
+        layerParams.set("axis", layerParams.get<int>("axis", 1));
+    }
+    else if (type == "Flatten" || type == "Reshape" || type == "Unsqueeze" || type == "Squeeze")
+    {
+        std::vector<int> dims;
+        if (type == "Flatten")
+        {
+            if (layerParams.get<int>("axis", 1) != 1)
+                CV_Error(Error::StsNotImplemented, "Flatten is supported only with axis=1");
+            dims.push_back(0);
+            dims.push_back(-1);
+        }
+        else if (type == "Reshape")
+        {
+            dims = getInts(node, layerParams, 1, "shape");
+            // Batch size which was computed from a shape is inferred or copied from the input.
+            const std::vector<int>* batch = node.inputs.size() > 1 ? getBatchPositions(node.inputs[1]) : 0;
+            for (size_t i = 0; batch && i < batch->size(); ++i)
+            {
+                int pos = (*batch)[i];
+                if (std::find(dims.begin(), dims.end(), -1) == dims.end())
+                    dims[pos] = -1;
+                else if (pos == 0)
+                    dims[pos] = 0;
+            }
+            // Shapes from constants copy batch size of the input if it's the same.
+            if (!inpShape.empty() && !dims.empty() && dims[0] == inpShape[0])
+                dims[0] = 0;
+        }
+        else
+        {
+            if (inpShape.empty())
+                CV_Error(Error::StsNotImplemented, type + " requires known shape of the input");
+            std::vector<int> axes = getSqueezeAxes(node, layerParams, inpShape);
+            dims = squeezeShape(inpShape, axes, type == "Unsqueeze");
+            if (std::find(axes.begin(), axes.end(), 0) == axes.end())
+                dims[0] = 0;
+        }
+
+        MatShape outShape = inpShape.empty() ? MatShape() : reshapeShape(inpShape, dims);
+        bool isFlatten = dims.size() == 2 && dims[0] == 0 &&
+                         (dims[1] == -1 || (!inpShape.empty() && dims[1] == total(inpShape, 1)));
+        // Fully connected layers flatten inputs themselves.
+        if ((isFlatten && onlyConsumedByFullyConnected(node.outputs[0])) ||
+            (!inpShape.empty() && outShape == inpShape))
+        {
+            setAlias(node.outputs[0], inpName);
+            if (!outShape.empty())
+                outShapes[node.outputs[0]] = outShape;
+            return;
+        }
+        layerParams.type = "Reshape";
+        layerParams.set("dim", DictValue::arrayInt(&dims[0], (int)dims.size()));
+    }
+    else if (type == "Transpose")
+    {
+        DictValue perm = layerParams.get("perm");
+        bool identity = true;
+        for (int i = 0; i < perm.size(); ++i)
+            identity = identity && perm.get<int>(i) == i;
+        if (identity)
+        {
+            setAlias(node.outputs[0], inpName);
+            return;
+        }
+        layerParams.type = "Permute";
+        layerParams.set("order", perm);
+    }
+    else if (type == "Identity" || type == "Dropout" || type == "Cast")
+    {
+        // Cast is skipped as the network is computed in floating point.
+        setAlias(node.outputs[0], inpName);
+        return;
+    }
+    else if (type == "LRN")
+    {
+        layerParams.set("local_size", layerParams.get<int>("size"));
+    }
+    else if (type == "Pad")
+    {
+        std::vector<int> pads = getInts(node, layerParams, 1, "pads");
+        if (node.inputs.size() > 2 && !node.inputs[2].empty())
+            layerParams.set("value", getBlob(node, 2).at<float>(0));
+        // [x1_begin, x2_begin, ..., x1_end, x2_end, ...] -> [x1_begin, x1_end, x2_begin, x2_end, ...]
+        int numDims = (int)pads.size() / 2;
+        std::vector<int> paddings(pads.size());
+        for (int i = 0; i < numDims; ++i)
+        {
+            paddings[i * 2] = pads[i];
+            paddings[i * 2 + 1] = pads[i + numDims];
+        }
+        layerParams.type = "Padding";
+        layerParams.set("paddings", DictValue::arrayInt(&paddings[0], (int)paddings.size()));
+        String mode = layerParams.get<String>("mode", "constant");
+        if (mode != "constant" && mode != "reflect")
+            CV_Error(Error::StsNotImplemented, "Unsupported padding mode " + mode);
+        layerParams.set("type", mode);
+    }
+    else if (type == "Upsample" || type == "Resize")
+    {
+        if (layerParams.get<String>("mode", "nearest") != "nearest")
+            CV_Error(Error::StsNotImplemented, type + " is supported only in nearest mode");
+        if (inpShape.size() != 4)
+            CV_Error(Error::StsNotImplemented, type + " requires known shape of the input");
+        int outH = 0, outW = 0;
+        if (layerParams.has("scales"))
+        {
+            DictValue scales = layerParams.get("scales");
+            outH = cvRound(inpShape[2] * scales.get<float>(2));
+            outW = cvRound(inpShape[3] * scales.get<float>(3));
+        }
+        else
+        {
+            // Scales are the last non-empty input, sizes are given by the 4th one.
+            Mat scales;
+            for (size_t i = 1; i < node.inputs.size(); ++i)
+            {
+                if (!node.inputs[i].empty() && outShapes[node.inputs[i]] == shape(4))
+                    scales = getBlob(node, (int)i);
+            }
+            CV_Assert(!scales.empty());
+            if (node.inputs.size() > 3 && !node.inputs[3].empty())
+            {
+                std::vector<int> sizes = getIntValues(scales);
+                outH = sizes[2];
+                outW = sizes[3];
+            }
+            else
+            {
+                outH = cvRound(inpShape[2] * scales.at<float>(2));
+                outW = cvRound(inpShape[3] * scales.at<float>(3));
+            }
+        }
+        layerParams.type = "ResizeNearestNeighbor";
+        layerParams.set("height", outH);
+        layerParams.set("width", outW);
+    }
+    else
+    {
+        CV_Error_(Error::StsNotImplemented, ("Unsupported ONNX operator %s (node \"%s\")",
+                                             type.c_str(), layerParams.name.c_str()));
+    }
+    addLayer(dstNet, layerParams, node, inputs);
+}
+
+void ONNXImporter::populateNet(Net dstNet)
+{
+    CV_TRACE_FUNCTION();
+
+    for (size_t i = 0; i < graph.initializers.size(); ++i)
+    {
+        const TensorProto& tensor = graph.initializers[i];
+        addConstant(tensor.name, getMatFromTensor(tensor), MatShape(tensor.dims.begin(), tensor.dims.end()));
+    }
+
+    // Old models list initializers as inputs too.
+    std::vector<String> netInputs;
+    for (size_t i = 0; i < graph.inputs.size(); ++i)
+    {
+        const ValueInfoProto& input = graph.inputs[i];
+        if (isConst(input.name))
+            continue;
+        layerIds[input.name] = LayerInfo(0, (int)netInputs.size());
+        netInputs.push_back(input.name);
+        if (input.hasShape)
+        {
+            // Symbolic dimensions (i.e. batch size) are set to 1.
+            MatShape inpShape(input.dims.begin(), input.dims.end());
+            for (size_t j = 0; j < inpShape.size(); ++j)
+                inpShape[j] = std::max(inpShape[j], 1);
+            outShapes[input.name] = inpShape;
+        }
+    }
+    dstNet.setInputsNames(netInputs);
+
+    for (size_t i = 0; i < graph.nodes.size(); ++i)
+    {
+        const NodeProto& node = graph.nodes[i];
+        for (size_t j = 0; j < node.inputs.size(); ++j)
+            consumers[node.inputs[j]].push_back(node.opType);
+    }
+
+    for (size_t i = 0; i < graph.nodes.size(); ++i)
+    {
+        handleNode(graph.nodes[i], dstNet);
+    }
+}
+
+} // namespace
+
+Net readNetFromONNX(const String& onnxFile)
+{
+    ONNXImporter importer(onnxFile.c_str());
+    Net net;
+    importer.populateNet(net);
+    return net;
+}
+
+Net readNetFromONNX(const char* buffer, size_t sizeBuffer)
+{
+    ONNXImporter importer(buffer, sizeBuffer);
+    Net net;
+    importer.populateNet(net);
+    return net;
+}
+
+CV__DNN_EXPERIMENTAL_NS_END
+}} // namespace
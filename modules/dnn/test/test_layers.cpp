@@ -490,6 +490,64 @@ TEST(Layer_LSTM_Test_Accuracy_with_, CaffeRecurrent)
     normAssert(h_t_reference, outputs[0]);
 }
 
+static float sigmoidRef(float x) { return 1.f / (1.f + std::exp(-x)); }
+
+TEST(Layer_LSTM_Test_Accuracy_with_, Reference)
+{
+    const int numTimeStamps = 5, numSamples = 3, numInp = 13, numOut = 37;
+    const float forgetBias = 0.5f, cellClip = 0.8f;
+
+    Mat Wh(4 * numOut, numOut, CV_32F), Wx(4 * numOut, numInp, CV_32F), b(1, 4 * numOut, CV_32F);
+    randu(Wh, -0.5f, 0.5f);
+    randu(Wx, -0.5f, 0.5f);
+    randu(b, -0.5f, 0.5f);
+
+    LayerParams lp;
+    lp.blobs.push_back(Wh);
+    lp.blobs.push_back(Wx);
+    lp.blobs.push_back(b);
+    lp.set("produce_cell_output", true);
+    lp.set("forget_bias", forgetBias);
+    lp.set("use_cell_clip", true);
+    lp.set("cell_clip", cellClip);
+    Ptr<LSTMLayer> layer = LSTMLayer::create(lp);
+
+    int inpShape[] = {numTimeStamps, numSamples, numInp};
+    Mat inp(3, inpShape, CV_32F);
+    randu(inp, -1.0f, 1.0f);
+    std::vector<Mat> inputs(1, inp), outputs;
+    runLayer(layer, inputs, outputs);
+    ASSERT_EQ(outputs.size(), (size_t)2);
+
+    int outShape[] = {numTimeStamps, numSamples, numOut};
+    Mat hRef(3, outShape, CV_32F), cRef(3, outShape, CV_32F);
+    Mat h = Mat::zeros(numSamples, numOut, CV_32F), c = h.clone();
+    Mat x = inp.reshape(1, numTimeStamps * numSamples);
+    for (int t = 0; t < numTimeStamps; ++t)
+    {
+        Mat gates = x.rowRange(t * numSamples, (t + 1) * numSamples) * Wx.t() +
+                    h * Wh.t() + repeat(b, numSamples, 1);
+        for (int s = 0; s < numSamples; ++s)
+        {
+            const float* g = gates.ptr<float>(s);
+            for (int j = 0; j < numOut; ++j)
+            {
+                float gi = sigmoidRef(g[j]);
+                float gf = sigmoidRef(g[numOut + j] + forgetBias);
+                float go = sigmoidRef(g[2 * numOut + j]);
+                float gg = std::tanh(g[3 * numOut + j]);
+                float cv = std::min(std::max(gf * c.at<float>(s, j) + gi * gg, -cellClip), cellClip);
+                c.at<float>(s, j) = cv;
+                h.at<float>(s, j) = go * std::tanh(cv);
+            }
+        }
+        h.copyTo(hRef.reshape(1, numTimeStamps * numSamples).rowRange(t * numSamples, (t + 1) * numSamples));
+        c.copyTo(cRef.reshape(1, numTimeStamps * numSamples).rowRange(t * numSamples, (t + 1) * numSamples));
+    }
+    normAssert(hRef, outputs[0], "h", 1e-5, 1e-4);
+    normAssert(cRef, outputs[1], "c", 1e-5, 1e-4);
+}
+
 TEST(Layer_RNN_Test_Accuracy_with_, CaffeRecurrent)
 {
     Ptr<RNNLayer> layer = RNNLayer::create(LayerParams());
@@ -806,4 +864,1012 @@ INSTANTIATE_TEST_CASE_P(Layer_Test, Crop, Combine(
 /*offset value*/        Values(3, 4)
 ));
 
+// Compare an 8-bit quantized network with the floating point one.
+typedef testing::TestWithParam<bool> Quantize;
+TEST_P(Quantize, Accuracy)
+{
+    bool calibrate = GetParam();
+    Net net;
+    {
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("pad", 1);
+        lp.set("num_output", 16);
+        lp.type = "Convolution";
+        lp.name = "testConv1";
+
+        int weightsShape[] = {16, 3, 3, 3};
+        Mat weights(4, weightsShape, CV_32F), bias(1, 16, CV_32F);
+        randu(weights, -1.0f, 1.0f);
+        randu(bias, -1.0f, 1.0f);
+        lp.blobs.push_back(weights);
+        lp.blobs.push_back(bias);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+    {
+        LayerParams lp;
+        lp.type = "ReLU";
+        lp.name = "testReLU";
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+    {
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("stride", 2);
+        lp.set("group", 2);
+        lp.set("num_output", 8);
+        lp.set("bias_term", false);
+        lp.type = "Convolution";
+        lp.name = "testConv2";
+
+        int weightsShape[] = {8, 8, 3, 3};
+        Mat weights(4, weightsShape, CV_32F);
+        randu(weights, -1.0f, 1.0f);
+        lp.blobs.push_back(weights);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+    {
+        LayerParams lp;
+        lp.set("num_output", 10);
+        lp.type = "InnerProduct";
+        lp.name = "testFC";
+
+        Mat weights(10, 8*4*5, CV_32F), bias(1, 10, CV_32F);
+        randu(weights, -1.0f, 1.0f);
+        randu(bias, -1.0f, 1.0f);
+        lp.blobs.push_back(weights);
+        lp.blobs.push_back(bias);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+
+    int inpShape[] = {2, 3, 10, 11};
+    Mat input(4, inpShape, CV_32F);
+    randu(input, 0.0f, 1.0f);
+
+    net.setInput(input);
+    Mat ref = net.forward().clone();
+    Mat refWeights = net.getParam(net.getLayerId("testFC")).clone();
+    size_t refWeightsSize = 0, weightsSize = 0, blobsSize = 0;
+    net.getMemoryConsumption(shape(input), refWeightsSize, blobsSize);
+
+    if (calibrate)
+        net.quantize(input);
+    else
+        net.quantize();
+
+    net.setInput(input);
+    Mat out = net.forward();
+
+    ASSERT_EQ(shape(ref), shape(out));
+    double refMax = cvtest::norm(ref, NORM_INF);
+    EXPECT_LE(cvtest::norm(out, ref, NORM_INF), 0.05 * refMax);
+    EXPECT_LE(cvtest::norm(out, ref, NORM_L1) / ref.total(), 0.01 * refMax);
+
+    // Floating point weights are released, biases are kept.
+    net.getMemoryConsumption(shape(input), weightsSize, blobsSize);
+    EXPECT_LT(weightsSize, refWeightsSize / 3);
+    Mat weights = net.getParam(net.getLayerId("testFC"));
+    ASSERT_EQ(weights.type(), CV_32F);
+    normAssert(weights, refWeights, "", 0.01, 0.01);
+}
+
+INSTANTIATE_TEST_CASE_P(Layer_Test, Quantize, testing::Bool());
+
+// 3x3 convolutions with enough channels are computed using Winograd algorithm.
+typedef testing::TestWithParam<tuple<Vec4i, int, int, bool> > Convolution_Winograd;
+TEST_P(Convolution_Winograd, Accuracy)
+{
+    Vec4i inpShapeVec = get<0>(GetParam());
+    int outCn = get<1>(GetParam());
+    int padding = get<2>(GetParam());
+    bool withReLU = get<3>(GetParam());
+    const int inpShape[] = {inpShapeVec[0], inpShapeVec[1], inpShapeVec[2], inpShapeVec[3]};
+    const int inpCn = inpShape[1], inpH = inpShape[2], inpW = inpShape[3];
+    const int outH = inpH + 2 * padding - 2, outW = inpW + 2 * padding - 2;
+    const float slope = 0.1f;
+
+    int weightsShape[] = {outCn, inpCn, 3, 3};
+    Mat weights(4, weightsShape, CV_32F), bias(1, outCn, CV_32F);
+    Mat input(4, inpShape, CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+    randu(input, -1.0f, 1.0f);
+
+    Net net;
+    {
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("pad", padding);
+        lp.set("num_output", outCn);
+        lp.type = "Convolution";
+        lp.name = "testConv";
+        lp.blobs.push_back(weights);
+        lp.blobs.push_back(bias);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+    if (withReLU)
+    {
+        LayerParams lp;
+        lp.set("negative_slope", slope);
+        lp.type = "ReLU";
+        lp.name = "testReLU";
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+    net.setInput(input);
+    Mat out = net.forward();
+
+    int outShape[] = {inpShape[0], outCn, outH, outW};
+    Mat ref(4, outShape, CV_32F);
+    for (int n = 0; n < inpShape[0]; ++n)
+    {
+        for (int oc = 0; oc < outCn; ++oc)
+        {
+            for (int y = 0; y < outH; ++y)
+            {
+                for (int x = 0; x < outW; ++x)
+                {
+                    float sum = bias.at<float>(oc);
+                    for (int ic = 0; ic < inpCn; ++ic)
+                    {
+                        for (int i = 0; i < 3; ++i)
+                        {
+                            for (int j = 0; j < 3; ++j)
+                            {
+                                int yi = y + i - padding, xj = x + j - padding;
+                                if (0 <= yi && yi < inpH && 0 <= xj && xj < inpW)
+                                {
+                                    int inpIdx[] = {n, ic, yi, xj};
+                                    int wIdx[] = {oc, ic, i, j};
+                                    sum += input.at<float>(inpIdx) * weights.at<float>(wIdx);
+                                }
+                            }
+                        }
+                    }
+                    int outIdx[] = {n, oc, y, x};
+                    ref.at<float>(outIdx) = withReLU && sum < 0 ? sum * slope : sum;
+                }
+            }
+        }
+    }
+    normAssert(out, ref, "", 1e-4, 1e-3);
+}
+
+INSTANTIATE_TEST_CASE_P(Layer_Test, Convolution_Winograd, Combine(
+/*input shape*/ Values(Vec4i(1, 8, 8, 8), Vec4i(2, 19, 13, 10)),
+/*num output*/  Values(16, 21),
+/*padding*/     Values(0, 1),
+/*ReLU*/        testing::Bool()
+));
+
+// Depthwise convolutions (group == channels) are computed by a direct kernel.
+typedef testing::TestWithParam<tuple<Vec4i, int, int, int, bool> > Convolution_Depthwise;
+TEST_P(Convolution_Depthwise, Accuracy)
+{
+    Vec4i inpShapeVec = get<0>(GetParam());
+    int kernelSize = get<1>(GetParam());
+    int stride = get<2>(GetParam());
+    int padding = get<3>(GetParam());
+    bool withReLU = get<4>(GetParam());
+    const int inpShape[] = {inpShapeVec[0], inpShapeVec[1], inpShapeVec[2], inpShapeVec[3]};
+    const int numCn = inpShape[1], inpH = inpShape[2], inpW = inpShape[3];
+    const int outH = (inpH + 2 * padding - kernelSize) / stride + 1;
+    const int outW = (inpW + 2 * padding - kernelSize) / stride + 1;
+    const float slope = 0.1f;
+
+    int weightsShape[] = {numCn, 1, kernelSize, kernelSize};
+    Mat weights(4, weightsShape, CV_32F), bias(1, numCn, CV_32F);
+    Mat input(4, inpShape, CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+    randu(input, -1.0f, 1.0f);
+
+    Net net;
+    {
+        LayerParams lp;
+        lp.set("kernel_size", kernelSize);
+        lp.set("stride", stride);
+        lp.set("pad", padding);
+        lp.set("num_output", numCn);
+        lp.set("group", numCn);
+        lp.type = "Convolution";
+        lp.name = "testConv";
+        lp.blobs.push_back(weights);
+        lp.blobs.push_back(bias);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+    if (withReLU)
+    {
+        LayerParams lp;
+        lp.set("negative_slope", slope);
+        lp.type = "ReLU";
+        lp.name = "testReLU";
+        net.addLayerToPrev(lp.name, lp.type, lp);
+    }
+    net.setInput(input);
+    Mat out = net.forward();
+
+    int outShape[] = {inpShape[0], numCn, outH, outW};
+    Mat ref(4, outShape, CV_32F);
+    for (int n = 0; n < inpShape[0]; ++n)
+    {
+        for (int c = 0; c < numCn; ++c)
+        {
+            for (int y = 0; y < outH; ++y)
+            {
+                for (int x = 0; x < outW; ++x)
+                {
+                    float sum = bias.at<float>(c);
+                    for (int i = 0; i < kernelSize; ++i)
+                    {
+                        for (int j = 0; j < kernelSize; ++j)
+                        {
+                            int yi = y * stride + i - padding, xj = x * stride + j - padding;
+                            if (0 <= yi && yi < inpH && 0 <= xj && xj < inpW)
+                            {
+                                int inpIdx[] = {n, c, yi, xj};
+                                int wIdx[] = {c, 0, i, j};
+                                sum += input.at<float>(inpIdx) * weights.at<float>(wIdx);
+                            }
+                        }
+                    }
+                    int outIdx[] = {n, c, y, x};
+                    ref.at<float>(outIdx) = withReLU && sum < 0 ? sum * slope : sum;
+                }
+            }
+        }
+    }
+    normAssert(out, ref, "", 1e-5, 1e-4);
+
+    // Half precision weights.
+    net.setPreferableTarget(DNN_TARGET_CPU_FP16);
+    out = net.forward();
+    double refMax = cvtest::norm(ref, NORM_INF);
+    normAssert(out, ref, "", 5e-3 * refMax, 2e-2 * refMax);
+}
+
+INSTANTIATE_TEST_CASE_P(Layer_Test, Convolution_Depthwise, Combine(
+/*input shape*/ Values(Vec4i(1, 8, 16, 16), Vec4i(2, 3, 19, 13), Vec4i(1, 1, 9, 30)),
+/*kernel size*/ Values(3, 5),
+/*stride*/      Values(1, 2),
+/*padding*/     Values(0, 1, 2),
+/*ReLU*/        testing::Bool()
+));
+
+static LayerParams convolutionParams(const String& name, int inpCn, int outCn)
+{
+    LayerParams lp;
+    lp.set("kernel_size", 3);
+    lp.set("pad", 1);
+    lp.set("num_output", outCn);
+    lp.type = "Convolution";
+    lp.name = name;
+
+    int weightsShape[] = {outCn, inpCn, 3, 3};
+    Mat weights(4, weightsShape, CV_32F), bias(1, outCn, CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+    lp.blobs.push_back(weights);
+    lp.blobs.push_back(bias);
+    return lp;
+}
+
+// Several asynchronous forward passes which are computed at the same time
+// produce the same outputs as synchronous ones.
+TEST(Net, forwardAsync)
+{
+    Net net;
+    LayerParams lp = convolutionParams("conv", 3, 8);
+    int convId = net.addLayerToPrev(lp.name, lp.type, lp);
+
+    lp = LayerParams();
+    lp.type = "ReLU";
+    lp.name = "relu";
+    int reluId = net.addLayerToPrev(lp.name, lp.type, lp);
+
+    lp = convolutionParams("branch1", 8, 4);
+    int branch1Id = net.addLayer(lp.name, lp.type, lp);
+    net.connect(reluId, 0, branch1Id, 0);
+
+    lp = convolutionParams("branch2", 8, 6);
+    int branch2Id = net.addLayer(lp.name, lp.type, lp);
+    net.connect(reluId, 0, branch2Id, 0);
+
+    lp = LayerParams();
+    lp.type = "Concat";
+    lp.name = "concat";
+    int concatId = net.addLayer(lp.name, lp.type, lp);
+    net.connect(branch1Id, 0, concatId, 0);
+    net.connect(branch2Id, 0, concatId, 1);
+    ASSERT_GT(convId, 0);
+
+    std::vector<String> outNames(2);
+    outNames[0] = "concat";
+    outNames[1] = "conv";
+
+    const int numRequests = 5;
+    int inpShape[] = {1, 3, 12, 9};
+    std::vector<Mat> inputs(numRequests), refs(numRequests), refsConv(numRequests);
+    for (int i = 0; i < numRequests; ++i)
+    {
+        inputs[i].create(4, inpShape, CV_32F);
+        randu(inputs[i], -1.0f, 1.0f);
+        net.setInput(inputs[i]);
+        std::vector<Mat> outs;
+        net.forward(outs, outNames);
+        refs[i] = outs[0].clone();
+        refsConv[i] = outs[1].clone();
+    }
+
+    for (int iter = 0; iter < 2; ++iter)
+    {
+        std::vector<AsyncResult> results(numRequests);
+        for (int i = 0; i < numRequests; ++i)
+        {
+            results[i] = net.forwardAsync(inputs[i], outNames);
+            ASSERT_TRUE(results[i].valid());
+        }
+        for (int i = numRequests - 1; i >= 0; --i)
+        {
+            ASSERT_TRUE(results[i].wait());
+            std::vector<Mat> outs;
+            results[i].get(outs);
+            ASSERT_EQ(outs.size(), (size_t)2);
+            normAssert(outs[0], refs[i]);
+            normAssert(outs[1], refsConv[i]);
+        }
+    }
+}
+
+// Intermediate blobs share memory if they are not used at the same time.
+// Results must be the same as if all the blobs are kept.
+TEST(Net, memoryReuse)
+{
+    Net net;
+    LayerParams lp = convolutionParams("conv1", 3, 8);
+    net.addLayerToPrev(lp.name, lp.type, lp);
+
+    lp = LayerParams();
+    lp.type = "ReLU";
+    lp.name = "relu1";
+    int relu1Id = net.addLayerToPrev(lp.name, lp.type, lp);
+
+    lp = convolutionParams("conv2", 8, 8);
+    int conv2Id = net.addLayer(lp.name, lp.type, lp);
+    net.connect(relu1Id, 0, conv2Id, 0);
+
+    lp = LayerParams();
+    lp.type = "TanH";
+    lp.name = "tanh";
+    int tanhId = net.addLayerToPrev(lp.name, lp.type, lp);
+
+    lp = convolutionParams("conv3", 8, 8);
+    int conv3Id = net.addLayer(lp.name, lp.type, lp);
+    net.connect(relu1Id, 0, conv3Id, 0);
+
+    lp = LayerParams();
+    lp.type = "Eltwise";
+    lp.name = "sum";
+    int sumId = net.addLayer(lp.name, lp.type, lp);
+    net.connect(tanhId, 0, sumId, 0);
+    net.connect(conv3Id, 0, sumId, 1);
+
+    lp = convolutionParams("conv4", 8, 4);
+    net.addLayerToPrev(lp.name, lp.type, lp);
+
+    lp = LayerParams();
+    lp.type = "Sigmoid";
+    lp.name = "sigmoid";
+    int sigmoidId = net.addLayerToPrev(lp.name, lp.type, lp);
+
+    lp = LayerParams();
+    lp.type = "Concat";
+    lp.name = "concat";
+    int concatId = net.addLayer(lp.name, lp.type, lp);
+    net.connect(sigmoidId, 0, concatId, 0);
+    net.connect(tanhId, 0, concatId, 1);
+
+    lp = convolutionParams("conv5", 12, 5);
+    net.addLayerToPrev(lp.name, lp.type, lp);
+
+    std::vector<String> names = net.getLayerNames();
+    for (int batch = 1; batch <= 2; ++batch)
+    {
+        int inpShape[] = {batch, 3, 10, 7};
+        Mat input(4, inpShape, CV_32F);
+        randu(input, -1.0f, 1.0f);
+
+        net.setInput(input);
+        std::vector<Mat> refs;
+        net.forward(refs, names);
+        Mat ref = refs.back().clone();
+
+        net.setInput(input);
+        Mat out = net.forward();
+        normAssert(out, ref);
+
+        // Blobs which don't live at the same time share memory.
+        size_t weights = 0, blobs = 0;
+        net.getMemoryConsumption(shape(input), weights, blobs);
+        size_t allocated = net.getAllocatedBlobsMemory();
+        EXPECT_GT(allocated, (size_t)0);
+        EXPECT_LT(allocated, blobs - input.total() * sizeof(float));
+    }
+}
+
+// Residual connections are fused into convolution and the layers which
+// don't change data (Split, Dropout, Reshape and Flatten) share memory
+// with their inputs. Results must be the same as without fusion.
+TEST(Net, fusion)
+{
+    const char* kernels[] = {"im2row", "winograd", "depthwise"};
+    for (int i = 0; i < 3; ++i)
+    {
+        const String kernel = kernels[i];
+        Net net;
+        LayerParams lp = convolutionParams("conv0", 3, 16);
+        net.addLayerToPrev(lp.name, lp.type, lp);
+
+        lp = LayerParams();
+        lp.set("top_count", 2);
+        int splitId = net.addLayerToPrev("split", "Split", lp);
+
+        if (kernel == "depthwise")
+        {
+            lp = convolutionParams("conv", 1, 16);
+            lp.set("group", 16);
+        }
+        else
+            lp = convolutionParams("conv", 16, 16);
+        if (kernel == "im2row")
+        {
+            lp.set("kernel_size", 1);
+            lp.set("pad", 0);
+            int weightsShape[] = {16, 16, 1, 1};
+            lp.blobs[0].create(4, weightsShape, CV_32F);
+            randu(lp.blobs[0], -1.0f, 1.0f);
+        }
+        int convId = net.addLayer(lp.name, lp.type, lp);
+        net.connect(splitId, 0, convId, 0);
+
+        lp = LayerParams();
+        int sumId = net.addLayer("sum", "Eltwise", lp);
+        net.connect(splitId, 1, sumId, 0);
+        net.connect(convId, 0, sumId, 1);
+
+        lp = LayerParams();
+        lp.set("negative_slope", 0.1f);
+        net.addLayerToPrev("relu", "ReLU", lp);
+
+        lp = LayerParams();
+        net.addLayerToPrev("dropout", "Dropout", lp);
+
+        lp = LayerParams();
+        int newShape[] = {1, 16, 10, 4};
+        lp.set("dim", DictValue::arrayInt(&newShape[0], 4));
+        net.addLayerToPrev("reshape", "Reshape", lp);
+
+        lp = LayerParams();
+        net.addLayerToPrev("flatten", "Flatten", lp);
+
+        int inpShape[] = {1, 3, 5, 8};
+        Mat input(4, inpShape, CV_32F);
+        randu(input, -1.0f, 1.0f);
+
+        net.enableFusion(false);
+        net.setInput(input);
+        Mat ref = net.forward().clone();
+
+        net.enableFusion(true);
+        net.enableProfiling(true);
+        net.setInput(input);
+        Mat out = net.forward();
+        normAssert(out, ref, kernel.c_str());
+
+        std::vector<LayerProfile> profile;
+        net.getProfile(profile);
+        ASSERT_EQ(profile.size(), (size_t)8);
+        EXPECT_EQ(profile[2].kernel, kernel);
+        EXPECT_EQ(profile[2].fusion, "fused with sum; fused with relu");
+        EXPECT_TRUE(profile[3].skipped);
+        EXPECT_TRUE(profile[4].skipped);
+    }
+}
+
+// Network which is loaded from the compiled file produces the same outputs.
+static Net compiledTestNet(LayerParams& convParams)
+{
+    Net net;
+    convParams = convolutionParams("conv", 3, 8);
+    net.addLayerToPrev(convParams.name, convParams.type, convParams);
+
+    LayerParams lp;
+    lp.set("bias_term", true);
+    lp.blobs.push_back(Mat(1, 8, CV_32F, Scalar(0.5)));
+    lp.blobs.push_back(Mat(1, 8, CV_32F, Scalar(-1)));
+    int scaleId = net.addLayerToPrev("scale", "Scale", lp);
+
+    lp = LayerParams();
+    lp.set("pool", "max");
+    lp.set("kernel_size", 2);
+    lp.set("stride", 2);
+    net.addLayerToPrev("pool", "Pooling", lp);
+
+    // enough channels for Winograd algorithm
+    lp = convolutionParams("branch", 8, 16);
+    int branchId = net.addLayer(lp.name, lp.type, lp);
+    net.connect(scaleId, 0, branchId, 0);
+
+    lp = LayerParams();
+    lp.set("negative_slope", 0.2);
+    net.addLayerToPrev("relu", "ReLU", lp);
+
+    lp = LayerParams();
+    lp.set("num_output", 5);
+    lp.blobs.push_back(Mat(5, 16 * 6 * 7, CV_32F));
+    lp.blobs.push_back(Mat(1, 5, CV_32F));
+    randu(lp.blobs[0], -1.0f, 1.0f);
+    randu(lp.blobs[1], -1.0f, 1.0f);
+    net.addLayerToPrev("fc", "InnerProduct", lp);
+
+    std::vector<String> inputNames(1, "data");
+    net.setInputsNames(inputNames);
+    return net;
+}
+
+typedef testing::TestWithParam<int> Net_saveCompiled;
+TEST_P(Net_saveCompiled, Accuracy)
+{
+    enum { SAVE_FP32, SAVE_FP16, SAVE_INT8 };
+    int mode = GetParam();
+
+    LayerParams convParams;
+    Net net = compiledTestNet(convParams);
+
+    int inpShape[] = {1, 3, 6, 7};
+    Mat input(4, inpShape, CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    if (mode == SAVE_FP16)
+        net.setPreferableTarget(DNN_TARGET_CPU_FP16);
+    else if (mode == SAVE_INT8)
+        net.quantize(input);
+
+    std::vector<String> outNames(2);
+    outNames[0] = "pool";
+    outNames[1] = "fc";
+    std::vector<Mat> refs, outs;
+    net.setInput(input, "data");
+    net.forward(refs, outNames);
+
+    std::string path = cv::tempfile(".bin");
+    net.save(path);
+    Net compiled = readNetFromCompiled(path);
+    remove(path.c_str());
+    ASSERT_FALSE(compiled.empty());
+
+    // the scale layer is folded into the convolution
+    EXPECT_EQ(compiled.getLayerId("scale"), -1);
+    EXPECT_EQ(compiled.getLayerNames().size(), net.getLayerNames().size() - 1);
+    if (mode == SAVE_FP32)
+        normAssert(compiled.getParam(compiled.getLayerId("conv")), convParams.blobs[0] * 0.5, "folded weights");
+    else if (mode == SAVE_FP16)
+        normAssert(compiled.getParam(compiled.getLayerId("conv")), convParams.blobs[0] * 0.5, "folded weights",
+                   1e-4, 1e-3);
+
+    compiled.setInput(input, "data");
+    compiled.forward(outs, outNames);
+    ASSERT_EQ(outs.size(), (size_t)2);
+    normAssert(outs[0], refs[0], "pool", 0, 0);
+    normAssert(outs[1], refs[1], "fc", 0, 0);
+}
+INSTANTIATE_TEST_CASE_P(/**/, Net_saveCompiled, Values(0, 1, 2));
+
+TEST(Net, saveCompiledTruncated)
+{
+    LayerParams convParams;
+    Net net = compiledTestNet(convParams);
+    int inpShape[] = {1, 3, 6, 7};
+    net.setInput(Mat(4, inpShape, CV_32F, Scalar(1)), "data");
+
+    std::string path = cv::tempfile(".bin");
+    net.save(path);
+    std::vector<char> data;
+    {
+        std::ifstream ifs(path.c_str(), std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    ASSERT_GT(data.size(), (size_t)0);
+    {
+        std::ofstream ofs(path.c_str(), std::ios::binary);
+        ofs.write(&data[0], data.size() / 2);
+    }
+    EXPECT_ANY_THROW(readNetFromCompiled(path));
+
+    // corrupted counts of the input names (after the magic, version and target)
+    // and of the layers (after the length and the characters of the input name "data")
+    const size_t countOffsets[] = {16, 28};
+    const int badCounts[] = {-1, 1 << 24, INT_MAX};
+    for (int i = 0; i < 2; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            std::vector<char> corrupted = data;
+            memcpy(&corrupted[countOffsets[i]], &badCounts[j], sizeof(int));
+            {
+                std::ofstream ofs(path.c_str(), std::ios::binary);
+                ofs.write(&corrupted[0], corrupted.size());
+            }
+            EXPECT_THROW(readNetFromCompiled(path), cv::Exception) << "offset " << countOffsets[i]
+                                                                   << " count " << badCounts[j];
+        }
+    }
+    remove(path.c_str());
+}
+
+class ForwardInvoker : public ParallelLoopBody
+{
+public:
+    ForwardInvoker(std::vector<Net>& nets, const std::vector<Mat>& inputs,
+                   std::vector<Mat>& outs, int shift)
+        : nets_(nets), inputs_(inputs), outs_(outs), shift_(shift) {}
+
+    void operator()(const Range& r) const
+    {
+        for (int i = r.start; i < r.end; ++i)
+        {
+            nets_[i].setInput(inputs_[(i + shift_) % inputs_.size()]);
+            outs_[i] = nets_[i].forward().clone();
+        }
+    }
+
+private:
+    std::vector<Net>& nets_;
+    const std::vector<Mat>& inputs_;
+    std::vector<Mat>& outs_;
+    int shift_;
+};
+
+// Cloned network shares weights and produces the same outputs.
+TEST(Net, clone)
+{
+    Net net;
+    LayerParams lp = convolutionParams("conv", 3, 8);
+    net.addLayerToPrev(lp.name, lp.type, lp);
+
+    lp = LayerParams();
+    net.addLayerToPrev("relu", "ReLU", lp);
+
+    lp = LayerParams();
+    lp.set("num_output", 5);
+    lp.blobs.push_back(Mat(5, 8 * 6 * 7, CV_32F));
+    lp.blobs.push_back(Mat(1, 5, CV_32F));
+    randu(lp.blobs[0], -1.0f, 1.0f);
+    randu(lp.blobs[1], -1.0f, 1.0f);
+    net.addLayerToPrev("fc", "InnerProduct", lp);
+
+    const int numNets = 3;
+    std::vector<Mat> inputs(numNets), refs(numNets);
+    for (int i = 0; i < numNets; ++i)
+    {
+        int inpShape[] = {1 + i % 2, 3, 6, 7};
+        inputs[i].create(4, inpShape, CV_32F);
+        randu(inputs[i], -1.0f, 1.0f);
+    }
+
+    // the first clone is made before allocation
+    std::vector<Net> nets(1, net.clone());
+    for (int i = 0; i < numNets; ++i)
+    {
+        net.setInput(inputs[i]);
+        refs[i] = net.forward().clone();
+    }
+    net.setInput(inputs[0]);
+    net.forward();
+    for (int i = 1; i < numNets; ++i)
+        nets.push_back(net.clone());
+
+    // inputs of different shapes reconfigure the clones
+    for (int iter = 0; iter < 2; ++iter)
+    {
+        std::vector<Mat> outs(numNets);
+        parallel_for_(Range(0, numNets), ForwardInvoker(nets, inputs, outs, iter), numNets);
+        for (int i = 0; i < numNets; ++i)
+        {
+            normAssert(outs[i], refs[(i + iter) % numNets]);
+            EXPECT_EQ(nets[i].getParam("conv").data, net.getParam("conv").data);
+            EXPECT_EQ(nets[i].getParam("fc").data, net.getParam("fc").data);
+        }
+    }
+    net.setInput(inputs[1]);
+    normAssert(net.forward(), refs[1]);
+}
+
+// Layers which are created again for a reconfigured clone keep the weights
+// set by setParam() and the quantization, and share the prepared weights.
+TEST(Net, cloneKeepsLayersState)
+{
+    enum { MODE_FP32, MODE_INT8, MODE_FP16 };
+    for (int mode = MODE_FP32; mode <= MODE_FP16; ++mode)
+    {
+        Net net;
+        LayerParams convParams = convolutionParams("conv", 3, 8);
+        int convId = net.addLayerToPrev(convParams.name, convParams.type, convParams);
+
+        LayerParams lp;
+        net.addLayerToPrev("relu", "ReLU", lp);
+
+        lp.set("num_output", 5);
+        lp.blobs.push_back(Mat(5, 8 * 6 * 7, CV_32F));
+        lp.blobs.push_back(Mat(1, 5, CV_32F));
+        randu(lp.blobs[0], -1.0f, 1.0f);
+        randu(lp.blobs[1], -1.0f, 1.0f);
+        net.addLayerToPrev("fc", "InnerProduct", lp);
+
+        std::vector<Mat> inputs(2);
+        for (int i = 0; i < 2; ++i)
+        {
+            int inpShape[] = {1 + i, 3, 6, 7};
+            inputs[i].create(4, inpShape, CV_32F);
+            randu(inputs[i], -1.0f, 1.0f);
+        }
+
+        Mat weights(4, convParams.blobs[0].size.p, CV_32F);
+        randu(weights, -1.0f, 1.0f);
+        net.setParam(convId, 0, weights);
+        if (mode == MODE_INT8)
+            net.quantize(inputs[0]);
+        else if (mode == MODE_FP16)
+            net.setPreferableTarget(DNN_TARGET_CPU_FP16);
+
+        net.setInput(inputs[1]);
+        Mat ref = net.forward().clone();
+
+        for (int allocated = 0; allocated < 2; ++allocated)
+        {
+            net.setInput(inputs[0]);
+            if (allocated)
+                net.forward();
+            Net clone = net.clone();
+
+            clone.setInput(inputs[1]);
+            normAssert(clone.forward(), ref, "clone", 0, 0);
+            net.setInput(inputs[1]);
+            normAssert(net.forward(), ref, "net", 0, 0);
+
+            // 8-bit and half precision weights are blobs[0] of the layers
+            if (mode != MODE_FP32)
+            {
+                EXPECT_NE(clone.getLayer(convId), net.getLayer(convId));
+                EXPECT_EQ(clone.getLayer(convId)->blobs[0].data, net.getLayer(convId)->blobs[0].data);
+                EXPECT_EQ(clone.getLayer("fc")->blobs[0].data, net.getLayer("fc")->blobs[0].data);
+            }
+        }
+    }
+}
+
+// Switching between input shapes keeps the fused weights of convolutions.
+TEST(Net, dynamicInputShapes)
+{
+    LayerParams conv1 = convolutionParams("conv1", 8, 16), conv2 = convolutionParams("conv2", 16, 16);
+    LayerParams bn;
+    bn.set("has_weight", true);
+    bn.set("has_bias", true);
+    for (int i = 0; i < 5; ++i)
+    {
+        bn.blobs.push_back(Mat(1, 16, CV_32F));
+        randu(bn.blobs.back(), 0.5f, 1.5f);
+    }
+    bn.blobs[2] = Mat(1, 1, CV_32F, Scalar(1));
+
+    Net nets[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        nets[i].addLayerToPrev(conv1.name, conv1.type, conv1);
+        nets[i].addLayerToPrev("bn", "BatchNorm", bn);
+        LayerParams lp;
+        nets[i].addLayerToPrev("relu", "ReLU", lp);
+        nets[i].addLayerToPrev(conv2.name, conv2.type, conv2);
+    }
+    Net& net = nets[0];
+    Net& ref = nets[1];
+    ref.enableFusion(false);
+
+    int shapeA[] = {1, 8, 10, 12}, shapeB[] = {2, 8, 17, 9};
+    Mat inputA(4, shapeA, CV_32F), inputB(4, shapeB, CV_32F);
+    randu(inputA, -1.0f, 1.0f);
+    randu(inputB, -1.0f, 1.0f);
+    for (int iter = 0; iter < 4; ++iter)
+    {
+        const Mat& input = iter % 2 ? inputB : inputA;
+        net.setInput(input);
+        ref.setInput(input);
+        Mat out = net.forward();
+        normAssert(out, ref.forward(), format("iter %d", iter).c_str(), 1e-4, 1e-3);
+
+        // batch normalization is not fused if the convolution output is requested
+        if (iter == 2)
+        {
+            std::vector<String> outNames(2);
+            outNames[0] = "conv1";
+            outNames[1] = "conv2";
+            std::vector<Mat> outs, refs;
+            net.forward(outs, outNames);
+            ref.forward(refs, outNames);
+            normAssert(outs[0], refs[0], "conv1", 1e-4, 1e-3);
+            normAssert(outs[1], refs[1], "conv2", 1e-4, 1e-3);
+        }
+    }
+
+    // the blobs are bound to the same memory for the same input shapes again
+    net.setInput(inputA);
+    const uchar* outData = net.forward().data;
+    size_t allocated = net.getAllocatedBlobsMemory();
+    for (int iter = 0; iter < 2; ++iter)
+    {
+        net.setInput(inputB);
+        net.forward();
+        net.setInput(inputA);
+        ref.setInput(inputA);
+        Mat out = net.forward();
+        EXPECT_EQ(out.data, outData);
+        EXPECT_EQ(net.getAllocatedBlobsMemory(), allocated);
+        normAssert(out, ref.forward(), format("same shape %d", iter).c_str(), 1e-4, 1e-3);
+    }
+
+    // a variable resolution feed evicts old shapes from the cache,
+    // a previously seen resolution is handled again afterwards
+    for (int width = 5; width <= 25; width += 2)
+    {
+        int shapeC[] = {1, 8, 7, width};
+        Mat inputC(4, shapeC, CV_32F);
+        randu(inputC, -1.0f, 1.0f);
+        net.setInput(inputC);
+        ref.setInput(inputC);
+        Mat out = net.forward();
+        normAssert(out, ref.forward(), format("width %d", width).c_str(), 1e-4, 1e-3);
+    }
+    net.setInput(inputA);
+    ref.setInput(inputA);
+    Mat out = net.forward();
+    normAssert(out, ref.forward(), "after eviction", 1e-4, 1e-3);
+}
+
+TEST(Net, profile)
+{
+    Net net;
+    LayerParams convParams = convolutionParams("conv", 3, 4);
+    int convId = net.addLayerToPrev(convParams.name, convParams.type, convParams);
+    {
+        LayerParams lp;
+        lp.set("bias_term", true);
+        lp.blobs.push_back(Mat(1, 4, CV_32F, Scalar(2)));
+        lp.blobs.push_back(Mat(1, 4, CV_32F, Scalar(1)));
+        net.addLayerToPrev("scale", "Scale", lp);
+    }
+    {
+        LayerParams lp;
+        net.addLayerToPrev("relu", "ReLU", lp);
+    }
+    {
+        LayerParams lp;
+        lp.set("pool", "max");
+        lp.set("kernel_size", 2);
+        lp.set("stride", 2);
+        net.addLayerToPrev("pool", "Pooling", lp);
+    }
+
+    int inpShape[] = {1, 3, 8, 10};
+    Mat input(4, inpShape, CV_32F);
+    randu(input, -1.0f, 1.0f);
+    net.setInput(input);
+    net.enableProfiling(true);
+    net.forward();
+
+    std::vector<LayerProfile> profile;
+    net.getProfile(profile);
+    ASSERT_EQ(profile.size(), (size_t)4);
+
+    const LayerProfile& conv = profile[0];
+    EXPECT_EQ(conv.name, "conv");
+    EXPECT_EQ(conv.backend, "OpenCV/CPU");
+    EXPECT_EQ(conv.kernel, "im2row");
+    EXPECT_FALSE(conv.skipped);
+    EXPECT_EQ(conv.fusion, "fused with scale; fused with relu");
+    EXPECT_EQ(conv.flops, net.getFLOPS(convId, shape(input)));
+    EXPECT_EQ(conv.bytesRead, (int64)(input.total() + 4 * 3 * 3 * 3 + 4) * (int64)sizeof(float));
+    EXPECT_EQ(conv.bytesWritten, 4 * 8 * 10 * (int64)sizeof(float));
+    EXPECT_GT(conv.timeMs, 0);
+
+    EXPECT_TRUE(profile[1].skipped);
+    EXPECT_EQ(profile[1].fusion, "fused into conv");
+    EXPECT_TRUE(profile[2].skipped);
+    EXPECT_EQ(profile[2].fusion, "fused into conv");
+
+    const LayerProfile& pool = profile[3];
+    EXPECT_TRUE(pool.fusion.empty());
+    // max values and their indices
+    EXPECT_EQ(pool.bytesWritten, 2 * 4 * 4 * 5 * (int64)sizeof(float));
+    EXPECT_GE(pool.startMs, conv.startMs + conv.timeMs);
+
+    std::string path = cv::tempfile(".json");
+    net.dumpProfile(path);
+    FileStorage fs(path, FileStorage::READ);
+    ASSERT_TRUE(fs.isOpened());
+    FileNode events = fs["traceEvents"];
+    ASSERT_EQ(events.size(), (size_t)4);
+    EXPECT_EQ((std::string)events[0]["name"], "conv");
+    EXPECT_EQ((std::string)events[0]["ph"], "X");
+    EXPECT_EQ((std::string)events[0]["args"]["kernel"], "im2row");
+    EXPECT_EQ((std::string)events[3]["cat"], "Pooling");
+    fs.release();
+    remove(path.c_str());
+}
+
+// Half precision weights of convolution and fully-connected layers.
+TEST(Layer_Test_FP16, Accuracy)
+{
+    Net net;
+    LayerParams lp = convolutionParams("conv", 3, 21);
+    net.addLayerToPrev(lp.name, lp.type, lp);
+
+    // fused into convolution, for half precision weights into their scales
+    lp = LayerParams();
+    lp.type = "Scale";
+    lp.name = "scale";
+    lp.set("bias_term", true);
+    Mat scale(1, 21, CV_32F), shift(1, 21, CV_32F);
+    randu(scale, 0.5f, 1.5f);
+    randu(shift, -1.0f, 1.0f);
+    lp.blobs.push_back(scale);
+    lp.blobs.push_back(shift);
+    net.addLayerToPrev(lp.name, lp.type, lp);
+
+    lp = LayerParams();
+    lp.type = "ReLU";
+    lp.name = "relu";
+    net.addLayerToPrev(lp.name, lp.type, lp);
+
+    lp = LayerParams();
+    lp.set("num_output", 13);
+    lp.type = "InnerProduct";
+    lp.name = "fc";
+    Mat weights(13, 21*7*5, CV_32F), bias(1, 13, CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+    lp.blobs.push_back(weights);
+    lp.blobs.push_back(bias);
+    net.addLayerToPrev(lp.name, lp.type, lp);
+
+    int inpShape[] = {2, 3, 7, 5};
+    Mat input(4, inpShape, CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    net.setInput(input);
+    Mat ref = net.forward().clone();
+    size_t refWeightsSize, weightsSize, blobsSize;
+    net.getMemoryConsumption(shape(input), refWeightsSize, blobsSize);
+
+    net.setPreferableTarget(DNN_TARGET_CPU_FP16);
+    net.setInput(input);
+    Mat out = net.forward().clone();
+
+    ASSERT_EQ(shape(ref), shape(out));
+    double refMax = cvtest::norm(ref, NORM_INF);
+    EXPECT_LE(cvtest::norm(out, ref, NORM_INF), 5e-3 * refMax);
+    EXPECT_GT(cvtest::norm(out, ref, NORM_INF), 0.0);
+    EXPECT_EQ(net.getLayer(lp.name)->getKernelName(), "fp16");
+
+    // Half precision weights replace the single precision ones.
+    net.getMemoryConsumption(shape(input), weightsSize, blobsSize);
+    EXPECT_LT(weightsSize, refWeightsSize * 0.6);
+    EXPECT_EQ(net.getParam(net.getLayerId(lp.name)).type(), CV_32F);
+    EXPECT_EQ(net.getParam(net.getLayerId("conv")).type(), CV_32F);
+
+    // Single precision kernels use the weights rounded to half precision.
+    net.setPreferableTarget(DNN_TARGET_CPU);
+    net.setInput(input);
+    normAssert(net.forward(), out, "", 1e-5 * refMax, 1e-4 * refMax);
+    EXPECT_EQ(net.getLayer(lp.name)->getKernelName(), "fp32");
+}
+
 }} // namespace
@@ -36,6 +36,75 @@ TEST(blobFromImage, allocated)
     ASSERT_EQ(blobData, blob.data);
 }
 
+// Reference preprocessing: every step is done separately.
+static Mat blobFromImageRef(const Mat& img, double scalefactor, Size size,
+                            Scalar mean, bool swapRB, bool crop)
+{
+    Mat image = img;
+    if (image.size() != size)
+    {
+        if (crop)
+        {
+            float resizeFactor = std::max(size.width / (float)image.cols,
+                                          size.height / (float)image.rows);
+            resize(image, image, Size(), resizeFactor, resizeFactor, INTER_LINEAR);
+            image = image(Rect(Point(0.5 * (image.cols - size.width),
+                                     0.5 * (image.rows - size.height)), size));
+        }
+        else
+            resize(image, image, size, 0, 0, INTER_LINEAR);
+    }
+    image.convertTo(image, CV_32F);
+    if (swapRB)
+        std::swap(mean[0], mean[2]);
+    image -= mean;
+    image *= scalefactor;
+
+    std::vector<Mat> ch;
+    split(image, ch);
+    if (swapRB && ch.size() >= 3)
+        std::swap(ch[0], ch[2]);
+    int sz[] = {1, (int)ch.size(), size.height, size.width};
+    Mat blob(4, sz, CV_32F);
+    for (int i = 0; i < (int)ch.size(); i++)
+        ch[i].copyTo(Mat(size, CV_32F, blob.ptr(0, i)));
+    return blob;
+}
+
+TEST(blobFromImages, preprocessing)
+{
+    Size size(35, 21);
+    Scalar mean(10, 20, 30, 40);
+    for (int depth = CV_8U; depth <= CV_32F; depth += CV_32F - CV_8U)
+    {
+        for (int cn = 1; cn <= 4; cn += cn == 1 ? 2 : 1)
+        {
+            std::vector<Mat> images;
+            images.push_back(Mat(size, CV_MAKETYPE(depth, cn)));
+            images.push_back(Mat(40, 51, CV_MAKETYPE(depth, cn)));
+            images.push_back(Mat(17, 30, CV_MAKETYPE(depth, cn)));
+            for (size_t i = 0; i < images.size(); i++)
+                randu(images[i], 0, 256);
+
+            for (int flags = 0; flags < 4; flags++)
+            {
+                bool swapRB = (flags & 1) != 0, crop = (flags & 2) != 0;
+                Mat blob;
+                blobFromImages(images, blob, 0.5, size, mean, swapRB, crop);
+                ASSERT_EQ(blob.dims, 4);
+                ASSERT_EQ(blob.size[0], 3); ASSERT_EQ(blob.size[1], cn);
+                ASSERT_EQ(blob.size[2], size.height); ASSERT_EQ(blob.size[3], size.width);
+                for (int i = 0; i < (int)images.size(); i++)
+                {
+                    Mat ref = blobFromImageRef(images[i], 0.5, size, mean, swapRB, crop);
+                    Mat out(4, &ref.size[0], CV_32F, blob.ptr(i));
+                    normAssert(out, ref, cv::format("depth=%d cn=%d flags=%d image=%d", depth, cn, flags, i).c_str(), 0, 0);
+                }
+            }
+        }
+    }
+}
+
 TEST(imagesFromBlob, Regression)
 {
     int nbOfImages = 8;
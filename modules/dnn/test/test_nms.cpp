@@ -37,4 +37,193 @@ TEST(NMS, Accuracy)
         ASSERT_EQ(indices[i], ref_indices[i]);
 }
 
+
+// Straightforward greedy NMS for cv::Rect.
+static void NMSBoxesRef(const std::vector<Rect>& bboxes, const std::vector<float>& scores,
+                        float score_threshold, float nms_threshold, std::vector<int>& indices)
+{
+    std::vector<std::pair<float, int> > candidates;
+    for (size_t i = 0; i < scores.size(); ++i)
+    {
+        if (scores[i] > score_threshold)
+            candidates.push_back(std::make_pair(-scores[i], (int)i));
+    }
+    std::sort(candidates.begin(), candidates.end());
+    indices.clear();
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        const Rect& box = bboxes[candidates[i].second];
+        bool keep = true;
+        for (size_t k = 0; k < indices.size() && keep; ++k)
+        {
+            const Rect& kept = bboxes[indices[k]];
+            float overlap = (float)(box & kept).area() / (box.area() + kept.area() - (box & kept).area());
+            keep = overlap <= nms_threshold;
+        }
+        if (keep)
+            indices.push_back(candidates[i].second);
+    }
+}
+
+static void randomBoxes(RNG& rng, int n, int numClasses, std::vector<Rect>& bboxes,
+                        std::vector<float>& scores, std::vector<int>& classIds)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        int x = rng.uniform(0, 100), y = rng.uniform(0, 100);
+        bboxes.push_back(Rect(x, y, rng.uniform(5, 40), rng.uniform(5, 40)));
+        // Scores are quantized to check the order of equal scores.
+        scores.push_back(rng.uniform(0, 20) * 0.05f);
+        classIds.push_back(rng.uniform(0, numClasses));
+    }
+}
+
+TEST(NMS, Reference)
+{
+    RNG rng(0);
+    std::vector<Rect> bboxes;
+    std::vector<float> scores;
+    std::vector<int> classIds;
+    randomBoxes(rng, 1000, 1, bboxes, scores, classIds);
+
+    std::vector<int> indices, ref;
+    cv::dnn::NMSBoxes(bboxes, scores, 0.1f, 0.4f, indices);
+    NMSBoxesRef(bboxes, scores, 0.1f, 0.4f, ref);
+    ASSERT_FALSE(ref.empty());
+    EXPECT_EQ(ref, indices);
+
+    // Keep only candidates with the highest scores.
+    cv::dnn::NMSBoxes(bboxes, scores, 0.1f, 0.4f, indices, 1.f, 10);
+    ASSERT_LE(indices.size(), (size_t)10);
+    for (size_t i = 0; i < indices.size(); ++i)
+        EXPECT_EQ(ref[i], indices[i]);
+}
+
+TEST(NMS, Batched)
+{
+    const int numClasses = 7;
+    RNG rng(0);
+    std::vector<Rect> bboxes;
+    std::vector<float> scores;
+    std::vector<int> classIds;
+    randomBoxes(rng, 2000, numClasses, bboxes, scores, classIds);
+
+    std::vector<int> indices;
+    cv::dnn::NMSBoxesBatched(bboxes, scores, classIds, 0.1f, 0.4f, indices);
+
+    // Boxes of different classes don't suppress each other.
+    std::vector<std::pair<float, int> > ref;
+    for (int c = 0; c < numClasses; ++c)
+    {
+        std::vector<Rect> classBoxes;
+        std::vector<float> classScores;
+        std::vector<int> classIndices, kept;
+        for (size_t i = 0; i < bboxes.size(); ++i)
+        {
+            if (classIds[i] != c)
+                continue;
+            classBoxes.push_back(bboxes[i]);
+            classScores.push_back(scores[i]);
+            classIndices.push_back((int)i);
+        }
+        NMSBoxesRef(classBoxes, classScores, 0.1f, 0.4f, kept);
+        for (size_t i = 0; i < kept.size(); ++i)
+            ref.push_back(std::make_pair(-classScores[kept[i]], classIndices[kept[i]]));
+    }
+    std::sort(ref.begin(), ref.end());
+
+    ASSERT_EQ(ref.size(), indices.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+        EXPECT_EQ(ref[i].second, indices[i]);
+}
+
+TEST(NMS, DetectionOutput)
+{
+    const int numPriors = 500, numClasses = 4;
+    RNG rng(0);
+
+    // Zero priors with CORNER coding give boxes equal to location predictions.
+    Mat loc(1, numPriors * 4, CV_32F), conf(1, numPriors * numClasses, CV_32F);
+    int priorShape[] = {1, 2, numPriors * 4};
+    Mat priors(3, priorShape, CV_32F, Scalar(0));
+    std::vector<Rect> bboxes;
+    std::vector<float> scores;
+    std::vector<int> classIds;
+    randomBoxes(rng, numPriors * numClasses, 1, bboxes, scores, classIds);
+    for (int i = 0; i < numPriors; ++i)
+    {
+        const Rect& r = bboxes[i];
+        loc.at<float>(i * 4) = r.x * 0.01f;
+        loc.at<float>(i * 4 + 1) = r.y * 0.01f;
+        loc.at<float>(i * 4 + 2) = r.br().x * 0.01f;
+        loc.at<float>(i * 4 + 3) = r.br().y * 0.01f;
+    }
+    for (int i = 0; i < numPriors * numClasses; ++i)
+        conf.at<float>(i) = scores[i];
+
+    LayerParams lp;
+    lp.set("num_classes", numClasses);
+    lp.set("share_location", true);
+    lp.set("background_label_id", 0);
+    lp.set("nms_threshold", 0.45f);
+    lp.set("keep_top_k", 1000);
+    lp.set("confidence_threshold", 0.1f);
+    lp.set("code_type", "CORNER");
+    lp.set("variance_encoded_in_target", true);
+    Net net;
+    std::vector<String> inputNames;
+    inputNames.push_back("loc");
+    inputNames.push_back("conf");
+    inputNames.push_back("priors");
+    net.setInputsNames(inputNames);
+    int id = net.addLayer("detection_out", "DetectionOutput", lp);
+    for (int i = 0; i < 3; ++i)
+        net.connect(0, i, id, i);
+    net.setInput(loc, "loc");
+    net.setInput(conf, "conf");
+    net.setInput(priors, "priors");
+    Mat out = net.forward();
+    out = out.reshape(1, (int)out.total() / 7);
+
+    std::vector<Vec<float, 7> > ref;
+    for (int c = 1; c < numClasses; ++c)
+    {
+        std::vector<std::pair<float, int> > candidates;
+        for (int i = 0; i < numPriors; ++i)
+        {
+            float score = conf.at<float>(i * numClasses + c);
+            if (score > 0.1f)
+                candidates.push_back(std::make_pair(-score, i));
+        }
+        std::sort(candidates.begin(), candidates.end());
+        std::vector<int> kept;
+        for (size_t i = 0; i < candidates.size(); ++i)
+        {
+            const float* box = loc.ptr<float>() + candidates[i].second * 4;
+            bool keep = true;
+            for (size_t k = 0; k < kept.size() && keep; ++k)
+            {
+                const float* other = loc.ptr<float>() + kept[k] * 4;
+                float w = std::min(box[2], other[2]) - std::max(box[0], other[0]);
+                float h = std::min(box[3], other[3]) - std::max(box[1], other[1]);
+                float inter = w < 0 || h < 0 ? 0.f : w * h;
+                float area = (box[2] - box[0]) * (box[3] - box[1]);
+                float otherArea = (other[2] - other[0]) * (other[3] - other[1]);
+                keep = inter <= 0 || inter / (area + otherArea - inter) <= 0.45f;
+            }
+            if (!keep)
+                continue;
+            kept.push_back(candidates[i].second);
+            const float* b = box;
+            Vec<float, 7> row(0, (float)c, -candidates[i].first, b[0], b[1], b[2], b[3]);
+            ref.push_back(row);
+        }
+    }
+
+    ASSERT_FALSE(ref.empty());
+    ASSERT_EQ((int)ref.size(), out.rows);
+    for (int i = 0; i < out.rows; ++i)
+        EXPECT_EQ(0, cvtest::norm(Mat(ref[i]).t(), out.row(i), NORM_INF)) << i;
+}
+
 }} // namespace
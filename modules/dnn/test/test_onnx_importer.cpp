@@ -0,0 +1,552 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+#include <opencv2/dnn/shape_utils.hpp>
+
+namespace opencv_test { namespace {
+
+// Minimal protobuf writer to compose ONNX models in memory.
+static void writeVarint(std::string& s, uint64 value)
+{
+    while (value >= 0x80)
+    {
+        s += (char)((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    s += (char)value;
+}
+
+static void writeInt(std::string& s, int field, int64 value)
+{
+    writeVarint(s, (uint64)field << 3);
+    writeVarint(s, (uint64)value);
+}
+
+static void writeBytes(std::string& s, int field, const std::string& value)
+{
+    writeVarint(s, ((uint64)field << 3) | 2);
+    writeVarint(s, value.size());
+    s += value;
+}
+
+static std::string makeTensor(const std::string& name, const Mat& blob, bool scalar = false)
+{
+    std::string tensor;
+    if (scalar)
+        CV_Assert(blob.total() == 1);
+    else if (blob.rows == 1 && blob.dims == 2)
+        writeInt(tensor, 1, blob.cols);
+    else
+    {
+        for (int i = 0; i < blob.dims; ++i)
+            writeInt(tensor, 1, blob.size[i]);
+    }
+    writeInt(tensor, 2, blob.depth() == CV_32F ? 1 : 7);  // FLOAT or INT64
+    writeBytes(tensor, 8, name);
+    if (blob.depth() == CV_32F)
+        writeBytes(tensor, 9, std::string((const char*)blob.data, blob.total() * sizeof(float)));
+    else
+    {
+        std::string packed;
+        for (size_t i = 0; i < blob.total(); ++i)
+            writeVarint(packed, (uint64)(int64)blob.ptr<int>()[i]);
+        writeBytes(tensor, 7, packed);
+    }
+    return tensor;
+}
+
+static std::vector<std::string> split(const std::string& values)
+{
+    std::vector<std::string> items;
+    std::stringstream ss(values);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        items.push_back(item);
+    return items;
+}
+
+static std::string makeIntsAttr(const std::string& name, const std::string& values)
+{
+    std::vector<std::string> items = split(values);
+    std::string attr;
+    writeBytes(attr, 1, name);
+    for (size_t i = 0; i < items.size(); ++i)
+        writeInt(attr, 8, atoi(items[i].c_str()));
+    writeInt(attr, 20, 7);  // INTS
+    return attr;
+}
+
+static std::string makeNode(const std::string& type, const std::string& inputs, const std::string& output,
+                            const std::string& attr0 = std::string(), const std::string& attr1 = std::string())
+{
+    std::vector<std::string> inputNames = split(inputs);
+    std::string node;
+    for (size_t i = 0; i < inputNames.size(); ++i)
+        writeBytes(node, 1, inputNames[i]);
+    writeBytes(node, 2, output);
+    writeBytes(node, 4, type);
+    if (!attr0.empty())
+        writeBytes(node, 5, attr0);
+    if (!attr1.empty())
+        writeBytes(node, 5, attr1);
+    return node;
+}
+
+// Dimensions which are not numbers are symbolic.
+static std::string makeInput(const std::string& name, const std::string& dims)
+{
+    std::vector<std::string> items = split(dims);
+    std::string shape;
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        std::string dim;
+        if (isdigit(items[i][0]))
+            writeInt(dim, 1, atoi(items[i].c_str()));
+        else
+            writeBytes(dim, 2, items[i]);
+        writeBytes(shape, 1, dim);
+    }
+    std::string tensorType, type, info;
+    writeInt(tensorType, 1, 1);
+    writeBytes(tensorType, 2, shape);
+    writeBytes(type, 1, tensorType);
+    writeBytes(info, 1, name);
+    writeBytes(info, 2, type);
+    return info;
+}
+
+// PyTorch-like export of a convolution followed by fully connected layer:
+// flattening is expressed by Shape-Gather-Unsqueeze-Concat-Reshape subgraph.
+TEST(Test_ONNX_layers, ConvolutionFlattenGemm)
+{
+    int wShape[] = {4, 2, 3, 3};
+    Mat convWeights(4, wShape, CV_32F), convBias(1, 4, CV_32F);
+    Mat fcWeights(3, 4 * 5 * 6, CV_32F), fcBias(1, 3, CV_32F);
+    randu(convWeights, -1.0f, 1.0f);
+    randu(convBias, -1.0f, 1.0f);
+    randu(fcWeights, -1.0f, 1.0f);
+    randu(fcBias, -1.0f, 1.0f);
+
+    std::string graph, model;
+    writeBytes(graph, 1, makeNode("Conv", "x,conv_w,conv_b", "conv",
+                                  makeIntsAttr("kernel_shape", "3,3"), makeIntsAttr("pads", "1,1,1,1")));
+    writeBytes(graph, 1, makeNode("Relu", "conv", "relu"));
+    writeBytes(graph, 1, makeNode("Shape", "relu", "relu_shape"));
+    writeBytes(graph, 1, makeNode("Gather", "relu_shape,zero", "batch"));
+    writeBytes(graph, 1, makeNode("Unsqueeze", "batch", "batch_1d", makeIntsAttr("axes", "0")));
+    writeBytes(graph, 1, makeNode("Concat", "batch_1d,minus_one", "flatten_shape", makeIntsAttr("axis", "0")));
+    writeBytes(graph, 1, makeNode("Reshape", "relu,flatten_shape", "flatten"));
+    writeBytes(graph, 1, makeNode("Gemm", "flatten,fc_w,fc_b", "y", makeIntsAttr("transB", "1")));
+    writeBytes(graph, 5, makeTensor("conv_w", convWeights));
+    writeBytes(graph, 5, makeTensor("conv_b", convBias));
+    writeBytes(graph, 5, makeTensor("fc_w", fcWeights));
+    writeBytes(graph, 5, makeTensor("fc_b", fcBias));
+    writeBytes(graph, 5, makeTensor("zero", Mat(1, 1, CV_32S, Scalar(0)), true));
+    writeBytes(graph, 5, makeTensor("minus_one", Mat(1, 1, CV_32S, Scalar(-1))));
+    writeBytes(graph, 11, makeInput("x", "N,2,5,6"));
+    writeBytes(model, 7, graph);
+
+    Net net = readNetFromONNX(model.data(), model.size());
+    ASSERT_FALSE(net.empty());
+    // Shape computations and flattening don't produce layers.
+    EXPECT_EQ(net.getLayerNames().size(), (size_t)3);
+
+    // Reference network.
+    Net refNet;
+    {
+        LayerParams lp;
+        lp.set("kernel_size", 3);
+        lp.set("pad", 1);
+        lp.set("num_output", 4);
+        lp.blobs.push_back(convWeights);
+        lp.blobs.push_back(convBias);
+        refNet.addLayerToPrev("conv", "Convolution", lp);
+    }
+    {
+        LayerParams lp;
+        refNet.addLayerToPrev("relu", "ReLU", lp);
+    }
+    {
+        LayerParams lp;
+        lp.set("num_output", 3);
+        lp.blobs.push_back(fcWeights);
+        lp.blobs.push_back(fcBias);
+        refNet.addLayerToPrev("fc", "InnerProduct", lp);
+    }
+
+    // Batch size differs from the one which is used to resolve shapes.
+    int inpShape[] = {2, 2, 5, 6};
+    Mat input(4, inpShape, CV_32F);
+    randu(input, -1.0f, 1.0f);
+
+    net.setInput(input);
+    Mat out = net.forward();
+    refNet.setInput(input);
+    Mat ref = refNet.forward();
+    normAssert(out, ref);
+}
+
+static std::string makeModel(const std::string& graph)
+{
+    std::string model;
+    writeBytes(model, 7, graph);
+    return model;
+}
+
+static Mat forwardOnnx(const std::string& model, const Mat& input)
+{
+    Net net = readNetFromONNX(model.data(), model.size());
+    net.setInput(input);
+    return net.forward().clone();
+}
+
+static Mat forwardLayer(const std::string& type, LayerParams& lp, const Mat& input)
+{
+    Net net;
+    net.addLayerToPrev("layer", type, lp);
+    net.setInput(input);
+    return net.forward().clone();
+}
+
+static Mat randomBlob(int n, int c, int h, int w)
+{
+    int sz[] = {n, c, h, w};
+    Mat blob(4, sz, CV_32F);
+    randu(blob, -1.0f, 1.0f);
+    return blob;
+}
+
+TEST(Test_ONNX_layers, ConvolutionStridesGroups)
+{
+    Mat weights = randomBlob(6, 2, 3, 3), bias(1, 6, CV_32F);
+    randu(bias, -1.0f, 1.0f);
+
+    std::string graph;
+    std::string group;
+    writeBytes(group, 1, "group");
+    writeInt(group, 3, 2);
+    writeInt(group, 20, 2);  // INT
+    std::string node = makeNode("Conv", "x,w,b", "y", makeIntsAttr("strides", "2,1"),
+                                makeIntsAttr("pads", "1,0,1,0"));
+    writeBytes(node, 5, group);
+    writeBytes(graph, 1, node);
+    writeBytes(graph, 5, makeTensor("w", weights));
+    writeBytes(graph, 5, makeTensor("b", bias));
+    writeBytes(graph, 11, makeInput("x", "N,4,7,8"));
+
+    LayerParams lp;
+    lp.set("kernel_size", 3);
+    lp.set("pad_h", 1);
+    lp.set("pad_w", 0);
+    lp.set("stride_h", 2);
+    lp.set("stride_w", 1);
+    lp.set("group", 2);
+    lp.set("num_output", 6);
+    lp.blobs.push_back(weights);
+    lp.blobs.push_back(bias);
+
+    Mat input = randomBlob(2, 4, 7, 8);
+    Mat out = forwardOnnx(makeModel(graph), input);
+    int outShape[] = {2, 6, 4, 6};
+    EXPECT_EQ(shape(out), shape(outShape, 4));
+    normAssert(out, forwardLayer("Convolution", lp, input));
+}
+
+TEST(Test_ONNX_layers, Pooling)
+{
+    Mat input = randomBlob(2, 3, 7, 9);
+    {
+        std::string graph;
+        writeBytes(graph, 1, makeNode("MaxPool", "x", "y", makeIntsAttr("kernel_shape", "3,3"),
+                                      makeIntsAttr("strides", "2,2")));
+        writeBytes(graph, 11, makeInput("x", "N,3,7,9"));
+
+        LayerParams lp;
+        lp.set("pool", "max");
+        lp.set("kernel_size", 3);
+        lp.set("stride", 2);
+        normAssert(forwardOnnx(makeModel(graph), input), forwardLayer("Pooling", lp, input));
+    }
+    {
+        std::string countPad;
+        writeBytes(countPad, 1, "count_include_pad");
+        writeInt(countPad, 3, 1);
+        writeInt(countPad, 20, 2);  // INT
+        std::string node = makeNode("AveragePool", "x", "y", makeIntsAttr("kernel_shape", "2,3"),
+                                    makeIntsAttr("pads", "1,1,1,1"));
+        writeBytes(node, 5, countPad);
+        std::string graph;
+        writeBytes(graph, 1, node);
+        writeBytes(graph, 11, makeInput("x", "N,3,7,9"));
+
+        LayerParams lp;
+        lp.set("pool", "ave");
+        lp.set("kernel_h", 2);
+        lp.set("kernel_w", 3);
+        lp.set("pad", 1);
+        normAssert(forwardOnnx(makeModel(graph), input), forwardLayer("Pooling", lp, input));
+    }
+    {
+        std::string graph;
+        writeBytes(graph, 1, makeNode("GlobalAveragePool", "x", "y"));
+        writeBytes(graph, 11, makeInput("x", "N,3,7,9"));
+
+        Mat out = forwardOnnx(makeModel(graph), input);
+        ASSERT_EQ(out.total(), (size_t)6);
+        for (int i = 0; i < 6; i++)
+        {
+            Mat plane(7, 9, CV_32F, input.ptr<float>() + i * 7 * 9);
+            EXPECT_NEAR(out.ptr<float>()[i], mean(plane)[0], 1e-5);
+        }
+    }
+    {
+        // Average pooling of padded area is not supported without counting the padding.
+        std::string graph;
+        writeBytes(graph, 1, makeNode("AveragePool", "x", "y", makeIntsAttr("kernel_shape", "3,3"),
+                                      makeIntsAttr("pads", "1,1,1,1")));
+        writeBytes(graph, 11, makeInput("x", "N,3,7,9"));
+        std::string model = makeModel(graph);
+        EXPECT_THROW(readNetFromONNX(model.data(), model.size()), cv::Exception);
+    }
+}
+
+TEST(Test_ONNX_layers, BatchNormalization)
+{
+    const int numChannels = 3;
+    Mat scale(1, numChannels, CV_32F), shift(1, numChannels, CV_32F);
+    Mat mean(1, numChannels, CV_32F), var(1, numChannels, CV_32F);
+    randu(scale, 0.5f, 2.0f);
+    randu(shift, -1.0f, 1.0f);
+    randu(mean, -1.0f, 1.0f);
+    randu(var, 0.1f, 2.0f);
+
+    std::string graph;
+    writeBytes(graph, 1, makeNode("BatchNormalization", "x,scale,shift,mean,var", "y"));
+    writeBytes(graph, 5, makeTensor("scale", scale));
+    writeBytes(graph, 5, makeTensor("shift", shift));
+    writeBytes(graph, 5, makeTensor("mean", mean));
+    writeBytes(graph, 5, makeTensor("var", var));
+    writeBytes(graph, 11, makeInput("x", "N,3,4,5"));
+
+    Mat input = randomBlob(2, numChannels, 4, 5);
+    Mat out = forwardOnnx(makeModel(graph), input);
+
+    Mat ref(input.dims, input.size.p, CV_32F);
+    const int planeSize = 4 * 5;
+    for (int i = 0; i < 2 * numChannels; i++)
+    {
+        int c = i % numChannels;
+        float w = scale.at<float>(c) / std::sqrt(var.at<float>(c) + 1e-5f);
+        float b = shift.at<float>(c) - mean.at<float>(c) * w;
+        for (int j = 0; j < planeSize; j++)
+            ref.ptr<float>()[i * planeSize + j] = input.ptr<float>()[i * planeSize + j] * w + b;
+    }
+    normAssert(out, ref);
+}
+
+TEST(Test_ONNX_layers, Concat)
+{
+    std::string graph;
+    writeBytes(graph, 1, makeNode("Relu", "x", "relu"));
+    writeBytes(graph, 1, makeNode("Neg", "x", "neg"));
+    writeBytes(graph, 1, makeNode("Concat", "relu,neg", "y", makeIntsAttr("axis", "1")));
+    writeBytes(graph, 11, makeInput("x", "N,2,3,4"));
+
+    Mat input = randomBlob(2, 2, 3, 4);
+    Mat out = forwardOnnx(makeModel(graph), input);
+
+    int refShape[] = {2, 4, 3, 4};
+    Mat ref(4, refShape, CV_32F);
+    const int planes = 2 * 3 * 4;
+    for (int n = 0; n < 2; n++)
+    {
+        Mat inp(1, planes, CV_32F, input.ptr<float>() + n * planes);
+        Mat relu(1, planes, CV_32F, ref.ptr<float>() + 2 * n * planes);
+        Mat neg(1, planes, CV_32F, ref.ptr<float>() + (2 * n + 1) * planes);
+        max(inp, 0, relu);
+        inp.convertTo(neg, CV_32F, -1);
+    }
+    normAssert(out, ref);
+}
+
+TEST(Test_ONNX_layers, Reshape)
+{
+    int dims[] = {0, 12, -1};
+    std::string graph;
+    writeBytes(graph, 1, makeNode("Reshape", "x,shape", "y"));
+    writeBytes(graph, 1, makeNode("Softmax", "y", "z", makeIntsAttr("axis", "1")));
+    writeBytes(graph, 5, makeTensor("shape", Mat(1, 3, CV_32S, dims)));
+    writeBytes(graph, 11, makeInput("x", "1,3,4,5"));
+
+    Mat input = randomBlob(3, 3, 4, 5);
+    Mat out = forwardOnnx(makeModel(graph), input);
+    int outShape[] = {3, 12, 5};
+    ASSERT_EQ(shape(out), shape(outShape, 3));
+
+    LayerParams lp;
+    lp.set("axis", 1);
+    int refShape[] = {3, 12, 5};
+    normAssert(out, forwardLayer("Softmax", lp, input.reshape(1, 3, refShape)));
+}
+
+// Reshape dimensions computed from the input shape by Shape and Gather nodes
+// must follow the batch size.
+TEST(Test_ONNX_layers, GatherShapeBatch)
+{
+    {
+        // [N, C, H, W] -> [N, C*H, W]
+        int lastIdx[] = {-1}, minusOne[] = {-1};
+        std::string graph;
+        writeBytes(graph, 1, makeNode("Shape", "x", "x_shape"));
+        writeBytes(graph, 1, makeNode("Gather", "x_shape,zero", "batch"));
+        writeBytes(graph, 1, makeNode("Unsqueeze", "batch", "batch_1d", makeIntsAttr("axes", "0")));
+        writeBytes(graph, 1, makeNode("Gather", "x_shape,last", "width"));
+        writeBytes(graph, 1, makeNode("Concat", "batch_1d,minus_one,width", "y_shape", makeIntsAttr("axis", "0")));
+        writeBytes(graph, 1, makeNode("Reshape", "x,y_shape", "y"));
+        writeBytes(graph, 1, makeNode("Relu", "y", "z"));
+        writeBytes(graph, 5, makeTensor("zero", Mat(1, 1, CV_32S, Scalar(0)), true));
+        writeBytes(graph, 5, makeTensor("last", Mat(1, 1, CV_32S, lastIdx)));
+        writeBytes(graph, 5, makeTensor("minus_one", Mat(1, 1, CV_32S, minusOne)));
+        writeBytes(graph, 11, makeInput("x", "1,2,3,4"));
+
+        Mat input = randomBlob(3, 2, 3, 4);
+        Mat out = forwardOnnx(makeModel(graph), input);
+        int outShape[] = {3, 6, 4};
+        ASSERT_EQ(shape(out), shape(outShape, 3));
+        Mat ref;
+        max(input.reshape(1, 1), 0, ref);
+        normAssert(out.reshape(1, 1), ref);
+    }
+    {
+        // The batch isn't the first dimension of the Reshape:
+        // [N, C, H, W] -> [C, N, H, W] -> [C, N, H*W, 1] -> [N, C, H*W, 1]
+        int channels[] = {2}, tail[] = {12, 1};
+        std::string graph;
+        writeBytes(graph, 1, makeNode("Shape", "x", "x_shape"));
+        writeBytes(graph, 1, makeNode("Gather", "x_shape,zero", "batch"));
+        writeBytes(graph, 1, makeNode("Unsqueeze", "batch", "batch_1d", makeIntsAttr("axes", "0")));
+        writeBytes(graph, 1, makeNode("Concat", "channels,batch_1d,tail", "t_shape", makeIntsAttr("axis", "0")));
+        writeBytes(graph, 1, makeNode("Transpose", "x", "t", makeIntsAttr("perm", "1,0,2,3")));
+        writeBytes(graph, 1, makeNode("Reshape", "t,t_shape", "r"));
+        writeBytes(graph, 1, makeNode("Transpose", "r", "y", makeIntsAttr("perm", "1,0,2,3")));
+        writeBytes(graph, 5, makeTensor("zero", Mat(1, 1, CV_32S, Scalar(0)), true));
+        writeBytes(graph, 5, makeTensor("channels", Mat(1, 1, CV_32S, channels)));
+        writeBytes(graph, 5, makeTensor("tail", Mat(1, 2, CV_32S, tail)));
+        writeBytes(graph, 11, makeInput("x", "1,2,3,4"));
+
+        Mat input = randomBlob(3, 2, 3, 4);
+        Mat out = forwardOnnx(makeModel(graph), input);
+        int outShape[] = {3, 2, 12, 1};
+        ASSERT_EQ(shape(out), shape(outShape, 4));
+        normAssert(out.reshape(1, 1), input.reshape(1, 1));
+    }
+}
+
+TEST(Test_ONNX_layers, Transpose)
+{
+    std::string graph;
+    writeBytes(graph, 1, makeNode("Transpose", "x", "y", makeIntsAttr("perm", "0,2,3,1")));
+    writeBytes(graph, 11, makeInput("x", "N,2,3,4"));
+
+    Mat input = randomBlob(2, 2, 3, 4);
+    Mat out = forwardOnnx(makeModel(graph), input);
+    int outShape[] = {2, 3, 4, 2};
+    ASSERT_EQ(shape(out), shape(outShape, 4));
+    for (int n = 0; n < 2; n++)
+        for (int c = 0; c < 2; c++)
+            for (int y = 0; y < 3; y++)
+                for (int x = 0; x < 4; x++)
+                {
+                    int inpIdx[] = {n, c, y, x}, outIdx[] = {n, y, x, c};
+                    ASSERT_EQ(input.at<float>(inpIdx), out.at<float>(outIdx));
+                }
+}
+
+TEST(Test_ONNX_layers, Softmax)
+{
+    Mat input(3, 5, CV_32F);
+    randu(input, -3.0f, 3.0f);
+    for (int logSoftmax = 0; logSoftmax < 2; logSoftmax++)
+    {
+        std::string graph;
+        writeBytes(graph, 1, makeNode(logSoftmax ? "LogSoftmax" : "Softmax", "x", "y",
+                                      makeIntsAttr("axis", "1")));
+        writeBytes(graph, 11, makeInput("x", "N,5"));
+
+        Mat out = forwardOnnx(makeModel(graph), input);
+        Mat ref;
+        exp(input, ref);
+        for (int i = 0; i < ref.rows; i++)
+            ref.row(i) /= sum(ref.row(i))[0];
+        if (logSoftmax)
+            log(ref, ref);
+        normAssert(out.reshape(1, 3), ref);
+    }
+}
+
+TEST(Test_ONNX_layers, MalformedModels)
+{
+    Mat weights = randomBlob(2, 1, 3, 3);
+    std::string graph;
+    writeBytes(graph, 1, makeNode("Conv", "x,w", "y", makeIntsAttr("kernel_shape", "3,3")));
+    writeBytes(graph, 5, makeTensor("w", weights));
+    writeBytes(graph, 11, makeInput("x", "N,1,5,5"));
+    const std::string model = makeModel(graph);
+    {
+        Net net = readNetFromONNX(model.data(), model.size());
+        EXPECT_FALSE(net.empty());
+    }
+
+    // Truncated models are either rejected or give a network without a crash.
+    for (size_t size = 0; size < model.size(); size++)
+    {
+        try
+        {
+            readNetFromONNX(model.data(), size);
+        }
+        catch (const cv::Exception&)
+        {
+        }
+    }
+
+    // Message without a graph.
+    std::string noGraph;
+    writeInt(noGraph, 1, 3);
+    EXPECT_THROW(readNetFromONNX(noGraph.data(), noGraph.size()), cv::Exception);
+
+    // Length of a field exceeds the data.
+    std::string tooLong;
+    writeVarint(tooLong, (7 << 3) | 2);
+    writeVarint(tooLong, 1000);
+    tooLong += "abc";
+    EXPECT_THROW(readNetFromONNX(tooLong.data(), tooLong.size()), cv::Exception);
+
+    // Unterminated varint.
+    std::string badVarint(12, (char)0xff);
+    EXPECT_THROW(readNetFromONNX(badVarint.data(), badVarint.size()), cv::Exception);
+
+    // Unknown wire type.
+    std::string badWire;
+    writeVarint(badWire, (7 << 3) | 3);
+    EXPECT_THROW(readNetFromONNX(badWire.data(), badWire.size()), cv::Exception);
+
+    // Raw data of a tensor doesn't match its dimensions.
+    {
+        std::string tensor;
+        writeInt(tensor, 1, 2);
+        writeInt(tensor, 1, 3);
+        writeInt(tensor, 2, 1);  // FLOAT
+        writeBytes(tensor, 8, "w");
+        writeBytes(tensor, 9, std::string(5 * sizeof(float), '\0'));
+        std::string badGraph;
+        writeBytes(badGraph, 1, makeNode("Gemm", "x,w", "y"));
+        writeBytes(badGraph, 5, tensor);
+        writeBytes(badGraph, 11, makeInput("x", "N,3"));
+        std::string badModel = makeModel(badGraph);
+        EXPECT_THROW(readNetFromONNX(badModel.data(), badModel.size()), cv::Exception);
+    }
+}
+
+}} // namespace
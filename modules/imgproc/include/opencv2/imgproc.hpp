@@ -3790,6 +3790,57 @@ not set by default. Currently, only the #TM_SQDIFF and #TM_CCORR_NORMED methods
 CV_EXPORTS_W void matchTemplate( InputArray image, InputArray templ,
                                  OutputArray result, int method, InputArray mask = noArray() );
 
+/** @brief Matches a fixed set of templates against many images.
+
+The spectra and the normalization terms of the templates are computed once and reused for all the
+following images of the same size. Each image is transformed tile by tile, only once for all the
+templates, and the tiles are processed in parallel. The results are the same as those of
+#matchTemplate up to floating-point rounding.
+
+@sa matchTemplate, createTemplateMatcher
+ */
+class CV_EXPORTS_W TemplateMatcher : public Algorithm
+{
+public:
+    /** @brief Adds a template to the set.
+
+    @param templ Searched template. It must be 8-bit or 32-bit floating-point, and all the templates
+    must have the same type.
+    @return Index of the template, which is also the index of its result in TemplateMatcher::match.
+     */
+    CV_WRAP virtual int add(InputArray templ) = 0;
+
+    //! Removes all the templates.
+    CV_WRAP virtual void clear() = 0;
+
+    //! Returns the number of templates.
+    CV_WRAP virtual int getTemplatesCount() const = 0;
+
+    /** @brief Compares all the templates against overlapped image regions.
+
+    @param image Image where the search is running. It must have the same type as the templates and
+    be at least as large as each of them.
+    @param results Maps of comparison results, one per template in the order they were added. See
+    #matchTemplate.
+     */
+    CV_WRAP virtual void match(InputArray image, OutputArrayOfArrays results) = 0;
+
+    /** @brief Sets the comparison method.
+
+    @param method Comparison method, see #TemplateMatchModes
+    */
+    CV_WRAP virtual void setMethod(int method) = 0;
+
+    //! Returns the comparison method.
+    CV_WRAP virtual int getMethod() const = 0;
+};
+
+/** @brief Creates a cv::TemplateMatcher.
+
+@param method Comparison method, see #TemplateMatchModes
+ */
+CV_EXPORTS_W Ptr<TemplateMatcher> createTemplateMatcher(int method = TM_CCOEFF_NORMED);
+
 //! @}
 
 //! @addtogroup imgproc_shape
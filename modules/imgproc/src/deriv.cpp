@@ -779,6 +779,70 @@ static bool ipp_Laplacian(InputArray _src, OutputArray _dst, int ksize, double s
 }
 #endif
 
+namespace cv
+{
+
+// sums the second derivatives along x and y for a band of rows, streaming the band through
+// two separable filters in stripes that fit the cache
+class LaplacianInvoker : public ParallelLoopBody
+{
+public:
+    LaplacianInvoker(const Mat& _src, Mat& _dst, const Size& _wsz, const Point& _ofs,
+                     const Mat& _kd, const Mat& _ks, int _wtype, double _scale, double _delta,
+                     int _borderType)
+        : src(_src), dst(_dst), wsz(_wsz), ofs(_ofs), kd(_kd), ks(_ks), wtype(_wtype),
+          scale(_scale), delta(_delta), borderType(_borderType)
+    {
+    }
+
+    virtual void operator()(const Range& range) const
+    {
+        const size_t STRIPE_SIZE = 1 << 14;
+        int stype = src.type(), ddepth = dst.depth();
+        Mat srcBand = src.rowRange(range), dstBand = dst.rowRange(range);
+        Point bandOfs(ofs.x, ofs.y + range.start);
+
+        Ptr<FilterEngine> fx = createSeparableLinearFilter(stype,
+            wtype, kd, ks, Point(-1,-1), 0, borderType, borderType, Scalar() );
+        Ptr<FilterEngine> fy = createSeparableLinearFilter(stype,
+            wtype, ks, kd, Point(-1,-1), 0, borderType, borderType, Scalar() );
+
+        int y = fx->start(srcBand, wsz, bandOfs), dsty = 0, dy = 0;
+        fy->start(srcBand, wsz, bandOfs);
+        const uchar* sptr = srcBand.ptr() + srcBand.step[0] * y;
+
+        int dy0 = std::min(std::max((int)(STRIPE_SIZE/(CV_ELEM_SIZE(stype)*srcBand.cols)), 1), srcBand.rows);
+        Mat d2x( dy0 + kd.rows - 1, srcBand.cols, wtype );
+        Mat d2y( dy0 + kd.rows - 1, srcBand.cols, wtype );
+
+        for( ; dsty < srcBand.rows; sptr += dy0*srcBand.step, dsty += dy )
+        {
+            fx->proceed( sptr, (int)srcBand.step, dy0, d2x.ptr(), (int)d2x.step );
+            dy = fy->proceed( sptr, (int)srcBand.step, dy0, d2y.ptr(), (int)d2y.step );
+            if( dy > 0 )
+            {
+                Mat dstripe = dstBand.rowRange(dsty, dsty + dy);
+                d2x.rows = d2y.rows = dy; // modify the headers, which should work
+                d2x += d2y;
+                d2x.convertTo( dstripe, ddepth, scale, delta );
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    Size wsz;
+    Point ofs;
+    Mat kd, ks;
+    int wtype;
+    double scale, delta;
+    int borderType;
+
+    LaplacianInvoker& operator=(const LaplacianInvoker&); // disabled
+};
+
+}
 
 void cv::Laplacian( InputArray _src, OutputArray _dst, int ddepth, int ksize,
                     double scale, double delta, int borderType )
@@ -854,32 +918,12 @@ void cv::Laplacian( InputArray _src, OutputArray _dst, int ddepth, int ksize,
             src.locateROI( wsz, ofs );
         borderType = (borderType&~BORDER_ISOLATED);
 
-        const size_t STRIPE_SIZE = 1 << 14;
-        Ptr<FilterEngine> fx = createSeparableLinearFilter(stype,
-            wtype, kd, ks, Point(-1,-1), 0, borderType, borderType, Scalar() );
-        Ptr<FilterEngine> fy = createSeparableLinearFilter(stype,
-            wtype, ks, kd, Point(-1,-1), 0, borderType, borderType, Scalar() );
-
-        int y = fx->start(src, wsz, ofs), dsty = 0, dy = 0;
-        fy->start(src, wsz, ofs);
-        const uchar* sptr = src.ptr() + src.step[0] * y;
-
-        int dy0 = std::min(std::max((int)(STRIPE_SIZE/(CV_ELEM_SIZE(stype)*src.cols)), 1), src.rows);
-        Mat d2x( dy0 + kd.rows - 1, src.cols, wtype );
-        Mat d2y( dy0 + kd.rows - 1, src.cols, wtype );
-
-        for( ; dsty < src.rows; sptr += dy0*src.step, dsty += dy )
-        {
-            fx->proceed( sptr, (int)src.step, dy0, d2x.ptr(), (int)d2x.step );
-            dy = fy->proceed( sptr, (int)src.step, dy0, d2y.ptr(), (int)d2y.step );
-            if( dy > 0 )
-            {
-                Mat dstripe = dst.rowRange(dsty, dsty + dy);
-                d2x.rows = d2y.rows = dy; // modify the headers, which should work
-                d2x += d2y;
-                d2x.convertTo( dstripe, ddepth, scale, delta );
-            }
-        }
+        LaplacianInvoker invoker(src, dst, wsz, ofs, kd, ks, wtype, scale, delta, borderType);
+        int nbands = getFilterBandCount(src, dst, wsz, ofs, ksize);
+        if( nbands > 1 )
+            parallel_for_(Range(0, src.rows), invoker, nbands);
+        else
+            invoker(Range(0, src.rows));
     }
 }
 
@@ -0,0 +1,2213 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "opencv2/core/hal/intrin.hpp"
+
+#if IPP_VERSION_X100 >= 710
+#define USE_IPP_SEP_FILTERS 1
+#else
+#undef USE_IPP_SEP_FILTERS
+#endif
+
+/****************************************************************************************\
+                                    Linear Filter Kernels
+\****************************************************************************************/
+
+namespace cv {
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+// forward declarations
+Ptr<BaseRowFilter> getLinearRowFilter(int srcType, int bufType, const Mat& kernel, int anchor,
+                                      int symmetryType);
+Ptr<BaseColumnFilter> getLinearColumnFilter(int bufType, int dstType, const Mat& kernel, int anchor,
+                                            int symmetryType, double delta, int bits);
+Ptr<BaseFilter> getLinearFilter(int srcType, int dstType, const Mat& kernel, Point anchor,
+                                double delta, int bits);
+
+#ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+namespace {
+
+struct RowNoVec
+{
+    RowNoVec() {}
+    RowNoVec(const Mat&) {}
+    int operator()(const uchar*, uchar*, int, int) const { return 0; }
+};
+
+struct ColumnNoVec
+{
+    ColumnNoVec() {}
+    ColumnNoVec(const Mat&, int, int, double) {}
+    int operator()(const uchar**, uchar*, int) const { return 0; }
+};
+
+struct SymmRowSmallNoVec
+{
+    SymmRowSmallNoVec() {}
+    SymmRowSmallNoVec(const Mat&, int) {}
+    int operator()(const uchar*, uchar*, int, int) const { return 0; }
+};
+
+struct SymmColumnSmallNoVec
+{
+    SymmColumnSmallNoVec() {}
+    SymmColumnSmallNoVec(const Mat&, int, int, double) {}
+    int operator()(const uchar**, uchar*, int) const { return 0; }
+};
+
+struct FilterNoVec
+{
+    FilterNoVec() {}
+    FilterNoVec(const Mat&, int, double) {}
+    int operator()(const uchar**, uchar*, int) const { return 0; }
+};
+
+
+#if CV_SIMD128
+
+///////////////////////////////////// 8u-16s & 8u-8u //////////////////////////////////
+
+struct RowVec_8u32s
+{
+    RowVec_8u32s() { smallValues = false; }
+    RowVec_8u32s( const Mat& _kernel )
+    {
+        kernel = _kernel;
+        smallValues = true;
+        int k, ksize = kernel.rows + kernel.cols - 1;
+        for( k = 0; k < ksize; k++ )
+        {
+            int v = kernel.ptr<int>()[k];
+            if( v < SHRT_MIN || v > SHRT_MAX )
+            {
+                smallValues = false;
+                break;
+            }
+        }
+    }
+
+    int operator()(const uchar* _src, uchar* _dst, int width, int cn) const
+    {
+        int i = 0, k, _ksize = kernel.rows + kernel.cols - 1;
+        int* dst = (int*)_dst;
+        const int* _kx = kernel.ptr<int>();
+        width *= cn;
+
+        if( smallValues )
+        {
+            // each 32-bit lane holds a zero-extended pixel, so the 16x16->32 dot
+            // product of (x, 0) and (k, *) pairs gives x*k without widening multiplies
+            for( ; i <= width - 8; i += 8 )
+            {
+                const uchar* src = _src + i;
+                v_int32x4 s0 = v_setzero_s32(), s1 = v_setzero_s32();
+
+                for( k = 0; k < _ksize; k++, src += cn )
+                {
+                    v_int16x8 f = v_reinterpret_as_s16(v_setall_s32(_kx[k]));
+                    v_uint32x4 x0, x1;
+                    v_expand(v_load_expand(src), x0, x1);
+                    s0 += v_dotprod(v_reinterpret_as_s16(x0), f);
+                    s1 += v_dotprod(v_reinterpret_as_s16(x1), f);
+                }
+
+                v_store(dst + i, s0);
+                v_store(dst + i + 4, s1);
+            }
+
+            if( i <= width - 4 )
+            {
+                const uchar* src = _src + i;
+                v_int32x4 s0 = v_setzero_s32();
+
+                for( k = 0; k < _ksize; k++, src += cn )
+                {
+                    v_int16x8 f = v_reinterpret_as_s16(v_setall_s32(_kx[k]));
+                    s0 += v_dotprod(v_reinterpret_as_s16(v_load_expand_q(src)), f);
+                }
+                v_store(dst + i, s0);
+                i += 4;
+            }
+        }
+        return i;
+    }
+
+    Mat kernel;
+    bool smallValues;
+};
+
+
+struct SymmColumnVec_32s8u
+{
+    SymmColumnVec_32s8u() { symmetryType=0; delta = 0; }
+    SymmColumnVec_32s8u(const Mat& _kernel, int _symmetryType, int _bits, double _delta)
+    {
+        symmetryType = _symmetryType;
+        _kernel.convertTo(kernel, CV_32F, 1./(1 << _bits), 0);
+        delta = (float)(_delta/(1 << _bits));
+        CV_Assert( (symmetryType & (KERNEL_SYMMETRICAL | KERNEL_ASYMMETRICAL)) != 0 );
+    }
+
+    int operator()(const uchar** _src, uchar* dst, int width) const
+    {
+        int ksize2 = (kernel.rows + kernel.cols - 1)/2;
+        const float* ky = kernel.ptr<float>() + ksize2;
+        int i = 0, k;
+        bool symmetrical = (symmetryType & KERNEL_SYMMETRICAL) != 0;
+        const int** src = (const int**)_src;
+        const int *S, *S2;
+        v_float32x4 d4 = v_setall_f32(delta);
+
+        if( symmetrical )
+        {
+            for( ; i <= width - 16; i += 16 )
+            {
+                v_float32x4 f = v_setall_f32(ky[0]);
+                S = src[0] + i;
+                v_float32x4 s0 = v_cvt_f32(v_load(S)) * f + d4;
+                v_float32x4 s1 = v_cvt_f32(v_load(S + 4)) * f + d4;
+                v_float32x4 s2 = v_cvt_f32(v_load(S + 8)) * f + d4;
+                v_float32x4 s3 = v_cvt_f32(v_load(S + 12)) * f + d4;
+
+                for( k = 1; k <= ksize2; k++ )
+                {
+                    S = src[k] + i;
+                    S2 = src[-k] + i;
+                    f = v_setall_f32(ky[k]);
+                    s0 += v_cvt_f32(v_load(S) + v_load(S2)) * f;
+                    s1 += v_cvt_f32(v_load(S + 4) + v_load(S2 + 4)) * f;
+                    s2 += v_cvt_f32(v_load(S + 8) + v_load(S2 + 8)) * f;
+                    s3 += v_cvt_f32(v_load(S + 12) + v_load(S2 + 12)) * f;
+                }
+
+                v_store(dst + i, v_pack_u(v_pack(v_round(s0), v_round(s1)),
+                                          v_pack(v_round(s2), v_round(s3))));
+            }
+
+            for( ; i <= width - 4; i += 4 )
+            {
+                v_float32x4 s0 = v_cvt_f32(v_load(src[0] + i)) * v_setall_f32(ky[0]) + d4;
+
+                for( k = 1; k <= ksize2; k++ )
+                    s0 += v_cvt_f32(v_load(src[k] + i) + v_load(src[-k] + i)) * v_setall_f32(ky[k]);
+
+                v_int16x8 x0 = v_pack(v_round(s0), v_round(s0));
+                *(int*)(dst + i) = v_reinterpret_as_s32(v_pack_u(x0, x0)).get0();
+            }
+        }
+        else
+        {
+            for( ; i <= width - 16; i += 16 )
+            {
+                v_float32x4 s0 = d4, s1 = d4, s2 = d4, s3 = d4;
+
+                for( k = 1; k <= ksize2; k++ )
+                {
+                    S = src[k] + i;
+                    S2 = src[-k] + i;
+                    v_float32x4 f = v_setall_f32(ky[k]);
+                    s0 += v_cvt_f32(v_load(S) - v_load(S2)) * f;
+                    s1 += v_cvt_f32(v_load(S + 4) - v_load(S2 + 4)) * f;
+                    s2 += v_cvt_f32(v_load(S + 8) - v_load(S2 + 8)) * f;
+                    s3 += v_cvt_f32(v_load(S + 12) - v_load(S2 + 12)) * f;
+                }
+
+                v_store(dst + i, v_pack_u(v_pack(v_round(s0), v_round(s1)),
+                                          v_pack(v_round(s2), v_round(s3))));
+            }
+
+            for( ; i <= width - 4; i += 4 )
+            {
+                v_float32x4 s0 = d4;
+
+                for( k = 1; k <= ksize2; k++ )
+                    s0 += v_cvt_f32(v_load(src[k] + i) - v_load(src[-k] + i)) * v_setall_f32(ky[k]);
+
+                v_int16x8 x0 = v_pack(v_round(s0), v_round(s0));
+                *(int*)(dst + i) = v_reinterpret_as_s32(v_pack_u(x0, x0)).get0();
+            }
+        }
+
+        return i;
+    }
+
+    int symmetryType;
+    float delta;
+    Mat kernel;
+};
+
+// 16 uchar -> 2 x 8 short
+static inline void v_load_expand_s16x2(const uchar* ptr, v_int16x8& a, v_int16x8& b)
+{
+    v_uint16x8 x0, x1;
+    v_expand(v_load(ptr), x0, x1);
+    a = v_reinterpret_as_s16(x0);
+    b = v_reinterpret_as_s16(x1);
+}
+
+// 8 short -> 8 int
+static inline void v_store_expand_s32(int* ptr, const v_int16x8& a)
+{
+    v_int32x4 x0, x1;
+    v_expand(a, x0, x1);
+    v_store(ptr, x0);
+    v_store(ptr + 4, x1);
+}
+
+struct SymmRowSmallVec_8u32s
+{
+    SymmRowSmallVec_8u32s() { smallValues = false; symmetryType = 0; }
+    SymmRowSmallVec_8u32s( const Mat& _kernel, int _symmetryType )
+    {
+        kernel = _kernel;
+        symmetryType = _symmetryType;
+        smallValues = true;
+        int k, ksize = kernel.rows + kernel.cols - 1;
+        for( k = 0; k < ksize; k++ )
+        {
+            int v = kernel.ptr<int>()[k];
+            if( v < SHRT_MIN || v > SHRT_MAX )
+            {
+                smallValues = false;
+                break;
+            }
+        }
+    }
+
+    int operator()(const uchar* src, uchar* _dst, int width, int cn) const
+    {
+        int i = 0, j, k, _ksize = kernel.rows + kernel.cols - 1;
+        int* dst = (int*)_dst;
+        bool symmetrical = (symmetryType & KERNEL_SYMMETRICAL) != 0;
+        const int* kx = kernel.ptr<int>() + _ksize/2;
+        if( !smallValues )
+            return 0;
+
+        src += (_ksize/2)*cn;
+        width *= cn;
+
+        // the generic branches interleave the pixels that share a coefficient,
+        // so a single 16x16->32 dot product gives k*(a + b) or k1*a + k2*b
+        v_int16x8 z = v_setzero_s16(), t0, t1;
+        if( symmetrical )
+        {
+            if( _ksize == 1 )
+                return 0;
+            if( _ksize == 3 )
+            {
+                if( kx[0] == 2 && kx[1] == 1 )
+                    for( ; i <= width - 16; i += 16, src += 16 )
+                    {
+                        v_int16x8 x0, x1, x2, y0, y1, y2;
+                        v_load_expand_s16x2(src - cn, x0, y0);
+                        v_load_expand_s16x2(src, x1, y1);
+                        v_load_expand_s16x2(src + cn, x2, y2);
+                        v_store_expand_s32(dst + i, x0 + x1 + x1 + x2);
+                        v_store_expand_s32(dst + i + 8, y0 + y1 + y1 + y2);
+                    }
+                else if( kx[0] == -2 && kx[1] == 1 )
+                    for( ; i <= width - 16; i += 16, src += 16 )
+                    {
+                        v_int16x8 x0, x1, x2, y0, y1, y2;
+                        v_load_expand_s16x2(src - cn, x0, y0);
+                        v_load_expand_s16x2(src, x1, y1);
+                        v_load_expand_s16x2(src + cn, x2, y2);
+                        v_store_expand_s32(dst + i, x0 + x2 - x1 - x1);
+                        v_store_expand_s32(dst + i + 8, y0 + y2 - y1 - y1);
+                    }
+                else
+                {
+                    v_int16x8 k0 = v_setall_s16((short)kx[0]), k1 = v_setall_s16((short)kx[1]);
+                    for( ; i <= width - 8; i += 8, src += 8 )
+                    {
+                        v_int16x8 x0 = v_reinterpret_as_s16(v_load_expand(src - cn));
+                        v_int16x8 x1 = v_reinterpret_as_s16(v_load_expand(src));
+                        v_int16x8 x2 = v_reinterpret_as_s16(v_load_expand(src + cn));
+                        v_int32x4 s0, s1;
+
+                        v_zip(x0, x2, t0, t1);
+                        s0 = v_dotprod(t0, k1);
+                        s1 = v_dotprod(t1, k1);
+                        v_zip(x1, z, t0, t1);
+                        s0 += v_dotprod(t0, k0);
+                        s1 += v_dotprod(t1, k0);
+
+                        v_store(dst + i, s0);
+                        v_store(dst + i + 4, s1);
+                    }
+                }
+            }
+            else if( _ksize == 5 )
+            {
+                if( kx[0] == -2 && kx[1] == 0 && kx[2] == 1 )
+                    for( ; i <= width - 16; i += 16, src += 16 )
+                    {
+                        v_int16x8 x0, x1, x2, y0, y1, y2;
+                        v_load_expand_s16x2(src - cn*2, x0, y0);
+                        v_load_expand_s16x2(src, x1, y1);
+                        v_load_expand_s16x2(src + cn*2, x2, y2);
+                        v_store_expand_s32(dst + i, x0 + x2 - x1 - x1);
+                        v_store_expand_s32(dst + i + 8, y0 + y2 - y1 - y1);
+                    }
+                else
+                {
+                    v_int16x8 k0 = v_setall_s16((short)kx[0]),
+                              k1 = v_setall_s16((short)kx[1]),
+                              k2 = v_setall_s16((short)kx[2]);
+                    for( ; i <= width - 8; i += 8, src += 8 )
+                    {
+                        v_int32x4 s0, s1;
+
+                        v_zip(v_reinterpret_as_s16(v_load_expand(src)), z, t0, t1);
+                        s0 = v_dotprod(t0, k0);
+                        s1 = v_dotprod(t1, k0);
+                        v_zip(v_reinterpret_as_s16(v_load_expand(src - cn)),
+                              v_reinterpret_as_s16(v_load_expand(src + cn)), t0, t1);
+                        s0 += v_dotprod(t0, k1);
+                        s1 += v_dotprod(t1, k1);
+                        v_zip(v_reinterpret_as_s16(v_load_expand(src - cn*2)),
+                              v_reinterpret_as_s16(v_load_expand(src + cn*2)), t0, t1);
+                        s0 += v_dotprod(t0, k2);
+                        s1 += v_dotprod(t1, k2);
+
+                        v_store(dst + i, s0);
+                        v_store(dst + i + 4, s1);
+                    }
+                }
+            }
+        }
+        else
+        {
+            if( _ksize == 3 )
+            {
+                if( kx[0] == 0 && kx[1] == 1 )
+                    for( ; i <= width - 16; i += 16, src += 16 )
+                    {
+                        v_int16x8 x0, x1, y0, y1;
+                        v_load_expand_s16x2(src + cn, x0, y0);
+                        v_load_expand_s16x2(src - cn, x1, y1);
+                        v_store_expand_s32(dst + i, x0 - x1);
+                        v_store_expand_s32(dst + i + 8, y0 - y1);
+                    }
+                else
+                {
+                    short k1 = (short)kx[1], nk1 = saturate_cast<short>(-kx[1]);
+                    v_int16x8 k0(k1, nk1, k1, nk1, k1, nk1, k1, nk1);
+                    for( ; i <= width - 16; i += 16, src += 16 )
+                    {
+                        v_int16x8 x0, x1, y0, y1;
+                        v_load_expand_s16x2(src + cn, x0, y0);
+                        v_load_expand_s16x2(src - cn, x1, y1);
+
+                        v_zip(x0, x1, t0, t1);
+                        v_store(dst + i, v_dotprod(t0, k0));
+                        v_store(dst + i + 4, v_dotprod(t1, k0));
+                        v_zip(y0, y1, t0, t1);
+                        v_store(dst + i + 8, v_dotprod(t0, k0));
+                        v_store(dst + i + 12, v_dotprod(t1, k0));
+                    }
+                }
+            }
+            else if( _ksize == 5 )
+            {
+                short k1 = (short)kx[1], k2 = (short)kx[2];
+                v_int16x8 k0(k1, k2, k1, k2, k1, k2, k1, k2);
+                for( ; i <= width - 16; i += 16, src += 16 )
+                {
+                    v_int16x8 x0, x1, y0, y1, x2, x3, y2, y3;
+                    v_load_expand_s16x2(src + cn, x0, y0);
+                    v_load_expand_s16x2(src - cn, x1, y1);
+                    v_load_expand_s16x2(src + cn*2, x2, y2);
+                    v_load_expand_s16x2(src - cn*2, x3, y3);
+
+                    v_zip(x0 - x1, x2 - x3, t0, t1);
+                    v_store(dst + i, v_dotprod(t0, k0));
+                    v_store(dst + i + 4, v_dotprod(t1, k0));
+                    v_zip(y0 - y1, y2 - y3, t0, t1);
+                    v_store(dst + i + 8, v_dotprod(t0, k0));
+                    v_store(dst + i + 12, v_dotprod(t1, k0));
+                }
+            }
+        }
+
+        src -= (_ksize/2)*cn;
+        kx -= _ksize/2;
+        for( ; i <= width - 4; i += 4, src += 4 )
+        {
+            v_int32x4 s0 = v_setzero_s32();
+
+            for( k = j = 0; k < _ksize; k++, j += cn )
+                s0 += v_dotprod(v_reinterpret_as_s16(v_load_expand_q(src + j)),
+                                v_reinterpret_as_s16(v_setall_s32(kx[k])));
+            v_store(dst + i, s0);
+        }
+
+        return i;
+    }
+
+    Mat kernel;
+    int symmetryType;
+    bool smallValues;
+};
+
+
+struct SymmColumnSmallVec_32s16s
+{
+    SymmColumnSmallVec_32s16s() { symmetryType=0; delta = 0; }
+    SymmColumnSmallVec_32s16s(const Mat& _kernel, int _symmetryType, int _bits, double _delta)
+    {
+        symmetryType = _symmetryType;
+        _kernel.convertTo(kernel, CV_32F, 1./(1 << _bits), 0);
+        delta = (float)(_delta/(1 << _bits));
+        CV_Assert( (symmetryType & (KERNEL_SYMMETRICAL | KERNEL_ASYMMETRICAL)) != 0 );
+    }
+
+    int operator()(const uchar** _src, uchar* _dst, int width) const
+    {
+        int ksize2 = (kernel.rows + kernel.cols - 1)/2;
+        const float* ky = kernel.ptr<float>() + ksize2;
+        int i = 0;
+        bool symmetrical = (symmetryType & KERNEL_SYMMETRICAL) != 0;
+        const int** src = (const int**)_src;
+        const int *S0 = src[-1], *S1 = src[0], *S2 = src[1];
+        short* dst = (short*)_dst;
+        v_float32x4 df4 = v_setall_f32(delta);
+        v_int32x4 d4 = v_round(df4);
+
+        if( symmetrical )
+        {
+            if( ky[0] == 2 && ky[1] == 1 )
+            {
+                for( ; i <= width - 8; i += 8 )
+                {
+                    v_int32x4 s0 = v_load(S0 + i) + v_load(S2 + i) + v_load(S1 + i) + v_load(S1 + i) + d4;
+                    v_int32x4 s1 = v_load(S0 + i + 4) + v_load(S2 + i + 4) +
+                                   v_load(S1 + i + 4) + v_load(S1 + i + 4) + d4;
+                    v_store(dst + i, v_pack(s0, s1));
+                }
+            }
+            else if( ky[0] == -2 && ky[1] == 1 )
+            {
+                for( ; i <= width - 8; i += 8 )
+                {
+                    v_int32x4 s0 = v_load(S0 + i) + v_load(S2 + i) - v_load(S1 + i) - v_load(S1 + i) + d4;
+                    v_int32x4 s1 = v_load(S0 + i + 4) + v_load(S2 + i + 4) -
+                                   v_load(S1 + i + 4) - v_load(S1 + i + 4) + d4;
+                    v_store(dst + i, v_pack(s0, s1));
+                }
+            }
+            else
+            {
+                v_float32x4 k0 = v_setall_f32(ky[0]), k1 = v_setall_f32(ky[1]);
+                for( ; i <= width - 8; i += 8 )
+                {
+                    v_float32x4 s0 = v_cvt_f32(v_load(S1 + i)) * k0 + df4;
+                    v_float32x4 s1 = v_cvt_f32(v_load(S1 + i + 4)) * k0 + df4;
+                    s0 += v_cvt_f32(v_load(S0 + i) + v_load(S2 + i)) * k1;
+                    s1 += v_cvt_f32(v_load(S0 + i + 4) + v_load(S2 + i + 4)) * k1;
+                    v_store(dst + i, v_pack(v_round(s0), v_round(s1)));
+                }
+            }
+        }
+        else
+        {
+            if( fabs(ky[1]) == 1 && ky[1] == -ky[-1] )
+            {
+                if( ky[1] < 0 )
+                    std::swap(S0, S2);
+                for( ; i <= width - 8; i += 8 )
+                {
+                    v_int32x4 s0 = v_load(S2 + i) - v_load(S0 + i) + d4;
+                    v_int32x4 s1 = v_load(S2 + i + 4) - v_load(S0 + i + 4) + d4;
+                    v_store(dst + i, v_pack(s0, s1));
+                }
+            }
+            else
+            {
+                v_float32x4 k1 = v_setall_f32(ky[1]);
+                for( ; i <= width - 8; i += 8 )
+                {
+                    v_float32x4 s0 = df4 + v_cvt_f32(v_load(S2 + i) - v_load(S0 + i)) * k1;
+                    v_float32x4 s1 = df4 + v_cvt_f32(v_load(S2 + i + 4) - v_load(S0 + i + 4)) * k1;
+                    v_store(dst + i, v_pack(v_round(s0), v_round(s1)));
+                }
+            }
+        }
+
+        return i;
+    }
+
+    int symmetryType;
+    float delta;
+    Mat kernel;
+};
+
+
+/////////////////////////////////////// 16s //////////////////////////////////
+
+struct RowVec_16s32f
+{
+    RowVec_16s32f() {}
+    RowVec_16s32f( const Mat& _kernel )
+    {
+        kernel = _kernel;
+    }
+
+    int operator()(const uchar* _src, uchar* _dst, int width, int cn) const
+    {
+        int i = 0, k, _ksize = kernel.rows + kernel.cols - 1;
+        float* dst = (float*)_dst;
+        const float* _kx = kernel.ptr<float>();
+        width *= cn;
+
+        for( ; i <= width - 8; i += 8 )
+        {
+            const short* src = (const short*)_src + i;
+            v_float32x4 s0 = v_setzero_f32(), s1 = v_setzero_f32();
+            for( k = 0; k < _ksize; k++, src += cn )
+            {
+                v_float32x4 f = v_setall_f32(_kx[k]);
+                v_int32x4 x0, x1;
+                v_expand(v_load(src), x0, x1);
+                s0 += v_cvt_f32(x0) * f;
+                s1 += v_cvt_f32(x1) * f;
+            }
+            v_store(dst + i, s0);
+            v_store(dst + i + 4, s1);
+        }
+        return i;
+    }
+
+    Mat kernel;
+};
+
+
+struct SymmColumnVec_32f16s
+{
+    SymmColumnVec_32f16s() { symmetryType=0; delta = 0; }
+    SymmColumnVec_32f16s(const Mat& _kernel, int _symmetryType, int, double _delta)
+    {
+        symmetryType = _symmetryType;
+        kernel = _kernel;
+        delta = (float)_delta;
+        CV_Assert( (symmetryType & (KERNEL_SYMMETRICAL | KERNEL_ASYMMETRICAL)) != 0 );
+    }
+
+    int operator()(const uchar** _src, uchar* _dst, int width) const
+    {
+        int ksize2 = (kernel.rows + kernel.cols - 1)/2;
+        const float* ky = kernel.ptr<float>() + ksize2;
+        int i = 0, k;
+        bool symmetrical = (symmetryType & KERNEL_SYMMETRICAL) != 0;
+        const float** src = (const float**)_src;
+        const float *S, *S2;
+        short* dst = (short*)_dst;
+        v_float32x4 d4 = v_setall_f32(delta);
+
+        if( symmetrical )
+        {
+            for( ; i <= width - 16; i += 16 )
+            {
+                v_float32x4 f = v_setall_f32(ky[0]);
+                S = src[0] + i;
+                v_float32x4 s0 = v_load(S) * f + d4;
+                v_float32x4 s1 = v_load(S + 4) * f + d4;
+                v_float32x4 s2 = v_load(S + 8) * f + d4;
+                v_float32x4 s3 = v_load(S + 12) * f + d4;
+
+                for( k = 1; k <= ksize2; k++ )
+                {
+                    S = src[k] + i;
+                    S2 = src[-k] + i;
+                    f = v_setall_f32(ky[k]);
+                    s0 += (v_load(S) + v_load(S2)) * f;
+                    s1 += (v_load(S + 4) + v_load(S2 + 4)) * f;
+                    s2 += (v_load(S + 8) + v_load(S2 + 8)) * f;
+                    s3 += (v_load(S + 12) + v_load(S2 + 12)) * f;
+                }
+
+                v_store(dst + i, v_pack(v_round(s0), v_round(s1)));
+                v_store(dst + i + 8, v_pack(v_round(s2), v_round(s3)));
+            }
+
+            for( ; i <= width - 4; i += 4 )
+            {
+                v_float32x4 s0 = v_load(src[0] + i) * v_setall_f32(ky[0]) + d4;
+
+                for( k = 1; k <= ksize2; k++ )
+                    s0 += (v_load(src[k] + i) + v_load(src[-k] + i)) * v_setall_f32(ky[k]);
+
+                v_int32x4 s0i = v_round(s0);
+                v_store_low(dst + i, v_pack(s0i, s0i));
+            }
+        }
+        else
+        {
+            for( ; i <= width - 16; i += 16 )
+            {
+                v_float32x4 s0 = d4, s1 = d4, s2 = d4, s3 = d4;
+
+                for( k = 1; k <= ksize2; k++ )
+                {
+                    S = src[k] + i;
+                    S2 = src[-k] + i;
+                    v_float32x4 f = v_setall_f32(ky[k]);
+                    s0 += (v_load(S) - v_load(S2)) * f;
+                    s1 += (v_load(S + 4) - v_load(S2 + 4)) * f;
+                    s2 += (v_load(S + 8) - v_load(S2 + 8)) * f;
+                    s3 += (v_load(S + 12) - v_load(S2 + 12)) * f;
+                }
+
+                v_store(dst + i, v_pack(v_round(s0), v_round(s1)));
+                v_store(dst + i + 8, v_pack(v_round(s2), v_round(s3)));
+            }
+
+            for( ; i <= width - 4; i += 4 )
+            {
+                v_float32x4 s0 = d4;
+
+                for( k = 1; k <= ksize2; k++ )
+                    s0 += (v_load(src[k] + i) - v_load(src[-k] + i)) * v_setall_f32(ky[k]);
+
+                v_int32x4 s0i = v_round(s0);
+                v_store_low(dst + i, v_pack(s0i, s0i));
+            }
+        }
+
+        return i;
+    }
+
+    int symmetryType;
+    float delta;
+    Mat kernel;
+};
+
+
+/////////////////////////////////////// 32f //////////////////////////////////
+
+struct RowVec_32f
+{
+    RowVec_32f()
+    {
+#if defined USE_IPP_SEP_FILTERS
+        bufsz = -1;
+#endif
+    }
+
+    RowVec_32f( const Mat& _kernel )
+    {
+        kernel = _kernel;
+#if defined USE_IPP_SEP_FILTERS
+        bufsz = -1;
+#endif
+    }
+
+    int operator()(const uchar* _src, uchar* _dst, int width, int cn) const
+    {
+#if defined USE_IPP_SEP_FILTERS
+        CV_IPP_CHECK()
+        {
+            int ret = ippiOperator(_src, _dst, width, cn);
+            if (ret > 0)
+                return ret;
+        }
+#endif
+        int _ksize = kernel.rows + kernel.cols - 1;
+        const float* src0 = (const float*)_src;
+        float* dst = (float*)_dst;
+        const float* _kx = kernel.ptr<float>();
+
+        int i = 0, k;
+        width *= cn;
+
+#if CV_AVX2
+        for( ; i <= width - 8; i += 8 )
+        {
+            const float* src = src0 + i;
+            __m256 s0 = _mm256_setzero_ps();
+            for( k = 0; k < _ksize; k++, src += cn )
+            {
+                __m256 f = _mm256_set1_ps(_kx[k]), x0 = _mm256_loadu_ps(src);
+#if CV_FMA3
+                s0 = _mm256_fmadd_ps(x0, f, s0);
+#else
+                s0 = _mm256_add_ps(s0, _mm256_mul_ps(x0, f));
+#endif
+            }
+            _mm256_storeu_ps(dst + i, s0);
+        }
+#endif
+        for( ; i <= width - 8; i += 8 )
+        {
+            const float* src = src0 + i;
+            v_float32x4 s0 = v_setzero_f32(), s1 = v_setzero_f32();
+            for( k = 0; k < _ksize; k++, src += cn )
+            {
+                v_float32x4 f = v_setall_f32(_kx[k]);
+                s0 += v_load(src) * f;
+                s1 += v_load(src + 4) * f;
+            }
+            v_store(dst + i, s0);
+            v_store(dst + i + 4, s1);
+        }
+        return i;
+    }
+
+    Mat kernel;
+#if defined USE_IPP_SEP_FILTERS
+private:
+    mutable int bufsz;
+    int ippiOperator(const uchar* _src, uchar* _dst, int width, int cn) const
+    {
+        CV_INSTRUMENT_REGION_IPP()
+
+        int _ksize = kernel.rows + kernel.cols - 1;
+        if ((1 != cn && 3 != cn) || width < _ksize*8)
+            return 0;
+
+        const float* src = (const float*)_src;
+        float* dst = (float*)_dst;
+        const float* _kx = (const float*)kernel.data;
+
+        IppiSize roisz = { width, 1 };
+        if( bufsz < 0 )
+        {
+            if( (cn == 1 && ippiFilterRowBorderPipelineGetBufferSize_32f_C1R(roisz, _ksize, &bufsz) < 0) ||
+                (cn == 3 && ippiFilterRowBorderPipelineGetBufferSize_32f_C3R(roisz, _ksize, &bufsz) < 0))
+                return 0;
+        }
+        AutoBuffer<uchar> buf(bufsz + 64);
+        uchar* bufptr = alignPtr((uchar*)buf, 32);
+        int step = (int)(width*sizeof(dst[0])*cn);
+        float borderValue[] = {0.f, 0.f, 0.f};
+        // here is the trick. IPP needs border type and extrapolates the row. We did it already.
+        // So we pass anchor=0 and ignore the right tail of results since they are incorrect there.
+        if( (cn == 1 && CV_INSTRUMENT_FUN_IPP(ippiFilterRowBorderPipeline_32f_C1R, src, step, &dst, roisz, _kx, _ksize, 0,
+                                                            ippBorderRepl, borderValue[0], bufptr) < 0) ||
+            (cn == 3 && CV_INSTRUMENT_FUN_IPP(ippiFilterRowBorderPipeline_32f_C3R, src, step, &dst, roisz, _kx, _ksize, 0,
+                                                            ippBorderRepl, borderValue, bufptr) < 0))
+        {
+            setIppErrorStatus();
+            return 0;
+        }
+        CV_IMPL_ADD(CV_IMPL_IPP);
+        return width - _ksize + 1;
+    }
+#endif
+};
+
+
+struct SymmRowSmallVec_32f
+{
+    SymmRowSmallVec_32f() { symmetryType = 0; }
+    SymmRowSmallVec_32f( const Mat& _kernel, int _symmetryType )
+    {
+        kernel = _kernel;
+        symmetryType = _symmetryType;
+    }
+
+    int operator()(const uchar* _src, uchar* _dst, int width, int cn) const
+    {
+        int i = 0, _ksize = kernel.rows + kernel.cols - 1;
+        float* dst = (float*)_dst;
+        const float* src = (const float*)_src + (_ksize/2)*cn;
+        bool symmetrical = (symmetryType & KERNEL_SYMMETRICAL) != 0;
+        const float* kx = kernel.ptr<float>() + _ksize/2;
+        width *= cn;
+
+        if( symmetrical )
+        {
+            if( _ksize == 1 )
+                return 0;
+            if( _ksize == 3 )
+            {
+                if( kx[0] == 2 && kx[1] == 1 )
+                    for( ; i <= width - 8; i += 8, src += 8 )
+                    {
+                        v_float32x4 x1 = v_load(src), y1 = v_load(src + 4);
+                        v_store(dst + i, v_load(src - cn) + (x1 + x1 + v_load(src + cn)));
+                        v_store(dst + i + 4, v_load(src - cn + 4) + (y1 + y1 + v_load(src + cn + 4)));
+                    }
+                else if( kx[0] == -2 && kx[1] == 1 )
+                    for( ; i <= width - 8; i += 8, src += 8 )
+                    {
+                        v_float32x4 x1 = v_load(src), y1 = v_load(src + 4);
+                        v_store(dst + i, v_load(src - cn) + (v_load(src + cn) - (x1 + x1)));
+                        v_store(dst + i + 4, v_load(src - cn + 4) + (v_load(src + cn + 4) - (y1 + y1)));
+                    }
+                else
+                {
+                    v_float32x4 k0 = v_setall_f32(kx[0]), k1 = v_setall_f32(kx[1]);
+                    for( ; i <= width - 8; i += 8, src += 8 )
+                    {
+                        v_store(dst + i, (v_load(src - cn) + v_load(src + cn)) * k1 + v_load(src) * k0);
+                        v_store(dst + i + 4, (v_load(src - cn + 4) + v_load(src + cn + 4)) * k1 +
+                                             v_load(src + 4) * k0);
+                    }
+                }
+            }
+            else if( _ksize == 5 )
+            {
+                if( kx[0] == -2 && kx[1] == 0 && kx[2] == 1 )
+                    for( ; i <= width - 8; i += 8, src += 8 )
+                    {
+                        v_float32x4 x1 = v_load(src), y1 = v_load(src + 4);
+                        v_store(dst + i, v_load(src - cn*2) + (v_load(src + cn*2) - (x1 + x1)));
+                        v_store(dst + i + 4, v_load(src - cn*2 + 4) + (v_load(src + cn*2 + 4) - (y1 + y1)));
+                    }
+                else
+                {
+                    v_float32x4 k0 = v_setall_f32(kx[0]), k1 = v_setall_f32(kx[1]), k2 = v_setall_f32(kx[2]);
+                    for( ; i <= width - 8; i += 8, src += 8 )
+                    {
+                        v_float32x4 x0 = (v_load(src - cn) + v_load(src + cn)) * k1 + v_load(src) * k0;
+                        v_float32x4 y0 = (v_load(src - cn + 4) + v_load(src + cn + 4)) * k1 + v_load(src + 4) * k0;
+                        x0 += (v_load(src + cn*2) + v_load(src - cn*2)) * k2;
+                        y0 += (v_load(src + cn*2 + 4) + v_load(src - cn*2 + 4)) * k2;
+                        v_store(dst + i, x0);
+                        v_store(dst + i + 4, y0);
+                    }
+                }
+            }
+        }
+        else
+        {
+            if( _ksize == 3 )
+            {
+                if( kx[0] == 0 && kx[1] == 1 )
+                    for( ; i <= width - 8; i += 8, src += 8 )
+                    {
+                        v_store(dst + i, v_load(src + cn) - v_load(src - cn));
+                        v_store(dst + i + 4, v_load(src + cn + 4) - v_load(src - cn + 4));
+                    }
+                else
+                {
+                    v_float32x4 k1 = v_setall_f32(kx[1]);
+                    for( ; i <= width - 8; i += 8, src += 8 )
+                    {
+                        v_store(dst + i, (v_load(src + cn) - v_load(src - cn)) * k1);
+                        v_store(dst + i + 4, (v_load(src + cn + 4) - v_load(src - cn + 4)) * k1);
+                    }
+                }
+            }
+            else if( _ksize == 5 )
+            {
+                v_float32x4 k1 = v_setall_f32(kx[1]), k2 = v_setall_f32(kx[2]);
+                for( ; i <= width - 8; i += 8, src += 8 )
+                {
+                    v_float32x4 x0 = (v_load(src + cn) - v_load(src - cn)) * k1;
+                    v_float32x4 y0 = (v_load(src + cn + 4) - v_load(src - cn + 4)) * k1;
+                    x0 += (v_load(src + cn*2) - v_load(src - cn*2)) * k2;
+                    y0 += (v_load(src + cn*2 + 4) - v_load(src - cn*2 + 4)) * k2;
+                    v_store(dst + i, x0);
+                    v_store(dst + i + 4, y0);
+                }
+            }
+        }
+
+        return i;
+    }
+
+    Mat kernel;
+    int symmetryType;
+};
+
+
+struct SymmColumnVec_32f
+{
+    SymmColumnVec_32f() { symmetryType=0; delta = 0; }
+    SymmColumnVec_32f(const Mat& _kernel, int _symmetryType, int, double _delta)
+    {
+        symmetryType = _symmetryType;
+        kernel = _kernel;
+        delta = (float)_delta;
+        CV_Assert( (symmetryType & (KERNEL_SYMMETRICAL | KERNEL_ASYMMETRICAL)) != 0 );
+    }
+
+    int operator()(const uchar** _src, uchar* _dst, int width) const
+    {
+        int ksize2 = (kernel.rows + kernel.cols - 1)/2;
+        const float* ky = kernel.ptr<float>() + ksize2;
+        int i = 0, k;
+        bool symmetrical = (symmetryType & KERNEL_SYMMETRICAL) != 0;
+        const float** src = (const float**)_src;
+        const float *S, *S2;
+        float* dst = (float*)_dst;
+        v_float32x4 d4 = v_setall_f32(delta);
+
+        if( symmetrical )
+        {
+#if CV_AVX2
+            const __m256 d8 = _mm256_set1_ps(delta);
+            for( ; i <= width - 16; i += 16 )
+            {
+                __m256 f = _mm256_set1_ps(ky[0]);
+                S = src[0] + i;
+#if CV_FMA3
+                __m256 s0 = _mm256_fmadd_ps(_mm256_loadu_ps(S), f, d8);
+                __m256 s1 = _mm256_fmadd_ps(_mm256_loadu_ps(S + 8), f, d8);
+#else
+                __m256 s0 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(S), f), d8);
+                __m256 s1 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(S + 8), f), d8);
+#endif
+
+                for( k = 1; k <= ksize2; k++ )
+                {
+                    S = src[k] + i;
+                    S2 = src[-k] + i;
+                    f = _mm256_set1_ps(ky[k]);
+                    __m256 x0 = _mm256_add_ps(_mm256_loadu_ps(S), _mm256_loadu_ps(S2));
+                    __m256 x1 = _mm256_add_ps(_mm256_loadu_ps(S + 8), _mm256_loadu_ps(S2 + 8));
+#if CV_FMA3
+                    s0 = _mm256_fmadd_ps(x0, f, s0);
+                    s1 = _mm256_fmadd_ps(x1, f, s1);
+#else
+                    s0 = _mm256_add_ps(s0, _mm256_mul_ps(x0, f));
+                    s1 = _mm256_add_ps(s1, _mm256_mul_ps(x1, f));
+#endif
+                }
+
+                _mm256_storeu_ps(dst + i, s0);
+                _mm256_storeu_ps(dst + i + 8, s1);
+            }
+#endif
+            for( ; i <= width - 16; i += 16 )
+            {
+                v_float32x4 f = v_setall_f32(ky[0]);
+                S = src[0] + i;
+                v_float32x4 s0 = v_load(S) * f + d4;
+                v_float32x4 s1 = v_load(S + 4) * f + d4;
+                v_float32x4 s2 = v_load(S + 8) * f + d4;
+                v_float32x4 s3 = v_load(S + 12) * f + d4;
+
+                for( k = 1; k <= ksize2; k++ )
+                {
+                    S = src[k] + i;
+                    S2 = src[-k] + i;
+                    f = v_setall_f32(ky[k]);
+                    s0 += (v_load(S) + v_load(S2)) * f;
+                    s1 += (v_load(S + 4) + v_load(S2 + 4)) * f;
+                    s2 += (v_load(S + 8) + v_load(S2 + 8)) * f;
+                    s3 += (v_load(S + 12) + v_load(S2 + 12)) * f;
+                }
+
+                v_store(dst + i, s0);
+                v_store(dst + i + 4, s1);
+                v_store(dst + i + 8, s2);
+                v_store(dst + i + 12, s3);
+            }
+
+            for( ; i <= width - 4; i += 4 )
+            {
+                v_float32x4 s0 = v_load(src[0] + i) * v_setall_f32(ky[0]) + d4;
+
+                for( k = 1; k <= ksize2; k++ )
+                    s0 += (v_load(src[k] + i) + v_load(src[-k] + i)) * v_setall_f32(ky[k]);
+
+                v_store(dst + i, s0);
+            }
+        }
+        else
+        {
+#if CV_AVX2
+            const __m256 d8 = _mm256_set1_ps(delta);
+            for( ; i <= width - 16; i += 16 )
+            {
+                __m256 s0 = d8, s1 = d8;
+
+                for( k = 1; k <= ksize2; k++ )
+                {
+                    S = src[k] + i;
+                    S2 = src[-k] + i;
+                    __m256 f = _mm256_set1_ps(ky[k]);
+                    __m256 x0 = _mm256_sub_ps(_mm256_loadu_ps(S), _mm256_loadu_ps(S2));
+                    __m256 x1 = _mm256_sub_ps(_mm256_loadu_ps(S + 8), _mm256_loadu_ps(S2 + 8));
+#if CV_FMA3
+                    s0 = _mm256_fmadd_ps(x0, f, s0);
+                    s1 = _mm256_fmadd_ps(x1, f, s1);
+#else
+                    s0 = _mm256_add_ps(s0, _mm256_mul_ps(x0, f));
+                    s1 = _mm256_add_ps(s1, _mm256_mul_ps(x1, f));
+#endif
+                }
+
+                _mm256_storeu_ps(dst + i, s0);
+                _mm256_storeu_ps(dst + i + 8, s1);
+            }
+#endif
+            for( ; i <= width - 16; i += 16 )
+            {
+                v_float32x4 s0 = d4, s1 = d4, s2 = d4, s3 = d4;
+
+                for( k = 1; k <= ksize2; k++ )
+                {
+                    S = src[k] + i;
+                    S2 = src[-k] + i;
+                    v_float32x4 f = v_setall_f32(ky[k]);
+                    s0 += (v_load(S) - v_load(S2)) * f;
+                    s1 += (v_load(S + 4) - v_load(S2 + 4)) * f;
+                    s2 += (v_load(S + 8) - v_load(S2 + 8)) * f;
+                    s3 += (v_load(S + 12) - v_load(S2 + 12)) * f;
+                }
+
+                v_store(dst + i, s0);
+                v_store(dst + i + 4, s1);
+                v_store(dst + i + 8, s2);
+                v_store(dst + i + 12, s3);
+            }
+
+            for( ; i <= width - 4; i += 4 )
+            {
+                v_float32x4 s0 = d4;
+
+                for( k = 1; k <= ksize2; k++ )
+                    s0 += (v_load(src[k] + i) - v_load(src[-k] + i)) * v_setall_f32(ky[k]);
+
+                v_store(dst + i, s0);
+            }
+        }
+
+        return i;
+    }
+
+    int symmetryType;
+    float delta;
+    Mat kernel;
+};
+
+
+struct SymmColumnSmallVec_32f
+{
+    SymmColumnSmallVec_32f() { symmetryType=0; delta = 0; }
+    SymmColumnSmallVec_32f(const Mat& _kernel, int _symmetryType, int, double _delta)
+    {
+        symmetryType = _symmetryType;
+        kernel = _kernel;
+        delta = (float)_delta;
+        CV_Assert( (symmetryType & (KERNEL_SYMMETRICAL | KERNEL_ASYMMETRICAL)) != 0 );
+    }
+
+    int operator()(const uchar** _src, uchar* _dst, int width) const
+    {
+        int ksize2 = (kernel.rows + kernel.cols - 1)/2;
+        const float* ky = kernel.ptr<float>() + ksize2;
+        int i = 0;
+        bool symmetrical = (symmetryType & KERNEL_SYMMETRICAL) != 0;
+        const float** src = (const float**)_src;
+        const float *S0 = src[-1], *S1 = src[0], *S2 = src[1];
+        float* dst = (float*)_dst;
+        v_float32x4 d4 = v_setall_f32(delta);
+
+        if( symmetrical )
+        {
+            if( ky[0] == 2 && ky[1] == 1 )
+            {
+                for( ; i <= width - 8; i += 8 )
+                {
+                    v_float32x4 x1 = v_load(S1 + i), y1 = v_load(S1 + i + 4);
+                    v_store(dst + i, v_load(S0 + i) + (v_load(S2 + i) + (x1 + x1)) + d4);
+                    v_store(dst + i + 4, v_load(S0 + i + 4) + (v_load(S2 + i + 4) + (y1 + y1)) + d4);
+                }
+            }
+            else if( ky[0] == -2 && ky[1] == 1 )
+            {
+                for( ; i <= width - 8; i += 8 )
+                {
+                    v_float32x4 x1 = v_load(S1 + i), y1 = v_load(S1 + i + 4);
+                    v_store(dst + i, v_load(S0 + i) + (v_load(S2 + i) - (x1 + x1)) + d4);
+                    v_store(dst + i + 4, v_load(S0 + i + 4) + (v_load(S2 + i + 4) - (y1 + y1)) + d4);
+                }
+            }
+            else
+            {
+                v_float32x4 k0 = v_setall_f32(ky[0]), k1 = v_setall_f32(ky[1]);
+                for( ; i <= width - 8; i += 8 )
+                {
+                    v_float32x4 s0 = v_load(S1 + i) * k0 + d4;
+                    v_float32x4 s1 = v_load(S1 + i + 4) * k0 + d4;
+                    s0 += (v_load(S0 + i) + v_load(S2 + i)) * k1;
+                    s1 += (v_load(S0 + i + 4) + v_load(S2 + i + 4)) * k1;
+                    v_store(dst + i, s0);
+                    v_store(dst + i + 4, s1);
+                }
+            }
+        }
+        else
+        {
+            if( fabs(ky[1]) == 1 && ky[1] == -ky[-1] )
+            {
+                if( ky[1] < 0 )
+                    std::swap(S0, S2);
+                for( ; i <= width - 8; i += 8 )
+                {
+                    v_store(dst + i, v_load(S2 + i) - v_load(S0 + i) + d4);
+                    v_store(dst + i + 4, v_load(S2 + i + 4) - v_load(S0 + i + 4) + d4);
+                }
+            }
+            else
+            {
+                v_float32x4 k1 = v_setall_f32(ky[1]);
+                for( ; i <= width - 8; i += 8 )
+                {
+                    v_store(dst + i, d4 + (v_load(S2 + i) - v_load(S0 + i)) * k1);
+                    v_store(dst + i + 4, d4 + (v_load(S2 + i + 4) - v_load(S0 + i + 4)) * k1);
+                }
+            }
+        }
+
+        return i;
+    }
+
+    int symmetryType;
+    float delta;
+    Mat kernel;
+};
+
+
+/////////////////////////////// non-separable filters ///////////////////////////////
+
+///////////////////////////////// 8u<->8u, 8u<->16s /////////////////////////////////
+
+// sums 16 pixels of the 8-bit rows weighted by the 2D kernel coefficients
+static inline void filterSum_8u(const uchar** src, const float* kf, int nz, int i, const v_float32x4& d4,
+                                v_float32x4& s0, v_float32x4& s1, v_float32x4& s2, v_float32x4& s3)
+{
+    s0 = s1 = s2 = s3 = d4;
+    for( int k = 0; k < nz; k++ )
+    {
+        v_float32x4 f = v_setall_f32(kf[k]);
+        v_uint16x8 x0, x1;
+        v_uint32x4 t0, t1;
+        v_expand(v_load(src[k] + i), x0, x1);
+
+        v_expand(x0, t0, t1);
+        s0 += v_cvt_f32(v_reinterpret_as_s32(t0)) * f;
+        s1 += v_cvt_f32(v_reinterpret_as_s32(t1)) * f;
+        v_expand(x1, t0, t1);
+        s2 += v_cvt_f32(v_reinterpret_as_s32(t0)) * f;
+        s3 += v_cvt_f32(v_reinterpret_as_s32(t1)) * f;
+    }
+}
+
+static inline v_float32x4 filterSum4_8u(const uchar** src, const float* kf, int nz, int i, const v_float32x4& d4)
+{
+    v_float32x4 s0 = d4;
+    for( int k = 0; k < nz; k++ )
+        s0 += v_cvt_f32(v_reinterpret_as_s32(v_load_expand_q(src[k] + i))) * v_setall_f32(kf[k]);
+    return s0;
+}
+
+struct FilterVec_8u
+{
+    FilterVec_8u() { delta = 0; _nz = 0; }
+    FilterVec_8u(const Mat& _kernel, int _bits, double _delta)
+    {
+        Mat kernel;
+        _kernel.convertTo(kernel, CV_32F, 1./(1 << _bits), 0);
+        delta = (float)(_delta/(1 << _bits));
+        std::vector<Point> coords;
+        preprocess2DKernel(kernel, coords, coeffs);
+        _nz = (int)coords.size();
+    }
+
+    int operator()(const uchar** src, uchar* dst, int width) const
+    {
+        const float* kf = (const float*)&coeffs[0];
+        int i = 0, nz = _nz;
+        v_float32x4 d4 = v_setall_f32(delta), s0, s1, s2, s3;
+
+        for( ; i <= width - 16; i += 16 )
+        {
+            filterSum_8u(src, kf, nz, i, d4, s0, s1, s2, s3);
+            v_store(dst + i, v_pack_u(v_pack(v_round(s0), v_round(s1)),
+                                      v_pack(v_round(s2), v_round(s3))));
+        }
+
+        for( ; i <= width - 4; i += 4 )
+        {
+            v_int32x4 s0i = v_round(filterSum4_8u(src, kf, nz, i, d4));
+            v_int16x8 x0 = v_pack(s0i, s0i);
+            *(int*)(dst + i) = v_reinterpret_as_s32(v_pack_u(x0, x0)).get0();
+        }
+
+        return i;
+    }
+
+    int _nz;
+    std::vector<uchar> coeffs;
+    float delta;
+};
+
+
+struct FilterVec_8u16s
+{
+    FilterVec_8u16s() { delta = 0; _nz = 0; }
+    FilterVec_8u16s(const Mat& _kernel, int _bits, double _delta)
+    {
+        Mat kernel;
+        _kernel.convertTo(kernel, CV_32F, 1./(1 << _bits), 0);
+        delta = (float)(_delta/(1 << _bits));
+        std::vector<Point> coords;
+        preprocess2DKernel(kernel, coords, coeffs);
+        _nz = (int)coords.size();
+    }
+
+    int operator()(const uchar** src, uchar* _dst, int width) const
+    {
+        const float* kf = (const float*)&coeffs[0];
+        short* dst = (short*)_dst;
+        int i = 0, nz = _nz;
+        v_float32x4 d4 = v_setall_f32(delta), s0, s1, s2, s3;
+
+        for( ; i <= width - 16; i += 16 )
+        {
+            filterSum_8u(src, kf, nz, i, d4, s0, s1, s2, s3);
+            v_store(dst + i, v_pack(v_round(s0), v_round(s1)));
+            v_store(dst + i + 8, v_pack(v_round(s2), v_round(s3)));
+        }
+
+        for( ; i <= width - 4; i += 4 )
+        {
+            v_int32x4 s0i = v_round(filterSum4_8u(src, kf, nz, i, d4));
+            v_store_low(dst + i, v_pack(s0i, s0i));
+        }
+
+        return i;
+    }
+
+    int _nz;
+    std::vector<uchar> coeffs;
+    float delta;
+};
+
+
+struct FilterVec_32f
+{
+    FilterVec_32f() { delta = 0; _nz = 0; }
+    FilterVec_32f(const Mat& _kernel, int, double _delta)
+    {
+        delta = (float)_delta;
+        std::vector<Point> coords;
+        preprocess2DKernel(_kernel, coords, coeffs);
+        _nz = (int)coords.size();
+    }
+
+    int operator()(const uchar** _src, uchar* _dst, int width) const
+    {
+        const float* kf = (const float*)&coeffs[0];
+        const float** src = (const float**)_src;
+        float* dst = (float*)_dst;
+        int i = 0, k, nz = _nz;
+        v_float32x4 d4 = v_setall_f32(delta);
+
+        for( ; i <= width - 16; i += 16 )
+        {
+            v_float32x4 s0 = d4, s1 = d4, s2 = d4, s3 = d4;
+
+            for( k = 0; k < nz; k++ )
+            {
+                v_float32x4 f = v_setall_f32(kf[k]);
+                const float* S = src[k] + i;
+                s0 += v_load(S) * f;
+                s1 += v_load(S + 4) * f;
+                s2 += v_load(S + 8) * f;
+                s3 += v_load(S + 12) * f;
+            }
+
+            v_store(dst + i, s0);
+            v_store(dst + i + 4, s1);
+            v_store(dst + i + 8, s2);
+            v_store(dst + i + 12, s3);
+        }
+
+        for( ; i <= width - 4; i += 4 )
+        {
+            v_float32x4 s0 = d4;
+
+            for( k = 0; k < nz; k++ )
+                s0 += v_load(src[k] + i) * v_setall_f32(kf[k]);
+            v_store(dst + i, s0);
+        }
+
+        return i;
+    }
+
+    int _nz;
+    std::vector<uchar> coeffs;
+    float delta;
+};
+
+#else
+
+typedef RowNoVec RowVec_8u32s;
+typedef RowNoVec RowVec_16s32f;
+typedef RowNoVec RowVec_32f;
+typedef SymmRowSmallNoVec SymmRowSmallVec_8u32s;
+typedef SymmRowSmallNoVec SymmRowSmallVec_32f;
+typedef ColumnNoVec SymmColumnVec_32s8u;
+typedef ColumnNoVec SymmColumnVec_32f16s;
+typedef ColumnNoVec SymmColumnVec_32f;
+typedef SymmColumnSmallNoVec SymmColumnSmallVec_32s16s;
+typedef SymmColumnSmallNoVec SymmColumnSmallVec_32f;
+typedef FilterNoVec FilterVec_8u;
+typedef FilterNoVec FilterVec_8u16s;
+typedef FilterNoVec FilterVec_32f;
+
+#endif
+
+
+template<typename ST, typename DT, class VecOp> struct RowFilter : public BaseRowFilter
+{
+    RowFilter( const Mat& _kernel, int _anchor, const VecOp& _vecOp=VecOp() )
+    {
+        if( _kernel.isContinuous() )
+            kernel = _kernel;
+        else
+            _kernel.copyTo(kernel);
+        anchor = _anchor;
+        ksize = kernel.rows + kernel.cols - 1;
+        CV_Assert( kernel.type() == DataType<DT>::type &&
+                   (kernel.rows == 1 || kernel.cols == 1));
+        vecOp = _vecOp;
+    }
+
+    void operator()(const uchar* src, uchar* dst, int width, int cn)
+    {
+        int _ksize = ksize;
+        const DT* kx = kernel.ptr<DT>();
+        const ST* S;
+        DT* D = (DT*)dst;
+        int i, k;
+
+        i = vecOp(src, dst, width, cn);
+        width *= cn;
+        #if CV_ENABLE_UNROLLED
+        for( ; i <= width - 4; i += 4 )
+        {
+            S = (const ST*)src + i;
+            DT f = kx[0];
+            DT s0 = f*S[0], s1 = f*S[1], s2 = f*S[2], s3 = f*S[3];
+
+            for( k = 1; k < _ksize; k++ )
+            {
+                S += cn;
+                f = kx[k];
+                s0 += f*S[0]; s1 += f*S[1];
+                s2 += f*S[2]; s3 += f*S[3];
+            }
+
+            D[i] = s0; D[i+1] = s1;
+            D[i+2] = s2; D[i+3] = s3;
+        }
+        #endif
+        for( ; i < width; i++ )
+        {
+            S = (const ST*)src + i;
+            DT s0 = kx[0]*S[0];
+            for( k = 1; k < _ksize; k++ )
+            {
+                S += cn;
+                s0 += kx[k]*S[0];
+            }
+            D[i] = s0;
+        }
+    }
+
+    Mat kernel;
+    VecOp vecOp;
+};
+
+
+template<typename ST, typename DT, class VecOp> struct SymmRowSmallFilter :
+    public RowFilter<ST, DT, VecOp>
+{
+    SymmRowSmallFilter( const Mat& _kernel, int _anchor, int _symmetryType,
+                        const VecOp& _vecOp = VecOp())
+        : RowFilter<ST, DT, VecOp>( _kernel, _anchor, _vecOp )
+    {
+        symmetryType = _symmetryType;
+        CV_Assert( (symmetryType & (KERNEL_SYMMETRICAL | KERNEL_ASYMMETRICAL)) != 0 && this->ksize <= 5 );
+    }
+
+    void operator()(const uchar* src, uchar* dst, int width, int cn)
+    {
+        int ksize2 = this->ksize/2, ksize2n = ksize2*cn;
+        const DT* kx = this->kernel.template ptr<DT>() + ksize2;
+        bool symmetrical = (this->symmetryType & KERNEL_SYMMETRICAL) != 0;
+        DT* D = (DT*)dst;
+        int i = this->vecOp(src, dst, width, cn), j, k;
+        const ST* S = (const ST*)src + i + ksize2n;
+        width *= cn;
+
+        if( symmetrical )
+        {
+            if( this->ksize == 1 && kx[0] == 1 )
+            {
+                for( ; i <= width - 2; i += 2 )
+                {
+                    DT s0 = S[i], s1 = S[i+1];
+                    D[i] = s0; D[i+1] = s1;
+                }
+                S += i;
+            }
+            else if( this->ksize == 3 )
+            {
+                if( kx[0] == 2 && kx[1] == 1 )
+                    for( ; i <= width - 2; i += 2, S += 2 )
+                    {
+                        DT s0 = S[-cn] + S[0]*2 + S[cn], s1 = S[1-cn] + S[1]*2 + S[1+cn];
+                        D[i] = s0; D[i+1] = s1;
+                    }
+                else if( kx[0] == -2 && kx[1] == 1 )
+                    for( ; i <= width - 2; i += 2, S += 2 )
+                    {
+                        DT s0 = S[-cn] - S[0]*2 + S[cn], s1 = S[1-cn] - S[1]*2 + S[1+cn];
+                        D[i] = s0; D[i+1] = s1;
+                    }
+                else
+                {
+                    DT k0 = kx[0], k1 = kx[1];
+                    for( ; i <= width - 2; i += 2, S += 2 )
+                    {
+                        DT s0 = S[0]*k0 + (S[-cn] + S[cn])*k1, s1 = S[1]*k0 + (S[1-cn] + S[1+cn])*k1;
+                        D[i] = s0; D[i+1] = s1;
+                    }
+                }
+            }
+            else if( this->ksize == 5 )
+            {
+                DT k0 = kx[0], k1 = kx[1], k2 = kx[2];
+                if( k0 == -2 && k1 == 0 && k2 == 1 )
+                    for( ; i <= width - 2; i += 2, S += 2 )
+                    {
+                        DT s0 = -2*S[0] + S[-cn*2] + S[cn*2];
+                        DT s1 = -2*S[1] + S[1-cn*2] + S[1+cn*2];
+                        D[i] = s0; D[i+1] = s1;
+                    }
+                else
+                    for( ; i <= width - 2; i += 2, S += 2 )
+                    {
+                        DT s0 = S[0]*k0 + (S[-cn] + S[cn])*k1 + (S[-cn*2] + S[cn*2])*k2;
+                        DT s1 = S[1]*k0 + (S[1-cn] + S[1+cn])*k1 + (S[1-cn*2] + S[1+cn*2])*k2;
+                        D[i] = s0; D[i+1] = s1;
+                    }
+            }
+
+            for( ; i < width; i++, S++ )
+            {
+                DT s0 = kx[0]*S[0];
+                for( k = 1, j = cn; k <= ksize2; k++, j += cn )
+                    s0 += kx[k]*(S[j] + S[-j]);
+                D[i] = s0;
+            }
+        }
+        else
+        {
+            if( this->ksize == 3 )
+            {
+                if( kx[0] == 0 && kx[1] == 1 )
+                    for( ; i <= width - 2; i += 2, S += 2 )
+                    {
+                        DT s0 = S[cn] - S[-cn], s1 = S[1+cn] - S[1-cn];
+                        D[i] = s0; D[i+1] = s1;
+                    }
+                else
+                {
+                    DT k1 = kx[1];
+                    for( ; i <= width - 2; i += 2, S += 2 )
+                    {
+                        DT s0 = (S[cn] - S[-cn])*k1, s1 = (S[1+cn] - S[1-cn])*k1;
+                        D[i] = s0; D[i+1] = s1;
+                    }
+                }
+            }
+            else if( this->ksize == 5 )
+            {
+                DT k1 = kx[1], k2 = kx[2];
+                for( ; i <= width - 2; i += 2, S += 2 )
+                {
+                    DT s0 = (S[cn] - S[-cn])*k1 + (S[cn*2] - S[-cn*2])*k2;
+                    DT s1 = (S[1+cn] - S[1-cn])*k1 + (S[1+cn*2] - S[1-cn*2])*k2;
+                    D[i] = s0; D[i+1] = s1;
+                }
+            }
+
+            for( ; i < width; i++, S++ )
+            {
+                DT s0 = kx[0]*S[0];
+                for( k = 1, j = cn; k <= ksize2; k++, j += cn )
+                    s0 += kx[k]*(S[j] - S[-j]);
+                D[i] = s0;
+            }
+        }
+    }
+
+    int symmetryType;
+};
+
+
+template<class CastOp, class VecOp> struct ColumnFilter : public BaseColumnFilter
+{
+    typedef typename CastOp::type1 ST;
+    typedef typename CastOp::rtype DT;
+
+    ColumnFilter( const Mat& _kernel, int _anchor,
+        double _delta, const CastOp& _castOp=CastOp(),
+        const VecOp& _vecOp=VecOp() )
+    {
+        if( _kernel.isContinuous() )
+            kernel = _kernel;
+        else
+            _kernel.copyTo(kernel);
+        anchor = _anchor;
+        ksize = kernel.rows + kernel.cols - 1;
+        delta = saturate_cast<ST>(_delta);
+        castOp0 = _castOp;
+        vecOp = _vecOp;
+        CV_Assert( kernel.type() == DataType<ST>::type &&
+                   (kernel.rows == 1 || kernel.cols == 1));
+    }
+
+    void operator()(const uchar** src, uchar* dst, int dststep, int count, int width)
+    {
+        const ST* ky = kernel.template ptr<ST>();
+        ST _delta = delta;
+        int _ksize = ksize;
+        int i, k;
+        CastOp castOp = castOp0;
+
+        for( ; count--; dst += dststep, src++ )
+        {
+            DT* D = (DT*)dst;
+            i = vecOp(src, dst, width);
+            #if CV_ENABLE_UNROLLED
+            for( ; i <= width - 4; i += 4 )
+            {
+                ST f = ky[0];
+                const ST* S = (const ST*)src[0] + i;
+                ST s0 = f*S[0] + _delta, s1 = f*S[1] + _delta,
+                    s2 = f*S[2] + _delta, s3 = f*S[3] + _delta;
+
+                for( k = 1; k < _ksize; k++ )
+                {
+                    S = (const ST*)src[k] + i; f = ky[k];
+                    s0 += f*S[0]; s1 += f*S[1];
+                    s2 += f*S[2]; s3 += f*S[3];
+                }
+
+                D[i] = castOp(s0); D[i+1] = castOp(s1);
+                D[i+2] = castOp(s2); D[i+3] = castOp(s3);
+            }
+            #endif
+            for( ; i < width; i++ )
+            {
+                ST s0 = ky[0]*((const ST*)src[0])[i] + _delta;
+                for( k = 1; k < _ksize; k++ )
+                    s0 += ky[k]*((const ST*)src[k])[i];
+                D[i] = castOp(s0);
+            }
+        }
+    }
+
+    Mat kernel;
+    CastOp castOp0;
+    VecOp vecOp;
+    ST delta;
+};
+
+
+template<class CastOp, class VecOp> struct SymmColumnFilter : public ColumnFilter<CastOp, VecOp>
+{
+    typedef typename CastOp::type1 ST;
+    typedef typename CastOp::rtype DT;
+
+    SymmColumnFilter( const Mat& _kernel, int _anchor,
+        double _delta, int _symmetryType,
+        const CastOp& _castOp=CastOp(),
+        const VecOp& _vecOp=VecOp())
+        : ColumnFilter<CastOp, VecOp>( _kernel, _anchor, _delta, _castOp, _vecOp )
+    {
+        symmetryType = _symmetryType;
+        CV_Assert( (symmetryType & (KERNEL_SYMMETRICAL | KERNEL_ASYMMETRICAL)) != 0 );
+    }
+
+    void operator()(const uchar** src, uchar* dst, int dststep, int count, int width)
+    {
+        int ksize2 = this->ksize/2;
+        const ST* ky = this->kernel.template ptr<ST>() + ksize2;
+        int i, k;
+        bool symmetrical = (symmetryType & KERNEL_SYMMETRICAL) != 0;
+        ST _delta = this->delta;
+        CastOp castOp = this->castOp0;
+        src += ksize2;
+
+        if( symmetrical )
+        {
+            for( ; count--; dst += dststep, src++ )
+            {
+                DT* D = (DT*)dst;
+                i = (this->vecOp)(src, dst, width);
+                #if CV_ENABLE_UNROLLED
+                for( ; i <= width - 4; i += 4 )
+                {
+                    ST f = ky[0];
+                    const ST* S = (const ST*)src[0] + i, *S2;
+                    ST s0 = f*S[0] + _delta, s1 = f*S[1] + _delta,
+                        s2 = f*S[2] + _delta, s3 = f*S[3] + _delta;
+
+                    for( k = 1; k <= ksize2; k++ )
+                    {
+                        S = (const ST*)src[k] + i;
+                        S2 = (const ST*)src[-k] + i;
+                        f = ky[k];
+                        s0 += f*(S[0] + S2[0]);
+                        s1 += f*(S[1] + S2[1]);
+                        s2 += f*(S[2] + S2[2]);
+                        s3 += f*(S[3] + S2[3]);
+                    }
+
+                    D[i] = castOp(s0); D[i+1] = castOp(s1);
+                    D[i+2] = castOp(s2); D[i+3] = castOp(s3);
+                }
+                #endif
+                for( ; i < width; i++ )
+                {
+                    ST s0 = ky[0]*((const ST*)src[0])[i] + _delta;
+                    for( k = 1; k <= ksize2; k++ )
+                        s0 += ky[k]*(((const ST*)src[k])[i] + ((const ST*)src[-k])[i]);
+                    D[i] = castOp(s0);
+                }
+            }
+        }
+        else
+        {
+            for( ; count--; dst += dststep, src++ )
+            {
+                DT* D = (DT*)dst;
+                i = this->vecOp(src, dst, width);
+                #if CV_ENABLE_UNROLLED
+                for( ; i <= width - 4; i += 4 )
+                {
+                    ST f = ky[0];
+                    const ST *S, *S2;
+                    ST s0 = _delta, s1 = _delta, s2 = _delta, s3 = _delta;
+
+                    for( k = 1; k <= ksize2; k++ )
+                    {
+                        S = (const ST*)src[k] + i;
+                        S2 = (const ST*)src[-k] + i;
+                        f = ky[k];
+                        s0 += f*(S[0] - S2[0]);
+                        s1 += f*(S[1] - S2[1]);
+                        s2 += f*(S[2] - S2[2]);
+                        s3 += f*(S[3] - S2[3]);
+                    }
+
+                    D[i] = castOp(s0); D[i+1] = castOp(s1);
+                    D[i+2] = castOp(s2); D[i+3] = castOp(s3);
+                }
+                #endif
+                for( ; i < width; i++ )
+                {
+                    ST s0 = _delta;
+                    for( k = 1; k <= ksize2; k++ )
+                        s0 += ky[k]*(((const ST*)src[k])[i] - ((const ST*)src[-k])[i]);
+                    D[i] = castOp(s0);
+                }
+            }
+        }
+    }
+
+    int symmetryType;
+};
+
+
+template<class CastOp, class VecOp>
+struct SymmColumnSmallFilter : public SymmColumnFilter<CastOp, VecOp>
+{
+    typedef typename CastOp::type1 ST;
+    typedef typename CastOp::rtype DT;
+
+    SymmColumnSmallFilter( const Mat& _kernel, int _anchor,
+                           double _delta, int _symmetryType,
+                           const CastOp& _castOp=CastOp(),
+                           const VecOp& _vecOp=VecOp())
+        : SymmColumnFilter<CastOp, VecOp>( _kernel, _anchor, _delta, _symmetryType, _castOp, _vecOp )
+    {
+        CV_Assert( this->ksize == 3 );
+    }
+
+    void operator()(const uchar** src, uchar* dst, int dststep, int count, int width)
+    {
+        int ksize2 = this->ksize/2;
+        const ST* ky = this->kernel.template ptr<ST>() + ksize2;
+        int i;
+        bool symmetrical = (this->symmetryType & KERNEL_SYMMETRICAL) != 0;
+        bool is_1_2_1 = ky[0] == 2 && ky[1] == 1;
+        bool is_1_m2_1 = ky[0] == -2 && ky[1] == 1;
+        bool is_m1_0_1 = ky[0] == 0 && (ky[1] == 1 || ky[1] == -1);
+        ST f0 = ky[0], f1 = ky[1];
+        ST _delta = this->delta;
+        CastOp castOp = this->castOp0;
+        src += ksize2;
+
+        for( ; count--; dst += dststep, src++ )
+        {
+            DT* D = (DT*)dst;
+            i = (this->vecOp)(src, dst, width);
+            const ST* S0 = (const ST*)src[-1];
+            const ST* S1 = (const ST*)src[0];
+            const ST* S2 = (const ST*)src[1];
+
+            if( symmetrical )
+            {
+                if( is_1_2_1 )
+                {
+                    #if CV_ENABLE_UNROLLED
+                    for( ; i <= width - 4; i += 4 )
+                    {
+                        ST s0 = S0[i] + S1[i]*2 + S2[i] + _delta;
+                        ST s1 = S0[i+1] + S1[i+1]*2 + S2[i+1] + _delta;
+                        D[i] = castOp(s0);
+                        D[i+1] = castOp(s1);
+
+                        s0 = S0[i+2] + S1[i+2]*2 + S2[i+2] + _delta;
+                        s1 = S0[i+3] + S1[i+3]*2 + S2[i+3] + _delta;
+                        D[i+2] = castOp(s0);
+                        D[i+3] = castOp(s1);
+                    }
+                    #endif
+                    for( ; i < width; i ++ )
+                    {
+                        ST s0 = S0[i] + S1[i]*2 + S2[i] + _delta;
+                        D[i] = castOp(s0);
+                    }
+                }
+                else if( is_1_m2_1 )
+                {
+                    #if CV_ENABLE_UNROLLED
+                    for( ; i <= width - 4; i += 4 )
+                    {
+                        ST s0 = S0[i] - S1[i]*2 + S2[i] + _delta;
+                        ST s1 = S0[i+1] - S1[i+1]*2 + S2[i+1] + _delta;
+                        D[i] = castOp(s0);
+                        D[i+1] = castOp(s1);
+
+                        s0 = S0[i+2] - S1[i+2]*2 + S2[i+2] + _delta;
+                        s1 = S0[i+3] - S1[i+3]*2 + S2[i+3] + _delta;
+                        D[i+2] = castOp(s0);
+                        D[i+3] = castOp(s1);
+                    }
+                    #endif
+                    for( ; i < width; i ++ )
+                    {
+                        ST s0 = S0[i] - S1[i]*2 + S2[i] + _delta;
+                        D[i] = castOp(s0);
+                    }
+                }
+                else
+                {
+                    #if CV_ENABLE_UNROLLED
+                    for( ; i <= width - 4; i += 4 )
+                    {
+                        ST s0 = (S0[i] + S2[i])*f1 + S1[i]*f0 + _delta;
+                        ST s1 = (S0[i+1] + S2[i+1])*f1 + S1[i+1]*f0 + _delta;
+                        D[i] = castOp(s0);
+                        D[i+1] = castOp(s1);
+
+                        s0 = (S0[i+2] + S2[i+2])*f1 + S1[i+2]*f0 + _delta;
+                        s1 = (S0[i+3] + S2[i+3])*f1 + S1[i+3]*f0 + _delta;
+                        D[i+2] = castOp(s0);
+                        D[i+3] = castOp(s1);
+                    }
+                    #endif
+                    for( ; i < width; i ++ )
+                    {
+                        ST s0 = (S0[i] + S2[i])*f1 + S1[i]*f0 + _delta;
+                        D[i] = castOp(s0);
+                    }
+                }
+            }
+            else
+            {
+                if( is_m1_0_1 )
+                {
+                    if( f1 < 0 )
+                        std::swap(S0, S2);
+                    #if CV_ENABLE_UNROLLED
+                    for( ; i <= width - 4; i += 4 )
+                    {
+                        ST s0 = S2[i] - S0[i] + _delta;
+                        ST s1 = S2[i+1] - S0[i+1] + _delta;
+                        D[i] = castOp(s0);
+                        D[i+1] = castOp(s1);
+
+                        s0 = S2[i+2] - S0[i+2] + _delta;
+                        s1 = S2[i+3] - S0[i+3] + _delta;
+                        D[i+2] = castOp(s0);
+                        D[i+3] = castOp(s1);
+                    }
+                    #endif
+                    for( ; i < width; i ++ )
+                    {
+                        ST s0 = S2[i] - S0[i] + _delta;
+                        D[i] = castOp(s0);
+                    }
+                    if( f1 < 0 )
+                        std::swap(S0, S2);
+                }
+                else
+                {
+                    #if CV_ENABLE_UNROLLED
+                    for( ; i <= width - 4; i += 4 )
+                    {
+                        ST s0 = (S2[i] - S0[i])*f1 + _delta;
+                        ST s1 = (S2[i+1] - S0[i+1])*f1 + _delta;
+                        D[i] = castOp(s0);
+                        D[i+1] = castOp(s1);
+
+                        s0 = (S2[i+2] - S0[i+2])*f1 + _delta;
+                        s1 = (S2[i+3] - S0[i+3])*f1 + _delta;
+                        D[i+2] = castOp(s0);
+                        D[i+3] = castOp(s1);
+                    }
+                    #endif
+                    for( ; i < width; i++ )
+                        D[i] = castOp((S2[i] - S0[i])*f1 + _delta);
+                }
+            }
+        }
+    }
+};
+
+template<typename ST, typename DT> struct Cast
+{
+    typedef ST type1;
+    typedef DT rtype;
+
+    DT operator()(ST val) const { return saturate_cast<DT>(val); }
+};
+
+template<typename ST, typename DT, int bits> struct FixedPtCast
+{
+    typedef ST type1;
+    typedef DT rtype;
+    enum { SHIFT = bits, DELTA = 1 << (bits-1) };
+
+    DT operator()(ST val) const { return saturate_cast<DT>((val + DELTA)>>SHIFT); }
+};
+
+template<typename ST, typename DT> struct FixedPtCastEx
+{
+    typedef ST type1;
+    typedef DT rtype;
+
+    FixedPtCastEx() : SHIFT(0), DELTA(0) {}
+    FixedPtCastEx(int bits) : SHIFT(bits), DELTA(bits ? 1 << (bits-1) : 0) {}
+    DT operator()(ST val) const { return saturate_cast<DT>((val + DELTA)>>SHIFT); }
+    int SHIFT, DELTA;
+};
+
+
+template<typename ST, class CastOp, class VecOp> struct Filter2D : public BaseFilter
+{
+    typedef typename CastOp::type1 KT;
+    typedef typename CastOp::rtype DT;
+
+    Filter2D( const Mat& _kernel, Point _anchor,
+        double _delta, const CastOp& _castOp=CastOp(),
+        const VecOp& _vecOp=VecOp() )
+    {
+        anchor = _anchor;
+        ksize = _kernel.size();
+        delta = saturate_cast<KT>(_delta);
+        castOp0 = _castOp;
+        vecOp = _vecOp;
+        CV_Assert( _kernel.type() == DataType<KT>::type );
+        preprocess2DKernel( _kernel, coords, coeffs );
+        ptrs.resize( coords.size() );
+    }
+
+    void operator()(const uchar** src, uchar* dst, int dststep, int count, int width, int cn)
+    {
+        KT _delta = delta;
+        const Point* pt = &coords[0];
+        const KT* kf = (const KT*)&coeffs[0];
+        const ST** kp = (const ST**)&ptrs[0];
+        int i, k, nz = (int)coords.size();
+        CastOp castOp = castOp0;
+
+        width *= cn;
+        for( ; count > 0; count--, dst += dststep, src++ )
+        {
+            DT* D = (DT*)dst;
+
+            for( k = 0; k < nz; k++ )
+                kp[k] = (const ST*)src[pt[k].y] + pt[k].x*cn;
+
+            i = vecOp((const uchar**)kp, dst, width);
+            #if CV_ENABLE_UNROLLED
+            for( ; i <= width - 4; i += 4 )
+            {
+                KT s0 = _delta, s1 = _delta, s2 = _delta, s3 = _delta;
+
+                for( k = 0; k < nz; k++ )
+                {
+                    const ST* sptr = kp[k] + i;
+                    KT f = kf[k];
+                    s0 += f*sptr[0];
+                    s1 += f*sptr[1];
+                    s2 += f*sptr[2];
+                    s3 += f*sptr[3];
+                }
+
+                D[i] = castOp(s0); D[i+1] = castOp(s1);
+                D[i+2] = castOp(s2); D[i+3] = castOp(s3);
+            }
+            #endif
+            for( ; i < width; i++ )
+            {
+                KT s0 = _delta;
+                for( k = 0; k < nz; k++ )
+                    s0 += kf[k]*kp[k][i];
+                D[i] = castOp(s0);
+            }
+        }
+    }
+
+    std::vector<Point> coords;
+    std::vector<uchar> coeffs;
+    std::vector<uchar*> ptrs;
+    KT delta;
+    CastOp castOp0;
+    VecOp vecOp;
+};
+
+} // namespace anon
+
+
+Ptr<BaseRowFilter> getLinearRowFilter(int srcType, int bufType, const Mat& kernel, int anchor,
+                                      int symmetryType)
+{
+    int sdepth = CV_MAT_DEPTH(srcType), ddepth = CV_MAT_DEPTH(bufType);
+    int cn = CV_MAT_CN(srcType);
+    CV_Assert( cn == CV_MAT_CN(bufType) &&
+        ddepth >= std::max(sdepth, CV_32S) &&
+        kernel.type() == ddepth );
+    int ksize = kernel.rows + kernel.cols - 1;
+
+    if( (symmetryType & (KERNEL_SYMMETRICAL|KERNEL_ASYMMETRICAL)) != 0 && ksize <= 5 )
+    {
+        if( sdepth == CV_8U && ddepth == CV_32S )
+            return makePtr<SymmRowSmallFilter<uchar, int, SymmRowSmallVec_8u32s> >
+                (kernel, anchor, symmetryType, SymmRowSmallVec_8u32s(kernel, symmetryType));
+        if( sdepth == CV_32F && ddepth == CV_32F )
+            return makePtr<SymmRowSmallFilter<float, float, SymmRowSmallVec_32f> >
+                (kernel, anchor, symmetryType, SymmRowSmallVec_32f(kernel, symmetryType));
+    }
+
+    if( sdepth == CV_8U && ddepth == CV_32S )
+        return makePtr<RowFilter<uchar, int, RowVec_8u32s> >
+            (kernel, anchor, RowVec_8u32s(kernel));
+    if( sdepth == CV_8U && ddepth == CV_32F )
+        return makePtr<RowFilter<uchar, float, RowNoVec> >(kernel, anchor);
+    if( sdepth == CV_8U && ddepth == CV_64F )
+        return makePtr<RowFilter<uchar, double, RowNoVec> >(kernel, anchor);
+    if( sdepth == CV_16U && ddepth == CV_32F )
+        return makePtr<RowFilter<ushort, float, RowNoVec> >(kernel, anchor);
+    if( sdepth == CV_16U && ddepth == CV_64F )
+        return makePtr<RowFilter<ushort, double, RowNoVec> >(kernel, anchor);
+    if( sdepth == CV_16S && ddepth == CV_32F )
+        return makePtr<RowFilter<short, float, RowVec_16s32f> >
+                                  (kernel, anchor, RowVec_16s32f(kernel));
+    if( sdepth == CV_16S && ddepth == CV_64F )
+        return makePtr<RowFilter<short, double, RowNoVec> >(kernel, anchor);
+    if( sdepth == CV_32F && ddepth == CV_32F )
+        return makePtr<RowFilter<float, float, RowVec_32f> >
+            (kernel, anchor, RowVec_32f(kernel));
+    if( sdepth == CV_32F && ddepth == CV_64F )
+        return makePtr<RowFilter<float, double, RowNoVec> >(kernel, anchor);
+    if( sdepth == CV_64F && ddepth == CV_64F )
+        return makePtr<RowFilter<double, double, RowNoVec> >(kernel, anchor);
+
+    CV_Error_( CV_StsNotImplemented,
+        ("Unsupported combination of source format (=%d), and buffer format (=%d)",
+        srcType, bufType));
+
+    return Ptr<BaseRowFilter>();
+}
+
+
+Ptr<BaseColumnFilter> getLinearColumnFilter(int bufType, int dstType, const Mat& kernel, int anchor,
+                                            int symmetryType, double delta, int bits)
+{
+    int sdepth = CV_MAT_DEPTH(bufType), ddepth = CV_MAT_DEPTH(dstType);
+    int cn = CV_MAT_CN(dstType);
+    CV_Assert( cn == CV_MAT_CN(bufType) &&
+        sdepth >= std::max(ddepth, CV_32S) &&
+        kernel.type() == sdepth );
+
+    if( !(symmetryType & (KERNEL_SYMMETRICAL|KERNEL_ASYMMETRICAL)) )
+    {
+        if( ddepth == CV_8U && sdepth == CV_32S )
+            return makePtr<ColumnFilter<FixedPtCastEx<int, uchar>, ColumnNoVec> >
+            (kernel, anchor, delta, FixedPtCastEx<int, uchar>(bits));
+        if( ddepth == CV_8U && sdepth == CV_32F )
+            return makePtr<ColumnFilter<Cast<float, uchar>, ColumnNoVec> >(kernel, anchor, delta);
+        if( ddepth == CV_8U && sdepth == CV_64F )
+            return makePtr<ColumnFilter<Cast<double, uchar>, ColumnNoVec> >(kernel, anchor, delta);
+        if( ddepth == CV_16U && sdepth == CV_32F )
+            return makePtr<ColumnFilter<Cast<float, ushort>, ColumnNoVec> >(kernel, anchor, delta);
+        if( ddepth == CV_16U && sdepth == CV_64F )
+            return makePtr<ColumnFilter<Cast<double, ushort>, ColumnNoVec> >(kernel, anchor, delta);
+        if( ddepth == CV_16S && sdepth == CV_32F )
+            return makePtr<ColumnFilter<Cast<float, short>, ColumnNoVec> >(kernel, anchor, delta);
+        if( ddepth == CV_16S && sdepth == CV_64F )
+            return makePtr<ColumnFilter<Cast<double, short>, ColumnNoVec> >(kernel, anchor, delta);
+        if( ddepth == CV_32F && sdepth == CV_32F )
+            return makePtr<ColumnFilter<Cast<float, float>, ColumnNoVec> >(kernel, anchor, delta);
+        if( ddepth == CV_64F && sdepth == CV_64F )
+            return makePtr<ColumnFilter<Cast<double, double>, ColumnNoVec> >(kernel, anchor, delta);
+    }
+    else
+    {
+        int ksize = kernel.rows + kernel.cols - 1;
+        if( ksize == 3 )
+        {
+            if( ddepth == CV_8U && sdepth == CV_32S )
+                return makePtr<SymmColumnSmallFilter<
+                    FixedPtCastEx<int, uchar>, SymmColumnVec_32s8u> >
+                    (kernel, anchor, delta, symmetryType, FixedPtCastEx<int, uchar>(bits),
+                    SymmColumnVec_32s8u(kernel, symmetryType, bits, delta));
+            if( ddepth == CV_16S && sdepth == CV_32S && bits == 0 )
+                return makePtr<SymmColumnSmallFilter<Cast<int, short>,
+                    SymmColumnSmallVec_32s16s> >(kernel, anchor, delta, symmetryType,
+                        Cast<int, short>(), SymmColumnSmallVec_32s16s(kernel, symmetryType, bits, delta));
+            if( ddepth == CV_32F && sdepth == CV_32F )
+                return makePtr<SymmColumnSmallFilter<
+                    Cast<float, float>,SymmColumnSmallVec_32f> >
+                    (kernel, anchor, delta, symmetryType, Cast<float, float>(),
+                    SymmColumnSmallVec_32f(kernel, symmetryType, 0, delta));
+        }
+        if( ddepth == CV_8U && sdepth == CV_32S )
+            return makePtr<SymmColumnFilter<FixedPtCastEx<int, uchar>, SymmColumnVec_32s8u> >
+                (kernel, anchor, delta, symmetryType, FixedPtCastEx<int, uchar>(bits),
+                SymmColumnVec_32s8u(kernel, symmetryType, bits, delta));
+        if( ddepth == CV_8U && sdepth == CV_32F )
+            return makePtr<SymmColumnFilter<Cast<float, uchar>, ColumnNoVec> >
+                (kernel, anchor, delta, symmetryType);
+        if( ddepth == CV_8U && sdepth == CV_64F )
+            return makePtr<SymmColumnFilter<Cast<double, uchar>, ColumnNoVec> >
+                (kernel, anchor, delta, symmetryType);
+        if( ddepth == CV_16U && sdepth == CV_32F )
+            return makePtr<SymmColumnFilter<Cast<float, ushort>, ColumnNoVec> >
+                (kernel, anchor, delta, symmetryType);
+        if( ddepth == CV_16U && sdepth == CV_64F )
+            return makePtr<SymmColumnFilter<Cast<double, ushort>, ColumnNoVec> >
+                (kernel, anchor, delta, symmetryType);
+        if( ddepth == CV_16S && sdepth == CV_32S )
+            return makePtr<SymmColumnFilter<Cast<int, short>, ColumnNoVec> >
+                (kernel, anchor, delta, symmetryType);
+        if( ddepth == CV_16S && sdepth == CV_32F )
+            return makePtr<SymmColumnFilter<Cast<float, short>, SymmColumnVec_32f16s> >
+                 (kernel, anchor, delta, symmetryType, Cast<float, short>(),
+                  SymmColumnVec_32f16s(kernel, symmetryType, 0, delta));
+        if( ddepth == CV_16S && sdepth == CV_64F )
+            return makePtr<SymmColumnFilter<Cast<double, short>, ColumnNoVec> >
+                (kernel, anchor, delta, symmetryType);
+        if( ddepth == CV_32F && sdepth == CV_32F )
+            return makePtr<SymmColumnFilter<Cast<float, float>, SymmColumnVec_32f> >
+                (kernel, anchor, delta, symmetryType, Cast<float, float>(),
+                SymmColumnVec_32f(kernel, symmetryType, 0, delta));
+        if( ddepth == CV_64F && sdepth == CV_64F )
+            return makePtr<SymmColumnFilter<Cast<double, double>, ColumnNoVec> >
+                (kernel, anchor, delta, symmetryType);
+    }
+
+    CV_Error_( CV_StsNotImplemented,
+        ("Unsupported combination of buffer format (=%d), and destination format (=%d)",
+        bufType, dstType));
+
+    return Ptr<BaseColumnFilter>();
+}
+
+
+Ptr<BaseFilter> getLinearFilter(int srcType, int dstType, const Mat& _kernel, Point anchor,
+                                double delta, int bits)
+{
+    int sdepth = CV_MAT_DEPTH(srcType), ddepth = CV_MAT_DEPTH(dstType);
+    int cn = CV_MAT_CN(srcType), kdepth = _kernel.depth();
+    CV_Assert( cn == CV_MAT_CN(dstType) && ddepth >= sdepth );
+
+    anchor = normalizeAnchor(anchor, _kernel.size());
+
+    /*if( sdepth == CV_8U && ddepth == CV_8U && kdepth == CV_32S )
+        return makePtr<Filter2D<uchar, FixedPtCastEx<int, uchar>, FilterVec_8u> >
+            (_kernel, anchor, delta, FixedPtCastEx<int, uchar>(bits),
+            FilterVec_8u(_kernel, bits, delta));
+    if( sdepth == CV_8U && ddepth == CV_16S && kdepth == CV_32S )
+        return makePtr<Filter2D<uchar, FixedPtCastEx<int, short>, FilterVec_8u16s> >
+            (_kernel, anchor, delta, FixedPtCastEx<int, short>(bits),
+            FilterVec_8u16s(_kernel, bits, delta));*/
+
+    kdepth = sdepth == CV_64F || ddepth == CV_64F ? CV_64F : CV_32F;
+    Mat kernel;
+    if( _kernel.type() == kdepth )
+        kernel = _kernel;
+    else
+        _kernel.convertTo(kernel, kdepth, _kernel.type() == CV_32S ? 1./(1 << bits) : 1.);
+
+    if( sdepth == CV_8U && ddepth == CV_8U )
+        return makePtr<Filter2D<uchar, Cast<float, uchar>, FilterVec_8u> >
+            (kernel, anchor, delta, Cast<float, uchar>(), FilterVec_8u(kernel, 0, delta));
+    if( sdepth == CV_8U && ddepth == CV_16U )
+        return makePtr<Filter2D<uchar,
+            Cast<float, ushort>, FilterNoVec> >(kernel, anchor, delta);
+    if( sdepth == CV_8U && ddepth == CV_16S )
+        return makePtr<Filter2D<uchar, Cast<float, short>, FilterVec_8u16s> >
+            (kernel, anchor, delta, Cast<float, short>(), FilterVec_8u16s(kernel, 0, delta));
+    if( sdepth == CV_8U && ddepth == CV_32F )
+        return makePtr<Filter2D<uchar,
+            Cast<float, float>, FilterNoVec> >(kernel, anchor, delta);
+    if( sdepth == CV_8U && ddepth == CV_64F )
+        return makePtr<Filter2D<uchar,
+            Cast<double, double>, FilterNoVec> >(kernel, anchor, delta);
+
+    if( sdepth == CV_16U && ddepth == CV_16U )
+        return makePtr<Filter2D<ushort,
+            Cast<float, ushort>, FilterNoVec> >(kernel, anchor, delta);
+    if( sdepth == CV_16U && ddepth == CV_32F )
+        return makePtr<Filter2D<ushort,
+            Cast<float, float>, FilterNoVec> >(kernel, anchor, delta);
+    if( sdepth == CV_16U && ddepth == CV_64F )
+        return makePtr<Filter2D<ushort,
+            Cast<double, double>, FilterNoVec> >(kernel, anchor, delta);
+
+    if( sdepth == CV_16S && ddepth == CV_16S )
+        return makePtr<Filter2D<short,
+            Cast<float, short>, FilterNoVec> >(kernel, anchor, delta);
+    if( sdepth == CV_16S && ddepth == CV_32F )
+        return makePtr<Filter2D<short,
+            Cast<float, float>, FilterNoVec> >(kernel, anchor, delta);
+    if( sdepth == CV_16S && ddepth == CV_64F )
+        return makePtr<Filter2D<short,
+            Cast<double, double>, FilterNoVec> >(kernel, anchor, delta);
+
+    if( sdepth == CV_32F && ddepth == CV_32F )
+        return makePtr<Filter2D<float, Cast<float, float>, FilterVec_32f> >
+            (kernel, anchor, delta, Cast<float, float>(), FilterVec_32f(kernel, 0, delta));
+    if( sdepth == CV_64F && ddepth == CV_64F )
+        return makePtr<Filter2D<double,
+            Cast<double, double>, FilterNoVec> >(kernel, anchor, delta);
+
+    CV_Error_( CV_StsNotImplemented,
+        ("Unsupported combination of source format (=%d), and destination format (=%d)",
+        srcType, dstType));
+
+    return Ptr<BaseFilter>();
+}
+
+#endif // CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+} // namespace cv
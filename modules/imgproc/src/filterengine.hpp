@@ -279,6 +279,31 @@ public:
 };
 
 
+/*!
+ Creates filter engines for parallelFilter().
+
+ Every band of the image is processed by its own engine, since the ring buffer and
+ some of the filters (e.g. the column sum of the box filter) keep state between rows.
+*/
+class FilterEngineCreator
+{
+public:
+    virtual ~FilterEngineCreator() {}
+    virtual Ptr<FilterEngine> create() const = 0;
+};
+
+//! returns the number of horizontal bands the filter can be applied by in parallel (1 if it should not be split)
+int getFilterBandCount(const Mat& src, const Mat& dst, const Size& wsz, const Point& ofs, int kheight);
+
+/*!
+ Applies the filter to the src ROI of the whole image (see FilterEngine::apply), processing
+ horizontal bands of dst in parallel. Each band is a ROI of the same whole image,
+ so its engine reads the rows around the band from the image itself and the result
+ is identical to the single-threaded one.
+*/
+void parallelFilter(const FilterEngineCreator& creator, const Mat& src, Mat& dst,
+                    const Size& wsz, const Point& ofs);
+
 //! returns type (one of KERNEL_*) of 1D or 2D kernel specified by its coefficients.
 int getKernelType(InputArray kernel, Point anchor);
 
@@ -0,0 +1,1125 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "opencv2/core/hal/intrin.hpp"
+
+/****************************************************************************************\
+                     Basic Morphological Operations: Erosion & Dilation
+\****************************************************************************************/
+
+namespace cv {
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+// forward declarations
+Ptr<BaseRowFilter> getMorphologyRowFilter(int op, int type, int ksize, int anchor);
+Ptr<BaseColumnFilter> getMorphologyColumnFilter(int op, int type, int ksize, int anchor);
+Ptr<BaseFilter> getMorphologyFilter(int op, int type, const Mat& kernel, Point anchor);
+void morphRectVanHerk(int op, int type, const Mat& src, Mat& dst, Size ksize);
+
+#ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+namespace {
+
+template<typename T> struct MinOp
+{
+    typedef T type1;
+    typedef T type2;
+    typedef T rtype;
+    T operator ()(const T a, const T b) const { return std::min(a, b); }
+};
+
+template<typename T> struct MaxOp
+{
+    typedef T type1;
+    typedef T type2;
+    typedef T rtype;
+    T operator ()(const T a, const T b) const { return std::max(a, b); }
+};
+
+#undef CV_MIN_8U
+#undef CV_MAX_8U
+#define CV_MIN_8U(a,b)       ((a) - CV_FAST_CAST_8U((a) - (b)))
+#define CV_MAX_8U(a,b)       ((a) + CV_FAST_CAST_8U((b) - (a)))
+
+template<> inline uchar MinOp<uchar>::operator ()(const uchar a, const uchar b) const { return CV_MIN_8U(a, b); }
+template<> inline uchar MaxOp<uchar>::operator ()(const uchar a, const uchar b) const { return CV_MAX_8U(a, b); }
+
+struct MorphRowNoVec
+{
+    MorphRowNoVec(int, int) {}
+    int operator()(const uchar*, uchar*, int, int) const { return 0; }
+};
+
+struct MorphColumnNoVec
+{
+    MorphColumnNoVec(int, int) {}
+    int operator()(const uchar**, uchar*, int, int, int) const { return 0; }
+};
+
+struct MorphNoVec
+{
+    int operator()(uchar**, int, uchar*, int) const { return 0; }
+};
+
+#if CV_SIMD128
+
+template<class VecUpdate> struct MorphRowVec
+{
+    typedef typename VecUpdate::vtype vtype;
+    typedef typename vtype::lane_type stype;
+
+    MorphRowVec(int _ksize, int _anchor) : ksize(_ksize), anchor(_anchor) {}
+    int operator()(const uchar* src, uchar* dst, int width, int cn) const
+    {
+        const int VECSZ = vtype::nlanes;
+        const stype* S = (const stype*)src;
+        stype* D = (stype*)dst;
+        int i, k, _ksize = ksize*cn;
+        width *= cn;
+        VecUpdate updateOp;
+
+        for( i = 0; i <= width - 4*VECSZ; i += 4*VECSZ )
+        {
+            const stype* sptr = S + i;
+            vtype s0 = v_load(sptr);
+            vtype s1 = v_load(sptr + VECSZ);
+            vtype s2 = v_load(sptr + VECSZ*2);
+            vtype s3 = v_load(sptr + VECSZ*3);
+            for( k = cn; k < _ksize; k += cn )
+            {
+                sptr = S + i + k;
+                s0 = updateOp(s0, v_load(sptr));
+                s1 = updateOp(s1, v_load(sptr + VECSZ));
+                s2 = updateOp(s2, v_load(sptr + VECSZ*2));
+                s3 = updateOp(s3, v_load(sptr + VECSZ*3));
+            }
+            v_store(D + i, s0);
+            v_store(D + i + VECSZ, s1);
+            v_store(D + i + VECSZ*2, s2);
+            v_store(D + i + VECSZ*3, s3);
+        }
+
+        for( ; i <= width - VECSZ; i += VECSZ )
+        {
+            vtype s = v_load(S + i);
+            for( k = cn; k < _ksize; k += cn )
+                s = updateOp(s, v_load(S + i + k));
+            v_store(D + i, s);
+        }
+
+        for( ; i <= width - VECSZ/2; i += VECSZ/2 )
+        {
+            vtype s = v_load_low(S + i);
+            for( k = cn; k < _ksize; k += cn )
+                s = updateOp(s, v_load_low(S + i + k));
+            v_store_low(D + i, s);
+        }
+
+        return i;
+    }
+
+    int ksize, anchor;
+};
+
+
+template<class VecUpdate> struct MorphColumnVec
+{
+    typedef typename VecUpdate::vtype vtype;
+    typedef typename vtype::lane_type stype;
+
+    MorphColumnVec(int _ksize, int _anchor) : ksize(_ksize), anchor(_anchor) {}
+    int operator()(const uchar** _src, uchar* _dst, int dststep, int count, int width) const
+    {
+        const int VECSZ = vtype::nlanes;
+        const stype** src = (const stype**)_src;
+        stype* dst = (stype*)_dst;
+        int i = 0, k, _ksize = ksize;
+        VecUpdate updateOp;
+
+        dststep /= sizeof(dst[0]);
+
+        // two output rows share the max/min over the ksize-2 inner source rows
+        for( ; _ksize > 1 && count > 1; count -= 2, dst += dststep*2, src += 2 )
+        {
+            for( i = 0; i <= width - 4*VECSZ; i += 4*VECSZ )
+            {
+                const stype* sptr = src[1] + i;
+                vtype s0 = v_load(sptr);
+                vtype s1 = v_load(sptr + VECSZ);
+                vtype s2 = v_load(sptr + VECSZ*2);
+                vtype s3 = v_load(sptr + VECSZ*3);
+
+                for( k = 2; k < _ksize; k++ )
+                {
+                    sptr = src[k] + i;
+                    s0 = updateOp(s0, v_load(sptr));
+                    s1 = updateOp(s1, v_load(sptr + VECSZ));
+                    s2 = updateOp(s2, v_load(sptr + VECSZ*2));
+                    s3 = updateOp(s3, v_load(sptr + VECSZ*3));
+                }
+
+                sptr = src[0] + i;
+                v_store(dst + i, updateOp(s0, v_load(sptr)));
+                v_store(dst + i + VECSZ, updateOp(s1, v_load(sptr + VECSZ)));
+                v_store(dst + i + VECSZ*2, updateOp(s2, v_load(sptr + VECSZ*2)));
+                v_store(dst + i + VECSZ*3, updateOp(s3, v_load(sptr + VECSZ*3)));
+
+                sptr = src[k] + i;
+                v_store(dst + dststep + i, updateOp(s0, v_load(sptr)));
+                v_store(dst + dststep + i + VECSZ, updateOp(s1, v_load(sptr + VECSZ)));
+                v_store(dst + dststep + i + VECSZ*2, updateOp(s2, v_load(sptr + VECSZ*2)));
+                v_store(dst + dststep + i + VECSZ*3, updateOp(s3, v_load(sptr + VECSZ*3)));
+            }
+
+            for( ; i <= width - VECSZ; i += VECSZ )
+            {
+                vtype s0 = v_load(src[1] + i);
+
+                for( k = 2; k < _ksize; k++ )
+                    s0 = updateOp(s0, v_load(src[k] + i));
+
+                v_store(dst + i, updateOp(s0, v_load(src[0] + i)));
+                v_store(dst + dststep + i, updateOp(s0, v_load(src[k] + i)));
+            }
+
+            for( ; i <= width - VECSZ/2; i += VECSZ/2 )
+            {
+                vtype s0 = v_load_low(src[1] + i);
+
+                for( k = 2; k < _ksize; k++ )
+                    s0 = updateOp(s0, v_load_low(src[k] + i));
+
+                v_store_low(dst + i, updateOp(s0, v_load_low(src[0] + i)));
+                v_store_low(dst + dststep + i, updateOp(s0, v_load_low(src[k] + i)));
+            }
+        }
+
+        for( ; count > 0; count--, dst += dststep, src++ )
+        {
+            for( i = 0; i <= width - 4*VECSZ; i += 4*VECSZ )
+            {
+                const stype* sptr = src[0] + i;
+                vtype s0 = v_load(sptr);
+                vtype s1 = v_load(sptr + VECSZ);
+                vtype s2 = v_load(sptr + VECSZ*2);
+                vtype s3 = v_load(sptr + VECSZ*3);
+
+                for( k = 1; k < _ksize; k++ )
+                {
+                    sptr = src[k] + i;
+                    s0 = updateOp(s0, v_load(sptr));
+                    s1 = updateOp(s1, v_load(sptr + VECSZ));
+                    s2 = updateOp(s2, v_load(sptr + VECSZ*2));
+                    s3 = updateOp(s3, v_load(sptr + VECSZ*3));
+                }
+                v_store(dst + i, s0);
+                v_store(dst + i + VECSZ, s1);
+                v_store(dst + i + VECSZ*2, s2);
+                v_store(dst + i + VECSZ*3, s3);
+            }
+
+            for( ; i <= width - VECSZ; i += VECSZ )
+            {
+                vtype s0 = v_load(src[0] + i);
+                for( k = 1; k < _ksize; k++ )
+                    s0 = updateOp(s0, v_load(src[k] + i));
+                v_store(dst + i, s0);
+            }
+
+            for( ; i <= width - VECSZ/2; i += VECSZ/2 )
+            {
+                vtype s0 = v_load_low(src[0] + i);
+                for( k = 1; k < _ksize; k++ )
+                    s0 = updateOp(s0, v_load_low(src[k] + i));
+                v_store_low(dst + i, s0);
+            }
+        }
+
+        return i;
+    }
+
+    int ksize, anchor;
+};
+
+
+template<class VecUpdate> struct MorphVec
+{
+    typedef typename VecUpdate::vtype vtype;
+    typedef typename vtype::lane_type stype;
+
+    int operator()(uchar** _src, int nz, uchar* _dst, int width) const
+    {
+        const int VECSZ = vtype::nlanes;
+        const stype** src = (const stype**)_src;
+        stype* dst = (stype*)_dst;
+        int i, k;
+        VecUpdate updateOp;
+
+        for( i = 0; i <= width - 4*VECSZ; i += 4*VECSZ )
+        {
+            const stype* sptr = src[0] + i;
+            vtype s0 = v_load(sptr);
+            vtype s1 = v_load(sptr + VECSZ);
+            vtype s2 = v_load(sptr + VECSZ*2);
+            vtype s3 = v_load(sptr + VECSZ*3);
+
+            for( k = 1; k < nz; k++ )
+            {
+                sptr = src[k] + i;
+                s0 = updateOp(s0, v_load(sptr));
+                s1 = updateOp(s1, v_load(sptr + VECSZ));
+                s2 = updateOp(s2, v_load(sptr + VECSZ*2));
+                s3 = updateOp(s3, v_load(sptr + VECSZ*3));
+            }
+            v_store(dst + i, s0);
+            v_store(dst + i + VECSZ, s1);
+            v_store(dst + i + VECSZ*2, s2);
+            v_store(dst + i + VECSZ*3, s3);
+        }
+
+        for( ; i <= width - VECSZ; i += VECSZ )
+        {
+            vtype s0 = v_load(src[0] + i);
+            for( k = 1; k < nz; k++ )
+                s0 = updateOp(s0, v_load(src[k] + i));
+            v_store(dst + i, s0);
+        }
+
+        for( ; i <= width - VECSZ/2; i += VECSZ/2 )
+        {
+            vtype s0 = v_load_low(src[0] + i);
+            for( k = 1; k < nz; k++ )
+                s0 = updateOp(s0, v_load_low(src[k] + i));
+            v_store_low(dst + i, s0);
+        }
+
+        return i;
+    }
+};
+
+template<typename V> struct VMin
+{
+    typedef V vtype;
+    V operator()(const V& a, const V& b) const { return v_min(a, b); }
+};
+
+template<typename V> struct VMax
+{
+    typedef V vtype;
+    V operator()(const V& a, const V& b) const { return v_max(a, b); }
+};
+
+typedef MorphRowVec<VMin<v_uint8x16> > ErodeRowVec8u;
+typedef MorphRowVec<VMax<v_uint8x16> > DilateRowVec8u;
+typedef MorphRowVec<VMin<v_uint16x8> > ErodeRowVec16u;
+typedef MorphRowVec<VMax<v_uint16x8> > DilateRowVec16u;
+typedef MorphRowVec<VMin<v_int16x8> > ErodeRowVec16s;
+typedef MorphRowVec<VMax<v_int16x8> > DilateRowVec16s;
+typedef MorphRowVec<VMin<v_float32x4> > ErodeRowVec32f;
+typedef MorphRowVec<VMax<v_float32x4> > DilateRowVec32f;
+
+typedef MorphColumnVec<VMin<v_uint8x16> > ErodeColumnVec8u;
+typedef MorphColumnVec<VMax<v_uint8x16> > DilateColumnVec8u;
+typedef MorphColumnVec<VMin<v_uint16x8> > ErodeColumnVec16u;
+typedef MorphColumnVec<VMax<v_uint16x8> > DilateColumnVec16u;
+typedef MorphColumnVec<VMin<v_int16x8> > ErodeColumnVec16s;
+typedef MorphColumnVec<VMax<v_int16x8> > DilateColumnVec16s;
+typedef MorphColumnVec<VMin<v_float32x4> > ErodeColumnVec32f;
+typedef MorphColumnVec<VMax<v_float32x4> > DilateColumnVec32f;
+
+typedef MorphVec<VMin<v_uint8x16> > ErodeVec8u;
+typedef MorphVec<VMax<v_uint8x16> > DilateVec8u;
+typedef MorphVec<VMin<v_uint16x8> > ErodeVec16u;
+typedef MorphVec<VMax<v_uint16x8> > DilateVec16u;
+typedef MorphVec<VMin<v_int16x8> > ErodeVec16s;
+typedef MorphVec<VMax<v_int16x8> > DilateVec16s;
+typedef MorphVec<VMin<v_float32x4> > ErodeVec32f;
+typedef MorphVec<VMax<v_float32x4> > DilateVec32f;
+
+#else
+
+typedef MorphRowNoVec ErodeRowVec8u;
+typedef MorphRowNoVec DilateRowVec8u;
+
+typedef MorphColumnNoVec ErodeColumnVec8u;
+typedef MorphColumnNoVec DilateColumnVec8u;
+
+typedef MorphRowNoVec ErodeRowVec16u;
+typedef MorphRowNoVec DilateRowVec16u;
+typedef MorphRowNoVec ErodeRowVec16s;
+typedef MorphRowNoVec DilateRowVec16s;
+typedef MorphRowNoVec ErodeRowVec32f;
+typedef MorphRowNoVec DilateRowVec32f;
+
+typedef MorphColumnNoVec ErodeColumnVec16u;
+typedef MorphColumnNoVec DilateColumnVec16u;
+typedef MorphColumnNoVec ErodeColumnVec16s;
+typedef MorphColumnNoVec DilateColumnVec16s;
+typedef MorphColumnNoVec ErodeColumnVec32f;
+typedef MorphColumnNoVec DilateColumnVec32f;
+
+typedef MorphNoVec ErodeVec8u;
+typedef MorphNoVec DilateVec8u;
+typedef MorphNoVec ErodeVec16u;
+typedef MorphNoVec DilateVec16u;
+typedef MorphNoVec ErodeVec16s;
+typedef MorphNoVec DilateVec16s;
+typedef MorphNoVec ErodeVec32f;
+typedef MorphNoVec DilateVec32f;
+
+#endif
+
+#if CV_SIMD128_64F
+
+typedef MorphRowVec<VMin<v_float64x2> > ErodeRowVec64f;
+typedef MorphRowVec<VMax<v_float64x2> > DilateRowVec64f;
+typedef MorphColumnVec<VMin<v_float64x2> > ErodeColumnVec64f;
+typedef MorphColumnVec<VMax<v_float64x2> > DilateColumnVec64f;
+typedef MorphVec<VMin<v_float64x2> > ErodeVec64f;
+typedef MorphVec<VMax<v_float64x2> > DilateVec64f;
+
+#else
+
+typedef MorphRowNoVec ErodeRowVec64f;
+typedef MorphRowNoVec DilateRowVec64f;
+typedef MorphColumnNoVec ErodeColumnVec64f;
+typedef MorphColumnNoVec DilateColumnVec64f;
+typedef MorphNoVec ErodeVec64f;
+typedef MorphNoVec DilateVec64f;
+
+#endif
+
+
+template<class Op, class VecOp> struct MorphRowFilter : public BaseRowFilter
+{
+    typedef typename Op::rtype T;
+
+    MorphRowFilter( int _ksize, int _anchor ) : vecOp(_ksize, _anchor)
+    {
+        ksize = _ksize;
+        anchor = _anchor;
+    }
+
+    void operator()(const uchar* src, uchar* dst, int width, int cn)
+    {
+        int i, j, k, _ksize = ksize*cn;
+        const T* S = (const T*)src;
+        Op op;
+        T* D = (T*)dst;
+
+        if( _ksize == cn )
+        {
+            for( i = 0; i < width*cn; i++ )
+                D[i] = S[i];
+            return;
+        }
+
+        // the scalar loop walks whole pixels, so restart it from a pixel boundary
+        // instead of running past the end of the row
+        int i0 = vecOp(src, dst, width, cn);
+        i0 -= i0 % cn;
+        width *= cn;
+
+        for( k = 0; k < cn; k++, S++, D++ )
+        {
+            for( i = i0; i <= width - cn*2; i += cn*2 )
+            {
+                const T* s = S + i;
+                T m = s[cn];
+                for( j = cn*2; j < _ksize; j += cn )
+                    m = op(m, s[j]);
+                D[i] = op(m, s[0]);
+                D[i+cn] = op(m, s[j]);
+            }
+
+            for( ; i < width; i += cn )
+            {
+                const T* s = S + i;
+                T m = s[0];
+                for( j = cn; j < _ksize; j += cn )
+                    m = op(m, s[j]);
+                D[i] = m;
+            }
+        }
+    }
+
+    VecOp vecOp;
+};
+
+
+template<class Op, class VecOp> struct MorphColumnFilter : public BaseColumnFilter
+{
+    typedef typename Op::rtype T;
+
+    MorphColumnFilter( int _ksize, int _anchor ) : vecOp(_ksize, _anchor)
+    {
+        ksize = _ksize;
+        anchor = _anchor;
+    }
+
+    void operator()(const uchar** _src, uchar* dst, int dststep, int count, int width)
+    {
+        int i, k, _ksize = ksize;
+        const T** src = (const T**)_src;
+        T* D = (T*)dst;
+        Op op;
+
+        int i0 = vecOp(_src, dst, dststep, count, width);
+        dststep /= sizeof(D[0]);
+
+        for( ; _ksize > 1 && count > 1; count -= 2, D += dststep*2, src += 2 )
+        {
+            i = i0;
+            #if CV_ENABLE_UNROLLED
+            for( ; i <= width - 4; i += 4 )
+            {
+                const T* sptr = src[1] + i;
+                T s0 = sptr[0], s1 = sptr[1], s2 = sptr[2], s3 = sptr[3];
+
+                for( k = 2; k < _ksize; k++ )
+                {
+                    sptr = src[k] + i;
+                    s0 = op(s0, sptr[0]); s1 = op(s1, sptr[1]);
+                    s2 = op(s2, sptr[2]); s3 = op(s3, sptr[3]);
+                }
+
+                sptr = src[0] + i;
+                D[i] = op(s0, sptr[0]);
+                D[i+1] = op(s1, sptr[1]);
+                D[i+2] = op(s2, sptr[2]);
+                D[i+3] = op(s3, sptr[3]);
+
+                sptr = src[k] + i;
+                D[i+dststep] = op(s0, sptr[0]);
+                D[i+dststep+1] = op(s1, sptr[1]);
+                D[i+dststep+2] = op(s2, sptr[2]);
+                D[i+dststep+3] = op(s3, sptr[3]);
+            }
+            #endif
+            for( ; i < width; i++ )
+            {
+                T s0 = src[1][i];
+
+                for( k = 2; k < _ksize; k++ )
+                    s0 = op(s0, src[k][i]);
+
+                D[i] = op(s0, src[0][i]);
+                D[i+dststep] = op(s0, src[k][i]);
+            }
+        }
+
+        for( ; count > 0; count--, D += dststep, src++ )
+        {
+            i = i0;
+            #if CV_ENABLE_UNROLLED
+            for( ; i <= width - 4; i += 4 )
+            {
+                const T* sptr = src[0] + i;
+                T s0 = sptr[0], s1 = sptr[1], s2 = sptr[2], s3 = sptr[3];
+
+                for( k = 1; k < _ksize; k++ )
+                {
+                    sptr = src[k] + i;
+                    s0 = op(s0, sptr[0]); s1 = op(s1, sptr[1]);
+                    s2 = op(s2, sptr[2]); s3 = op(s3, sptr[3]);
+                }
+
+                D[i] = s0; D[i+1] = s1;
+                D[i+2] = s2; D[i+3] = s3;
+            }
+            #endif
+            for( ; i < width; i++ )
+            {
+                T s0 = src[0][i];
+                for( k = 1; k < _ksize; k++ )
+                    s0 = op(s0, src[k][i]);
+                D[i] = s0;
+            }
+        }
+    }
+
+    VecOp vecOp;
+};
+
+
+template<class Op, class VecOp> struct MorphFilter : BaseFilter
+{
+    typedef typename Op::rtype T;
+
+    MorphFilter( const Mat& _kernel, Point _anchor )
+    {
+        anchor = _anchor;
+        ksize = _kernel.size();
+        CV_Assert( _kernel.type() == CV_8U );
+
+        std::vector<uchar> coeffs; // we do not really the values of non-zero
+        // kernel elements, just their locations
+        preprocess2DKernel( _kernel, coords, coeffs );
+        ptrs.resize( coords.size() );
+    }
+
+    void operator()(const uchar** src, uchar* dst, int dststep, int count, int width, int cn)
+    {
+        const Point* pt = &coords[0];
+        const T** kp = (const T**)&ptrs[0];
+        int i, k, nz = (int)coords.size();
+        Op op;
+
+        width *= cn;
+        for( ; count > 0; count--, dst += dststep, src++ )
+        {
+            T* D = (T*)dst;
+
+            for( k = 0; k < nz; k++ )
+                kp[k] = (const T*)src[pt[k].y] + pt[k].x*cn;
+
+            i = vecOp(&ptrs[0], nz, dst, width);
+            #if CV_ENABLE_UNROLLED
+            for( ; i <= width - 4; i += 4 )
+            {
+                const T* sptr = kp[0] + i;
+                T s0 = sptr[0], s1 = sptr[1], s2 = sptr[2], s3 = sptr[3];
+
+                for( k = 1; k < nz; k++ )
+                {
+                    sptr = kp[k] + i;
+                    s0 = op(s0, sptr[0]); s1 = op(s1, sptr[1]);
+                    s2 = op(s2, sptr[2]); s3 = op(s3, sptr[3]);
+                }
+
+                D[i] = s0; D[i+1] = s1;
+                D[i+2] = s2; D[i+3] = s3;
+            }
+            #endif
+            for( ; i < width; i++ )
+            {
+                T s0 = kp[0][i];
+                for( k = 1; k < nz; k++ )
+                    s0 = op(s0, kp[k][i]);
+                D[i] = s0;
+            }
+        }
+    }
+
+    std::vector<Point> coords;
+    std::vector<uchar*> ptrs;
+    VecOp vecOp;
+};
+
+
+/****************************************************************************************\
+          van Herk/Gil-Werman erosion & dilation with rectangular structuring elements
+\****************************************************************************************/
+
+// The line is split into blocks of ksize pixels. Any window of ksize pixels
+// covers the tail of one block and the head of the next one, so its min/max
+// is op(suffix[x], prefix[x + ksize - 1]): three comparisons per pixel
+// whatever the kernel size.
+
+struct MorphPairNoVec
+{
+    int operator()(const void*, const void*, void*, int) const { return 0; }
+};
+
+#if CV_SIMD128
+
+template<class VecUpdate> struct MorphPairVec
+{
+    typedef typename VecUpdate::vtype vtype;
+    typedef typename vtype::lane_type stype;
+
+    int operator()(const stype* a, const stype* b, stype* d, int n) const
+    {
+        const int VECSZ = vtype::nlanes;
+        int i = 0;
+        VecUpdate updateOp;
+
+        for( ; i <= n - 2*VECSZ; i += 2*VECSZ )
+        {
+            vtype s0 = updateOp(v_load(a + i), v_load(b + i));
+            vtype s1 = updateOp(v_load(a + i + VECSZ), v_load(b + i + VECSZ));
+            v_store(d + i, s0);
+            v_store(d + i + VECSZ, s1);
+        }
+        for( ; i <= n - VECSZ; i += VECSZ )
+            v_store(d + i, updateOp(v_load(a + i), v_load(b + i)));
+        return i;
+    }
+};
+
+typedef MorphPairVec<VMin<v_uint8x16> > ErodePairVec8u;
+typedef MorphPairVec<VMax<v_uint8x16> > DilatePairVec8u;
+typedef MorphPairVec<VMin<v_uint16x8> > ErodePairVec16u;
+typedef MorphPairVec<VMax<v_uint16x8> > DilatePairVec16u;
+typedef MorphPairVec<VMin<v_int16x8> > ErodePairVec16s;
+typedef MorphPairVec<VMax<v_int16x8> > DilatePairVec16s;
+typedef MorphPairVec<VMin<v_float32x4> > ErodePairVec32f;
+typedef MorphPairVec<VMax<v_float32x4> > DilatePairVec32f;
+
+#else
+
+typedef MorphPairNoVec ErodePairVec8u;
+typedef MorphPairNoVec DilatePairVec8u;
+typedef MorphPairNoVec ErodePairVec16u;
+typedef MorphPairNoVec DilatePairVec16u;
+typedef MorphPairNoVec ErodePairVec16s;
+typedef MorphPairNoVec DilatePairVec16s;
+typedef MorphPairNoVec ErodePairVec32f;
+typedef MorphPairNoVec DilatePairVec32f;
+
+#endif
+
+#if CV_SIMD128_64F
+typedef MorphPairVec<VMin<v_float64x2> > ErodePairVec64f;
+typedef MorphPairVec<VMax<v_float64x2> > DilatePairVec64f;
+#else
+typedef MorphPairNoVec ErodePairVec64f;
+typedef MorphPairNoVec DilatePairVec64f;
+#endif
+
+// d[i] = op(a[i], b[i]); d may alias a or b
+template<class Op, class VecOp> static inline
+void morphPair(const typename Op::rtype* a, const typename Op::rtype* b,
+               typename Op::rtype* d, int n)
+{
+    Op op;
+    int i = VecOp()(a, b, d, n);
+    for( ; i < n; i++ )
+        d[i] = op(a[i], b[i]);
+}
+
+// Horizontal pass for a group of rows. Each row is split into blocks as above;
+// the prefix and suffix scans of all rows in the group are interleaved, so the
+// dependency chains of different rows can overlap.
+template<class Op, class RowVec, class PairVec>
+class MorphRectRowFilter
+{
+public:
+    typedef typename Op::rtype T;
+    enum { MAX_GROUP = 4 };
+
+    MorphRectRowFilter(int _ksize, int _width, int _cn, bool _blocked)
+        : ksize(_ksize), width(_width), cn(_cn), blocked(_blocked)
+    {
+        if( blocked )
+            buf.allocate(width*cn*MAX_GROUP*2);
+    }
+
+    // src rows have width pixels, dst rows width - ksize + 1 pixels
+    void operator()(const T** src, T** dst, int count)
+    {
+        if( !blocked )
+        {
+            // short kernels: the plain vectorized sliding window is faster
+            MorphRowFilter<Op, RowVec> f(ksize, 0);
+            for( int r = 0; r < count; r++ )
+                f((const uchar*)src[r], (uchar*)dst[r], width - ksize + 1, cn);
+            return;
+        }
+
+        int len = width*cn, dwidth = (width - ksize + 1)*cn;
+        T* g[MAX_GROUP];
+        T* h[MAX_GROUP];
+        Op op;
+
+        for( int r = 0; r < MAX_GROUP; r++ )
+        {
+            g[r] = (T*)buf + len*r*2;
+            h[r] = g[r] + len;
+        }
+
+        for( ; count > 0; count -= MAX_GROUP, src += MAX_GROUP, dst += MAX_GROUP )
+        {
+            int nr = std::min(count, (int)MAX_GROUP), r, j, t;
+
+            for( int x0 = 0; x0 < width; x0 += ksize )
+            {
+                int j0 = x0*cn, j1 = std::min(x0 + ksize, width)*cn;
+                for( r = 0; r < nr; r++ )
+                {
+                    const T* S = src[r];
+                    for( j = 0; j < cn; j++ )
+                    {
+                        g[r][j0 + j] = S[j0 + j];
+                        h[r][j1 - 1 - j] = S[j1 - 1 - j];
+                    }
+                }
+                for( t = cn; t < j1 - j0; t++ )
+                {
+                    int jg = j0 + t, jh = j1 - 1 - t;
+                    for( r = 0; r < nr; r++ )
+                    {
+                        g[r][jg] = op(g[r][jg - cn], src[r][jg]);
+                        h[r][jh] = op(h[r][jh + cn], src[r][jh]);
+                    }
+                }
+            }
+
+            for( r = 0; r < nr; r++ )
+                morphPair<Op, PairVec>(h[r], g[r] + (ksize - 1)*cn, dst[r], dwidth);
+        }
+    }
+
+private:
+    int ksize, width, cn;
+    bool blocked;
+    AutoBuffer<T> buf;
+};
+
+template<class Op, class RowVec, class PairVec>
+class MorphRectRowInvoker : public ParallelLoopBody
+{
+public:
+    typedef typename Op::rtype T;
+
+    MorphRectRowInvoker(const Mat& _src, Mat& _dst, int _ksize, bool _blocked)
+        : src(_src), dst(_dst), ksize(_ksize), blocked(_blocked)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        enum { MAX_GROUP = MorphRectRowFilter<Op, RowVec, PairVec>::MAX_GROUP };
+        MorphRectRowFilter<Op, RowVec, PairVec> rowFilter(ksize, src.cols, src.channels(), blocked);
+        const T* S[MAX_GROUP];
+        T* D[MAX_GROUP];
+
+        for( int y = range.start; y < range.end; y += MAX_GROUP )
+        {
+            int nr = std::min(range.end - y, (int)MAX_GROUP);
+            for( int r = 0; r < nr; r++ )
+            {
+                S[r] = src.ptr<T>(y + r);
+                D[r] = dst.ptr<T>(y + r);
+            }
+            rowFilter(S, D, nr);
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    int ksize;
+    bool blocked;
+
+    MorphRectRowInvoker& operator=(const MorphRectRowInvoker&); // disabled
+};
+
+// Vertical pass, fused with the horizontal one: every band of output rows keeps
+// the horizontally filtered rows of two consecutive blocks in a small ring, so
+// the intermediate image never has to be stored as a whole.
+template<class Op, class RowVec, class PairVec>
+class MorphRectInvoker : public ParallelLoopBody
+{
+public:
+    typedef typename Op::rtype T;
+
+    MorphRectInvoker(const Mat& _src, Mat& _dst, Size _ksize, bool _blocked, int _bandRows)
+        : src(_src), dst(_dst), ksize(_ksize), blocked(_blocked), bandRows(_bandRows)
+    {
+    }
+
+    void operator()(const Range& range) const
+    {
+        int y0 = range.start*bandRows, y1 = std::min(range.end*bandRows, dst.rows);
+        int kh = ksize.height, n = dst.cols*dst.channels(), r;
+        bool rowPass = ksize.width > 1;
+        MorphRectRowFilter<Op, RowVec, PairVec> rowFilter(ksize.width, src.cols, src.channels(), blocked);
+
+        // R[0..kh-1] hold the rows of the current block, R[kh..2*kh-1] the rows of the next one
+        AutoBuffer<const T*> _rows(kh*4);
+        const T** R = _rows;
+        T** W = (T**)(R + kh*2);
+        AutoBuffer<T> _buf(n*(rowPass ? kh*2 + 2 : 2));
+        T* cur = _buf;
+        T* gbuf = cur + n;
+        for( r = 0; r < kh*2; r++ )
+            W[r] = rowPass ? gbuf + n*(r + 1) : 0;
+
+        fillRows(rowFilter, R, W, 0, kh, y0);
+        for( int b = y0; b < y1; b += kh )
+        {
+            int nout = std::min(kh, y1 - b);
+            fillRows(rowFilter, R, W, kh, kh + nout - 1, b);
+
+            // suffix min/max of the block, rows b + r .. b + kh - 1;
+            // the first nout of them are kept directly in the destination rows
+            const T* prev = R[kh - 1];
+            if( kh - 1 < nout )
+            {
+                memcpy(dst.ptr<T>(b + kh - 1), prev, n*sizeof(T));
+                prev = dst.ptr<T>(b + kh - 1);
+            }
+            for( r = kh - 2; r >= 0; r-- )
+            {
+                T* out = r < nout ? dst.ptr<T>(b + r) : cur;
+                morphPair<Op, PairVec>(R[r], prev, out, n);
+                prev = out;
+            }
+
+            // combine with the prefix min/max of the next block, rows b + kh .. b + kh + r - 1
+            const T* g = R[kh];
+            for( r = 1; r < nout; r++ )
+            {
+                T* D = dst.ptr<T>(b + r);
+                morphPair<Op, PairVec>(D, g, D, n);
+                if( r + 1 < nout )
+                {
+                    morphPair<Op, PairVec>(g, R[kh + r], gbuf, n);
+                    g = gbuf;
+                }
+            }
+
+            if( b + kh < y1 )
+            {
+                // the next block becomes the current one; all but its last row are ready
+                for( r = 0; r < kh; r++ )
+                {
+                    std::swap(R[r], R[r + kh]);
+                    std::swap(W[r], W[r + kh]);
+                }
+                fillRows(rowFilter, R, W, kh - 1, kh, b + kh);
+            }
+        }
+    }
+
+private:
+    // makes R[j0..j1-1] point to the horizontally filtered source rows y + j0 .. y + j1 - 1
+    void fillRows(MorphRectRowFilter<Op, RowVec, PairVec>& rowFilter,
+                  const T** R, T** W, int j0, int j1, int y) const
+    {
+        enum { MAX_GROUP = MorphRectRowFilter<Op, RowVec, PairVec>::MAX_GROUP };
+        const T* S[MAX_GROUP];
+
+        for( int j = j0; j < j1; j += MAX_GROUP )
+        {
+            int nr = std::min(j1 - j, (int)MAX_GROUP), r;
+            for( r = 0; r < nr; r++ )
+                S[r] = src.ptr<T>(y + j + r);
+            if( ksize.width == 1 )
+            {
+                for( r = 0; r < nr; r++ )
+                    R[j + r] = S[r];
+                continue;
+            }
+            rowFilter(S, W + j, nr);
+            for( r = 0; r < nr; r++ )
+                R[j + r] = W[j + r];
+        }
+    }
+
+    const Mat& src;
+    Mat& dst;
+    Size ksize;
+    bool blocked;
+    int bandRows;
+
+    MorphRectInvoker& operator=(const MorphRectInvoker&); // disabled
+};
+
+template<class Op, class RowVec, class PairVec> static
+void morphRectVanHerk_(const Mat& src, Mat& dst, Size ksize)
+{
+    typedef typename Op::rtype T;
+
+    // below this width the sliding-window row filter wins over the block scans
+    const int rowBlockedMinSize = std::max(64/(int)sizeof(T), 16);
+    bool blocked = ksize.width >= rowBlockedMinSize;
+
+    if( ksize.height == 1 )
+    {
+        if( ksize.width == 1 )
+        {
+            src.copyTo(dst);
+            return;
+        }
+        MorphRectRowInvoker<Op, RowVec, PairVec> body(src, dst, ksize.width, blocked);
+        parallel_for_(Range(0, dst.rows), body,
+                      std::max((double)src.total()*src.elemSize()/(1 << 16), 1.));
+        return;
+    }
+
+    int nblocks = (dst.rows + ksize.height - 1)/ksize.height;
+    int nbands = std::min(nblocks, std::max(getNumThreads(), 1)*2);
+    int bandRows = ((nblocks + nbands - 1)/nbands)*ksize.height;
+    nbands = (dst.rows + bandRows - 1)/bandRows;
+    MorphRectInvoker<Op, RowVec, PairVec> body(src, dst, ksize, blocked, bandRows);
+    parallel_for_(Range(0, nbands), body, nbands);
+}
+
+} // namespace anon
+
+/////////////////////////////////// External Interface /////////////////////////////////////
+
+Ptr<BaseRowFilter> getMorphologyRowFilter(int op, int type, int ksize, int anchor)
+{
+    int depth = CV_MAT_DEPTH(type);
+    if( anchor < 0 )
+        anchor = ksize/2;
+    CV_Assert( op == MORPH_ERODE || op == MORPH_DILATE );
+    if( op == MORPH_ERODE )
+    {
+        if( depth == CV_8U )
+            return makePtr<MorphRowFilter<MinOp<uchar>,
+                                      ErodeRowVec8u> >(ksize, anchor);
+        if( depth == CV_16U )
+            return makePtr<MorphRowFilter<MinOp<ushort>,
+                                      ErodeRowVec16u> >(ksize, anchor);
+        if( depth == CV_16S )
+            return makePtr<MorphRowFilter<MinOp<short>,
+                                      ErodeRowVec16s> >(ksize, anchor);
+        if( depth == CV_32F )
+            return makePtr<MorphRowFilter<MinOp<float>,
+                                      ErodeRowVec32f> >(ksize, anchor);
+        if( depth == CV_64F )
+            return makePtr<MorphRowFilter<MinOp<double>,
+                                      ErodeRowVec64f> >(ksize, anchor);
+    }
+    else
+    {
+        if( depth == CV_8U )
+            return makePtr<MorphRowFilter<MaxOp<uchar>,
+                                      DilateRowVec8u> >(ksize, anchor);
+        if( depth == CV_16U )
+            return makePtr<MorphRowFilter<MaxOp<ushort>,
+                                      DilateRowVec16u> >(ksize, anchor);
+        if( depth == CV_16S )
+            return makePtr<MorphRowFilter<MaxOp<short>,
+                                      DilateRowVec16s> >(ksize, anchor);
+        if( depth == CV_32F )
+            return makePtr<MorphRowFilter<MaxOp<float>,
+                                      DilateRowVec32f> >(ksize, anchor);
+        if( depth == CV_64F )
+            return makePtr<MorphRowFilter<MaxOp<double>,
+                                      DilateRowVec64f> >(ksize, anchor);
+    }
+
+    CV_Error_( CV_StsNotImplemented, ("Unsupported data type (=%d)", type));
+    return Ptr<BaseRowFilter>();
+}
+
+Ptr<BaseColumnFilter> getMorphologyColumnFilter(int op, int type, int ksize, int anchor)
+{
+    int depth = CV_MAT_DEPTH(type);
+    if( anchor < 0 )
+        anchor = ksize/2;
+    CV_Assert( op == MORPH_ERODE || op == MORPH_DILATE );
+    if( op == MORPH_ERODE )
+    {
+        if( depth == CV_8U )
+            return makePtr<MorphColumnFilter<MinOp<uchar>,
+                                         ErodeColumnVec8u> >(ksize, anchor);
+        if( depth == CV_16U )
+            return makePtr<MorphColumnFilter<MinOp<ushort>,
+                                         ErodeColumnVec16u> >(ksize, anchor);
+        if( depth == CV_16S )
+            return makePtr<MorphColumnFilter<MinOp<short>,
+                                         ErodeColumnVec16s> >(ksize, anchor);
+        if( depth == CV_32F )
+            return makePtr<MorphColumnFilter<MinOp<float>,
+                                         ErodeColumnVec32f> >(ksize, anchor);
+        if( depth == CV_64F )
+            return makePtr<MorphColumnFilter<MinOp<double>,
+                                         ErodeColumnVec64f> >(ksize, anchor);
+    }
+    else
+    {
+        if( depth == CV_8U )
+            return makePtr<MorphColumnFilter<MaxOp<uchar>,
+                                         DilateColumnVec8u> >(ksize, anchor);
+        if( depth == CV_16U )
+            return makePtr<MorphColumnFilter<MaxOp<ushort>,
+                                         DilateColumnVec16u> >(ksize, anchor);
+        if( depth == CV_16S )
+            return makePtr<MorphColumnFilter<MaxOp<short>,
+                                         DilateColumnVec16s> >(ksize, anchor);
+        if( depth == CV_32F )
+            return makePtr<MorphColumnFilter<MaxOp<float>,
+                                         DilateColumnVec32f> >(ksize, anchor);
+        if( depth == CV_64F )
+            return makePtr<MorphColumnFilter<MaxOp<double>,
+                                         DilateColumnVec64f> >(ksize, anchor);
+    }
+
+    CV_Error_( CV_StsNotImplemented, ("Unsupported data type (=%d)", type));
+    return Ptr<BaseColumnFilter>();
+}
+
+Ptr<BaseFilter> getMorphologyFilter(int op, int type, const Mat& kernel, Point anchor)
+{
+    int depth = CV_MAT_DEPTH(type);
+    anchor = normalizeAnchor(anchor, kernel.size());
+    CV_Assert( op == MORPH_ERODE || op == MORPH_DILATE );
+    if( op == MORPH_ERODE )
+    {
+        if( depth == CV_8U )
+            return makePtr<MorphFilter<MinOp<uchar>, ErodeVec8u> >(kernel, anchor);
+        if( depth == CV_16U )
+            return makePtr<MorphFilter<MinOp<ushort>, ErodeVec16u> >(kernel, anchor);
+        if( depth == CV_16S )
+            return makePtr<MorphFilter<MinOp<short>, ErodeVec16s> >(kernel, anchor);
+        if( depth == CV_32F )
+            return makePtr<MorphFilter<MinOp<float>, ErodeVec32f> >(kernel, anchor);
+        if( depth == CV_64F )
+            return makePtr<MorphFilter<MinOp<double>, ErodeVec64f> >(kernel, anchor);
+    }
+    else
+    {
+        if( depth == CV_8U )
+            return makePtr<MorphFilter<MaxOp<uchar>, DilateVec8u> >(kernel, anchor);
+        if( depth == CV_16U )
+            return makePtr<MorphFilter<MaxOp<ushort>, DilateVec16u> >(kernel, anchor);
+        if( depth == CV_16S )
+            return makePtr<MorphFilter<MaxOp<short>, DilateVec16s> >(kernel, anchor);
+        if( depth == CV_32F )
+            return makePtr<MorphFilter<MaxOp<float>, DilateVec32f> >(kernel, anchor);
+        if( depth == CV_64F )
+            return makePtr<MorphFilter<MaxOp<double>, DilateVec64f> >(kernel, anchor);
+    }
+
+    CV_Error_( CV_StsNotImplemented, ("Unsupported data type (=%d)", type));
+    return Ptr<BaseFilter>();
+}
+
+void morphRectVanHerk(int op, int type, const Mat& src, Mat& dst, Size ksize)
+{
+    int depth = CV_MAT_DEPTH(type);
+    CV_Assert( op == MORPH_ERODE || op == MORPH_DILATE );
+    CV_Assert( src.type() == type && dst.type() == type &&
+               src.rows == dst.rows + ksize.height - 1 && src.cols == dst.cols + ksize.width - 1 );
+
+    if( op == MORPH_ERODE )
+    {
+        if( depth == CV_8U )
+            morphRectVanHerk_<MinOp<uchar>, ErodeRowVec8u, ErodePairVec8u>(src, dst, ksize);
+        else if( depth == CV_16U )
+            morphRectVanHerk_<MinOp<ushort>, ErodeRowVec16u, ErodePairVec16u>(src, dst, ksize);
+        else if( depth == CV_16S )
+            morphRectVanHerk_<MinOp<short>, ErodeRowVec16s, ErodePairVec16s>(src, dst, ksize);
+        else if( depth == CV_32F )
+            morphRectVanHerk_<MinOp<float>, ErodeRowVec32f, ErodePairVec32f>(src, dst, ksize);
+        else if( depth == CV_64F )
+            morphRectVanHerk_<MinOp<double>, ErodeRowVec64f, ErodePairVec64f>(src, dst, ksize);
+        else
+            CV_Error_( CV_StsNotImplemented, ("Unsupported data type (=%d)", type));
+    }
+    else
+    {
+        if( depth == CV_8U )
+            morphRectVanHerk_<MaxOp<uchar>, DilateRowVec8u, DilatePairVec8u>(src, dst, ksize);
+        else if( depth == CV_16U )
+            morphRectVanHerk_<MaxOp<ushort>, DilateRowVec16u, DilatePairVec16u>(src, dst, ksize);
+        else if( depth == CV_16S )
+            morphRectVanHerk_<MaxOp<short>, DilateRowVec16s, DilatePairVec16s>(src, dst, ksize);
+        else if( depth == CV_32F )
+            morphRectVanHerk_<MaxOp<float>, DilateRowVec32f, DilatePairVec32f>(src, dst, ksize);
+        else if( depth == CV_64F )
+            morphRectVanHerk_<MaxOp<double>, DilateRowVec64f, DilatePairVec64f>(src, dst, ksize);
+        else
+            CV_Error_( CV_StsNotImplemented, ("Unsupported data type (=%d)", type));
+    }
+}
+
+#endif // CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+} // namespace cv
@@ -848,133 +848,252 @@ typedef PyrUpNoVec<float, float> PyrUpVec_32f;
 
 #endif
 
-template<class CastOp, class VecOp> void
-pyrDown_( const Mat& _src, Mat& _dst, int borderType )
+// Computes the rows of a pyrDown level in order. The horizontally convolved and
+// decimated source rows live in a small ring buffer, so any range of destination
+// rows can be produced on its own: it only reads the source rows it covers plus
+// two rows above and below. Consecutive calls continue where the previous one stopped.
+template<class CastOp, class VecOp> class PyrDownRows
 {
-    const int PD_SZ = 5;
+public:
     typedef typename CastOp::type1 WT;
     typedef typename CastOp::rtype T;
+    enum { PD_SZ = 5 };
 
-    CV_Assert( !_src.empty() );
-    Size ssize = _src.size(), dsize = _dst.size();
-    int cn = _src.channels();
-    int bufstep = (int)alignSize(dsize.width*cn, 16);
-    AutoBuffer<WT> _buf(bufstep*PD_SZ + 16);
-    WT* buf = alignPtr((WT*)_buf, 16);
-    int tabL[CV_CN_MAX*(PD_SZ+2)], tabR[CV_CN_MAX*(PD_SZ+2)];
-    AutoBuffer<int> _tabM(dsize.width*cn);
-    int* tabM = _tabM;
-    WT* rows[PD_SZ];
-    CastOp castOp;
-    VecOp vecOp;
-
-    CV_Assert( ssize.width > 0 && ssize.height > 0 &&
-               std::abs(dsize.width*2 - ssize.width) <= 2 &&
-               std::abs(dsize.height*2 - ssize.height) <= 2 );
-    int k, x, sy0 = -PD_SZ/2, sy = sy0, width0 = std::min((ssize.width-PD_SZ/2-1)/2 + 1, dsize.width);
-
-    for( x = 0; x <= PD_SZ+1; x++ )
+    PyrDownRows( const Mat& _src, Mat& _dst, int _borderType )
+        : src(_src), dst(_dst), borderType(_borderType), nextY(-1)
     {
-        int sx0 = borderInterpolate(x - PD_SZ/2, ssize.width, borderType)*cn;
-        int sx1 = borderInterpolate(x + width0*2 - PD_SZ/2, ssize.width, borderType)*cn;
-        for( k = 0; k < cn; k++ )
+        CV_Assert( !src.empty() );
+        ssize = src.size();
+        dsize = dst.size();
+        cn = src.channels();
+        bufstep = (int)alignSize(dsize.width*cn, 16);
+        _buf.allocate(bufstep*PD_SZ + 16);
+        buf = alignPtr((WT*)_buf, 16);
+        _tabM.allocate(dsize.width*cn);
+        tabM = _tabM;
+
+        CV_Assert( ssize.width > 0 && ssize.height > 0 &&
+                   std::abs(dsize.width*2 - ssize.width) <= 2 &&
+                   std::abs(dsize.height*2 - ssize.height) <= 2 );
+        int k, x;
+        width0 = std::min((ssize.width-PD_SZ/2-1)/2 + 1, dsize.width);
+
+        for( x = 0; x <= PD_SZ+1; x++ )
         {
-            tabL[x*cn + k] = sx0 + k;
-            tabR[x*cn + k] = sx1 + k;
+            int sx0 = borderInterpolate(x - PD_SZ/2, ssize.width, borderType)*cn;
+            int sx1 = borderInterpolate(x + width0*2 - PD_SZ/2, ssize.width, borderType)*cn;
+            for( k = 0; k < cn; k++ )
+            {
+                tabL[x*cn + k] = sx0 + k;
+                tabR[x*cn + k] = sx1 + k;
+            }
         }
-    }
 
-    ssize.width *= cn;
-    dsize.width *= cn;
-    width0 *= cn;
+        ssize.width *= cn;
+        dsize.width *= cn;
+        width0 *= cn;
+
+        for( x = 0; x < dsize.width; x++ )
+            tabM[x] = (x/cn)*2*cn + x % cn;
+    }
 
-    for( x = 0; x < dsize.width; x++ )
-        tabM[x] = (x/cn)*2*cn + x % cn;
+    // the number of leading source rows that destination row y reads
+    // (for all border modes except BORDER_WRAP)
+    int srcRowsUsed( int y ) const
+    {
+        return std::min(y*2 + PD_SZ/2 + 1, ssize.height);
+    }
 
-    for( int y = 0; y < dsize.height; y++ )
+    // computes the destination rows [y0, y1)
+    void operator()( int y0, int y1 )
     {
-        T* dst = _dst.ptr<T>(y);
-        WT *row0, *row1, *row2, *row3, *row4;
+        int k, x;
+        WT* rows[PD_SZ];
+        CastOp castOp;
+        VecOp vecOp;
 
-        // fill the ring buffer (horizontal convolution and decimation)
-        for( ; sy <= y*2 + 2; sy++ )
+        if( y0 != nextY )
+            sy0 = sy = y0*2 - PD_SZ/2;
+
+        for( int y = y0; y < y1; y++ )
         {
-            WT* row = buf + ((sy - sy0) % PD_SZ)*bufstep;
-            int _sy = borderInterpolate(sy, ssize.height, borderType);
-            const T* src = _src.ptr<T>(_sy);
-            int limit = cn;
-            const int* tab = tabL;
+            T* D = dst.ptr<T>(y);
+            WT *row0, *row1, *row2, *row3, *row4;
 
-            for( x = 0;;)
+            // fill the ring buffer (horizontal convolution and decimation)
+            for( ; sy <= y*2 + 2; sy++ )
             {
-                for( ; x < limit; x++ )
+                WT* row = buf + ((sy - sy0) % PD_SZ)*bufstep;
+                int _sy = borderInterpolate(sy, ssize.height, borderType);
+                const T* S = src.ptr<T>(_sy);
+                int limit = cn;
+                const int* tab = tabL;
+
+                for( x = 0;;)
                 {
-                    row[x] = src[tab[x+cn*2]]*6 + (src[tab[x+cn]] + src[tab[x+cn*3]])*4 +
-                        src[tab[x]] + src[tab[x+cn*4]];
-                }
+                    for( ; x < limit; x++ )
+                    {
+                        row[x] = S[tab[x+cn*2]]*6 + (S[tab[x+cn]] + S[tab[x+cn*3]])*4 +
+                            S[tab[x]] + S[tab[x+cn*4]];
+                    }
 
-                if( x == dsize.width )
-                    break;
+                    if( x == dsize.width )
+                        break;
 
-                if( cn == 1 )
-                {
-                    for( ; x < width0; x++ )
-                        row[x] = src[x*2]*6 + (src[x*2 - 1] + src[x*2 + 1])*4 +
-                            src[x*2 - 2] + src[x*2 + 2];
-                }
-                else if( cn == 3 )
-                {
-                    for( ; x < width0; x += 3 )
+                    if( cn == 1 )
                     {
-                        const T* s = src + x*2;
-                        WT t0 = s[0]*6 + (s[-3] + s[3])*4 + s[-6] + s[6];
-                        WT t1 = s[1]*6 + (s[-2] + s[4])*4 + s[-5] + s[7];
-                        WT t2 = s[2]*6 + (s[-1] + s[5])*4 + s[-4] + s[8];
-                        row[x] = t0; row[x+1] = t1; row[x+2] = t2;
+                        for( ; x < width0; x++ )
+                            row[x] = S[x*2]*6 + (S[x*2 - 1] + S[x*2 + 1])*4 +
+                                S[x*2 - 2] + S[x*2 + 2];
                     }
-                }
-                else if( cn == 4 )
-                {
-                    for( ; x < width0; x += 4 )
+                    else if( cn == 3 )
                     {
-                        const T* s = src + x*2;
-                        WT t0 = s[0]*6 + (s[-4] + s[4])*4 + s[-8] + s[8];
-                        WT t1 = s[1]*6 + (s[-3] + s[5])*4 + s[-7] + s[9];
-                        row[x] = t0; row[x+1] = t1;
-                        t0 = s[2]*6 + (s[-2] + s[6])*4 + s[-6] + s[10];
-                        t1 = s[3]*6 + (s[-1] + s[7])*4 + s[-5] + s[11];
-                        row[x+2] = t0; row[x+3] = t1;
+                        for( ; x < width0; x += 3 )
+                        {
+                            const T* s = S + x*2;
+                            WT t0 = s[0]*6 + (s[-3] + s[3])*4 + s[-6] + s[6];
+                            WT t1 = s[1]*6 + (s[-2] + s[4])*4 + s[-5] + s[7];
+                            WT t2 = s[2]*6 + (s[-1] + s[5])*4 + s[-4] + s[8];
+                            row[x] = t0; row[x+1] = t1; row[x+2] = t2;
+                        }
                     }
-                }
-                else
-                {
-                    for( ; x < width0; x++ )
+                    else if( cn == 4 )
                     {
-                        int sx = tabM[x];
-                        row[x] = src[sx]*6 + (src[sx - cn] + src[sx + cn])*4 +
-                            src[sx - cn*2] + src[sx + cn*2];
+                        for( ; x < width0; x += 4 )
+                        {
+                            const T* s = S + x*2;
+                            WT t0 = s[0]*6 + (s[-4] + s[4])*4 + s[-8] + s[8];
+                            WT t1 = s[1]*6 + (s[-3] + s[5])*4 + s[-7] + s[9];
+                            row[x] = t0; row[x+1] = t1;
+                            t0 = s[2]*6 + (s[-2] + s[6])*4 + s[-6] + s[10];
+                            t1 = s[3]*6 + (s[-1] + s[7])*4 + s[-5] + s[11];
+                            row[x+2] = t0; row[x+3] = t1;
+                        }
+                    }
+                    else
+                    {
+                        for( ; x < width0; x++ )
+                        {
+                            int sx = tabM[x];
+                            row[x] = S[sx]*6 + (S[sx - cn] + S[sx + cn])*4 +
+                                S[sx - cn*2] + S[sx + cn*2];
+                        }
                     }
-                }
 
-                limit = dsize.width;
-                tab = tabR - x;
+                    limit = dsize.width;
+                    tab = tabR - x;
+                }
             }
+
+            // do vertical convolution and decimation and write the result to the destination image
+            for( k = 0; k < PD_SZ; k++ )
+                rows[k] = buf + ((y*2 - PD_SZ/2 + k - sy0) % PD_SZ)*bufstep;
+            row0 = rows[0]; row1 = rows[1]; row2 = rows[2]; row3 = rows[3]; row4 = rows[4];
+
+            x = vecOp(rows, D, (int)dst.step, dsize.width);
+            for( ; x < dsize.width; x++ )
+                D[x] = castOp(row2[x]*6 + (row1[x] + row3[x])*4 + row0[x] + row4[x]);
         }
+        nextY = y1;
+    }
 
-        // do vertical convolution and decimation and write the result to the destination image
-        for( k = 0; k < PD_SZ; k++ )
-            rows[k] = buf + ((y*2 - PD_SZ/2 + k - sy0) % PD_SZ)*bufstep;
-        row0 = rows[0]; row1 = rows[1]; row2 = rows[2]; row3 = rows[3]; row4 = rows[4];
+private:
+    const Mat& src;
+    Mat& dst;
+    int borderType;
+    Size ssize, dsize;
+    int cn, width0, bufstep;
+    AutoBuffer<WT> _buf;
+    WT* buf;
+    int tabL[CV_CN_MAX*(PD_SZ+2)], tabR[CV_CN_MAX*(PD_SZ+2)];
+    AutoBuffer<int> _tabM;
+    int* tabM;
+    int sy0, sy, nextY;
 
-        x = vecOp(rows, dst, (int)_dst.step, dsize.width);
-        for( ; x < dsize.width; x++ )
-            dst[x] = castOp(row2[x]*6 + (row1[x] + row3[x])*4 + row0[x] + row4[x]);
+    PyrDownRows(const PyrDownRows&); // disabled
+    PyrDownRows& operator=(const PyrDownRows&); // disabled
+};
+
+// the number of row bands a pyramid level is split into
+static int getPyrBandCount( const Mat& dst )
+{
+    int nthreads = getNumThreads();
+    if( nthreads <= 1 || (double)dst.total()*dst.elemSize() < (double)(1 << 16) )
+        return 1;
+    // every band convolves two extra source rows on each side
+    return std::max(std::min(dst.rows/16, nthreads), 1);
+}
+
+template<class CastOp, class VecOp> class PyrDownInvoker : public ParallelLoopBody
+{
+public:
+    PyrDownInvoker( const Mat& _src, Mat& _dst, int _borderType )
+        : src(_src), dst(_dst), borderType(_borderType)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const
+    {
+        PyrDownRows<CastOp, VecOp> rows(src, dst, borderType);
+        rows(range.start, range.end);
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    int borderType;
+
+    PyrDownInvoker& operator=(const PyrDownInvoker&); // disabled
+};
+
+template<class CastOp, class VecOp> void
+pyrDown_( const Mat& _src, Mat& _dst, int borderType )
+{
+    int nbands = getPyrBandCount(_dst);
+    if( nbands <= 1 )
+    {
+        PyrDownRows<CastOp, VecOp> rows(_src, _dst, borderType);
+        rows(0, _dst.rows);
+        return;
     }
+    parallel_for_(Range(0, _dst.rows), PyrDownInvoker<CastOp, VecOp>(_src, _dst, borderType), nbands);
 }
 
+// Builds levels[1..nlevels] from levels[0] in a single pass: every new row of a level
+// is fed to the next level right away, while the rows it needs are still in cache.
+template<class CastOp, class VecOp> void
+pyrDownFused_( Mat* levels, int nlevels, int borderType )
+{
+    std::vector<Ptr<PyrDownRows<CastOp, VecOp> > > stages(nlevels);
+    std::vector<int> ready(nlevels + 1, 0);
+    int i;
+
+    for( i = 0; i < nlevels; i++ )
+        stages[i] = Ptr<PyrDownRows<CastOp, VecOp> >(new PyrDownRows<CastOp, VecOp>(levels[i], levels[i+1], borderType));
+    ready[0] = levels[0].rows;
 
+    while( ready[nlevels] < levels[nlevels].rows )
+    {
+        for( i = 0; i < nlevels; i++ )
+        {
+            int y0 = ready[i+1], y1 = y0, rows = levels[i+1].rows;
+            // the first level advances by a few rows per step, the others as far as their source allows
+            int limit = i == 0 ? std::min(y0 + 8, rows) : rows;
+            while( y1 < limit && stages[i]->srcRowsUsed(y1) <= ready[i] )
+                y1++;
+            if( y1 > y0 )
+            {
+                (*stages[i])(y0, y1);
+                ready[i+1] = y1;
+            }
+        }
+    }
+}
+
+
+// computes the destination rows produced from the source rows [y0, y1)
 template<class CastOp, class VecOp> void
-pyrUp_( const Mat& _src, Mat& _dst, int)
+pyrUpRows_( const Mat& _src, Mat& _dst, int y0, int y1 )
 {
     const int PU_SZ = 3;
     typedef typename CastOp::type1 WT;
@@ -994,7 +1113,7 @@ pyrUp_( const Mat& _src, Mat& _dst, int)
 
     CV_Assert( std::abs(dsize.width - ssize.width*2) == dsize.width % 2 &&
                std::abs(dsize.height - ssize.height*2) == dsize.height % 2);
-    int k, x, sy0 = -PU_SZ/2, sy = sy0;
+    int k, x, sy0 = y0 - PU_SZ/2, sy = sy0;
 
     ssize.width *= cn;
     dsize.width *= cn;
@@ -1002,7 +1121,7 @@ pyrUp_( const Mat& _src, Mat& _dst, int)
     for( x = 0; x < ssize.width; x++ )
         dtab[x] = (x/cn)*2*cn + x % cn;
 
-    for( int y = 0; y < ssize.height; y++ )
+    for( int y = y0; y < y1; y++ )
     {
         T* dst0 = _dst.ptr<T>(y*2);
         T* dst1 = _dst.ptr<T>(std::min(y*2+1, dsize.height-1));
@@ -1064,13 +1183,46 @@ pyrUp_( const Mat& _src, Mat& _dst, int)
             dst1[x] = t1; dst0[x] = t0;
         }
     }
+}
+
+template<class CastOp, class VecOp> class PyrUpInvoker : public ParallelLoopBody
+{
+public:
+    PyrUpInvoker( const Mat& _src, Mat& _dst )
+        : src(_src), dst(_dst)
+    {
+    }
 
-    if (dsize.height > ssize.height*2)
+    virtual void operator()( const Range& range ) const
     {
-        T* dst0 = _dst.ptr<T>(ssize.height*2-2);
-        T* dst2 = _dst.ptr<T>(ssize.height*2);
+        pyrUpRows_<CastOp, VecOp>(src, dst, range.start, range.end);
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+
+    PyrUpInvoker& operator=(const PyrUpInvoker&); // disabled
+};
 
-        for(x = 0; x < dsize.width ; x++ )
+template<class CastOp, class VecOp> void
+pyrUp_( const Mat& _src, Mat& _dst, int)
+{
+    typedef typename CastOp::rtype T;
+
+    int nbands = std::min(getPyrBandCount(_dst), _src.rows);
+    if( nbands <= 1 )
+        pyrUpRows_<CastOp, VecOp>(_src, _dst, 0, _src.rows);
+    else
+        parallel_for_(Range(0, _src.rows), PyrUpInvoker<CastOp, VecOp>(_src, _dst), nbands);
+
+    if (_dst.rows > _src.rows*2)
+    {
+        const T* dst0 = _dst.ptr<T>(_src.rows*2-2);
+        T* dst2 = _dst.ptr<T>(_src.rows*2);
+        int width = _dst.cols*_dst.channels();
+
+        for(int x = 0; x < width ; x++ )
         {
             dst2[x] = dst0[x];
         }
@@ -1078,6 +1230,48 @@ pyrUp_( const Mat& _src, Mat& _dst, int)
 }
 
 typedef void (*PyrFunc)(const Mat&, Mat&, int);
+typedef void (*PyrFusedFunc)(Mat*, int, int);
+
+// Fills levels[1..maxlevel] from levels[0]. Levels large enough to be split into
+// row bands are computed one by one, in parallel; the remaining ones are built in
+// a single fused pass.
+static void buildPyramidLevels( std::vector<Mat>& levels, int maxlevel, int borderType )
+{
+    int i = 1, depth = levels[0].depth();
+
+    for( ; i <= maxlevel; i++ )
+    {
+        if( getPyrBandCount(levels[i]) <= 1 )
+            break;
+        pyrDown( levels[i-1], levels[i], levels[i].size(), borderType );
+    }
+
+    // BORDER_WRAP reads the bottom rows of the source before its top rows are produced
+    if( (borderType & ~BORDER_ISOLATED) == BORDER_WRAP )
+    {
+        for( ; i <= maxlevel; i++ )
+            pyrDown( levels[i-1], levels[i], levels[i].size(), borderType );
+        return;
+    }
+    if( i > maxlevel )
+        return;
+
+    PyrFusedFunc func = 0;
+    if( depth == CV_8U )
+        func = pyrDownFused_<FixPtCast<uchar, 8>, PyrDownVec_32s8u>;
+    else if( depth == CV_16S )
+        func = pyrDownFused_<FixPtCast<short, 8>, PyrDownVec_32s16s >;
+    else if( depth == CV_16U )
+        func = pyrDownFused_<FixPtCast<ushort, 8>, PyrDownVec_32s16u >;
+    else if( depth == CV_32F )
+        func = pyrDownFused_<FltCast<float, 8>, PyrDownVec_32f>;
+    else if( depth == CV_64F )
+        func = pyrDownFused_<FltCast<double, 8>, PyrDownNoVec<double, double> >;
+    else
+        CV_Error( CV_StsUnsupportedFormat, "" );
+
+    func( &levels[i-1], maxlevel - i + 1, borderType );
+}
 
 #ifdef HAVE_OPENCL
 
@@ -1634,8 +1828,46 @@ void cv::buildPyramid( InputArray _src, OutputArrayOfArrays _dst, int maxlevel,
     CV_IPP_RUN(((IPP_VERSION_X100 >= 810) && ((borderType & ~BORDER_ISOLATED) == BORDER_DEFAULT && (!_src.isSubmatrix() || ((borderType & BORDER_ISOLATED) != 0)))),
         ipp_buildpyramid( _src,  _dst,  maxlevel,  borderType));
 
-    for( ; i <= maxlevel; i++ )
-        pyrDown( _dst.getMatRef(i-1), _dst.getMatRef(i), Size(), borderType );
+    if( maxlevel <= 0 )
+        return;
+
+    // Levels that already have the right size and type (e.g. when the same pyramid is
+    // rebuilt for every frame) are reused; otherwise all of them are placed in one
+    // contiguous buffer.
+    std::vector<Mat> levels(maxlevel + 1);
+    std::vector<Size> sizes(maxlevel + 1);
+    bool reuse = true;
+    int total = 0;
+    levels[0] = src;
+    sizes[0] = src.size();
+    for( i = 1; i <= maxlevel; i++ )
+    {
+        sizes[i] = Size((sizes[i-1].width + 1)/2, (sizes[i-1].height + 1)/2);
+        levels[i] = _dst.getMatRef(i);
+        reuse = reuse && levels[i].size() == sizes[i] && levels[i].type() == src.type();
+        total += sizes[i].area();
+    }
+
+    if( !reuse )
+    {
+        Mat buf(1, total, src.type());
+        int ofs = 0;
+        for( i = 1; i <= maxlevel; i++ )
+        {
+            int area = sizes[i].area();
+            Mat& level = levels[i];
+            level = buf.colRange(ofs, ofs + area).reshape(0, sizes[i].height);
+            // make every level look like a standalone image, so that filters with
+            // non-isolated borders do not treat the neighbouring levels as ROI context
+            level.datastart = level.data;
+            level.dataend = level.datalimit = level.data + level.rows*level.step[0];
+            level.flags &= ~Mat::SUBMATRIX_FLAG;
+            _dst.getMatRef(i) = level;
+            ofs += area;
+        }
+    }
+
+    buildPyramidLevels( levels, maxlevel, borderType );
 }
 
 CV_IMPL void cvPyrDown( const void* srcarr, void* dstarr, int _filter )
@@ -1401,6 +1401,34 @@ cv::Ptr<cv::FilterEngine> cv::createBoxFilter( int srcType, int dstType, Size ks
            srcType, dstType, sumType, borderType );
 }
 
+namespace cv
+{
+
+class BoxFilterCreator : public FilterEngineCreator
+{
+public:
+    BoxFilterCreator(int _srcType, int _dstType, Size _ksize, Point _anchor,
+                     bool _normalize, int _borderType)
+        : srcType(_srcType), dstType(_dstType), ksize(_ksize), anchor(_anchor),
+          normalize(_normalize), borderType(_borderType)
+    {
+    }
+
+    virtual Ptr<FilterEngine> create() const
+    {
+        return createBoxFilter(srcType, dstType, ksize, anchor, normalize, borderType);
+    }
+
+private:
+    int srcType, dstType;
+    Size ksize;
+    Point anchor;
+    bool normalize;
+    int borderType;
+};
+
+}
+
 #ifdef HAVE_OPENVX
 namespace cv
 {
@@ -1572,10 +1600,10 @@ void cv::boxFilter( InputArray _src, OutputArray _dst, int ddepth,
 
     borderType = (borderType&~BORDER_ISOLATED);
 
-    Ptr<FilterEngine> f = createBoxFilter( src.type(), dst.type(),
-                        ksize, anchor, normalize, borderType );
+    BoxFilterCreator creator( src.type(), dst.type(),
+                              ksize, anchor, normalize, borderType );
 
-    f->apply( src, dst, wsz, ofs );
+    parallelFilter( creator, src, dst, wsz, ofs );
 }
 
 
@@ -1660,6 +1688,35 @@ static Ptr<BaseRowFilter> getSqrRowSumFilter(int srcType, int sumType, int ksize
     return Ptr<BaseRowFilter>();
 }
 
+class SqrBoxFilterCreator : public FilterEngineCreator
+{
+public:
+    SqrBoxFilterCreator(int _srcType, int _sumType, int _dstType, Size _ksize, Point _anchor,
+                        bool _normalize, int _borderType)
+        : srcType(_srcType), sumType(_sumType), dstType(_dstType), ksize(_ksize), anchor(_anchor),
+          normalize(_normalize), borderType(_borderType)
+    {
+    }
+
+    virtual Ptr<FilterEngine> create() const
+    {
+        Ptr<BaseRowFilter> rowFilter = getSqrRowSumFilter(srcType, sumType, ksize.width, anchor.x );
+        Ptr<BaseColumnFilter> columnFilter = getColumnSumFilter(sumType,
+                                                                dstType, ksize.height, anchor.y,
+                                                                normalize ? 1./(ksize.width*ksize.height) : 1);
+
+        return makePtr<FilterEngine>(Ptr<BaseFilter>(), rowFilter, columnFilter,
+                                     srcType, dstType, sumType, borderType );
+    }
+
+private:
+    int srcType, sumType, dstType;
+    Size ksize;
+    Point anchor;
+    bool normalize;
+    int borderType;
+};
+
 }
 
 void cv::sqrBoxFilter( InputArray _src, OutputArray _dst, int ddepth,
@@ -1694,18 +1751,12 @@ void cv::sqrBoxFilter( InputArray _src, OutputArray _dst, int ddepth,
     _dst.create( size, dstType );
     Mat dst = _dst.getMat();
 
-    Ptr<BaseRowFilter> rowFilter = getSqrRowSumFilter(srcType, sumType, ksize.width, anchor.x );
-    Ptr<BaseColumnFilter> columnFilter = getColumnSumFilter(sumType,
-                                                            dstType, ksize.height, anchor.y,
-                                                            normalize ? 1./(ksize.width*ksize.height) : 1);
-
-    Ptr<FilterEngine> f = makePtr<FilterEngine>(Ptr<BaseFilter>(), rowFilter, columnFilter,
-                                                srcType, dstType, sumType, borderType );
+    SqrBoxFilterCreator creator(srcType, sumType, dstType, ksize, anchor, normalize, borderType);
     Point ofs;
     Size wsz(src.cols, src.rows);
     src.locateROI( wsz, ofs );
 
-    f->apply( src, dst, wsz, ofs );
+    parallelFilter( creator, src, dst, wsz, ofs );
 }
 
 
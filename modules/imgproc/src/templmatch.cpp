@@ -841,73 +841,75 @@ static void matchTemplateMask( InputArray _img, InputArray _templ, OutputArray _
         CV_Error(Error::StsNotImplemented, "");
 }
 
-static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int cn )
+// Derives the template terms of the normalization from the template mean and standard
+// deviation. Returns false if the result is 1 everywhere (a flat template with TM_CCOEFF_NORMED).
+static bool getTemplateNormTerms( int method, Size tsize, const Scalar& mean, const Scalar& sdv,
+                                  Scalar& templMean, double& templNorm, double& templSum2 )
 {
-    if( method == CV_TM_CCORR )
-        return;
-
     int numType = method == CV_TM_CCORR || method == CV_TM_CCORR_NORMED ? 0 :
                   method == CV_TM_CCOEFF || method == CV_TM_CCOEFF_NORMED ? 1 : 2;
-    bool isNormed = method == CV_TM_CCORR_NORMED ||
-                    method == CV_TM_SQDIFF_NORMED ||
-                    method == CV_TM_CCOEFF_NORMED;
+    double invArea = 1./((double)tsize.height * tsize.width);
 
-    double invArea = 1./((double)templ.rows * templ.cols);
+    templMean = mean;
+    templNorm = templSum2 = 0;
+    if( method == CV_TM_CCOEFF )
+        return true;
 
-    Mat sum, sqsum;
-    Scalar templMean, templSdv;
-    double *q0 = 0, *q1 = 0, *q2 = 0, *q3 = 0;
-    double templNorm = 0, templSum2 = 0;
+    templNorm = sdv[0]*sdv[0] + sdv[1]*sdv[1] + sdv[2]*sdv[2] + sdv[3]*sdv[3];
 
-    if( method == CV_TM_CCOEFF )
-    {
-        integral(img, sum, CV_64F);
-        templMean = mean(templ);
-    }
-    else
-    {
-        integral(img, sum, sqsum, CV_64F);
-        meanStdDev( templ, templMean, templSdv );
+    if( templNorm < DBL_EPSILON && method == CV_TM_CCOEFF_NORMED )
+        return false;
 
-        templNorm = templSdv[0]*templSdv[0] + templSdv[1]*templSdv[1] + templSdv[2]*templSdv[2] + templSdv[3]*templSdv[3];
+    templSum2 = templNorm + mean[0]*mean[0] + mean[1]*mean[1] + mean[2]*mean[2] + mean[3]*mean[3];
 
-        if( templNorm < DBL_EPSILON && method == CV_TM_CCOEFF_NORMED )
-        {
-            result = Scalar::all(1);
-            return;
-        }
+    if( numType != 1 )
+    {
+        templMean = Scalar::all(0);
+        templNorm = templSum2;
+    }
 
-        templSum2 = templNorm + templMean[0]*templMean[0] + templMean[1]*templMean[1] + templMean[2]*templMean[2] + templMean[3]*templMean[3];
+    templSum2 /= invArea;
+    templNorm = std::sqrt(templNorm);
+    templNorm /= std::sqrt(invArea); // care of accuracy here
+    return true;
+}
 
-        if( numType != 1 )
-        {
-            templMean = Scalar::all(0);
-            templNorm = templSum2;
-        }
+// Turns the cross-correlation in the given rows of result into the score of the method,
+// using the integral images of the image (sqsum is not needed for CV_TM_CCOEFF)
+static void normalizeCorrRows( const Mat& sum, const Mat& sqsum, Size tsize, int cn, int method,
+                               const Scalar& templMean, double templNorm, double templSum2,
+                               Mat& result, const Range& rows )
+{
+    int numType = method == CV_TM_CCORR || method == CV_TM_CCORR_NORMED ? 0 :
+                  method == CV_TM_CCOEFF || method == CV_TM_CCOEFF_NORMED ? 1 : 2;
+    bool isNormed = method == CV_TM_CCORR_NORMED ||
+                    method == CV_TM_SQDIFF_NORMED ||
+                    method == CV_TM_CCOEFF_NORMED;
 
-        templSum2 /= invArea;
-        templNorm = std::sqrt(templNorm);
-        templNorm /= std::sqrt(invArea); // care of accuracy here
+    double invArea = 1./((double)tsize.height * tsize.width);
+    double *q0 = 0, *q1 = 0, *q2 = 0, *q3 = 0;
 
+    if( method != CV_TM_CCOEFF )
+    {
         CV_Assert(sqsum.data != NULL);
         q0 = (double*)sqsum.data;
-        q1 = q0 + templ.cols*cn;
-        q2 = (double*)(sqsum.data + templ.rows*sqsum.step);
-        q3 = q2 + templ.cols*cn;
+        q1 = q0 + tsize.width*cn;
+        q2 = (double*)(sqsum.data + tsize.height*sqsum.step);
+        q3 = q2 + tsize.width*cn;
     }
 
     CV_Assert(sum.data != NULL);
     double* p0 = (double*)sum.data;
-    double* p1 = p0 + templ.cols*cn;
-    double* p2 = (double*)(sum.data + templ.rows*sum.step);
-    double* p3 = p2 + templ.cols*cn;
+    double* p1 = p0 + tsize.width*cn;
+    double* p2 = (double*)(sum.data + tsize.height*sum.step);
+    double* p3 = p2 + tsize.width*cn;
 
     int sumstep = sum.data ? (int)(sum.step / sizeof(double)) : 0;
     int sqstep = sqsum.data ? (int)(sqsum.step / sizeof(double)) : 0;
 
     int i, j, k;
 
-    for( i = 0; i < result.rows; i++ )
+    for( i = rows.start; i < rows.end; i++ )
     {
         float* rrow = result.ptr<float>(i);
         int idx = i * sumstep;
@@ -960,6 +962,353 @@ static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method,
         }
     }
 }
+
+static void common_matchTemplate( Mat& img, Mat& templ, Mat& result, int method, int cn )
+{
+    if( method == CV_TM_CCORR )
+        return;
+
+    Mat sum, sqsum;
+    Scalar mean, sdv, templMean;
+    double templNorm = 0, templSum2 = 0;
+
+    if( method == CV_TM_CCOEFF )
+    {
+        integral(img, sum, CV_64F);
+        mean = cv::mean(templ);
+    }
+    else
+    {
+        integral(img, sum, sqsum, CV_64F);
+        meanStdDev( templ, mean, sdv );
+    }
+
+    if( !getTemplateNormTerms(method, templ.size(), mean, sdv, templMean, templNorm, templSum2) )
+    {
+        result = Scalar::all(1);
+        return;
+    }
+
+    normalizeCorrRows(sum, sqsum, templ.size(), cn, method, templMean, templNorm, templSum2,
+                      result, Range(0, result.rows));
+}
+
+class MatchTemplateNormInvoker : public ParallelLoopBody
+{
+public:
+    MatchTemplateNormInvoker( const Mat& _sum, const Mat& _sqsum, Size _tsize, int _cn, int _method,
+                              const Scalar& _templMean, double _templNorm, double _templSum2, Mat& _result )
+        : sum(_sum), sqsum(_sqsum), tsize(_tsize), cn(_cn), method(_method),
+          templMean(_templMean), templNorm(_templNorm), templSum2(_templSum2), result(_result)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const
+    {
+        normalizeCorrRows(sum, sqsum, tsize, cn, method, templMean, templNorm, templSum2, result, range);
+    }
+
+private:
+    const Mat& sum;
+    const Mat& sqsum;
+    Size tsize;
+    int cn, method;
+    Scalar templMean;
+    double templNorm, templSum2;
+    Mat& result;
+
+    MatchTemplateNormInvoker& operator=(const MatchTemplateNormInvoker&); // disabled
+};
+
+// Correlates the image with all the templates, tile by tile. Every image tile is transformed
+// once; its spectrum is multiplied by the spectrum of each template, the products of all the
+// channels are summed up and a single inverse transform gives the correlation block.
+class TemplateCorrInvoker : public ParallelLoopBody
+{
+public:
+    TemplateCorrInvoker( const Mat& _img, const std::vector<Mat>& _spectra, std::vector<Mat>& _results,
+                         Size _dftsize, Size _blocksize, int _tileCountX, int _maxDepth )
+        : img(_img), spectra(_spectra), results(_results), dftsize(_dftsize), blocksize(_blocksize),
+          tileCountX(_tileCountX), maxDepth(_maxDepth)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const
+    {
+        int cn = img.channels();
+        Mat dftImg(dftsize.height*cn, dftsize.width, maxDepth);
+        Mat acc(dftsize, maxDepth), prod(dftsize, maxDepth), plane;
+
+        Ptr<hal::DFT2D> cF = hal::DFT2D::create(dftsize.width, dftsize.height, maxDepth, 1, 1,
+                                                CV_HAL_DFT_IS_INPLACE, dftsize.height);
+        Ptr<hal::DFT2D> cR = hal::DFT2D::create(dftsize.width, dftsize.height, maxDepth, 1, 1,
+                                                CV_HAL_DFT_IS_INPLACE | CV_HAL_DFT_INVERSE | CV_HAL_DFT_SCALE,
+                                                blocksize.height);
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int x = (i % tileCountX)*blocksize.width;
+            int y = (i / tileCountX)*blocksize.height;
+            Mat src0(img, Rect(x, y, std::min(dftsize.width, img.cols - x),
+                               std::min(dftsize.height, img.rows - y)));
+            int k;
+
+            for( k = 0; k < cn; k++ )
+            {
+                Mat dst(dftImg, Rect(0, k*dftsize.height, dftsize.width, dftsize.height));
+                Mat dst1(dst, Rect(0, 0, src0.cols, src0.rows));
+                dst = Scalar::all(0);
+
+                if( cn > 1 )
+                {
+                    extractChannel(src0, plane, k);
+                    plane.convertTo(dst1, maxDepth);
+                }
+                else
+                    src0.convertTo(dst1, maxDepth);
+
+                if( src0.rows == dftsize.height )
+                    cF->apply(dst.data, (int)dst.step, dst.data, (int)dst.step);
+                else
+                    dft(dst, dst, 0, src0.rows);
+            }
+
+            for( size_t t = 0; t < results.size(); t++ )
+            {
+                Mat& corr = results[t];
+                Size bsz(std::min(blocksize.width, corr.cols - x),
+                         std::min(blocksize.height, corr.rows - y));
+                if( bsz.width <= 0 || bsz.height <= 0 )
+                    continue;
+
+                for( k = 0; k < cn; k++ )
+                {
+                    Mat src(dftImg, Rect(0, k*dftsize.height, dftsize.width, dftsize.height));
+                    Mat templSpec(spectra[t], Rect(0, k*dftsize.height, dftsize.width, dftsize.height));
+                    if( k == 0 )
+                        mulSpectrums(src, templSpec, acc, 0, true);
+                    else
+                    {
+                        mulSpectrums(src, templSpec, prod, 0, true);
+                        add(acc, prod, acc);
+                    }
+                }
+
+                if( bsz.height == blocksize.height )
+                    cR->apply(acc.data, (int)acc.step, acc.data, (int)acc.step);
+                else
+                    dft(acc, acc, DFT_INVERSE + DFT_SCALE, bsz.height);
+
+                Mat cdst(corr, Rect(x, y, bsz.width, bsz.height));
+                acc(Rect(0, 0, bsz.width, bsz.height)).convertTo(cdst, CV_32F);
+            }
+        }
+    }
+
+private:
+    const Mat& img;
+    const std::vector<Mat>& spectra;
+    std::vector<Mat>& results;
+    Size dftsize, blocksize;
+    int tileCountX, maxDepth;
+
+    TemplateCorrInvoker& operator=(const TemplateCorrInvoker&); // disabled
+};
+
+class TemplateSpectrumInvoker : public ParallelLoopBody
+{
+public:
+    TemplateSpectrumInvoker( const std::vector<Mat>& _templs, std::vector<Mat>& _spectra,
+                             Size _dftsize, int _maxDepth )
+        : templs(_templs), spectra(_spectra), dftsize(_dftsize), maxDepth(_maxDepth)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const
+    {
+        Mat plane;
+        for( int i = range.start; i < range.end; i++ )
+        {
+            if( !spectra[i].empty() )
+                continue;
+
+            const Mat& templ = templs[i];
+            int cn = templ.channels();
+            Mat spectrum(dftsize.height*cn, dftsize.width, maxDepth, Scalar::all(0));
+
+            for( int k = 0; k < cn; k++ )
+            {
+                Mat dst(spectrum, Rect(0, k*dftsize.height, dftsize.width, dftsize.height));
+                Mat dst1(dst, Rect(0, 0, templ.cols, templ.rows));
+                if( cn > 1 )
+                {
+                    extractChannel(templ, plane, k);
+                    plane.convertTo(dst1, maxDepth);
+                }
+                else
+                    templ.convertTo(dst1, maxDepth);
+                dft(dst, dst, 0, templ.rows);
+            }
+            spectra[i] = spectrum;
+        }
+    }
+
+private:
+    const std::vector<Mat>& templs;
+    std::vector<Mat>& spectra;
+    Size dftsize;
+    int maxDepth;
+
+    TemplateSpectrumInvoker& operator=(const TemplateSpectrumInvoker&); // disabled
+};
+
+class TemplateMatcherImpl : public TemplateMatcher
+{
+public:
+    TemplateMatcherImpl( int _method ) : method(_method), spectraDepth(-1)
+    {
+        CV_Assert( CV_TM_SQDIFF <= method && method <= CV_TM_CCOEFF_NORMED );
+    }
+
+    int add( InputArray _templ )
+    {
+        Mat templ = _templ.getMat();
+        int type = templ.type(), depth = CV_MAT_DEPTH(type);
+        CV_Assert( !templ.empty() && templ.dims <= 2 && (depth == CV_8U || depth == CV_32F) );
+        CV_Assert( templs.empty() || type == templs[0].type() );
+
+        Scalar mean, sdv;
+        meanStdDev(templ, mean, sdv);
+
+        templs.push_back(templ.clone());
+        templMeans.push_back(mean);
+        templSdvs.push_back(sdv);
+        spectra.push_back(Mat());
+        return (int)templs.size() - 1;
+    }
+
+    void clear()
+    {
+        templs.clear();
+        templMeans.clear();
+        templSdvs.clear();
+        spectra.clear();
+    }
+
+    int getTemplatesCount() const { return (int)templs.size(); }
+
+    void setMethod( int _method )
+    {
+        CV_Assert( CV_TM_SQDIFF <= _method && _method <= CV_TM_CCOEFF_NORMED );
+        method = _method;
+    }
+
+    int getMethod() const { return method; }
+
+    void match( InputArray _img, OutputArrayOfArrays _results );
+
+private:
+    int method;
+    std::vector<Mat> templs;
+    std::vector<Scalar> templMeans, templSdvs;
+
+    // template spectra, valid for the transform size and depth they were computed with
+    std::vector<Mat> spectra;
+    Size spectraSize;
+    int spectraDepth;
+};
+
+void TemplateMatcherImpl::match( InputArray _img, OutputArrayOfArrays _results )
+{
+    CV_INSTRUMENT_REGION()
+
+    const double blockScale = 4.5;
+    const int minBlockSize = 256;
+
+    Mat img = _img.getMat();
+    int ntempl = (int)templs.size(), cn = img.channels(), i;
+    CV_Assert( ntempl > 0 && img.dims <= 2 && img.type() == templs[0].type() );
+
+    // one tiling for all the templates: the tiles overlap by the largest template
+    // and cover the result of the smallest one
+    Size tmax(0, 0), tmin(INT_MAX, INT_MAX);
+    for( i = 0; i < ntempl; i++ )
+    {
+        Size tsize = templs[i].size();
+        CV_Assert( tsize.width <= img.cols && tsize.height <= img.rows );
+        tmax = Size(std::max(tmax.width, tsize.width), std::max(tmax.height, tsize.height));
+        tmin = Size(std::min(tmin.width, tsize.width), std::min(tmin.height, tsize.height));
+    }
+    Size corrMax(img.cols - tmin.width + 1, img.rows - tmin.height + 1);
+
+    int maxDepth = img.depth() > CV_8S ? CV_64F : CV_32F;
+    Size blocksize, dftsize;
+
+    blocksize.width = cvRound(tmax.width*blockScale);
+    blocksize.width = std::max( blocksize.width, minBlockSize - tmax.width + 1 );
+    blocksize.width = std::min( blocksize.width, corrMax.width );
+    blocksize.height = cvRound(tmax.height*blockScale);
+    blocksize.height = std::max( blocksize.height, minBlockSize - tmax.height + 1 );
+    blocksize.height = std::min( blocksize.height, corrMax.height );
+
+    dftsize.width = std::max(getOptimalDFTSize(blocksize.width + tmax.width - 1), 2);
+    dftsize.height = getOptimalDFTSize(blocksize.height + tmax.height - 1);
+    if( dftsize.width <= 0 || dftsize.height <= 0 )
+        CV_Error( CV_StsOutOfRange, "the input arrays are too big" );
+
+    // recompute block size
+    blocksize.width = std::min( dftsize.width - tmax.width + 1, corrMax.width );
+    blocksize.height = std::min( dftsize.height - tmax.height + 1, corrMax.height );
+
+    if( dftsize != spectraSize || maxDepth != spectraDepth )
+    {
+        for( i = 0; i < ntempl; i++ )
+            spectra[i].release();
+        spectraSize = dftsize;
+        spectraDepth = maxDepth;
+    }
+    parallel_for_(Range(0, ntempl), TemplateSpectrumInvoker(templs, spectra, dftsize, maxDepth));
+
+    std::vector<Mat> results(ntempl);
+    _results.create(ntempl, 1, CV_32F);
+    for( i = 0; i < ntempl; i++ )
+    {
+        Size corrSize(img.cols - templs[i].cols + 1, img.rows - templs[i].rows + 1);
+        _results.create(corrSize, CV_32F, i);
+        results[i] = _results.getMat(i);
+    }
+
+    int tileCountX = (corrMax.width + blocksize.width - 1)/blocksize.width;
+    int tileCountY = (corrMax.height + blocksize.height - 1)/blocksize.height;
+    parallel_for_(Range(0, tileCountX*tileCountY),
+                  TemplateCorrInvoker(img, spectra, results, dftsize, blocksize, tileCountX, maxDepth));
+
+    if( method == CV_TM_CCORR )
+        return;
+
+    // the integral images of the image are shared by all the templates
+    Mat sum, sqsum;
+    if( method == CV_TM_CCOEFF )
+        integral(img, sum, CV_64F);
+    else
+        integral(img, sum, sqsum, CV_64F);
+
+    for( i = 0; i < ntempl; i++ )
+    {
+        Scalar templMean;
+        double templNorm = 0, templSum2 = 0;
+        if( !getTemplateNormTerms(method, templs[i].size(), templMeans[i], templSdvs[i],
+                                  templMean, templNorm, templSum2) )
+        {
+            results[i] = Scalar::all(1);
+            continue;
+        }
+        parallel_for_(Range(0, results[i].rows),
+                      MatchTemplateNormInvoker(sum, sqsum, templs[i].size(), cn, method,
+                                               templMean, templNorm, templSum2, results[i]),
+                      results[i].total()/(double)(1 << 16));
+    }
+}
 }
 
 
@@ -1130,6 +1479,11 @@ void cv::matchTemplate( InputArray _img, InputArray _templ, OutputArray _result,
     common_matchTemplate(img, templ, result, method, cn);
 }
 
+cv::Ptr<cv::TemplateMatcher> cv::createTemplateMatcher( int method )
+{
+    return makePtr<TemplateMatcherImpl>(method);
+}
+
 CV_IMPL void
 cvMatchTemplate( const CvArr* _img, const CvArr* _templ, CvArr* _result, int method )
 {
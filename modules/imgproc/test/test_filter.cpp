@@ -2119,4 +2119,286 @@ TEST(Imgproc_MorphEx, hitmiss_zero_kernel)
     ASSERT_DOUBLE_EQ(cvtest::norm(dst, src, NORM_INF), 0.);
 }
 
+TEST(Imgproc_Filtering, parallel_bands_bitexact)
+{
+    const int borderTypes[] = { BORDER_REPLICATE, BORDER_REFLECT_101, BORDER_CONSTANT,
+                                BORDER_REFLECT_101 | BORDER_ISOLATED };
+    const int types[] = { CV_8UC1, CV_8UC3, CV_16SC1, CV_32FC1 };
+    Mat kernel2D(5, 7, CV_32F), kernelX(1, 9, CV_32F), kernelY(7, 1, CV_32F);
+    randu(kernel2D, -1, 1);
+    randu(kernelX, -1, 1);
+    randu(kernelY, -1, 1);
+    int nthreads = getNumThreads();
+
+    for (size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++)
+    for (size_t b = 0; b < sizeof(borderTypes)/sizeof(borderTypes[0]); b++)
+    {
+        SCOPED_TRACE(cv::format("type=%d border=%d", types[t], borderTypes[b]));
+        Mat whole(613, 347, types[t]);
+        randu(whole, 0, 256);
+        Mat src = whole(Rect(3, 5, whole.cols - 10, whole.rows - 11));
+        int border = borderTypes[b];
+
+        Mat ref[7], dst[7];
+        for (int pass = 0; pass < 2; pass++)
+        {
+            Mat* d = pass == 0 ? ref : dst;
+            setNumThreads(pass == 0 ? 1 : std::max(nthreads, 4));
+            cv::filter2D(src, d[0], -1, kernel2D, Point(-1, -1), 3, border);
+            cv::sepFilter2D(src, d[1], CV_32F, kernelX, kernelY, Point(-1, -1), 0, border);
+            cv::Sobel(src, d[2], CV_32F, 1, 1, 5, 1, 0, border);
+            cv::Scharr(src, d[3], CV_32F, 0, 1, 1, 0, border);
+            cv::Laplacian(src, d[4], CV_32F, 7, 1, 0, border);
+            cv::boxFilter(src, d[5], -1, Size(9, 13), Point(-1, -1), true, border);
+            cv::sqrBoxFilter(src, d[6], -1, Size(5, 3), Point(-1, -1), false, border);
+        }
+        setNumThreads(nthreads);
+
+        // the box filters keep running sums along columns, so with floating-point sums
+        // the result depends slightly on the row the band starts from
+        for (int i = 0; i < 7; i++)
+        {
+            double eps = i >= 5 ? 1e-12*cvtest::norm(ref[i], NORM_INF) : 0;
+            EXPECT_LE(cvtest::norm(ref[i], dst[i], NORM_INF), eps) << "function #" << i;
+        }
+    }
+}
+
+
+template<typename T> static void naiveMorph(const Mat& src, Mat& dst, const Mat& kernel, bool dilate)
+{
+    Point anchor(kernel.cols/2, kernel.rows/2);
+    Mat ext;
+    cv::copyMakeBorder(src, ext, anchor.y, kernel.rows - anchor.y - 1,
+                   anchor.x, kernel.cols - anchor.x - 1, BORDER_REPLICATE);
+    int cn = src.channels();
+    dst.create(src.size(), src.type());
+    for (int y = 0; y < src.rows; y++)
+        for (int x = 0; x < src.cols*cn; x++)
+        {
+            T m = ext.at<T>(y + anchor.y, x + anchor.x*cn);
+            for (int ky = 0; ky < kernel.rows; ky++)
+                for (int kx = 0; kx < kernel.cols; kx++)
+                    if (kernel.at<uchar>(ky, kx))
+                    {
+                        T v = ext.ptr<T>(y + ky)[x + kx*cn];
+                        m = dilate ? std::max(m, v) : std::min(m, v);
+                    }
+            dst.ptr<T>(y)[x] = m;
+        }
+}
+
+TEST(Imgproc_Morphology, vector_tails_all_depths)
+{
+    const int depths[] = { CV_8U, CV_16U, CV_16S, CV_32F, CV_64F };
+    const Size ksizes[] = { Size(3, 3), Size(7, 1), Size(1, 4), Size(5, 5) };
+    RNG& rng = theRNG();
+
+    for (size_t d = 0; d < sizeof(depths)/sizeof(depths[0]); d++)
+    for (int cn = 1; cn <= 3; cn += 2)
+    for (size_t k = 0; k < sizeof(ksizes)/sizeof(ksizes[0]); k++)
+    for (int shape = MORPH_RECT; shape <= MORPH_ELLIPSE; shape += MORPH_ELLIPSE - MORPH_RECT)
+    {
+        // widths around every multiple of the vector length exercise the full, single
+        // and half-register loops as well as the scalar tail
+        int width = rng.uniform(1, 80);
+        Mat src(rng.uniform(1, 20), width, CV_MAKETYPE(depths[d], cn)), dst, ref;
+        randu(src, -100, 300);
+        Mat kernel = getStructuringElement(shape, ksizes[k]);
+        SCOPED_TRACE(cv::format("depth=%d cn=%d ksize=%dx%d shape=%d width=%d",
+                                depths[d], cn, ksizes[k].width, ksizes[k].height, shape, width));
+
+        for (int op = 0; op < 2; op++)
+        {
+            if (op == 0)
+                cv::erode(src, dst, kernel, Point(-1, -1), 1, BORDER_REPLICATE);
+            else
+                cv::dilate(src, dst, kernel, Point(-1, -1), 1, BORDER_REPLICATE);
+            switch (depths[d])
+            {
+            case CV_8U: naiveMorph<uchar>(src, ref, kernel, op == 1); break;
+            case CV_16U: naiveMorph<ushort>(src, ref, kernel, op == 1); break;
+            case CV_16S: naiveMorph<short>(src, ref, kernel, op == 1); break;
+            case CV_32F: naiveMorph<float>(src, ref, kernel, op == 1); break;
+            default: naiveMorph<double>(src, ref, kernel, op == 1); break;
+            }
+            ASSERT_EQ(0.0, cvtest::norm(ref, dst, NORM_INF)) << "op=" << op;
+        }
+    }
+}
+
+
+// min/max over a rectangle of the parent image, with the border handled pixel by pixel
+template<typename T> static void naiveRectMorph(const Mat& src, Mat& dst, Size ksize, Point anchor,
+                                                bool dilate, int borderType)
+{
+    Size wsz;
+    Point ofs;
+    src.locateROI(wsz, ofs);
+    const Mat whole(wsz, src.type(), (void*)(src.data - ofs.y*src.step - ofs.x*src.elemSize()), src.step);
+    int cn = src.channels();
+    T inf = dilate ? -std::numeric_limits<T>::max() : std::numeric_limits<T>::max();
+    if (dilate && std::numeric_limits<T>::is_integer)
+        inf = std::numeric_limits<T>::min();
+    dst.create(src.size(), src.type());
+    for (int y = 0; y < src.rows; y++)
+        for (int x = 0; x < src.cols; x++)
+            for (int c = 0; c < cn; c++)
+            {
+                T m = inf;
+                for (int ky = 0; ky < ksize.height; ky++)
+                {
+                    int sy = cv::borderInterpolate(y + ofs.y + ky - anchor.y, wsz.height, borderType);
+                    for (int kx = 0; kx < ksize.width; kx++)
+                    {
+                        int sx = cv::borderInterpolate(x + ofs.x + kx - anchor.x, wsz.width, borderType);
+                        T v = sy < 0 || sx < 0 ? inf : whole.ptr<T>(sy)[sx*cn + c];
+                        m = dilate ? std::max(m, v) : std::min(m, v);
+                    }
+                }
+                dst.ptr<T>(y)[x*cn + c] = m;
+            }
+}
+
+TEST(Imgproc_Morphology, large_rect_kernels)
+{
+    const int depths[] = { CV_8U, CV_16U, CV_16S, CV_32F, CV_64F };
+    const Size ksizes[] = { Size(31, 31), Size(61, 1), Size(1, 25), Size(9, 40), Size(70, 16) };
+    const int borderTypes[] = { BORDER_CONSTANT, BORDER_REPLICATE, BORDER_REFLECT_101 };
+    RNG& rng = theRNG();
+
+    for (size_t d = 0; d < sizeof(depths)/sizeof(depths[0]); d++)
+    for (size_t k = 0; k < sizeof(ksizes)/sizeof(ksizes[0]); k++)
+    for (size_t b = 0; b < sizeof(borderTypes)/sizeof(borderTypes[0]); b++)
+    {
+        int cn = rng.uniform(0, 2) ? 3 : 1;
+        Mat whole(rng.uniform(20, 90), rng.uniform(20, 90), CV_MAKETYPE(depths[d], cn));
+        randu(whole, -100, 300);
+        Rect roi(rng.uniform(0, 5), rng.uniform(0, 5), 0, 0);
+        roi.width = whole.cols - roi.x - rng.uniform(0, 5);
+        roi.height = whole.rows - roi.y - rng.uniform(0, 5);
+        Mat src = whole(roi), dst, ref;
+        Point anchor(rng.uniform(0, ksizes[k].width), rng.uniform(0, ksizes[k].height));
+        Mat kernel = getStructuringElement(MORPH_RECT, ksizes[k]);
+        SCOPED_TRACE(cv::format("depth=%d cn=%d ksize=%dx%d anchor=(%d,%d) border=%d size=%dx%d",
+                                depths[d], cn, ksizes[k].width, ksizes[k].height, anchor.x, anchor.y,
+                                borderTypes[b], src.cols, src.rows));
+
+        for (int op = 0; op < 2; op++)
+        {
+            if (op == 0)
+                cv::erode(src, dst, kernel, anchor, 1, borderTypes[b]);
+            else
+                cv::dilate(src, dst, kernel, anchor, 1, borderTypes[b]);
+            switch (depths[d])
+            {
+            case CV_8U: naiveRectMorph<uchar>(src, ref, ksizes[k], anchor, op == 1, borderTypes[b]); break;
+            case CV_16U: naiveRectMorph<ushort>(src, ref, ksizes[k], anchor, op == 1, borderTypes[b]); break;
+            case CV_16S: naiveRectMorph<short>(src, ref, ksizes[k], anchor, op == 1, borderTypes[b]); break;
+            case CV_32F: naiveRectMorph<float>(src, ref, ksizes[k], anchor, op == 1, borderTypes[b]); break;
+            default: naiveRectMorph<double>(src, ref, ksizes[k], anchor, op == 1, borderTypes[b]); break;
+            }
+            ASSERT_EQ(0.0, cvtest::norm(ref, dst, NORM_INF)) << "op=" << op;
+        }
+    }
+}
+
+TEST(Imgproc_Morphology, large_rect_kernel_inplace_iterated)
+{
+    Mat src(300, 257, CV_8UC1), ref, dst;
+    randu(src, 0, 256);
+    Mat kernel = getStructuringElement(MORPH_RECT, Size(5, 5));
+    Mat big = getStructuringElement(MORPH_RECT, Size(5 + 6*4, 5 + 6*4));
+
+    // seven iterations of a 5x5 element collapse into one 29x29 pass
+    cv::erode(src, ref, big, Point(-1, -1), 1, BORDER_REPLICATE);
+    dst = src.clone();
+    cv::erode(dst, dst, kernel, Point(-1, -1), 7, BORDER_REPLICATE);
+    ASSERT_EQ(0.0, cvtest::norm(ref, dst, NORM_INF));
+
+    naiveRectMorph<uchar>(src, dst, big.size(), Point(14, 14), false, BORDER_REPLICATE);
+    ASSERT_EQ(0.0, cvtest::norm(ref, dst, NORM_INF));
+}
+
+TEST(Imgproc_Pyramid, buildPyramid_parallel_fused_bitexact)
+{
+    const int borderTypes[] = { BORDER_REFLECT_101, BORDER_REFLECT, BORDER_REPLICATE, BORDER_WRAP };
+    const int types[] = { CV_8UC1, CV_8UC3, CV_16UC2, CV_16SC4, CV_32FC1, CV_64FC3 };
+    const int maxlevel = 5;
+    struct NumThreadsGuard
+    {
+        NumThreadsGuard() : n(getNumThreads()) {}
+        ~NumThreadsGuard() { setNumThreads(n); }
+        int n;
+    } threadsGuard;
+    const int nthreads = threadsGuard.n;
+
+    for (size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++)
+    for (size_t b = 0; b < sizeof(borderTypes)/sizeof(borderTypes[0]); b++)
+    {
+        SCOPED_TRACE(cv::format("type=%d border=%d", types[t], borderTypes[b]));
+        Mat whole(1031, 773, types[t]);
+        randu(whole, 0, 256);
+        Mat src = whole(Rect(2, 3, whole.cols - 7, whole.rows - 4));
+
+        // reference: level by level, single-threaded
+        setNumThreads(1);
+        std::vector<Mat> ref(maxlevel + 1);
+        ref[0] = src;
+        for (int i = 1; i <= maxlevel; i++)
+            cv::pyrDown(ref[i-1], ref[i], Size(), borderTypes[b]);
+        Mat upRef;
+        if (borderTypes[b] == BORDER_REFLECT_101)
+            cv::pyrUp(src, upRef);
+
+        for (int pass = 0; pass < 2; pass++)
+        {
+            setNumThreads(pass == 0 ? 1 : std::max(nthreads, 4));
+            std::vector<Mat> pyr;
+            cv::buildPyramid(src, pyr, maxlevel, borderTypes[b]);
+            ASSERT_EQ((size_t)maxlevel + 1, pyr.size());
+            // level storage is reused when the pyramid is rebuilt
+            const uchar* data1 = pyr[1].data;
+            cv::buildPyramid(src, pyr, maxlevel, borderTypes[b]);
+            EXPECT_EQ(data1, pyr[1].data);
+
+            for (int i = 0; i <= maxlevel; i++)
+            {
+                ASSERT_EQ(ref[i].size(), pyr[i].size()) << "level " << i;
+                EXPECT_EQ(0.0, cvtest::norm(ref[i], pyr[i], NORM_INF)) << "level " << i << " pass " << pass;
+            }
+
+            if (!upRef.empty())
+            {
+                Mat up;
+                cv::pyrUp(src, up);
+                EXPECT_EQ(0.0, cvtest::norm(upRef, up, NORM_INF)) << "pyrUp pass " << pass;
+            }
+        }
+    }
+}
+
+TEST(Imgproc_Pyramid, buildPyramid_levels_are_not_roi)
+{
+    Mat src(480, 640, CV_8UC1);
+    randu(src, 0, 256);
+    std::vector<Mat> pyr;
+    cv::buildPyramid(src, pyr, 4);
+
+    for (size_t i = 1; i < pyr.size(); i++)
+    {
+        SCOPED_TRACE(cv::format("level %d", (int)i));
+        Size wholeSize; Point ofs;
+        pyr[i].locateROI(wholeSize, ofs);
+        EXPECT_EQ(pyr[i].size(), wholeSize);
+        EXPECT_EQ(Point(0, 0), ofs);
+
+        // the border context must not come from the neighbouring levels
+        Mat dst, ref;
+        cv::GaussianBlur(pyr[i], dst, Size(5, 5), 0);
+        cv::GaussianBlur(pyr[i].clone(), ref, Size(5, 5), 0);
+        EXPECT_EQ(0.0, cvtest::norm(ref, dst, NORM_INF));
+    }
+}
+
 }} // namespace
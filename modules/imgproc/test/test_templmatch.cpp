@@ -334,4 +334,51 @@ void CV_TemplMatchTest::prepare_to_validation( int /*test_case_idx*/ )
 
 TEST(Imgproc_MatchTemplate, accuracy) { CV_TemplMatchTest test; test.safe_run(); }
 
+TEST(Imgproc_MatchTemplate, matcher_many_templates)
+{
+    RNG& rng = theRNG();
+    const int types[] = { CV_8UC3, CV_32FC1 };
+    const Size tsizes[] = { Size(107, 43), Size(27, 52), Size(5, 3), Size(64, 64) };
+    int nthreads = getNumThreads();
+    for (int k = 0; k < 2; k++)
+    {
+        Mat img(383, 526, types[k]);
+        cvtest::randUni(rng, img, Scalar::all(0), Scalar::all(255));
+        std::vector<Mat> templs;
+        for (int t = 0; t < 4; t++)
+        {
+            Mat templ(tsizes[t], types[k]);
+            cvtest::randUni(rng, templ, Scalar::all(0), Scalar::all(255));
+            templs.push_back(templ);
+        }
+
+        for (int method = TM_SQDIFF; method <= TM_CCOEFF_NORMED; method++)
+        {
+            Ptr<TemplateMatcher> matcher = createTemplateMatcher(method);
+            // the last template is added after the first match to check that the spectra are updated
+            for (int t = 0; t < 3; t++)
+                EXPECT_EQ(t, matcher->add(templs[t]));
+
+            for (int iter = 0; iter < 3; iter++)
+            {
+                if (iter == 2)
+                    matcher->add(templs[3]);
+                setNumThreads(iter == 1 ? 1 : 4);
+                std::vector<Mat> results;
+                matcher->match(img, results);
+                ASSERT_EQ((size_t)matcher->getTemplatesCount(), results.size());
+                for (size_t t = 0; t < results.size(); t++)
+                {
+                    Mat ref;
+                    matchTemplate(img, templs[t], ref, method);
+                    double eps = 1e-4*std::max(1., cvtest::norm(ref, NORM_INF));
+                    EXPECT_LE(cvtest::norm(results[t], ref, NORM_INF), eps)
+                        << "type " << types[k] << " method " << method << " template " << t;
+                }
+            }
+        }
+    }
+    setNumThreads(nthreads);
+}
+
 }} // namespace